@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace BAN
+{
+
+	// ChaCha20 block function as described in RFC 8439, with the original
+	// 64 bit block counter and 64 bit nonce layout
+	class ChaCha20
+	{
+	public:
+		static constexpr size_t key_words   = 8;
+		static constexpr size_t block_words = 16;
+		static constexpr size_t block_size  = block_words * sizeof(uint32_t);
+
+		static constexpr void block(const uint32_t (&key)[key_words], uint64_t counter, uint64_t nonce, uint32_t (&out)[block_words])
+		{
+			uint32_t state[block_words] {
+				0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+				key[0], key[1], key[2], key[3],
+				key[4], key[5], key[6], key[7],
+				static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+				static_cast<uint32_t>(nonce),   static_cast<uint32_t>(nonce >> 32),
+			};
+
+			for (size_t i = 0; i < block_words; i++)
+				out[i] = state[i];
+
+			for (size_t i = 0; i < 10; i++)
+			{
+				quarter_round(out, 0, 4,  8, 12);
+				quarter_round(out, 1, 5,  9, 13);
+				quarter_round(out, 2, 6, 10, 14);
+				quarter_round(out, 3, 7, 11, 15);
+				quarter_round(out, 0, 5, 10, 15);
+				quarter_round(out, 1, 6, 11, 12);
+				quarter_round(out, 2, 7,  8, 13);
+				quarter_round(out, 3, 4,  9, 14);
+			}
+
+			for (size_t i = 0; i < block_words; i++)
+				out[i] += state[i];
+		}
+
+	private:
+		static constexpr uint32_t rotl(uint32_t value, int amount)
+		{
+			return (value << amount) | (value >> (32 - amount));
+		}
+
+		static constexpr void quarter_round(uint32_t (&x)[block_words], size_t a, size_t b, size_t c, size_t d)
+		{
+			x[a] += x[b]; x[d] ^= x[a]; x[d] = rotl(x[d], 16);
+			x[c] += x[d]; x[b] ^= x[c]; x[b] = rotl(x[b], 12);
+			x[a] += x[b]; x[d] ^= x[a]; x[d] = rotl(x[d],  8);
+			x[c] += x[d]; x[b] ^= x[c]; x[b] = rotl(x[b],  7);
+		}
+	};
+
+	// RFC 8439 section 2.3.2 test vector. Its 32 bit counter and 96 bit nonce
+	// map to counter 0x0900000000000001 and nonce 0x4a000000 in this layout
+	static_assert([] {
+		constexpr uint32_t key[ChaCha20::key_words] {
+			0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+			0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+		};
+		constexpr uint32_t expected[ChaCha20::block_words] {
+			0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3,
+			0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+			0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+			0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2,
+		};
+		uint32_t out[ChaCha20::block_words] {};
+		ChaCha20::block(key, 0x0900000000000001, 0x4a000000, out);
+		for (size_t i = 0; i < ChaCha20::block_words; i++)
+			if (out[i] != expected[i])
+				return false;
+		return true;
+	}());
+
+}
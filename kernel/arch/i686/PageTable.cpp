@@ -1,5 +1,6 @@
 #include <kernel/BootInfo.h>
 #include <kernel/CPUID.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/SpinLock.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/PageTable.h>
@@ -21,7 +22,8 @@ extern uint64_t g_boot_fast_page_pt[];
 namespace Kernel
 {
 
-	SpinLock PageTable::s_fast_page_lock;
+	static LockClass s_fast_page_lock_class { "fast_page" };
+	SpinLock PageTable::s_fast_page_lock { s_fast_page_lock_class };
 
 	constexpr uint64_t s_page_flag_mask = 0x8000000000000FFF;
 	constexpr uint64_t s_page_addr_mask = ~s_page_flag_mask;
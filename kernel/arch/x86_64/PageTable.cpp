@@ -1,5 +1,6 @@
 #include <kernel/BootInfo.h>
 #include <kernel/CPUID.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/SpinLock.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/PageTable.h>
@@ -21,9 +22,10 @@ extern uint64_t g_boot_fast_page_pt[];
 namespace Kernel
 {
 
-	SpinLock PageTable::s_fast_page_lock;
+	static LockClass s_fast_page_lock_class { "fast_page" };
+	SpinLock PageTable::s_fast_page_lock { s_fast_page_lock_class };
 
-	static constexpr vaddr_t s_hhdm_offset = 0xFFFF800000000000;
+	static constexpr vaddr_t s_hhdm_offset = PageTable::direct_map_offset;
 
 	constexpr uint64_t s_page_flag_mask = 0x8000000000000FFF;
 	constexpr uint64_t s_page_addr_mask = ~s_page_flag_mask;
@@ -58,9 +60,8 @@ namespace Kernel
 
 	static paddr_t allocate_zeroed_page_aligned_page()
 	{
-		const paddr_t paddr = Heap::get().take_free_page();
+		const paddr_t paddr = Heap::get().take_zeroed_page();
 		ASSERT(paddr);
-		memset(reinterpret_cast<void*>(paddr + s_hhdm_offset), 0, PAGE_SIZE);
 		return paddr;
 	}
 
@@ -7,8 +7,15 @@ namespace Kernel::API
 
 	enum SharedPageFeature : uint32_t
 	{
-		SPF_GETTIME = 1 << 0,
-		SPF_RDTSCP  = 1 << 1,
+		SPF_GETTIME   = 1 << 0,
+		SPF_RDTSCP    = 1 << 1,
+		SPF_GETRANDOM = 1 << 2,
+	};
+
+	enum SharedPageCPUTimeFlag : uint32_t
+	{
+		// thread is the only thread of its process, process cpu time equals thread cpu time
+		SPC_SINGLE_THREADED = 1 << 0,
 	};
 
 	struct SharedPage
@@ -17,10 +24,19 @@ namespace Kernel::API
 
 		uint32_t features;
 
+		// incremented every time the kernel random generator is reseeded,
+		// userspace generators seeded with an older generation must reseed
+		uint64_t random_generation;
+
 		struct
 		{
 			uint64_t realtime_s;
 			uint32_t realtime_ns;
+
+			// ns since boot at the last system timer tick
+			uint32_t coarse_seq;
+			uint32_t coarse_resolution_ns;
+			uint64_t coarse_ns;
 		} gettime_shared;
 
 		struct
@@ -33,6 +49,16 @@ namespace Kernel::API
 				uint64_t last_ns;
 				uint64_t last_tsc;
 			} gettime_local;
+
+			// userspace thread currently executing on this processor
+			struct
+			{
+				uint32_t seq;
+				uint32_t tid;
+				uint32_t flags;
+				uint64_t total_ns;
+				uint64_t start_ns;
+			} cputime;
 		} cpus[];
 	};
 
@@ -30,6 +30,8 @@ namespace Kernel
 		void set_timer_dealine(uint64_t ns);
 
 	private:
+		void set_irq_destination(uint8_t irq, ProcessorID);
+
 		uint32_t read_from_local_apic(ptrdiff_t);
 		void write_to_local_apic(ptrdiff_t, uint32_t);
 
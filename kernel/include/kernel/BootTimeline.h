@@ -0,0 +1,67 @@
+#pragma once
+
+#include <BAN/String.h>
+#include <BAN/StringView.h>
+#include <kernel/Lock/Mutex.h>
+#include <kernel/ThreadBlocker.h>
+
+namespace Kernel
+{
+
+	// Start and end times of the steps taken during boot. Entries are kept in a
+	// fixed table so recording never allocates, steps past its capacity are dropped.
+	class BootTimeline
+	{
+	public:
+		static constexpr size_t invalid_id = SIZE_MAX;
+
+		static size_t begin(BAN::StringView name);
+		static void end(size_t id);
+
+		// One line per step in the order they were started, "start_ns end_ns cpu tid name".
+		// end_ns is 0 for steps that are still running
+		static BAN::ErrorOr<BAN::String> format();
+
+		class Scope
+		{
+			BAN_NON_COPYABLE(Scope);
+			BAN_NON_MOVABLE(Scope);
+
+		public:
+			Scope(BAN::StringView name)
+				: m_id(BootTimeline::begin(name))
+			{ }
+			~Scope() { BootTimeline::end(m_id); }
+
+		private:
+			const size_t m_id;
+		};
+	};
+
+	// Runs independent boot tasks concurrently on kernel threads. Every task is
+	// recorded to the boot timeline, wait() returns once all spawned tasks are done.
+	class BootTaskGroup
+	{
+		BAN_NON_COPYABLE(BootTaskGroup);
+		BAN_NON_MOVABLE(BootTaskGroup);
+
+	public:
+		using task_t = void(*)(void*);
+
+	public:
+		BootTaskGroup() = default;
+		~BootTaskGroup() { wait(); }
+
+		void spawn(BAN::StringView name, task_t, void* data);
+		void wait();
+
+	private:
+		void task_done();
+
+	private:
+		Mutex         m_mutex;
+		ThreadBlocker m_blocker;
+		size_t        m_pending { 0 };
+	};
+
+}
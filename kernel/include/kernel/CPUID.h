@@ -83,6 +83,10 @@ namespace CPUID
 	bool has_1gib_pages();
 	bool has_invariant_tsc();
 	bool has_rdtscp();
+	bool has_rdseed();
+	bool has_arat();
+	// returns the substate counts of MWAIT C-states (CPUID leaf 5 EDX), 0 if MONITOR/MWAIT is not usable
+	uint32_t get_mwait_substates();
 	uint64_t get_tsc_frequency();
 	bool has_kvm_pvclock();
 
@@ -24,6 +24,8 @@ namespace Kernel
 		Loopback,
 		TmpFS,
 		AudioController,
+		SyscallTrace,
+		Profiler,
 	};
 
 }
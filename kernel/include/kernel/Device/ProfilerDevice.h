@@ -0,0 +1,59 @@
+#pragma once
+
+#include <BAN/StringView.h>
+#include <kernel/Device/Device.h>
+#include <kernel/InterruptStack.h>
+#include <kernel/Lock/Mutex.h>
+
+#include <sys/profile.h>
+
+namespace Kernel
+{
+
+	// Sampling profiler driven by the scheduler's timer. While profiling is active every
+	// processor arms its timer for the next sample and records the interrupted kernel and
+	// userspace call chains to its own ring buffer. Reading the device drains whole records.
+	class ProfilerDevice final : public CharacterDevice
+	{
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<ProfilerDevice>> create(mode_t, uid_t, gid_t);
+
+		static bool is_active();
+		static bool is_profiling(pid_t);
+
+		// Returns the time of the next sample on the current processor
+		static uint64_t next_sample_ns();
+
+		// Called from the timer interrupt with interrupts disabled
+		static void on_timer_interrupt(const InterruptStack&, const InterruptRegisters&);
+
+		// Records an executable mapping so samples can be symbolized
+		static void record_mmap(pid_t, vaddr_t, size_t, off_t, BAN::StringView path);
+
+		virtual BAN::StringView name() const override { return "profile"_sv; }
+
+	protected:
+		ProfilerDevice(mode_t mode, uid_t uid, gid_t gid, dev_t rdev)
+			: CharacterDevice(mode, uid, gid)
+		{
+			m_rdev = rdev;
+		}
+
+		virtual BAN::ErrorOr<long> ioctl_impl(unsigned long, void*) override;
+
+		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan) override;
+		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan) override { return BAN::Error::from_errno(EINVAL); }
+
+		virtual bool can_read_impl() const override;
+		virtual bool can_write_impl() const override { return false; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		static void record(const profile_record&);
+
+	private:
+		Mutex m_mutex;
+	};
+
+}
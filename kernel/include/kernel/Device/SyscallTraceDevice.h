@@ -0,0 +1,46 @@
+#pragma once
+
+#include <kernel/Device/Device.h>
+#include <kernel/Lock/Mutex.h>
+
+#include <sys/syscall_trace.h>
+
+namespace Kernel
+{
+
+	// Traced syscalls are recorded to per processor ring buffers. A buffer is only written
+	// by its own processor with interrupts disabled, so recording does not take any locks.
+	// Reading the device drains whole events from all buffers.
+	class SyscallTraceDevice final : public CharacterDevice
+	{
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<SyscallTraceDevice>> create(mode_t, uid_t, gid_t);
+
+		// Allocates the event buffers, must be called before any thread is traced
+		static BAN::ErrorOr<void> initialize_buffers();
+
+		// Appends event to the current processor's buffer. The event is dropped if the buffer is full
+		static void record(const syscall_trace_event&);
+
+		virtual BAN::StringView name() const override { return "systrace"_sv; }
+
+	protected:
+		SyscallTraceDevice(mode_t mode, uid_t uid, gid_t gid, dev_t rdev)
+			: CharacterDevice(mode, uid, gid)
+		{
+			m_rdev = rdev;
+		}
+
+		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan) override;
+		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan) override { return BAN::Error::from_errno(EINVAL); }
+
+		virtual bool can_read_impl() const override;
+		virtual bool can_write_impl() const override { return false; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		Mutex m_mutex;
+	};
+
+}
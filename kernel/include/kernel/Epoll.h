@@ -1,6 +1,7 @@
 #pragma once
 
 #include <BAN/HashMap.h>
+#include <BAN/UniqPtr.h>
 #include <kernel/FS/Inode.h>
 #include <kernel/Lock/Mutex.h>
 #include <kernel/ThreadBlocker.h>
@@ -10,6 +11,30 @@
 namespace Kernel
 {
 
+	class Epoll;
+
+	// One registration of (fd, inode) in an epoll. Listeners are linked to the
+	// inode they listen on and, while they may have events pending, to the
+	// ready list of their epoll.
+	struct EpollListener
+	{
+		Epoll* epoll;
+		Inode* inode;
+		int fd;
+		epoll_event event;
+
+		// protected by epoll's ready lock
+		uint32_t ready_events { 0 };
+		bool in_ready_list { false };
+		EpollListener* ready_prev { nullptr };
+		EpollListener* ready_next { nullptr };
+
+		bool is_exclusive() const { return event.events & EPOLLEXCLUSIVE; }
+
+		// disabled oneshot listeners have no events, errors and hangups are always reported
+		bool listens_for(uint32_t events) const { return event.events && (events & (event.events | EPOLLHUP | EPOLLERR)); }
+	};
+
 	class Epoll final : public Inode
 	{
 	public:
@@ -19,7 +44,10 @@ namespace Kernel
 		BAN::ErrorOr<void> ctl(int op, int fd, BAN::RefPtr<Inode> inode, epoll_event event);
 		BAN::ErrorOr<size_t> wait(BAN::Span<epoll_event> events, uint64_t waketime_ns);
 
-		void notify(BAN::RefPtr<Inode> inode, uint32_t event);
+		// Called by the inode with its epoll lock held
+		void notify(EpollListener& listener, uint32_t event);
+
+		bool has_waiters() const { return m_waiters > 0; }
 
 	private:
 		Epoll();
@@ -34,54 +62,20 @@ namespace Kernel
 		BAN::ErrorOr<void> sync_inode(SyncType) override { return {}; }
 		BAN::ErrorOr<void> sync_data() override { return {}; }
 
-	private:
-		struct ListenEventList
-		{
-			ListenEventList() = default;
-
-			ListenEventList(const ListenEventList&) = delete;
-			ListenEventList& operator=(const ListenEventList&) = delete;
-
-			ListenEventList(ListenEventList&& other)
-				: events(BAN::move(other.events))
-			{}
-			ListenEventList& operator=(ListenEventList&& other)
-			{
-				events = BAN::move(other.events);
-				return *this;
-			}
-
-			BAN::HashMap<int, epoll_event> events;
-
-			bool has_fd(int fd) const
-			{
-				return events.contains(fd);
-			}
-
-			bool empty() const
-			{
-				return events.empty();
-			}
-
-			BAN::ErrorOr<void> add_fd(int fd, epoll_event event)
-			{
-				TRY(events.insert(fd, event));
-				return {};
-			}
-
-			void remove_fd(int fd)
-			{
-				events.remove(fd);
-			}
-		};
+		// You must hold m_ready_lock when calling these
+		void append_to_ready_list(EpollListener& listener);
+		void remove_from_ready_list(EpollListener& listener);
 
 	private:
 		Mutex m_mutex;
 		ThreadBlocker m_thread_blocker;
+		BAN::Atomic<uint32_t> m_waiters { 0 };
+
 		SpinLock m_ready_lock;
-		BAN::HashMap<BAN::RefPtr<Inode>, uint32_t> m_ready_events;
-		BAN::HashMap<BAN::RefPtr<Inode>, uint32_t> m_processing_events;
-		BAN::HashMap<BAN::RefPtr<Inode>, ListenEventList> m_listening_events;
+		EpollListener* m_ready_head { nullptr };
+		EpollListener* m_ready_tail { nullptr };
+
+		BAN::HashMap<BAN::RefPtr<Inode>, BAN::HashMap<int, BAN::UniqPtr<EpollListener>>> m_listeners;
 	};
 
 }
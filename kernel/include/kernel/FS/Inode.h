@@ -70,6 +70,7 @@ namespace Kernel
 			TTY       = 0x08,
 			PARTITION = 0x10,
 			STORAGE   = 0x20,
+			IORING    = 0x40,
 		};
 
 		enum class SyncType
@@ -108,6 +109,7 @@ namespace Kernel
 		bool is_tty()            const { return m_kind & InodeKind::TTY;       }
 		bool is_partition()      const { return m_kind & InodeKind::PARTITION; }
 		bool is_storage_device() const { return m_kind & InodeKind::STORAGE;   }
+		bool is_ioring()         const { return m_kind & InodeKind::IORING;    }
 
 		virtual const FileSystem* filesystem() const = 0;
 
@@ -131,6 +133,7 @@ namespace Kernel
 		BAN::ErrorOr<void> listen(int backlog);
 		BAN::ErrorOr<size_t> sendmsg(const msghdr& message, int flags);
 		BAN::ErrorOr<size_t> recvmsg(msghdr& message, int flags);
+		BAN::ErrorOr<size_t> recvmmsg(BAN::Span<mmsghdr> messages, int flags);
 		BAN::ErrorOr<void> getsockname(sockaddr* address, socklen_t* address_len);
 		BAN::ErrorOr<void> getpeername(sockaddr* address, socklen_t* address_len);
 		BAN::ErrorOr<void> getsockopt(int level, int option, void* value, socklen_t* value_len);
@@ -139,6 +142,8 @@ namespace Kernel
 		// General API
 		BAN::ErrorOr<size_t> read(off_t, BAN::ByteSpan buffer);
 		BAN::ErrorOr<size_t> write(off_t, BAN::ConstByteSpan buffer);
+		BAN::ErrorOr<size_t> readv(off_t, BAN::Span<const BAN::ByteSpan> buffers);
+		BAN::ErrorOr<size_t> writev(off_t, BAN::Span<const BAN::ConstByteSpan> buffers);
 		BAN::ErrorOr<void> truncate(size_t);
 		BAN::ErrorOr<void> chmod(mode_t);
 		BAN::ErrorOr<void> chown(uid_t, gid_t);
@@ -153,8 +158,8 @@ namespace Kernel
 
 		BAN::ErrorOr<long> ioctl(unsigned long request, void* arg);
 
-		BAN::ErrorOr<void> add_epoll(class Epoll*);
-		void del_epoll(class Epoll*);
+		BAN::ErrorOr<void> add_epoll(struct EpollListener*);
+		void del_epoll(struct EpollListener*);
 		void epoll_notify(uint32_t event);
 
 		virtual void on_close(int status_flags) { (void)status_flags; }
@@ -184,6 +189,9 @@ namespace Kernel
 		virtual BAN::ErrorOr<void> bind_impl(const sockaddr*, socklen_t)							{ return BAN::Error::from_errno(ENOTSUP); }
 		virtual BAN::ErrorOr<size_t> recvmsg_impl(msghdr&, int)										{ return BAN::Error::from_errno(ENOTSUP); }
 		virtual BAN::ErrorOr<size_t> sendmsg_impl(const msghdr&, int)								{ return BAN::Error::from_errno(ENOTSUP); }
+		// Receives the first message like recvmsg_impl and then any further messages that are already queued.
+		// Returns the number of messages received, which is always at least one
+		virtual BAN::ErrorOr<size_t> recvmmsg_impl(BAN::Span<mmsghdr>, int);
 		virtual BAN::ErrorOr<void> getsockname_impl(sockaddr*, socklen_t*)							{ return BAN::Error::from_errno(ENOTSUP); }
 		virtual BAN::ErrorOr<void> getpeername_impl(sockaddr*, socklen_t*)							{ return BAN::Error::from_errno(ENOTSUP); }
 		virtual BAN::ErrorOr<void> getsockopt_impl(int, int, void*, socklen_t*)						{ return BAN::Error::from_errno(ENOTSUP); }
@@ -192,6 +200,9 @@ namespace Kernel
 		// General API
 		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan)		{ return BAN::Error::from_errno(ENOTSUP); }
 		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan)	{ return BAN::Error::from_errno(ENOTSUP); }
+		// default implementations call read_impl/write_impl for each buffer
+		virtual BAN::ErrorOr<size_t> readv_impl(off_t, BAN::Span<const BAN::ByteSpan>);
+		virtual BAN::ErrorOr<size_t> writev_impl(off_t, BAN::Span<const BAN::ConstByteSpan>);
 		virtual BAN::ErrorOr<void> truncate_impl(size_t)					{ return BAN::Error::from_errno(ENOTSUP); }
 
 		// Select/Non blocking API
@@ -228,7 +239,8 @@ namespace Kernel
 		BAN::WeakPtr<SharedFileData> m_shared_region;
 
 		SpinLock m_epoll_lock;
-		BAN::LinkedList<class Epoll*> m_epolls;
+		BAN::LinkedList<struct EpollListener*> m_epoll_listeners;
+		size_t m_epoll_exclusive_rotor { 0 };
 
 		friend class Epoll;
 		friend class FileBackedRegion;
@@ -2,9 +2,9 @@
 
 #include <kernel/FS/Inode.h>
 #include <kernel/Lock/Mutex.h>
-#include <kernel/Memory/ByteRingBuffer.h>
 #include <kernel/ThreadBlocker.h>
 
+#include <limits.h>
 #include <sys/stat.h>
 
 namespace Kernel
@@ -22,27 +22,69 @@ namespace Kernel
 
 		virtual const FileSystem* filesystem() const override { return nullptr; }
 
+		size_t capacity() const { return m_buffers.size() * PAGE_SIZE; }
+		// capacity is rounded up to a multiple of PAGE_SIZE, returns the new capacity
+		BAN::ErrorOr<size_t> set_capacity(size_t);
+
+		// moves up to count bytes from source to target by passing whole pages
+		static BAN::ErrorOr<size_t> splice(Pipe& source, Pipe& target, size_t count, bool nonblock_in, bool nonblock_out);
+
+		static constexpr size_t default_capacity = 16 * PAGE_SIZE;
+		static constexpr size_t max_user_capacity = 256 * PAGE_SIZE;
+		static constexpr size_t max_capacity = 4096 * PAGE_SIZE;
+
 	private:
 		virtual BAN::ErrorOr<void> sync_inode(SyncType) override;
 		virtual BAN::ErrorOr<void> sync_data() override;
 
 		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan) override;
 		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan) override;
+		virtual BAN::ErrorOr<size_t> readv_impl(off_t, BAN::Span<const BAN::ByteSpan>) override;
+		virtual BAN::ErrorOr<size_t> writev_impl(off_t, BAN::Span<const BAN::ConstByteSpan>) override;
 		virtual BAN::ErrorOr<void> truncate_impl(size_t) override;
 
-		virtual bool can_read_impl() const override { return !m_buffer->empty(); }
-		virtual bool can_write_impl() const override { return true; }
+		virtual bool can_read_impl() const override { return m_data_size > 0; }
+		virtual bool can_write_impl() const override { return free_bytes() >= PIPE_BUF; }
 		virtual bool has_error_impl() const override { return m_reading_count == 0; }
 		virtual bool has_hungup_impl() const override { return m_writing_count == 0; }
 
 	private:
 		Pipe(const struct stat&);
 
+		// data of a pipe is stored in pages that are owned by exactly one pipe at a time
+		struct PipeBuffer
+		{
+			uint8_t* page;
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		PipeBuffer& buffer_at(size_t index) { return m_buffers[(m_buffer_head + index) % m_buffers.size()]; }
+		size_t free_bytes() const;
+
+		uint8_t* allocate_page();
+		void release_page(uint8_t* page);
+
+		// you must hold m_mutex when calling these
+		BAN::ErrorOr<void> wait_for_data(bool nonblock);
+		BAN::ErrorOr<void> wait_for_space(size_t required_space, bool nonblock);
+		BAN::ErrorOr<void> wait_for_free_buffer(bool nonblock);
+		void on_data_removed(size_t free_before, size_t buffer_count_before);
+		void on_data_added(size_t size_before);
+
 	private:
 		Mutex m_mutex;
-		ThreadBlocker m_thread_blocker;
+		// readers wait for data and writers for space. they are woken up only when
+		// the pipe stops being empty, gains enough space for an atomic write or
+		// gets a free buffer slot after all of them were in use
+		ThreadBlocker m_read_blocker;
+		ThreadBlocker m_write_blocker;
 
-		BAN::UniqPtr<ByteRingBuffer> m_buffer;
+		BAN::Vector<PipeBuffer> m_buffers;
+		size_t m_buffer_head { 0 };
+		size_t m_buffer_count { 0 };
+		size_t m_data_size { 0 };
+		uint8_t* m_spare_page { nullptr };
 
 		BAN::Atomic<uint32_t> m_writing_count { 0 };
 		BAN::Atomic<uint32_t> m_reading_count { 0 };
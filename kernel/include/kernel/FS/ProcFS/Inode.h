@@ -100,6 +100,37 @@ namespace Kernel
 		void* m_argument;
 	};
 
+	class ProcRWInode final : public TmpInode
+	{
+	public:
+		using read_callback_t = BAN::ErrorOr<size_t> (*)(off_t, BAN::ByteSpan, void*);
+		using write_callback_t = BAN::ErrorOr<size_t> (*)(off_t, BAN::ConstByteSpan, void*);
+
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<ProcRWInode>> create_new(read_callback_t, write_callback_t, TmpFileSystem&, void*, mode_t, uid_t, gid_t);
+		~ProcRWInode() = default;
+
+	protected:
+		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan) override;
+		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan) override;
+
+		// Contents are generated, truncating is allowed so the file can be opened with O_TRUNC
+		virtual BAN::ErrorOr<void> truncate_impl(size_t) override { return {}; }
+
+		virtual bool can_read_impl() const override { return true; }
+		virtual bool can_write_impl() const override { return true; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		ProcRWInode(read_callback_t, write_callback_t, TmpFileSystem&, void*, const TmpInodeInfo&);
+
+	private:
+		read_callback_t m_read_callback;
+		write_callback_t m_write_callback;
+		void* m_argument;
+	};
+
 	class ProcSymlinkInode final : public TmpInode
 	{
 	public:
@@ -150,4 +181,87 @@ namespace Kernel
 		Process& m_process;
 	};
 
+	// /proc/<pid>/task, a directory per thread is created on lookup
+	class ProcTaskDirectoryInode final : public TmpInode
+	{
+		//FIXME: dynamically update ruid/rgid
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<ProcTaskDirectoryInode>> create_new(Process&, TmpFileSystem&, mode_t);
+		~ProcTaskDirectoryInode() = default;
+	protected:
+		virtual BAN::ErrorOr<BAN::RefPtr<Inode>> find_inode_impl(BAN::StringView) override;
+		virtual BAN::ErrorOr<size_t> list_next_inodes_impl(off_t, struct dirent*, size_t) override;
+		virtual BAN::ErrorOr<void> create_file_impl(BAN::StringView, mode_t, uid_t, gid_t) override                 { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> create_directory_impl(BAN::StringView, mode_t, uid_t, gid_t) override            { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> link_inode_impl(BAN::StringView, BAN::RefPtr<Inode>) override                    { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> rename_inode_impl(BAN::RefPtr<Inode>, BAN::StringView, BAN::StringView) override { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> unlink_impl(BAN::StringView) override                                            { return BAN::Error::from_errno(EPERM); }
+
+		virtual bool can_read_impl() const override { return false; }
+		virtual bool can_write_impl() const override { return false; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		ProcTaskDirectoryInode(Process&, TmpFileSystem&, const TmpInodeInfo&);
+
+	private:
+		Process& m_process;
+	};
+
+	class ProcTidDirectoryInode final : public TmpInode
+	{
+		//FIXME: dynamically update ruid/rgid
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<ProcTidDirectoryInode>> create_new(Process&, pid_t tid, TmpFileSystem&, mode_t);
+		~ProcTidDirectoryInode() = default;
+	protected:
+		virtual BAN::ErrorOr<BAN::RefPtr<Inode>> find_inode_impl(BAN::StringView) override;
+		virtual BAN::ErrorOr<size_t> list_next_inodes_impl(off_t, struct dirent*, size_t) override;
+		virtual BAN::ErrorOr<void> create_file_impl(BAN::StringView, mode_t, uid_t, gid_t) override                 { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> create_directory_impl(BAN::StringView, mode_t, uid_t, gid_t) override            { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> link_inode_impl(BAN::StringView, BAN::RefPtr<Inode>) override                    { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> rename_inode_impl(BAN::RefPtr<Inode>, BAN::StringView, BAN::StringView) override { return BAN::Error::from_errno(EPERM); }
+		virtual BAN::ErrorOr<void> unlink_impl(BAN::StringView) override                                            { return BAN::Error::from_errno(EPERM); }
+
+		virtual bool can_read_impl() const override { return false; }
+		virtual bool can_write_impl() const override { return false; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		ProcTidDirectoryInode(Process&, pid_t tid, TmpFileSystem&, const TmpInodeInfo&);
+
+	private:
+		Process& m_process;
+		const pid_t m_tid;
+	};
+
+	class ProcROThreadInode final : public TmpInode
+	{
+		//FIXME: dynamically update ruid/rgid
+	public:
+		static BAN::ErrorOr<BAN::RefPtr<ProcROThreadInode>> create_new(Process&, pid_t tid, size_t (Process::*callback)(pid_t, off_t, BAN::ByteSpan) const, TmpFileSystem&, mode_t);
+		~ProcROThreadInode() = default;
+	protected:
+		virtual BAN::ErrorOr<size_t> read_impl(off_t, BAN::ByteSpan) override;
+
+		// You may not write here and this is always non blocking
+		virtual BAN::ErrorOr<size_t> write_impl(off_t, BAN::ConstByteSpan) override		{ return BAN::Error::from_errno(EINVAL); }
+		virtual BAN::ErrorOr<void> truncate_impl(size_t) override						{ return BAN::Error::from_errno(EINVAL); }
+
+		virtual bool can_read_impl() const override { return true; }
+		virtual bool can_write_impl() const override { return false; }
+		virtual bool has_error_impl() const override { return false; }
+		virtual bool has_hungup_impl() const override { return false; }
+
+	private:
+		ProcROThreadInode(Process&, pid_t tid, size_t (Process::*)(pid_t, off_t, BAN::ByteSpan) const, TmpFileSystem&, const TmpInodeInfo&);
+
+	private:
+		Process& m_process;
+		const pid_t m_tid;
+		size_t (Process::*m_callback)(pid_t, off_t, BAN::ByteSpan) const;
+	};
+
 }
@@ -65,9 +65,6 @@ namespace Kernel
 		BAN::ErrorOr<void> add_to_cache(BAN::RefPtr<TmpInode>);
 		void remove_from_cache(BAN::RefPtr<TmpInode>);
 
-		// FIXME: read_block and write_block should not require external buffer
-		//        probably some wrapper like PageTable::with_fast_page could work?
-
 		void read_inode(ino_t ino, TmpInodeInfo& out);
 		void write_inode(ino_t ino, const TmpInodeInfo&);
 		void delete_inode(ino_t ino);
@@ -159,10 +156,11 @@ namespace Kernel
 	template<TmpFuncs::with_block_buffer_callback F>
 	void TmpFileSystem::with_block_buffer(size_t index, F callback)
 	{
-		LockGuard _(m_mutex);
-		paddr_t block_paddr = find_block(index);
-		PageTable::with_fast_page(block_paddr, [&] {
-			BAN::ByteSpan buffer(reinterpret_cast<uint8_t*>(PageTable::fast_page()), PAGE_SIZE);
+		// the block can only be freed by the inode owning it, which is locked by
+		// the caller, so the filesystem lock is not needed while accessing it
+		const paddr_t block_paddr = find_block(index);
+		PageTable::with_physical_page(block_paddr, [&](void* page) {
+			BAN::ByteSpan buffer(static_cast<uint8_t*>(page), PAGE_SIZE);
 			callback(buffer);
 		});
 	}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <BAN/Errors.h>
+#include <BAN/Optional.h>
+#include <kernel/Memory/Types.h>
+
+namespace Kernel
+{
+
+	// Futex waiters live on the stack of the waiting thread and are linked to one of
+	// a fixed number of hashed buckets, each protected by its own lock. There are no
+	// per address objects so nothing has to be allocated or reclaimed.
+	class Futex
+	{
+	public:
+		struct Key
+		{
+			paddr_t paddr;
+			// process of a private futex, null for shared futexes
+			const void* owner;
+
+			bool operator==(const Key& other) const { return paddr == other.paddr && owner == other.owner; }
+		};
+
+		// Blocks until woken up by a matching wake. Returns EAGAIN if *addr != value
+		static BAN::ErrorOr<void> wait(Key, const uint32_t* addr, uint32_t value, uint32_t bitset, uint64_t wake_time_ns);
+
+		// Wakes up to count waiters whose bitset intersects bitset and returns the number woken up
+		static size_t wake(Key, uint32_t count, uint32_t bitset);
+
+		// Wakes up to wake_count waiters of key and moves up to requeue_count of the remaining ones
+		// to wait on target. If compare_value is set, fails with EAGAIN if *addr != compare_value
+		static BAN::ErrorOr<size_t> requeue(Key key, const uint32_t* addr, Key target, uint32_t wake_count, uint32_t requeue_count, BAN::Optional<uint32_t> compare_value);
+
+		// Atomically applies encoded operation to *addr2, wakes up to wake_count waiters of key and
+		// if the operation's comparison holds for the old value, up to wake_count2 waiters of key2
+		static BAN::ErrorOr<size_t> wake_op(Key key, Key key2, uint32_t* addr2, uint32_t wake_count, uint32_t wake_count2, uint32_t operation);
+	};
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <BAN/Optional.h>
+#include <BAN/Vector.h>
+#include <kernel/Epoll.h>
+#include <kernel/Lock/Mutex.h>
+#include <kernel/OpenFileDescriptorSet.h>
+
+#include <sys/ioring.h>
+
+namespace Kernel
+{
+
+	class Process;
+
+	class IORing final : public Inode
+	{
+	public:
+		// user_shared is only valid in the address space identified by address_space_id
+		static BAN::ErrorOr<BAN::RefPtr<IORing>> create(uint32_t entries, vaddr_t user_shared, uint64_t address_space_id);
+
+		// Submits up to to_submit entries from the submission queue and waits until at least
+		// min_complete completions are available, no operations are in flight or timeout
+		// expires. Operations are executed in the context of the calling process, which must
+		// share the address space the ring was created in.
+		BAN::ErrorOr<size_t> enter(Process&, uint32_t to_submit, uint32_t min_complete, const timespec* timeout);
+
+	private:
+		IORing(uint32_t entries, vaddr_t user_shared, uint64_t address_space_id, BAN::RefPtr<Epoll>);
+
+		static BAN::ErrorOr<uint64_t> timeout_to_waketime_ns(const timespec&);
+
+		const FileSystem* filesystem() const override { return nullptr; }
+
+		bool can_read_impl() const override { return false; }
+		bool can_write_impl() const override { return false; }
+		bool has_error_impl() const override { return false; }
+		bool has_hungup_impl() const override { return false; }
+
+		BAN::ErrorOr<void> sync_inode(SyncType) override { return {}; }
+		BAN::ErrorOr<void> sync_data() override { return {}; }
+
+	private:
+		using OpenFileDescription = OpenFileDescriptorSet::OpenFileDescription;
+
+		struct PendingOperation
+		{
+			ioring_sqe sqe;
+			// captured at submit so the operation is not redirected if the fd is closed and reused
+			BAN::RefPtr<OpenFileDescription> description;
+			uint64_t waketime_ns;
+			int epoll_key;
+		};
+
+		ioring_shared* shared() const { return reinterpret_cast<ioring_shared*>(m_user_shared); }
+		ioring_sqe* sqes() const { return reinterpret_cast<ioring_sqe*>(shared() + 1); }
+		ioring_cqe* cqes() const { return reinterpret_cast<ioring_cqe*>(sqes() + m_sq_entries); }
+
+		BAN::ErrorOr<void> submit(Process&, const ioring_sqe&);
+		BAN::ErrorOr<void> process_pending(Process&);
+
+		// Executes the operation if it can be done without blocking
+		BAN::Optional<int32_t> try_execute(Process&, const ioring_sqe&, OpenFileDescription&);
+		BAN::ErrorOr<long> execute(Process&, const ioring_sqe&, OpenFileDescription&);
+
+		BAN::ErrorOr<uint32_t> completions_available() const;
+		BAN::ErrorOr<void> post_completion(uint64_t user_data, int32_t result);
+
+	private:
+		Mutex m_mutex;
+		const BAN::RefPtr<Epoll> m_epoll;
+
+		const vaddr_t m_user_shared;
+		const uint64_t m_address_space_id;
+		const uint32_t m_sq_entries;
+		const uint32_t m_cq_entries;
+
+		uint32_t m_sq_head { 0 };
+		uint32_t m_cq_tail { 0 };
+		uint32_t m_cq_overflow { 0 };
+
+		int m_next_epoll_key { 0 };
+		BAN::Vector<PendingOperation> m_pending;
+	};
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <BAN/ByteSpan.h>
+#include <BAN/String.h>
+#include <kernel/InterruptNumbers.h>
+#include <kernel/ProcessorID.h>
+
+namespace Kernel
+{
+
+	// Tracks the processor every irq is delivered to and how many times each
+	// processor has handled it. Whoever programs the routing of an irq (IOAPIC
+	// redirection entry or MSI/MSI-X message address) registers a callback that
+	// moves it to another processor.
+	class IRQAffinity
+	{
+	public:
+		static constexpr uint8_t irq_count = IRQ_MSI_END - IRQ_VECTOR_BASE;
+
+		using retarget_t = BAN::ErrorOr<void>(*)(uint8_t irq, ProcessorID target, void* data);
+
+	public:
+		// Allocates the per processor counters, must be called once all processors are online
+		static BAN::ErrorOr<void> initialize();
+
+		// Returns the processor irq should be delivered to. Spread irqs are distributed
+		// round robin over online processors, others go to the bootstrap processor
+		static ProcessorID register_irq(uint8_t irq, retarget_t, void* data, bool spread);
+
+		static BAN::ErrorOr<void> set_affinity(uint8_t irq, uint8_t processor_index);
+
+		// Called on every handled irq with interrupts disabled
+		static void on_irq(uint8_t irq);
+
+		// One line per routed irq, "irq processor_index count_cpu0 count_cpu1 ..."
+		static BAN::ErrorOr<BAN::String> format_counts();
+
+		// One line per routed irq, "irq processor_index"
+		static BAN::ErrorOr<BAN::String> format_affinities();
+
+		// Parses lines of "irq processor_index" and retargets the given irqs
+		static BAN::ErrorOr<size_t> write_affinities(BAN::ConstByteSpan);
+	};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <BAN/Atomic.h>
+#include <BAN/NoCopyMove.h>
+#include <BAN/String.h>
+
+#include <stdint.h>
+
+namespace Kernel
+{
+
+	// Contention statistics shared by all locks of one class. A class registers itself
+	// when constructed and is never unregistered, so classes must be static objects.
+	class LockClass
+	{
+		BAN_NON_COPYABLE(LockClass);
+		BAN_NON_MOVABLE(LockClass);
+
+	public:
+		explicit LockClass(const char* name);
+
+		static bool is_enabled() { return s_enabled.load(BAN::MemoryOrder::memory_order_relaxed); }
+		static void set_enabled(bool enabled) { s_enabled.store(enabled, BAN::MemoryOrder::memory_order_relaxed); }
+		static void reset_all();
+
+		static uint64_t now() { return __builtin_ia32_rdtsc(); }
+
+		// One line per class, "name acquisitions contended wait_cycles hold_cycles max_hold_cycles"
+		static BAN::ErrorOr<BAN::String> format_all();
+
+		// Called by the lock implementations. wait_start is the time the caller started
+		// waiting for the lock or zero if it was acquired without contention. Returns
+		// the time hold time is measured from.
+		uint64_t on_acquire(uint64_t wait_start);
+		void on_release(uint64_t hold_start);
+
+		const char* name() const { return m_name; }
+
+	private:
+		static BAN::Atomic<bool> s_enabled;
+		static BAN::Atomic<LockClass*> s_first;
+
+		const char* const m_name;
+		LockClass* m_next { nullptr };
+
+		BAN::Atomic<uint64_t> m_acquisitions    { 0 };
+		BAN::Atomic<uint64_t> m_contended       { 0 };
+		BAN::Atomic<uint64_t> m_wait_cycles     { 0 };
+		BAN::Atomic<uint64_t> m_hold_cycles     { 0 };
+		BAN::Atomic<uint64_t> m_max_hold_cycles { 0 };
+	};
+
+}
@@ -8,6 +8,8 @@
 namespace Kernel
 {
 
+	class LockClass;
+
 	class BaseMutex
 	{
 	public:
@@ -25,6 +27,9 @@ namespace Kernel
 
 	public:
 		Mutex() = default;
+		explicit Mutex(LockClass& lock_class)
+			: m_lock_class(&lock_class)
+		{}
 
 		bool try_lock();
 		void lock() override;
@@ -38,6 +43,8 @@ namespace Kernel
 	private:
 		BAN::Atomic<pid_t>	m_locker		{ -1 };
 		uint32_t			m_lock_depth	{  0 };
+		LockClass*			m_lock_class	{ nullptr };
+		uint64_t			m_hold_start	{  0 };
 	};
 
 	class PriorityMutex final : public BaseMutex
@@ -6,12 +6,19 @@
 namespace Kernel
 {
 
+	class LockClass;
+
+	// NOTE: Readers hold the lock concurrently, so lock statistics only
+	//       measure hold time of writers
 	class RWLock
 	{
 		BAN_NON_COPYABLE(RWLock);
 		BAN_NON_MOVABLE(RWLock);
 	public:
 		RWLock() = default;
+		explicit RWLock(LockClass& lock_class)
+			: m_lock_class(&lock_class)
+		{}
 
 		void rd_lock();
 		void rd_unlock();
@@ -25,6 +32,8 @@ namespace Kernel
 		uint32_t m_writers_waiting { 0 };
 		pid_t m_writer { -1 };
 		uint32_t m_writer_depth { 0 };
+		LockClass* m_lock_class { nullptr };
+		uint64_t m_write_hold_start { 0 };
 	};
 
 	class RWLockRDGuard
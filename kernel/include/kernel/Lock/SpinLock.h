@@ -10,6 +10,8 @@
 namespace Kernel
 {
 
+	class LockClass;
+
 	class SpinLock
 	{
 		BAN_NON_COPYABLE(SpinLock);
@@ -17,6 +19,9 @@ namespace Kernel
 
 	public:
 		SpinLock() = default;
+		explicit SpinLock(LockClass& lock_class)
+			: m_lock_class(&lock_class)
+		{}
 
 		InterruptState lock();
 
@@ -33,6 +38,8 @@ namespace Kernel
 
 	private:
 		BAN::Atomic<ProcessorID::value_type> m_locker { PROCESSOR_NONE.as_u32() };
+		LockClass*                           m_lock_class { nullptr };
+		uint64_t                             m_hold_start { 0 };
 	};
 
 	class RecursiveSpinLock
@@ -42,6 +49,9 @@ namespace Kernel
 
 	public:
 		RecursiveSpinLock() = default;
+		explicit RecursiveSpinLock(LockClass& lock_class)
+			: m_lock_class(&lock_class)
+		{}
 
 		InterruptState lock();
 
@@ -59,6 +69,8 @@ namespace Kernel
 	private:
 		BAN::Atomic<ProcessorID::value_type> m_locker { PROCESSOR_NONE.as_u32() };
 		uint32_t                             m_lock_depth { 0 };
+		LockClass*                           m_lock_class { nullptr };
+		uint64_t                             m_hold_start { 0 };
 	};
 
 	template<typename Lock>
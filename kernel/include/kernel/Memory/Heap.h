@@ -1,6 +1,9 @@
 #pragma once
 
+#include <BAN/Array.h>
+#include <BAN/Atomic.h>
 #include <BAN/NoCopyMove.h>
+#include <BAN/String.h>
 #include <BAN/Vector.h>
 
 #include <kernel/Lock/SpinLock.h>
@@ -23,6 +26,17 @@ namespace Kernel
 		paddr_t take_free_page();
 		void release_page(paddr_t);
 
+		// Returns a page filled with zeros. Pages zeroed ahead of time by idle
+		// processors are used first, otherwise a free page is zeroed here
+		paddr_t take_zeroed_page();
+
+		// Zeroes one free page into the zeroed page pool, returns false if the pool is
+		// full or free memory is low. Must be called with interrupts enabled
+		bool fill_zeroed_page_pool();
+
+		// "pages capacity hits misses" of the zeroed page pool
+		static BAN::ErrorOr<BAN::String> format_zeroed_page_pool();
+
 		paddr_t take_free_contiguous_pages(size_t pages);
 		void release_contiguous_pages(paddr_t paddr, size_t pages);
 
@@ -33,9 +47,18 @@ namespace Kernel
 		Heap() = default;
 		void initialize_impl();
 
+	private:
+		static constexpr size_t zeroed_page_pool_capacity = 2048;
+
 	private:
 		BAN::Vector<PhysicalRange>	m_physical_ranges;
 		mutable SpinLock			m_lock;
+
+		BAN::Array<paddr_t, zeroed_page_pool_capacity>	m_zeroed_pages;
+		size_t											m_zeroed_page_count { 0 };
+		mutable SpinLock								m_zeroed_page_lock;
+		BAN::Atomic<size_t>								m_zeroed_page_hits { 0 };
+		BAN::Atomic<size_t>								m_zeroed_page_misses { 0 };
 	};
 
 }
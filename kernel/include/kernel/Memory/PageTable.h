@@ -104,6 +104,42 @@ namespace Kernel
 			return ret;
 		}
 
+		// On x86_64 all RAM (memory map entries marked available) is mapped at a fixed
+		// offset. Pointers into it need no locking and stay valid until the page is freed,
+		// but MMIO and firmware reserved memory is not covered.
+		static constexpr bool has_direct_map()
+		{
+#if ARCH(x86_64)
+			return true;
+#elif ARCH(i686)
+			return false;
+#endif
+		}
+
+#if ARCH(x86_64)
+		static constexpr vaddr_t direct_map_offset = 0xFFFF800000000000;
+
+		template<typename T = void>
+		static T* direct_map_as(paddr_t paddr)
+		{
+			ASSERT(paddr != 0);
+			return reinterpret_cast<T*>(paddr + direct_map_offset);
+		}
+#endif
+
+		// Calls callback with the page at paddr mapped. This goes through the direct map when
+		// there is one and falls back to the current processor's fast page otherwise, so the
+		// callback must not block or access another page with the same function.
+		template<with_per_cpu_fast_page_callback F>
+		static void with_physical_page(paddr_t paddr, F callback)
+		{
+#if ARCH(x86_64)
+			callback(direct_map_as(paddr));
+#elif ARCH(i686)
+			with_per_cpu_fast_page(paddr, callback);
+#endif
+		}
+
 		// FIXME: implement sized checks, return span, etc
 		static void* fast_page_as_ptr(size_t offset = 0)
 		{
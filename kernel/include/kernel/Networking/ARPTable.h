@@ -1,8 +1,9 @@
 #pragma once
 
-#include <BAN/CircularQueue.h>
 #include <BAN/HashMap.h>
+#include <BAN/Optional.h>
 #include <BAN/UniqPtr.h>
+#include <BAN/Vector.h>
 #include <kernel/Networking/NetworkInterface.h>
 
 namespace Kernel
@@ -22,6 +23,9 @@ namespace Kernel
 	};
 	static_assert(sizeof(ARPPacket) == 28);
 
+	// Resolution never blocks the sender. Packets to a neighbor whose MAC address is not
+	// yet known are queued on its entry and sent when the ARP reply arrives. A background
+	// thread retransmits unanswered requests and ages out entries that are no longer used.
 	class ARPTable
 	{
 		BAN_NON_COPYABLE(ARPTable);
@@ -30,16 +34,61 @@ namespace Kernel
 	public:
 		static BAN::ErrorOr<BAN::UniqPtr<ARPTable>> create();
 
-		BAN::ErrorOr<BAN::MACAddress> get_mac_from_ipv4(NetworkInterface&, BAN::IPv4Address);
+		// Sends IPv4 packet to ipv4_address (or the gateway) through interface. If the address is
+		// not resolved yet, the packet is queued and this returns immediately
+		template<size_t SIZE>
+		BAN::ErrorOr<void> send_ipv4_packet(NetworkInterface& interface, BAN::IPv4Address ipv4_address, const BAN::ConstByteSpan (&buffer_array)[SIZE], TransmitOffload offload = {})
+		{
+			const auto dst_mac = TRY(get_mac_or_queue_packet(interface, ipv4_address, { buffer_array, SIZE }, offload));
+			if (!dst_mac.has_value())
+				return {};
+			return interface.send_with_ethernet_header(dst_mac.value(), EtherType::IPv4, buffer_array, offload);
+		}
 
 		BAN::ErrorOr<void> handle_arp_packet(NetworkInterface&, BAN::ConstByteSpan);
 
+	private:
+		enum class State
+		{
+			Incomplete,	// request sent, waiting for a reply
+			Reachable,	// confirmed within the reachable time
+			Stale,		// still used for sending, being refreshed with unicast requests
+		};
+
+		struct PendingPacket
+		{
+			BAN::Vector<uint8_t> data;
+			TransmitOffload offload;
+		};
+
+		struct Entry
+		{
+			BAN::RefPtr<NetworkInterface> interface;
+			BAN::MACAddress mac {};
+			State state { State::Incomplete };
+			uint32_t requests_sent { 0 };
+			uint64_t confirmed_ms { 0 };
+			uint64_t last_used_ms { 0 };
+			uint64_t next_request_ms { 0 };
+			BAN::Vector<PendingPacket> pending_packets;
+		};
+
 	private:
 		ARPTable() = default;
 
+		// returns empty optional if the packet was queued
+		BAN::ErrorOr<BAN::Optional<BAN::MACAddress>> get_mac_or_queue_packet(NetworkInterface&, BAN::IPv4Address, BAN::Span<const BAN::ConstByteSpan>, const TransmitOffload&);
+
+		BAN::ErrorOr<void> send_request(NetworkInterface&, BAN::IPv4Address, BAN::MACAddress dst_mac);
+		void send_pending_packets(NetworkInterface&, BAN::MACAddress, BAN::Vector<PendingPacket>&&);
+
+		void update_thread();
+
+		static BAN::ErrorOr<size_t> read_proc_table(off_t, BAN::ByteSpan, void*);
+
 	private:
 		SpinLock m_arp_table_lock;
-		BAN::HashMap<BAN::IPv4Address, BAN::MACAddress> m_arp_table;
+		BAN::HashMap<BAN::IPv4Address, Entry> m_arp_table;
 
 		friend class BAN::UniqPtr<ARPTable>;
 	};
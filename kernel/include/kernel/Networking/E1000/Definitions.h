@@ -188,6 +188,39 @@ namespace Kernel
 		CMD_IDE		= 1 << 7,
 	};
 
+	enum E1000_TUCMD : uint8_t
+	{
+		TUCMD_TCP	= 1 << 0,
+		TUCMD_IP	= 1 << 1,
+		TUCMD_TSE	= 1 << 2,
+		TUCMD_RS	= 1 << 3,
+		TUCMD_DEXT	= 1 << 5,
+		TUCMD_IDE	= 1 << 7,
+	};
+
+	enum E1000_DCMD : uint8_t
+	{
+		DCMD_EOP	= 1 << 0,
+		DCMD_IFCS	= 1 << 1,
+		DCMD_TSE	= 1 << 2,
+		DCMD_RS		= 1 << 3,
+		DCMD_DEXT	= 1 << 5,
+		DCMD_VLE	= 1 << 6,
+		DCMD_IDE	= 1 << 7,
+	};
+
+	enum E1000_DTYP : uint8_t
+	{
+		DTYP_CONTEXT	= 0b0000,
+		DTYP_DATA		= 0b0001,
+	};
+
+	enum E1000_POPTS : uint8_t
+	{
+		POPTS_IXSM = 1 << 0,
+		POPTS_TXSM = 1 << 1,
+	};
+
 	enum E1000_RX_STS : uint8_t
 	{
 		RX_STS_IPCS  = 1 << 6,
@@ -229,4 +262,33 @@ namespace Kernel
 		uint16_t special;
 	} __attribute__((packed));
 
+	// length (bits 0-19), dtyp (bits 20-23) and command (bits 24-31)
+	constexpr uint32_t e1000_tx_cmd_and_length(uint8_t cmd, uint8_t dtyp, uint32_t length)
+	{
+		return ((uint32_t)cmd << 24) | ((uint32_t)dtyp << 20) | (length & 0xFFFFF);
+	}
+
+	struct e1000_tx_context_desc
+	{
+		uint8_t ipcss;
+		uint8_t ipcso;
+		uint16_t ipcse;
+		uint8_t tucss;
+		uint8_t tucso;
+		uint16_t tucse;
+		uint32_t cmd_and_length;
+		uint8_t status;
+		uint8_t hdrlen;
+		uint16_t mss;
+	} __attribute__((packed));
+
+	struct e1000_tx_data_desc
+	{
+		uint64_t addr;
+		uint32_t cmd_and_length;
+		uint8_t status;
+		uint8_t popts;
+		uint16_t special;
+	} __attribute__((packed));
+
 }
@@ -29,6 +29,7 @@ namespace Kernel
 		int link_speed() override;
 
 		size_t payload_mtu() const override { return E1000_RX_BUFFER_SIZE - sizeof(EthernetHeader); }
+		uint32_t offload_features() const override;
 
 		void handle_irq() final override;
 
@@ -45,7 +46,7 @@ namespace Kernel
 		uint32_t read32(uint16_t reg);
 		void write32(uint16_t reg, uint32_t value);
 
-		BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers) override;
+		BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload) override;
 
 		bool can_read_impl() const override { return false; }
 		bool can_write_impl() const override { return false; }
@@ -6,7 +6,9 @@
 #include <BAN/Endianness.h>
 #include <BAN/IPv4.h>
 #include <BAN/NoCopyMove.h>
+#include <BAN/Optional.h>
 #include <BAN/UniqPtr.h>
+#include <BAN/Vector.h>
 #include <kernel/Networking/ARPTable.h>
 #include <kernel/Networking/NetworkInterface.h>
 #include <kernel/Networking/NetworkLayer.h>
@@ -42,26 +44,86 @@ namespace Kernel
 
 		BAN::ErrorOr<void> handle_ipv4_packet(NetworkInterface&, BAN::ConstByteSpan, uint32_t validated_cksums);
 
-		virtual void unbind_socket(uint16_t port) override;
+		virtual void unbind_socket(const NetworkSocket&, uint16_t port) override;
 		virtual BAN::ErrorOr<void> bind_socket_with_target(BAN::RefPtr<NetworkSocket>, const sockaddr* target_address, socklen_t target_address_len) override;
 		virtual BAN::ErrorOr<void> bind_socket_to_address(BAN::RefPtr<NetworkSocket>, const sockaddr* address, socklen_t address_len) override;
 		virtual BAN::ErrorOr<void> get_socket_address(BAN::RefPtr<NetworkSocket>, sockaddr* address, socklen_t* address_len) override;
 
+		virtual BAN::ErrorOr<void> add_connection(BAN::RefPtr<NetworkSocket>, const sockaddr* remote_address, socklen_t remote_address_len) override;
+		virtual void remove_connection(const NetworkSocket&, const sockaddr* remote_address, socklen_t remote_address_len) override;
+
 		virtual BAN::ErrorOr<void> sendto(NetworkSocket&, BAN::ConstByteSpan, const sockaddr*, socklen_t) override;
 
 		virtual Socket::Domain domain() const override { return Socket::Domain::INET ;}
 		virtual size_t header_size() const override { return sizeof(IPv4Header); }
 
+	private:
+		struct ConnectionKey
+		{
+			BAN::IPv4Address local_address { 0 };
+			BAN::IPv4Address remote_address { 0 };
+			uint16_t local_port { 0 };
+			uint16_t remote_port { 0 };
+			uint8_t protocol { 0 };
+
+			bool operator==(const ConnectionKey& other) const
+			{
+				return local_address == other.local_address
+					&& remote_address == other.remote_address
+					&& local_port == other.local_port
+					&& remote_port == other.remote_port
+					&& protocol == other.protocol;
+			}
+
+			BAN::hash_t hash() const;
+		};
+
+		struct Connection
+		{
+			ConnectionKey key;
+			const NetworkSocket* owner;
+			BAN::WeakPtr<NetworkSocket> socket;
+		};
+
+		static LockClass s_connection_bucket_lock_class;
+		static LockClass s_bound_socket_lock_class;
+
+		// Connected sockets are hashed by their 4-tuple into buckets with their own
+		// locks, so lookups for different connections don't contend with each other
+		// or with binding
+		struct ConnectionBucket
+		{
+			SpinLock lock { s_connection_bucket_lock_class };
+			BAN::Vector<Connection> connections;
+		};
+		static constexpr size_t s_connection_bucket_count = 256;
+
+		struct BoundSocket
+		{
+			const NetworkSocket* owner;
+			BAN::WeakPtr<NetworkSocket> socket;
+		};
+
 	private:
 		IPv4Layer() = default;
 
 		BAN::ErrorOr<in_port_t> find_free_port();
 
+		static BAN::Optional<ConnectionKey> connection_key(const NetworkSocket&, const sockaddr* remote_address, socklen_t remote_address_len);
+		ConnectionBucket& connection_bucket(const ConnectionKey&);
+
+		BAN::RefPtr<NetworkSocket> find_connected_socket(const ConnectionKey&);
+		// selects one of the sockets bound to key's local port. sockets sharing
+		// a port with SO_REUSEPORT are selected by the hash of the 4-tuple
+		BAN::RefPtr<NetworkSocket> find_bound_socket(const ConnectionKey&);
+
 	private:
 		BAN::UniqPtr<ARPTable> m_arp_table;
 
-		RecursiveSpinLock m_bound_socket_lock;
-		BAN::HashMap<int, BAN::WeakPtr<NetworkSocket>> m_bound_sockets;
+		RecursiveSpinLock m_bound_socket_lock { s_bound_socket_lock_class };
+		BAN::HashMap<int, BAN::Vector<BoundSocket>> m_bound_sockets;
+
+		ConnectionBucket m_connection_buckets[s_connection_bucket_count];
 
 		friend class BAN::UniqPtr<IPv4Layer>;
 	};
@@ -22,13 +22,16 @@ namespace Kernel
 
 		size_t payload_mtu() const override { return buffer_size - sizeof(EthernetHeader); }
 
+		// packets never leave the machine, so checksums don't have to be calculated at all
+		uint32_t offload_features() const override { return OFFLOAD_TX_CKSUM_IPV4 | OFFLOAD_TX_CKSUM_TCP | OFFLOAD_TX_CKSUM_UDP; }
+
 	protected:
 		LoopbackInterface()
 			: NetworkInterface(Type::Loopback)
 		{}
 		~LoopbackInterface();
 
-		BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers) override;
+		BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload) override;
 
 		bool can_read_impl() const override { return false; }
 		bool can_write_impl() const override { return false; }
@@ -43,6 +46,7 @@ namespace Kernel
 		{
 			uint8_t* addr;
 			uint32_t size;
+			uint32_t validated_cksums;
 			uint8_t state;
 		};
 
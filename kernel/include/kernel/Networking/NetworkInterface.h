@@ -30,6 +30,23 @@ namespace Kernel
 		CKSUM_UDP  = 1 << 2,
 	};
 
+	enum NetworkOffload : uint32_t
+	{
+		OFFLOAD_TX_CKSUM_IPV4 = CKSUM_IPV4,
+		OFFLOAD_TX_CKSUM_TCP  = CKSUM_TCP,
+		OFFLOAD_TX_CKSUM_UDP  = CKSUM_UDP,
+		OFFLOAD_TX_TSO        = 1 << 3,
+	};
+
+	struct TransmitOffload
+	{
+		uint32_t checksums   { 0 }; // NetworkChecksum flags that the interface should insert
+		uint16_t l3_offset   { 0 }; // offset of network layer header
+		uint16_t l4_offset   { 0 }; // offset of transport layer header
+		uint16_t header_size { 0 }; // size of all headers, only used with tso
+		uint16_t tso_mss     { 0 }; // non-zero if packet should be segmented
+	};
+
 	class NetworkInterface : public CharacterDevice
 	{
 		BAN_NON_COPYABLE(NetworkInterface);
@@ -64,6 +81,9 @@ namespace Kernel
 
 		virtual size_t payload_mtu() const = 0;
 
+		// bitmask of NetworkOffload flags this interface supports
+		virtual uint32_t offload_features() const { return 0; }
+
 		virtual BAN::StringView name() const override { return m_name; }
 
 		BAN::ErrorOr<void> send_with_ethernet_header(BAN::MACAddress dst_mac, EtherType ether_type, BAN::ConstByteSpan buffer)
@@ -73,7 +93,7 @@ namespace Kernel
 		}
 
 		template<size_t SIZE>
-		BAN::ErrorOr<void> send_with_ethernet_header(BAN::MACAddress dst_mac, EtherType ether_type, const BAN::ConstByteSpan (&buffer_array)[SIZE])
+		BAN::ErrorOr<void> send_with_ethernet_header(BAN::MACAddress dst_mac, EtherType ether_type, const BAN::ConstByteSpan (&buffer_array)[SIZE], TransmitOffload offload = {})
 		{
 			const auto ethernet_header = EthernetHeader {
 				.dst_mac = dst_mac,
@@ -86,10 +106,21 @@ namespace Kernel
 			for (size_t i = 0; i < SIZE; i++)
 				new_buffer_array[i + 1] = buffer_array[i];
 
-			return send_raw_bytes({ new_buffer_array, SIZE + 1 });
+			if (offload.checksums || offload.tso_mss)
+			{
+				offload.l3_offset   += sizeof(EthernetHeader);
+				offload.l4_offset   += sizeof(EthernetHeader);
+				offload.header_size += sizeof(EthernetHeader);
+			}
+
+			return send_raw_bytes({ new_buffer_array, SIZE + 1 }, offload);
 		}
 
-		virtual BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers) = 0;
+		virtual BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload) = 0;
+
+	protected:
+		// copies bytes from buffers to destination, advancing buffers and offset. returns number of bytes copied
+		static size_t gather_buffers(BAN::Span<const BAN::ConstByteSpan>& buffers, size_t& offset, BAN::ByteSpan destination);
 
 	private:
 		BAN::ErrorOr<long> ioctl_impl(unsigned long, void*) override;
@@ -22,11 +22,16 @@ namespace Kernel
 	public:
 		virtual ~NetworkLayer() {}
 
-		virtual void unbind_socket(uint16_t port) = 0;
+		virtual void unbind_socket(const NetworkSocket&, uint16_t port) = 0;
 		virtual BAN::ErrorOr<void> bind_socket_with_target(BAN::RefPtr<NetworkSocket>, const sockaddr* target_address, socklen_t target_address_len) = 0;
 		virtual BAN::ErrorOr<void> bind_socket_to_address(BAN::RefPtr<NetworkSocket>, const sockaddr* address, socklen_t address_len) = 0;
 		virtual BAN::ErrorOr<void> get_socket_address(BAN::RefPtr<NetworkSocket>, sockaddr* address, socklen_t* address_len) = 0;
 
+		// Registers a connected socket so that packets from remote_address are delivered to
+		// it directly instead of through the socket bound to its port
+		virtual BAN::ErrorOr<void> add_connection(BAN::RefPtr<NetworkSocket>, const sockaddr* remote_address, socklen_t remote_address_len) = 0;
+		virtual void remove_connection(const NetworkSocket&, const sockaddr* remote_address, socklen_t remote_address_len) = 0;
+
 		virtual BAN::ErrorOr<void> sendto(NetworkSocket&, BAN::ConstByteSpan, const sockaddr*, socklen_t) = 0;
 
 		virtual Socket::Domain domain() const = 0;
@@ -2,6 +2,7 @@
 
 #include <BAN/Vector.h>
 #include <kernel/FS/Socket.h>
+#include <kernel/Lock/Mutex.h>
 #include <kernel/Networking/IPv4Layer.h>
 #include <kernel/Networking/NetworkInterface.h>
 #include <kernel/PCI.h>
@@ -36,6 +37,7 @@ namespace Kernel
 
 	private:
 		BAN::UniqPtr<IPv4Layer>						m_ipv4_layer;
+		Mutex										m_interface_lock;
 		BAN::Vector<BAN::RefPtr<NetworkInterface>>	m_interfaces;
 
 		friend class BAN::UniqPtr<NetworkManager>;
@@ -32,9 +32,15 @@ namespace Kernel
 		BAN::ErrorOr<BAN::RefPtr<NetworkInterface>> interface(const sockaddr* target, socklen_t target_len);
 
 		virtual size_t protocol_header_size() const = 0;
-		virtual void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader) = 0;
+		// If checksum_offload is set, only pseudo header's checksum should be written to
+		// the header. Network interface will calculate the rest of the checksum.
+		virtual void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader, bool checksum_offload) = 0;
 		virtual NetworkProtocol protocol() const = 0;
 
+		// Maximum segment size for payloads that are segmented by the network interface.
+		// Zero means that this socket's packets cannot be segmented.
+		virtual uint16_t segmentation_mss() const { return 0; }
+
 		virtual void receive_packet(BAN::ConstByteSpan, const sockaddr* sender, socklen_t sender_len, uint32_t validated_cksums) = 0;
 
 		bool is_bound() const { return m_address_len >= static_cast<socklen_t>(sizeof(sa_family_t)) && m_address.ss_family != AF_UNSPEC; }
@@ -48,6 +54,9 @@ namespace Kernel
 		const sockaddr* address() const { return reinterpret_cast<const sockaddr*>(&m_address); }
 		socklen_t address_len() const { return m_address_len; }
 
+		// set with SO_REUSEPORT, allows binding multiple sockets to the same port
+		bool reuse_port() const { return m_reuse_port; }
+
 	private:
 		bool can_interface_send_to(const NetworkInterface&, const sockaddr*, socklen_t) const;
 
@@ -62,6 +71,7 @@ namespace Kernel
 		NetworkLayer&    m_network_layer;
 		sockaddr_storage m_address       { .ss_family = AF_UNSPEC, .ss_storage = {} };
 		socklen_t        m_address_len   { 0 };
+		bool             m_reuse_port    { false };
 	};
 
 }
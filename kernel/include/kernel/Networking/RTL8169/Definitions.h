@@ -148,4 +148,30 @@ namespace Kernel
 		RTL8169_DESC_CMD_OWN   = 1u << 31,
 	};
 
+	// transmit offload bits for 8169 style descriptors, all in command
+	enum RTL8169TxOffloadV1 : uint32_t
+	{
+		RTL8169_TX_V1_TCP_CS    = 1u << 16,
+		RTL8169_TX_V1_UDP_CS    = 1u << 17,
+		RTL8169_TX_V1_IP_CS     = 1u << 18,
+		RTL8169_TX_V1_MSS_SHIFT = 16,
+	};
+
+	// transmit offload bits for 8168 style descriptors
+	enum RTL8169TxOffloadV2 : uint32_t
+	{
+		// command
+		RTL8169_TX_V2_GTSENV4       = 1u << 26,
+		RTL8169_TX_V2_GTTCPHO_SHIFT = 18,
+
+		// vlan
+		RTL8169_TX_V2_TCPHO_SHIFT = 18,
+		RTL8169_TX_V2_MSS_SHIFT   = 18,
+		RTL8169_TX_V2_IPV4_CS     = 1u << 29,
+		RTL8169_TX_V2_TCP_CS      = 1u << 30,
+		RTL8169_TX_V2_UDP_CS      = 1u << 31,
+	};
+
+	constexpr uint32_t RTL8169_TX_MSS_MAX = 0x7FF;
+
 }
@@ -21,6 +21,7 @@ namespace Kernel
 		virtual int link_speed() override;
 
 		virtual size_t payload_mtu() const override { return 0x1FF8 - sizeof(EthernetHeader); }
+		virtual uint32_t offload_features() const override;
 
 		virtual void handle_irq() override;
 
@@ -33,7 +34,7 @@ namespace Kernel
 
 		BAN::ErrorOr<void> initialize();
 
-		virtual BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers) override;
+		virtual BAN::ErrorOr<void> send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload) override;
 
 		virtual bool can_read_impl() const override { return false; }
 		virtual bool can_write_impl() const override { return false; }
@@ -49,6 +50,9 @@ namespace Kernel
 		void enable_link();
 		BAN::ErrorOr<void> enable_interrupt();
 
+		// computes offload bits of descriptor command and vlan fields
+		void get_tx_offload_bits(const TransmitOffload& offload, uint32_t& command, uint32_t& vlan) const;
+
 		void receive_thread();
 
 	protected:
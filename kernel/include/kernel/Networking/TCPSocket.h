@@ -52,7 +52,9 @@ namespace Kernel
 		NetworkProtocol protocol() const override { return NetworkProtocol::TCP; }
 
 		size_t protocol_header_size() const override { return sizeof(TCPHeader) + m_tcp_options_bytes; }
-		void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader) override;
+		void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader, bool checksum_offload) override;
+
+		uint16_t segmentation_mss() const override { return m_send_window.mss; }
 
 	protected:
 		BAN::ErrorOr<long> accept_impl(sockaddr*, socklen_t*, int) override;
@@ -161,6 +163,8 @@ namespace Kernel
 
 		BAN::ErrorOr<size_t> return_with_maybe_zero();
 
+		size_t max_send_segment_size(const sockaddr* target, socklen_t target_len);
+
 	private:
 		State m_state = State::Closed;
 
@@ -189,6 +193,9 @@ namespace Kernel
 		bool m_has_connected { false };
 		bool m_has_sent_zero { false };
 
+		// set if this socket is in the network layer's connection table
+		bool m_has_connection_entry { false };
+
 		BAN::Optional<ConnectionInfo> m_connection_info;
 		BAN::Queue<PendingConnection> m_pending_connections;
 
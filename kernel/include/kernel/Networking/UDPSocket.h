@@ -28,7 +28,10 @@ namespace Kernel
 		NetworkProtocol protocol() const override { return NetworkProtocol::UDP; }
 
 		size_t protocol_header_size() const override { return sizeof(UDPHeader); }
-		void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader) override;
+		void get_protocol_header(BAN::ByteSpan header, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader, bool checksum_offload) override;
+
+		// Queues an already validated datagram without protocol headers
+		void receive_payload(BAN::ConstByteSpan payload, const sockaddr* sender, socklen_t sender_len);
 
 	protected:
 		void receive_packet(BAN::ConstByteSpan, const sockaddr* sender, socklen_t sender_len, uint32_t validated_cksums) override;
@@ -36,6 +39,7 @@ namespace Kernel
 		BAN::ErrorOr<void> connect_impl(const sockaddr*, socklen_t) override;
 		BAN::ErrorOr<void> bind_impl(const sockaddr* address, socklen_t address_len) override;
 		BAN::ErrorOr<size_t> recvmsg_impl(msghdr& message, int flags) override;
+		BAN::ErrorOr<size_t> recvmmsg_impl(BAN::Span<mmsghdr> messages, int flags) override;
 		BAN::ErrorOr<size_t> sendmsg_impl(const msghdr& message, int flags) override;
 		BAN::ErrorOr<void> getpeername_impl(sockaddr*, socklen_t*) override { return BAN::Error::from_errno(ENOTCONN); }
 		BAN::ErrorOr<void> getsockopt_impl(int, int, void*, socklen_t*) override;
@@ -52,6 +56,11 @@ namespace Kernel
 		UDPSocket(NetworkLayer&, const Socket::Info&);
 		~UDPSocket();
 
+		BAN::ErrorOr<void> validate_recvmsg(msghdr&, int flags);
+		// You must hold m_packet_lock when calling these
+		BAN::ErrorOr<void> wait_for_packet();
+		size_t receive_queued_packet(msghdr&);
+
 		struct PacketInfo
 		{
 			sockaddr_storage	sender;
@@ -30,6 +30,7 @@ namespace Kernel
 		virtual BAN::ErrorOr<void> listen_impl(int) override;
 		virtual BAN::ErrorOr<void> bind_impl(const sockaddr*, socklen_t) override;
 		virtual BAN::ErrorOr<size_t> recvmsg_impl(msghdr& message, int flags) override;
+		virtual BAN::ErrorOr<size_t> recvmmsg_impl(BAN::Span<mmsghdr> messages, int flags) override;
 		virtual BAN::ErrorOr<size_t> sendmsg_impl(const msghdr& message, int flags) override;
 		virtual BAN::ErrorOr<void> getsockname_impl(sockaddr*, socklen_t*) override;
 		virtual BAN::ErrorOr<void> getpeername_impl(sockaddr*, socklen_t*) override;
@@ -77,8 +78,24 @@ namespace Kernel
 			BAN::WeakPtr<UnixDomainSocket> sender;
 		};
 
+		struct StreamAncillary
+		{
+			size_t offset;
+			size_t size;
+			BAN::Vector<FDWrapper> fds;
+			BAN::Optional<struct ucred> ucred;
+		};
+
 		BAN::ErrorOr<size_t> add_packet(const msghdr&, PacketInfo&&, bool dont_block);
 
+		// You must hold m_packet_lock when calling these. wait_for_packet returns false if the peer has closed
+		BAN::ErrorOr<bool> wait_for_packet();
+		size_t receive_queued_packet(msghdr&);
+
+		BAN::ErrorOr<size_t> add_stream_data(const msghdr&, PacketInfo&&, bool dont_block);
+		BAN::ErrorOr<size_t> recvmsg_stream(msghdr&);
+		size_t stream_free_space() const;
+
 	private:
 		const Socket::Type m_socket_type;
 
@@ -94,6 +111,21 @@ namespace Kernel
 		mutable Mutex						m_packet_lock;
 		ThreadBlocker						m_packet_thread_blocker;
 
+		// SOCK_STREAM sockets use the packet buffer as a plain byte ring indexed by
+		// monotonically increasing read and write positions. Readers serialize on
+		// m_packet_lock and writers on m_stream_write_lock, so a single reader and
+		// writer never contend on a lock. Ancillary data is queued out of band and
+		// tagged with the stream offset of the first byte it was sent with.
+		BAN::Atomic<size_t>					m_stream_read_pos { 0 };
+		BAN::Atomic<size_t>					m_stream_write_pos { 0 };
+		BAN::Atomic<uint32_t>				m_stream_readers_waiting { 0 };
+		BAN::Atomic<uint32_t>				m_stream_writers_waiting { 0 };
+		Mutex								m_stream_write_lock;
+		ThreadBlocker						m_stream_write_blocker;
+		BAN::Queue<StreamAncillary>			m_stream_ancillary;
+		BAN::Atomic<size_t>					m_stream_ancillary_count { 0 };
+		Mutex								m_stream_ancillary_lock;
+
 		BAN::Atomic<size_t> m_sndbuf { 0 };
 		BAN::Atomic<size_t> m_bytes_sent { 0 };
 
@@ -1,12 +1,15 @@
 #pragma once
 
-#include <BAN/Array.h>
+#include <BAN/Atomic.h>
 #include <BAN/HashSet.h>
+#include <BAN/Vector.h>
 #include <kernel/FS/Inode.h>
 #include <kernel/FS/VirtualFileSystem.h>
 
 #include <limits.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
 namespace Kernel
 {
@@ -54,13 +57,28 @@ namespace Kernel
 		BAN::ErrorOr<size_t> read(int fd, BAN::ByteSpan);
 		BAN::ErrorOr<size_t> write(int fd, BAN::ConstByteSpan);
 
+		// If offset is non-null, it is used instead of the file offset
+		BAN::ErrorOr<size_t> readv(int fd, BAN::Span<const iovec>, const off_t* offset);
+		BAN::ErrorOr<size_t> writev(int fd, BAN::Span<const iovec>, const off_t* offset);
+
+		// Copies up to count bytes from fd_in to fd_out without going through userspace.
+		// Non-null offsets are used and updated instead of the file offsets
+		BAN::ErrorOr<size_t> splice(int fd_in, off_t* offset_in, int fd_out, off_t* offset_out, size_t count, bool force_nonblock);
+
 		BAN::ErrorOr<size_t> read_dir_entries(int fd, struct dirent* list, size_t list_len);
 
 		BAN::ErrorOr<size_t> recvmsg(int socket, msghdr& message, int flags);
 		BAN::ErrorOr<size_t> sendmsg(int socket, const msghdr& message, int flags);
+		// Returns the number of messages transferred. Errors are only reported if no message could be transferred.
+		// Like on linux, the receive timeout is only checked after each received message
+		BAN::ErrorOr<size_t> recvmmsg(int socket, BAN::Span<mmsghdr> messages, int flags, uint64_t waketime_ns);
+		BAN::ErrorOr<size_t> sendmmsg(int socket, BAN::Span<mmsghdr> messages, int flags);
 
 		int get_max_open_fd() const;
 
+		rlimit get_nofile_limit() const;
+		BAN::ErrorOr<void> set_nofile_limit(const rlimit&);
+
 		BAN::ErrorOr<VirtualFileSystem::File> file_of(int) const;
 		BAN::ErrorOr<BAN::String> path_of(int) const;
 		BAN::ErrorOr<BAN::RefPtr<Inode>> inode_of(int);
@@ -91,9 +109,35 @@ namespace Kernel
 			friend class BAN::RefPtr<OpenFileDescription>;
 		};
 
+		struct FileTable
+		{
+			BAN::Vector<OpenFileDescription*> files;
+		};
+
+		// Returns a reference to the description of fd without taking m_mutex
+		BAN::ErrorOr<BAN::RefPtr<OpenFileDescription>> get_description(int fd) const;
+
+		// These operate on a description that was looked up earlier, so they keep acting on the
+		// same open file after its fd is closed or reused. If offset is non-null, it is used
+		// instead of the file offset. With force_nonblock they behave as if O_NONBLOCK was set
+		static BAN::ErrorOr<size_t> read(OpenFileDescription&, BAN::ByteSpan, const off_t* offset, bool force_nonblock);
+		static BAN::ErrorOr<size_t> write(OpenFileDescription&, BAN::ConstByteSpan, const off_t* offset, bool force_nonblock);
+		static BAN::ErrorOr<size_t> recvmsg(OpenFileDescription&, msghdr& message, int flags, bool force_nonblock);
+		static BAN::ErrorOr<size_t> sendmsg(OpenFileDescription&, const msghdr& message, int flags, bool force_nonblock);
+		static BAN::ErrorOr<long> accept(OpenFileDescription&, sockaddr* address, socklen_t* address_len, int flags, bool force_nonblock);
+
+		// You must hold m_mutex when calling these
+		OpenFileDescription* description_at(int fd) const;
+		void set_description(int fd, BAN::RefPtr<OpenFileDescription>);
+		BAN::ErrorOr<void> reserve_fd_table(size_t size);
+		size_t fd_table_size() const;
+
+		// Waits until all lookups that may have seen an unpublished table or description are done
+		void synchronize_lookups() const;
+
 		BAN::ErrorOr<void> validate_fd(int) const;
-		BAN::ErrorOr<int> get_free_fd() const;
-		BAN::ErrorOr<void> get_free_fd_pair(int fds[2]) const;
+		BAN::ErrorOr<int> get_free_fd(int min_fd = 0);
+		BAN::ErrorOr<void> get_free_fd_pair(int fds[2]);
 
 	public:
 		class FDWrapper
@@ -125,8 +169,22 @@ namespace Kernel
 		const Credentials& m_credentials;
 		mutable Mutex m_mutex;
 
-		BAN::Array<BAN::RefPtr<OpenFileDescription>, OPEN_MAX> m_open_files;
-		BAN::Array<uint32_t, (OPEN_MAX + 31) / 32> m_cloexec_files {};
+		static constexpr rlim_t default_nofile_soft_limit = 1024;
+		static constexpr rlim_t default_nofile_hard_limit = 65536;
+
+		// The table pointer and its slots are only modified with m_mutex held but
+		// they are read without it. Replaced tables and closed descriptions are
+		// released only after lookups that may still see them have finished.
+		BAN::Atomic<FileTable*> m_table { nullptr };
+		mutable BAN::Atomic<uint32_t> m_lookup_epoch { 0 };
+		mutable BAN::Atomic<uint32_t> m_active_lookups[2] {};
+
+		BAN::Vector<uint32_t> m_open_fds;
+		BAN::Vector<uint32_t> m_cloexec_files;
+
+		rlimit m_nofile_limit { default_nofile_soft_limit, default_nofile_hard_limit };
+
+		friend class IORing;
 	};
 
 }
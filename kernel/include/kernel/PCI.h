@@ -3,9 +3,11 @@
 #include <BAN/UniqPtr.h>
 #include <BAN/Vector.h>
 #include <kernel/ACPI/AML/Node.h>
+#include <kernel/BootTimeline.h>
 #include <kernel/InterruptNumbers.h>
 #include <kernel/Interruptable.h>
 #include <kernel/Memory/Types.h>
+#include <kernel/ProcessorID.h>
 
 #include <sys/types.h>
 
@@ -123,6 +125,8 @@ namespace Kernel::PCI
 		void enable_pin_interrupts();
 		void disable_pin_interrupts();
 
+		BAN::ErrorOr<void> set_msi_target(uint8_t irq, ProcessorID);
+
 		BAN::ErrorOr<uint8_t> route_prt_entry(const ACPI::AML::Node& routing_entry);
 		BAN::ErrorOr<uint8_t> find_intx_interrupt();
 
@@ -158,7 +162,11 @@ namespace Kernel::PCI
 		static void initialize();
 		static PCIManager& get();
 
+		// Starts probing drivers for all devices, storage and USB controllers
+		// are done once wait_for_storage_devices() returns
 		void initialize_devices(bool disable_usb);
+		void wait_for_storage_devices();
+		void wait_for_all_devices();
 
 		template<typename F>
 		void for_each_device(F callback)
@@ -195,6 +203,15 @@ namespace Kernel::PCI
 
 		BAN::Vector<Device> m_devices;
 
+		BootTaskGroup m_storage_probes;
+		BootTaskGroup m_device_probes;
+
+		// Drivers of these devices hand out device minors in probe order. Every list is
+		// probed on a single thread in PCI enumeration order, so names like sda, nvme0
+		// and eth0 do not depend on which probe happens to finish first.
+		enum ProbeList { SCSIProbes, NVMeProbes, NetworkProbes, AudioProbes, ProbeListCount };
+		BAN::Vector<Device*> m_ordered_probes[ProbeListCount];
+
 		SpinLock                             m_reserved_msi_lock;
 		BAN::Array<uint8_t, m_msi_count / 8> m_reserved_msi_bitmap;
 	};
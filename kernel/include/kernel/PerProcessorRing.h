@@ -0,0 +1,218 @@
+#pragma once
+
+#include <BAN/Atomic.h>
+#include <BAN/Span.h>
+#include <BAN/UniqPtr.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/Mutex.h>
+#include <kernel/Memory/VirtualRange.h>
+#include <kernel/Processor.h>
+#include <kernel/Thread.h>
+#include <kernel/ThreadBlocker.h>
+
+namespace Kernel
+{
+
+	struct PerProcessorRingNoData {};
+
+	// One ring of N entries per processor. A ring is only written by its own processor
+	// with interrupts disabled, so recording does not take any locks. Buffers are
+	// allocated on first use and never freed, recording before that is a no-op.
+	template<typename T, size_t N, typename PerProcessorData = PerProcessorRingNoData>
+	class PerProcessorRing
+	{
+	public:
+		struct Buffer
+		{
+			BAN::Atomic<uint64_t> head { 0 };		// written only by the owning processor
+			BAN::Atomic<uint64_t> tail { 0 };		// written only by the reader
+			BAN::Atomic<uint64_t> dropped { 0 };
+			PerProcessorData data;
+			T entries[N];
+		};
+
+	public:
+		BAN::ErrorOr<void> initialize()
+		{
+			if (m_buffers.load(BAN::memory_order_acquire))
+				return {};
+
+			LockGuard _(m_initialize_mutex);
+			if (m_buffers.load(BAN::memory_order_acquire))
+				return {};
+
+			const size_t buffer_count = Processor::count();
+			m_buffer_range = TRY(VirtualRange::create_to_vaddr_range(
+				PageTable::kernel(),
+				{ KERNEL_OFFSET, UINTPTR_MAX },
+				BAN::Math::div_round_up<size_t>(buffer_count * sizeof(Buffer), PAGE_SIZE) * PAGE_SIZE,
+				PageTable::Flags::ReadWrite | PageTable::Flags::Present,
+				false
+			));
+
+			auto* buffers = reinterpret_cast<Buffer*>(m_buffer_range->vaddr());
+			for (size_t i = 0; i < buffer_count; i++)
+				new (&buffers[i]) Buffer();
+
+			m_buffer_count = buffer_count;
+			m_buffers.store(buffers, BAN::memory_order_release);
+
+			return {};
+		}
+
+		bool is_initialized() const { return m_buffers.load(BAN::memory_order_acquire) != nullptr; }
+
+		size_t buffer_count() const { return is_initialized() ? m_buffer_count : 0; }
+		Buffer& buffer(size_t index) { ASSERT(index < buffer_count()); return m_buffers.load(BAN::memory_order_acquire)[index]; }
+		const Buffer& buffer(size_t index) const { ASSERT(index < buffer_count()); return m_buffers.load(BAN::memory_order_acquire)[index]; }
+
+		// Must be called with interrupts disabled
+		PerProcessorData& current_data()
+		{
+			ASSERT(Processor::get_interrupt_state() == InterruptState::Disabled);
+			return buffer(Processor::current_index()).data;
+		}
+
+		// Calls fill(T&) on the next free entry of the current processor's ring with interrupts
+		// disabled and wakes up a waiting reader. The entry is counted as dropped if the ring is full.
+		template<typename F>
+		void push(F fill)
+		{
+			if (!is_initialized())
+				return;
+
+			const auto state = Processor::get_interrupt_state();
+			Processor::set_interrupt_state(InterruptState::Disabled);
+
+			auto& buffer = this->buffer(Processor::current_index());
+			const uint64_t head = buffer.head.load(BAN::memory_order_relaxed);
+			if (head - buffer.tail.load(BAN::memory_order_acquire) >= N)
+				buffer.dropped.add_fetch(1, BAN::memory_order_relaxed);
+			else
+			{
+				fill(buffer.entries[head % N]);
+				buffer.head.store(head + 1, BAN::memory_order_release);
+			}
+
+			Processor::set_interrupt_state(state);
+
+			// NOTE: this can race with a reader that is about to block, readers
+			//       block with a timeout so the entry is not lost, only delayed
+			if (m_reader_waiting.load(BAN::memory_order_relaxed))
+				m_reader_blocker.unblock();
+		}
+
+		// Like push but overwrites the oldest entry when the ring is full. Readers of
+		// an overwriting ring take snapshots instead of draining it.
+		template<typename F>
+		void push_overwrite(F fill)
+		{
+			if (!is_initialized())
+				return;
+
+			const auto state = Processor::get_interrupt_state();
+			Processor::set_interrupt_state(InterruptState::Disabled);
+
+			auto& buffer = this->buffer(Processor::current_index());
+			const uint64_t head = buffer.head.load(BAN::memory_order_relaxed);
+			fill(buffer.entries[head % N]);
+			buffer.head.store(head + 1, BAN::memory_order_release);
+
+			Processor::set_interrupt_state(state);
+		}
+
+		// Moves entries from all rings to output. For every ring that dropped entries
+		// make_dropped(T&, buffer index, dropped count) is called to report them first.
+		// Returns the number of entries written.
+		template<typename F>
+		size_t drain(BAN::Span<T> output, F make_dropped)
+		{
+			size_t count = 0;
+			for (size_t index = 0; index < buffer_count() && count < output.size(); index++)
+			{
+				auto& buffer = this->buffer(index);
+
+				if (const uint64_t dropped = buffer.dropped.exchange(0, BAN::memory_order_relaxed))
+				{
+					make_dropped(output[count++], index, dropped);
+					if (count >= output.size())
+						break;
+				}
+
+				const uint64_t head = buffer.head.load(BAN::memory_order_acquire);
+				uint64_t tail = buffer.tail.load(BAN::memory_order_relaxed);
+				while (tail != head && count < output.size())
+					output[count++] = buffer.entries[tail++ % N];
+				buffer.tail.store(tail, BAN::memory_order_release);
+			}
+
+			return count;
+		}
+
+		bool has_entries() const
+		{
+			for (size_t index = 0; index < buffer_count(); index++)
+			{
+				const auto& buffer = this->buffer(index);
+				if (buffer.dropped.load(BAN::memory_order_relaxed))
+					return true;
+				if (buffer.head.load(BAN::memory_order_acquire) != buffer.tail.load(BAN::memory_order_relaxed))
+					return true;
+			}
+			return false;
+		}
+
+		// Blocks until some ring has entries, a signal arrives or a short timeout expires
+		BAN::ErrorOr<void> wait_for_entries(Mutex& mutex)
+		{
+			m_reader_waiting.store(true);
+			if (!has_entries())
+			{
+				auto ret = Thread::current().block_or_eintr_or_timeout_ms(m_reader_blocker, 100, false, &mutex);
+				if (ret.is_error())
+				{
+					m_reader_waiting.store(false);
+					return ret.release_error();
+				}
+			}
+			m_reader_waiting.store(false);
+			return {};
+		}
+
+		// Copies the entries of an overwriting ring recorded after its tail to output,
+		// which must fit N entries. Returns the entries that were not overwritten while copying.
+		BAN::Span<T> snapshot(size_t index, BAN::Span<T> output) const
+		{
+			ASSERT(output.size() >= N);
+
+			const auto& buffer = this->buffer(index);
+
+			const uint64_t head = buffer.head.load(BAN::memory_order_acquire);
+			uint64_t first = buffer.tail.load(BAN::memory_order_relaxed);
+			if (head - first > N)
+				first = head - N;
+
+			for (uint64_t i = first; i < head; i++)
+				output[i - first] = buffer.entries[i % N];
+
+			// the owning processor keeps recording while we copy, drop the entries
+			// that may have been overwritten under us, including the slot of an
+			// entry that is being written right now
+			const uint64_t new_head = buffer.head.load(BAN::memory_order_acquire);
+			const uint64_t valid_first = BAN::Math::max(first, (new_head + 1 > N) ? new_head + 1 - N : 0);
+			if (valid_first >= head)
+				return {};
+			return output.slice(valid_first - first, head - valid_first);
+		}
+
+	private:
+		Mutex m_initialize_mutex;
+		BAN::UniqPtr<VirtualRange> m_buffer_range;
+		BAN::Atomic<Buffer*> m_buffers { nullptr };
+		size_t m_buffer_count { 0 };
+
+		ThreadBlocker m_reader_blocker;
+		BAN::Atomic<bool> m_reader_waiting { false };
+	};
+
+}
@@ -17,14 +17,18 @@
 #include <kernel/Terminal/TTY.h>
 #include <kernel/Thread.h>
 
+#include <fcntl.h>
 #include <poll.h>
 #include <sys/banan-os.h>
 #include <sys/epoll.h>
+#include <sys/futex.h>
 #include <sys/mman.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/statvfs.h>
 #include <sys/time.h>
+#include <sys/ioring.h>
+#include <sys/uio.h>
 #include <termios.h>
 
 namespace Kernel
@@ -61,6 +65,8 @@ namespace Kernel
 
 		const Credentials& credentials() const { return m_credentials; }
 
+		bool is_syscall_traced() const { return m_is_syscall_traced; }
+
 		BAN::ErrorOr<long> sys_exit(int status);
 
 		BAN::ErrorOr<long> sys_fork(uintptr_t rsp, uintptr_t rip);
@@ -117,6 +123,15 @@ namespace Kernel
 		BAN::ErrorOr<long> sys_pread(int fd, void* buffer, size_t count, off_t offset);
 		BAN::ErrorOr<long> sys_pwrite(int fd, const void* buffer, size_t count, off_t offset);
 
+		BAN::ErrorOr<long> sys_readv(int fd, const iovec* iov, int iovcnt);
+		BAN::ErrorOr<long> sys_writev(int fd, const iovec* iov, int iovcnt);
+		BAN::ErrorOr<long> sys_preadv(int fd, const iovec* iov, int iovcnt, off_t offset);
+		BAN::ErrorOr<long> sys_pwritev(int fd, const iovec* iov, int iovcnt, off_t offset);
+
+		BAN::ErrorOr<long> sys_sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+		BAN::ErrorOr<long> sys_splice(const sys_splice_t* arguments);
+		BAN::ErrorOr<long> sys_copy_file_range(int fd_in, off_t* offset_in, int fd_out, off_t* offset_out, size_t count);
+
 		BAN::ErrorOr<long> sys_fchmodat(int fd, const char* path, mode_t mode, int flag);
 		BAN::ErrorOr<long> sys_fchownat(int fd, const char* path, uid_t uid, gid_t gid, int flag);
 		BAN::ErrorOr<long> sys_utimensat(int fd, const char* path, const struct timespec times[2], int flag);
@@ -134,6 +149,8 @@ namespace Kernel
 		BAN::ErrorOr<long> sys_listen(int socket, int backlog);
 		BAN::ErrorOr<long> sys_recvmsg(int socket, msghdr* message, int flags);
 		BAN::ErrorOr<long> sys_sendmsg(int socket, const msghdr* message, int flags);
+		BAN::ErrorOr<long> sys_recvmmsg(int socket, mmsghdr* messages, unsigned int vlen, int flags, const timespec* timeout);
+		BAN::ErrorOr<long> sys_sendmmsg(int socket, mmsghdr* messages, unsigned int vlen, int flags);
 
 		BAN::ErrorOr<long> sys_ioctl(int fildes, unsigned long request, void* arg);
 
@@ -146,11 +163,17 @@ namespace Kernel
 
 		BAN::ErrorOr<long> sys_eventfd(unsigned int initval_hi, int flags);
 
+		BAN::ErrorOr<long> sys_ioring_setup(unsigned entries, ioring_shared* shared, int flags);
+		BAN::ErrorOr<long> sys_ioring_enter(int fd, unsigned to_submit, unsigned min_complete, const timespec* timeout);
+
 		BAN::ErrorOr<long> sys_pipe(int fildes[2]);
 		BAN::ErrorOr<long> sys_dup2(int fildes, int fildes2);
 
 		BAN::ErrorOr<long> sys_fcntl(int fildes, int cmd, uintptr_t extra);
 
+		BAN::ErrorOr<long> sys_getrlimit(int resource, rlimit* rlp);
+		BAN::ErrorOr<long> sys_setrlimit(int resource, const rlimit* rlp);
+
 		BAN::ErrorOr<long> sys_seek(int fd, off_t offset, int whence);
 		BAN::ErrorOr<long> sys_tell(int fd);
 
@@ -201,7 +224,7 @@ namespace Kernel
 		BAN::ErrorOr<long> sys_sigwait(const sigset_t* set, int* sig);
 		BAN::ErrorOr<long> sys_sigaltstack(const stack_t* ss, stack_t* oss);
 
-		BAN::ErrorOr<long> sys_futex(int op, const uint32_t* addr, uint32_t val, const timespec* abstime);
+		BAN::ErrorOr<long> sys_futex(int op, const uint32_t* addr, uint32_t val, const timespec* abstime, const futex_args* args);
 		BAN::ErrorOr<long> sys_yield();
 
 		BAN::ErrorOr<long> sys_set_fsbase(void*);
@@ -222,21 +245,41 @@ namespace Kernel
 
 		BAN::ErrorOr<long> sys_banos_install(const char* object);
 
+		BAN::ErrorOr<long> sys_syscall_trace(int target, pid_t id, int enable);
+
+		BAN::ErrorOr<long> sys_lockstat(int command);
+
+		BAN::ErrorOr<long> sys_getrandom(void* buffer, size_t count, unsigned flags);
+
 		BAN::RefPtr<TTY> controlling_terminal() { return m_controlling_terminal; }
 
 		static Process& current() { return Thread::current().process(); }
 
 		vaddr_t shared_page_vaddr() const { return m_shared_page_vaddr; }
 
+		size_t thread_count() const { return m_threads.size(); }
+
 		PageTable& page_table() { return *m_page_table; }
 
+		// Unique id of the current page table, changes on exec and differs between forked processes.
+		// Used to detect user pointers stored by kernel objects being used in a different address space.
+		uint64_t address_space_id() const { return m_address_space_id; }
+
 		size_t proc_meminfo(off_t offset, BAN::ByteSpan) const;
 		size_t proc_cmdline(off_t offset, BAN::ByteSpan) const;
 		size_t proc_environ(off_t offset, BAN::ByteSpan) const;
 		size_t proc_cputime(off_t offset, BAN::ByteSpan) const;
+		size_t proc_stat(off_t offset, BAN::ByteSpan) const;
+		size_t proc_thread_stat(pid_t tid, off_t offset, BAN::ByteSpan) const;
 		BAN::ErrorOr<BAN::String> proc_cwd() const;
 		BAN::ErrorOr<BAN::String> proc_exe() const;
 
+		// Returns proc_stat_t of every process as one contiguous array
+		static BAN::ErrorOr<size_t> proc_processes(off_t offset, BAN::ByteSpan);
+
+		BAN::ErrorOr<BAN::Vector<pid_t>> thread_ids() const;
+		bool has_thread(pid_t tid) const;
+
 		BAN::StringView executable() const { return m_executable; }
 
 		// Returns error if page could not be allocated
@@ -268,6 +311,9 @@ namespace Kernel
 		};
 		static BAN::ErrorOr<TLSResult> initialize_thread_local_storage(PageTable&, ELF::LoadResult::TLS master_tls);
 
+		proc_meminfo_t meminfo() const;
+		proc_stat_t stat() const;
+
 		struct FileParent
 		{
 			VirtualFileSystem::File parent;
@@ -287,6 +333,10 @@ namespace Kernel
 		BAN::ErrorOr<VirtualFileSystem::File> find_relative_parent(int fd, const char* path) const;
 
 		BAN::ErrorOr<MemoryRegion*> validate_and_pin_pointer_access(const void*, size_t, bool needs_write);
+		// Copies iovec array from userspace and pins all of its buffers. Pinned regions are appended to regions
+		BAN::ErrorOr<BAN::Vector<iovec>> read_and_pin_iovecs(const iovec* user_iov, int iovcnt, bool needs_write, BAN::Vector<MemoryRegion*>& regions);
+		// Pins the address, control and iovec buffers of a message. Pinned regions are appended to regions
+		BAN::ErrorOr<void> pin_message_buffers(const msghdr&, bool needs_write, BAN::Vector<MemoryRegion*>& regions);
 
 		uint64_t signal_pending_mask() const
 		{
@@ -330,7 +380,8 @@ namespace Kernel
 
 		OpenFileDescriptorSet m_open_file_descriptors;
 
-		mutable RWLock m_memory_region_lock;
+		static LockClass s_memory_region_lock_class;
+		mutable RWLock m_memory_region_lock { s_memory_region_lock_class };
 		BAN::Vector<BAN::UniqPtr<MemoryRegion>> m_mapped_regions;
 
 		pid_t m_sid;
@@ -338,7 +389,8 @@ namespace Kernel
 		const pid_t m_pid;
 		const pid_t m_parent;
 
-		mutable Mutex m_process_lock;
+		static LockClass s_process_lock_class;
+		mutable Mutex m_process_lock { s_process_lock_class };
 
 		BAN::Atomic<bool> m_stopped { false };
 		ThreadBlocker m_stop_blocker;
@@ -348,20 +400,6 @@ namespace Kernel
 
 		vaddr_t m_shared_page_vaddr { 0 };
 
-		struct futex_t
-		{
-			Mutex mutex;
-			ThreadBlocker blocker;
-			uint32_t waiters { 0 };
-			uint32_t to_wakeup { 0 };
-		};
-
-		static BAN::HashMap<paddr_t, BAN::UniqPtr<futex_t>> s_futexes;
-		static Mutex s_futex_lock;
-
-		BAN::HashMap<paddr_t, BAN::UniqPtr<futex_t>> m_futexes;
-		Mutex m_futex_lock;
-
 		BAN::Vector<Thread*> m_threads;
 
 		struct exited_thread_info_t
@@ -370,6 +408,7 @@ namespace Kernel
 			void* value;
 		};
 		BAN::Vector<exited_thread_info_t> m_exited_threads;
+		proc_counters_t m_exited_thread_counters {};
 		ThreadBlocker m_thread_exit_blocker;
 
 		uint64_t m_alarm_interval_ns { 0 };
@@ -390,11 +429,15 @@ namespace Kernel
 
 		BAN::Atomic<bool> m_is_exiting { false };
 
+		BAN::Atomic<bool> m_is_syscall_traced { false };
+
 		bool m_has_called_exec { false };
 
 		BAN::UniqPtr<PageTable> m_page_table;
+		uint64_t m_address_space_id { 0 };
 		BAN::RefPtr<TTY> m_controlling_terminal;
 
+		friend class IORing;
 		friend class OpenFileDescriptorSet;
 		friend class Thread;
 	};
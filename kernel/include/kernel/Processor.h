@@ -10,6 +10,8 @@
 #include <kernel/Memory/Types.h>
 #include <kernel/ProcessorID.h>
 
+#include <sys/types.h>
+
 namespace Kernel
 {
 
@@ -47,6 +49,7 @@ namespace Kernel
 				NewThread,
 				UnblockThread,
 				UpdateTSC,
+				StartProfiling,
 				StackTrace,
 			};
 			SMPMessage* next { nullptr };
@@ -132,18 +135,35 @@ namespace Kernel
 		static LoadStats get_load_stats(size_t index);
 
 		static void yield();
+
+		// Sleeps until an interrupt or a new smp message arrives, called in a loop by the idle thread.
+		// With MONITOR/MWAIT queueing a message wakes the processor without an ipi.
+		// While the zeroed page pool is not full, a page is zeroed instead of sleeping
+		static void idle();
+
+		// Called by the scheduler when it switches away from the idle thread. The idle thread
+		// does not resume where it was interrupted, so idle() may not get to clear its state
+		static void leave_idle();
+
 		static Scheduler& scheduler() { return *read_gs_sized<Scheduler*>(offsetof(Processor, m_scheduler)); }
 
 		static void initialize_tsc(uint64_t realtime_seconds);
 		static void update_tsc();
 		static uint64_t ns_since_boot_tsc();
 
+		static void update_coarse_time(uint64_t ns_since_boot);
+		// publishes cpu time of the thread executing on this processor, tid 0 clears it
+		static void update_shared_cpu_time(pid_t tid, uint64_t total_ns, uint64_t start_ns, uint32_t flags);
+
 		static Thread* get_current_sse_thread() { return read_gs_sized<Thread*>(offsetof(Processor, m_sse_thread)); };
 		static void set_current_sse_thread(Thread* thread) { write_gs_sized<Thread*>(offsetof(Processor, m_sse_thread), thread); };
 
 		static paddr_t shared_page_paddr() { return s_shared_page_paddr; }
 		static volatile API::SharedPage& shared_page() { return *reinterpret_cast<API::SharedPage*>(s_shared_page_vaddr); }
 
+		// arms the timer of every processor for the first profiling sample
+		static void start_profiling();
+
 		static void handle_ipi();
 
 		static void handle_smp_messages();
@@ -233,9 +253,11 @@ namespace Kernel
 		uint64_t m_load_start_ns { 0 };
 		LoadStats m_load_stats {};
 
-		BAN::Atomic<SMPMessage*> m_smp_pending { nullptr };
-		BAN::Atomic<SMPMessage*> m_smp_free    { nullptr };
+		// m_smp_pending is on its own cache line, idle processors monitor it with mwait
+		alignas(64) BAN::Atomic<SMPMessage*> m_smp_pending { nullptr };
+		alignas(64) BAN::Atomic<SMPMessage*> m_smp_free    { nullptr };
 		SMPMessage* m_smp_message_storage { nullptr };
+		BAN::Atomic<bool> m_mwait_idle { false };
 
 		BAN::Atomic<bool> m_tlb_lock { false };
 		size_t m_tlb_entry_count { 0 };
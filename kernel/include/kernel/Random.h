@@ -1,5 +1,6 @@
 #pragma once
 
+#include <BAN/ByteSpan.h>
 #include <BAN/Traits.h>
 
 #include <stdint.h>
@@ -7,6 +8,9 @@
 namespace Kernel
 {
 
+	// ChaCha20 based CSPRNG. Every processor has its own generator keyed from a
+	// base generator, which is reseeded periodically from RDSEED/RDRAND and from
+	// interrupt timing collected by each processor.
 	class Random
 	{
 	public:
@@ -17,8 +21,16 @@ namespace Kernel
 		static T get() { return Random::get_u32(); }
 		template<BAN::unsigned_integral T> requires (sizeof(T) == 8)
 		static T get() { return Random::get_u64(); }
-	};
 
+		// Fills the buffer with random bytes. Interrupts are only disabled
+		// while a key for this call is derived, not while generating output.
+		static void get_bytes(BAN::ByteSpan);
+
+		// Called on every interrupt with interrupts disabled
+		static void add_interrupt_entropy(uint32_t irq);
 
+		// Incremented on every reseed of the base generator
+		static uint64_t generation();
+	};
 
 }
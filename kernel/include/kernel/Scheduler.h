@@ -54,6 +54,9 @@ namespace Kernel
 		pid_t current_tid() const;
 		bool is_idle() const;
 
+		// when the next timer interrupt of this processor is due
+		uint64_t wake_up_deadline_ns() const { return m_wake_up_deadline_ns; }
+
 	private:
 		Scheduler() = default;
 
@@ -83,6 +86,7 @@ namespace Kernel
 
 		uint64_t m_next_reschedule_ns { 0 };
 		uint64_t m_last_load_balance_ns { 0 };
+		uint64_t m_wake_up_deadline_ns { BAN::numeric_limits<uint64_t>::max() };
 
 		struct ThreadInfo
 		{
@@ -52,6 +52,11 @@ namespace Kernel
 		virtual bool has_error_impl() const override { return false; }
 		virtual bool has_hungup_impl() const override { return false; }
 
+	private:
+		// Calls the matching *_impl function between block I/O tracepoints
+		BAN::ErrorOr<void> do_read_sectors(uint64_t lba, uint64_t sector_count, BAN::ByteSpan);
+		BAN::ErrorOr<void> do_write_sectors(uint64_t lba, uint64_t sector_count, BAN::ConstByteSpan);
+
 	private:
 		BAN::Optional<DiskCache>			m_disk_cache;
 		BAN::Vector<BAN::RefPtr<Partition>>	m_partitions;
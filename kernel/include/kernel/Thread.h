@@ -35,6 +35,21 @@ namespace Kernel
 			Terminated,
 		};
 
+		// NOTE: written only by the thread itself or by the scheduler
+		//       of the processor it is running on, reads are racy
+		struct Statistics
+		{
+			uint64_t voluntary_switches   { 0 };
+			uint64_t involuntary_switches { 0 };
+			uint64_t minor_page_faults    { 0 };
+			uint64_t major_page_faults    { 0 };
+			uint64_t read_bytes           { 0 };
+			uint64_t write_bytes          { 0 };
+			uint64_t read_syscalls        { 0 };
+			uint64_t write_syscalls       { 0 };
+			uint8_t  last_processor       { 0 };
+		};
+
 		// FIXME: kernel stack does NOT have to be this big, but my recursive AML interpreter
 		//        stack overflows on some machines with 8 page stack
 		static constexpr size_t kernel_stack_size    { PAGE_SIZE * 16 };
@@ -106,6 +121,8 @@ namespace Kernel
 		pid_t tid() const { return m_tid; }
 
 		State state() const { return m_state; }
+		// NOTE: racy, only meant for statistics
+		bool is_blocked() const;
 
 		vaddr_t kernel_stack_bottom() const	{ return m_kernel_stack->vaddr(); }
 		vaddr_t kernel_stack_top() const	{ return m_kernel_stack->vaddr() + m_kernel_stack->size(); }
@@ -129,10 +146,22 @@ namespace Kernel
 		void cpu_time_ns(uint64_t& user_ns, uint64_t& system_ns) const;
 		void set_cpu_time_start();
 		void set_cpu_time_stop();
+		// republishes cpu time to the shared page, must be called by the thread itself
+		void update_shared_cpu_time();
 
 		void set_is_in_syscall(bool is_in_syscall);
 		bool is_in_syscall() const { return m_is_in_syscall; }
 
+		void set_syscall_traced(bool traced) { m_is_syscall_traced = traced; }
+		bool is_syscall_traced() const { return m_is_syscall_traced; }
+
+		Statistics& statistics() { return m_statistics; }
+		const Statistics& statistics() const { return m_statistics; }
+		// Counts read and write syscalls, transferred bytes are accounted by the syscalls themselves
+		void account_syscall(int syscall);
+		void account_read_bytes(size_t bytes) { m_statistics.read_bytes += bytes; }
+		void account_write_bytes(size_t bytes) { m_statistics.write_bytes += bytes; }
+
 		void update_processor_index_address();
 
 		void set_fsbase(vaddr_t base) { m_fsbase = base; }
@@ -163,6 +192,9 @@ namespace Kernel
 
 		bool currently_on_alternate_stack() const;
 
+		// NOTE: m_cpu_time_lock must be held
+		void publish_cpu_time() const;
+
 		struct signal_handle_info_t
 		{
 			vaddr_t handler;
@@ -209,6 +241,9 @@ namespace Kernel
 		uint64_t                   m_cpu_time_system_ns   { 0 };
 		uint64_t                   m_cpu_time_start_ns    { UINT64_MAX };
 		BAN::Atomic<bool>          m_is_in_syscall        { false };
+		BAN::Atomic<bool>          m_is_syscall_traced    { false };
+
+		Statistics                 m_statistics;
 
 		BAN::Atomic<uint32_t>      m_spinlock_count       { 0 };
 		BAN::Atomic<uint32_t>      m_mutex_count          { 0 };
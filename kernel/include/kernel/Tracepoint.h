@@ -0,0 +1,47 @@
+#pragma once
+
+#include <BAN/Atomic.h>
+#include <BAN/String.h>
+
+#define TRACEPOINT(id, ...) \
+	do { \
+		if (::Kernel::Tracepoints::is_enabled()) [[unlikely]] \
+			::Kernel::Tracepoints::hit(::Kernel::Tracepoints::id __VA_OPT__(,) __VA_ARGS__); \
+	} while (false)
+
+namespace Kernel
+{
+
+	// Static tracepoints in the kernel's hot paths. While enabled every hit is counted and
+	// recorded, with up to three arguments, to a ring of recent events owned by the current processor.
+	class Tracepoints
+	{
+	public:
+		enum Id : uint32_t
+		{
+			SchedulerSwitch,	// previous tid, next tid (0 is the idle thread)
+			PageFault,			// address, error code, instruction pointer
+			BlockIOSubmit,		// lba, sector count, is write
+			BlockIOComplete,	// lba, sector count, errno
+			IRQEntry,			// irq
+			Count
+		};
+
+	public:
+		static bool is_enabled() { return s_enabled.load(BAN::MemoryOrder::memory_order_relaxed); }
+		static BAN::ErrorOr<void> set_enabled(bool);
+		static void reset();
+
+		static void hit(Id, uint64_t arg0 = 0, uint64_t arg1 = 0, uint64_t arg2 = 0);
+
+		// One line per tracepoint, "name count"
+		static BAN::ErrorOr<BAN::String> format_counts();
+
+		// Recent events of every processor, one per line "timestamp_ns cpu tid name arg0 arg1 arg2"
+		static BAN::ErrorOr<BAN::String> format_events();
+
+	private:
+		static BAN::Atomic<bool> s_enabled;
+	};
+
+}
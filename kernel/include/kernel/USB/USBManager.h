@@ -1,5 +1,6 @@
 #pragma once
 
+#include <kernel/Lock/Mutex.h>
 #include <kernel/PCI.h>
 #include <kernel/USB/Controller.h>
 #include <kernel/USB/Definitions.h>
@@ -22,6 +23,7 @@ namespace Kernel
 		USBManager() = default;
 
 	private:
+		Mutex                                    m_controller_lock;
 		BAN::Vector<BAN::UniqPtr<USBController>> m_controllers;
 
 		friend class BAN::UniqPtr<USBManager>;
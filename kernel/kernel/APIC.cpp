@@ -4,6 +4,7 @@
 #include <kernel/CPUID.h>
 #include <kernel/Debug.h>
 #include <kernel/IDT.h>
+#include <kernel/IRQAffinity.h>
 #include <kernel/Memory/PageTable.h>
 #include <kernel/MMIO.h>
 #include <kernel/Timer/Timer.h>
@@ -489,6 +490,14 @@ namespace Kernel
 
 	void APIC::enable_irq(uint8_t irq, bool level_triggered)
 	{
+		const auto retarget =
+			[](uint8_t irq, ProcessorID target, void* apic) -> BAN::ErrorOr<void>
+			{
+				static_cast<APIC*>(apic)->set_irq_destination(irq, target);
+				return {};
+			};
+		const auto target = IRQAffinity::register_irq(irq, retarget, this, false);
+
 		SpinLockGuard _(m_lock);
 
 		const uint32_t gsi = m_irq_overrides[irq];
@@ -517,13 +526,37 @@ namespace Kernel
 		redir.trigger_mode = level_triggered;
 		redir.mask = 0;
 		redir.destination_mode = 0; // physical
-		// FIXME: distribute IRQs more evenly?
-		redir.destination = Kernel::Processor::bsp_id().as_u32();
+		redir.destination = target.as_u32();
 
 		ioapic->write(IOAPIC_REDIRS + pin * 2,     redir.lo_dword);
 		ioapic->write(IOAPIC_REDIRS + pin * 2 + 1, redir.hi_dword);
 	}
 
+	void APIC::set_irq_destination(uint8_t irq, ProcessorID target)
+	{
+		SpinLockGuard _(m_lock);
+
+		const uint32_t gsi = m_irq_overrides[irq];
+
+		IOAPIC* ioapic = nullptr;
+		for (IOAPIC& io : m_io_apics)
+		{
+			if (io.gsi_base <= gsi && gsi <= io.gsi_base + io.max_redirs)
+			{
+				ioapic = &io;
+				break;
+			}
+		}
+		ASSERT(ioapic);
+
+		const uint32_t pin = gsi - ioapic->gsi_base;
+
+		RedirectionEntry redir;
+		redir.hi_dword = ioapic->read(IOAPIC_REDIRS + pin * 2 + 1);
+		redir.destination = target.as_u32();
+		ioapic->write(IOAPIC_REDIRS + pin * 2 + 1, redir.hi_dword);
+	}
+
 	bool APIC::is_in_service(uint8_t irq)
 	{
 		const uint32_t dword = (irq + IRQ_VECTOR_BASE) / 32;
@@ -0,0 +1,150 @@
+#include <BAN/Array.h>
+#include <kernel/BootTimeline.h>
+#include <kernel/Debug.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/LockStats.h>
+#include <kernel/Lock/SpinLock.h>
+#include <kernel/Processor.h>
+#include <kernel/Scheduler.h>
+#include <kernel/Thread.h>
+#include <kernel/Timer/Timer.h>
+
+namespace Kernel
+{
+
+	static constexpr size_t s_max_entries = 128;
+	static constexpr size_t s_max_name_length = 31;
+
+	struct BootTimelineEntry
+	{
+		uint64_t start_ns;
+		BAN::Atomic<uint64_t> end_ns;
+		pid_t tid;
+		uint8_t cpu;
+		char name[s_max_name_length + 1];
+	};
+
+	static LockClass s_timeline_lock_class { "boot_timeline" };
+	static SpinLock s_timeline_lock { s_timeline_lock_class };
+	static BAN::Array<BootTimelineEntry, s_max_entries> s_entries;
+	static size_t s_entry_count { 0 };
+
+	size_t BootTimeline::begin(BAN::StringView name)
+	{
+		const uint64_t start_ns = SystemTimer::get().ns_since_boot();
+
+		SpinLockGuard _(s_timeline_lock);
+		if (s_entry_count >= s_max_entries)
+			return invalid_id;
+
+		auto& entry = s_entries[s_entry_count];
+		entry.start_ns = start_ns;
+		entry.end_ns.store(0, BAN::memory_order_relaxed);
+		entry.tid = Thread::current_tid();
+		entry.cpu = Processor::current_index();
+
+		const size_t name_length = BAN::Math::min(name.size(), s_max_name_length);
+		memcpy(entry.name, name.data(), name_length);
+		entry.name[name_length] = '\0';
+
+		return s_entry_count++;
+	}
+
+	void BootTimeline::end(size_t id)
+	{
+		if (id == invalid_id)
+			return;
+		s_entries[id].end_ns.store(SystemTimer::get().ns_since_boot(), BAN::memory_order_release);
+	}
+
+	BAN::ErrorOr<BAN::String> BootTimeline::format()
+	{
+		size_t entry_count;
+		{
+			SpinLockGuard _(s_timeline_lock);
+			entry_count = s_entry_count;
+		}
+
+		// entries are never removed and only their end time changes after begin()
+		BAN::String result;
+		for (size_t i = 0; i < entry_count; i++)
+		{
+			const auto& entry = s_entries[i];
+			TRY(result.append(TRY(BAN::String::formatted("{} {} {} {} {}\n",
+				entry.start_ns,
+				entry.end_ns.load(BAN::memory_order_acquire),
+				entry.cpu,
+				entry.tid,
+				entry.name
+			))));
+		}
+		return result;
+	}
+
+	struct BootTask
+	{
+		BootTaskGroup* group;
+		BootTaskGroup::task_t task;
+		void* data;
+		char name[s_max_name_length + 1];
+	};
+
+	void BootTaskGroup::spawn(BAN::StringView name, task_t task, void* data)
+	{
+		{
+			LockGuard _(m_mutex);
+			m_pending++;
+		}
+
+		const auto run_task =
+			[](void* _boot_task)
+			{
+				auto* boot_task = static_cast<BootTask*>(_boot_task);
+				{
+					BootTimeline::Scope _(boot_task->name);
+					boot_task->task(boot_task->data);
+				}
+				boot_task->group->task_done();
+				delete boot_task;
+			};
+
+		auto* boot_task = new BootTask { this, task, data, {} };
+		if (boot_task != nullptr)
+		{
+			const size_t name_length = BAN::Math::min(name.size(), s_max_name_length);
+			memcpy(boot_task->name, name.data(), name_length);
+			boot_task->name[name_length] = '\0';
+
+			auto thread_or_error = Thread::create_kernel(run_task, boot_task);
+			if (!thread_or_error.is_error())
+			{
+				if (auto ret = Processor::scheduler().add_thread(thread_or_error.value()); !ret.is_error())
+					return;
+				delete thread_or_error.value();
+			}
+			delete boot_task;
+		}
+
+		// could not get a thread for this task, run it on the caller
+		dwarnln("could not start boot task '{}' on its own thread", name);
+		BootTimeline::Scope _(name);
+		task(data);
+		task_done();
+	}
+
+	void BootTaskGroup::task_done()
+	{
+		LockGuard _(m_mutex);
+		ASSERT(m_pending > 0);
+		if (--m_pending == 0)
+			m_blocker.unblock();
+	}
+
+	void BootTaskGroup::wait()
+	{
+		LockGuard _(m_mutex);
+		while (m_pending > 0)
+			m_blocker.block_indefinite(&m_mutex);
+	}
+
+}
@@ -8,6 +8,11 @@ namespace CPUID
 		asm volatile("cpuid" : "=a"(out[0]), "=b"(out[1]), "=c"(out[2]), "=d"(out[3]) : "a"(code));
 	}
 
+	static inline void get_cpuid(uint32_t code, uint32_t subleaf, uint32_t* out)
+	{
+		asm volatile("cpuid" : "=a"(out[0]), "=b"(out[1]), "=c"(out[2]), "=d"(out[3]) : "a"(code), "c"(subleaf));
+	}
+
 	static inline void get_cpuid_string(uint32_t code, uint32_t* out)
 	{
 		asm volatile ("cpuid": "=a"(out[0]), "=b"(out[0]), "=d"(out[1]), "=c"(out[2]) : "a"(code));
@@ -95,6 +100,47 @@ namespace CPUID
 		return buffer[3] & (1 << 27);
 	}
 
+	bool has_rdseed()
+	{
+		uint32_t buffer[4] {};
+		get_cpuid(0x00, buffer);
+		if (buffer[0] < 0x07)
+			return false;
+		get_cpuid(0x07, 0, buffer);
+		return buffer[1] & (1 << 18);
+	}
+
+	bool has_arat()
+	{
+		uint32_t buffer[4] {};
+		get_cpuid(0x00, buffer);
+		if (buffer[0] < 0x06)
+			return false;
+		get_cpuid(0x06, buffer);
+		return buffer[0] & (1 << 2);
+	}
+
+	uint32_t get_mwait_substates()
+	{
+		uint32_t buffer[4] {};
+		get_cpuid(0x00, buffer);
+		if (buffer[0] < 0x05)
+			return 0;
+
+		get_cpuid(0x01, buffer);
+		if (!(buffer[2] & ECX_MONITOR))
+			return 0;
+
+		get_cpuid(0x05, buffer);
+		// without the enumeration extensions EDX does not describe C-states
+		if (!(buffer[2] & (1 << 0)))
+			return 0;
+		// hint 0 (C1) is always valid, even if not enumerated
+		if (((buffer[3] >> 4) & 0x0F) == 0)
+			buffer[3] |= 1 << 4;
+		return buffer[3];
+	}
+
 	uint64_t get_tsc_frequency()
 	{
 		uint32_t buffer[4];
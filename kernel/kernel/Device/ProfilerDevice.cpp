@@ -0,0 +1,282 @@
+#include <BAN/Atomic.h>
+#include <kernel/Device/DeviceNumbers.h>
+#include <kernel/Device/ProfilerDevice.h>
+#include <kernel/GDT.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/PerProcessorRing.h>
+#include <kernel/Process.h>
+#include <kernel/Processor.h>
+#include <kernel/Scheduler.h>
+#include <kernel/Thread.h>
+#include <kernel/Timer/Timer.h>
+#include <kernel/UserCopy.h>
+
+#include <sys/ioctl.h>
+#include <sys/sysmacros.h>
+
+extern "C" bool safe_user_memcpy_no_paging(void*, const void*, size_t);
+
+namespace Kernel
+{
+
+	static constexpr uint32_t s_max_frequency_hz = 10'000;
+
+	struct ProfileProcessorData
+	{
+		uint64_t next_sample_ns { 0 };			// accessed only by the owning processor
+	};
+
+	static PerProcessorRing<profile_record, 1024, ProfileProcessorData> s_records;
+
+	static BAN::Atomic<bool> s_active { false };
+	static BAN::Atomic<pid_t> s_target_pid { 0 };
+	static BAN::Atomic<uint64_t> s_interval_ns { 0 };
+
+	BAN::ErrorOr<BAN::RefPtr<ProfilerDevice>> ProfilerDevice::create(mode_t mode, uid_t uid, gid_t gid)
+	{
+		static uint32_t minor = 0;
+		auto* result = new ProfilerDevice(mode, uid, gid, makedev(DeviceNumber::Profiler, minor++));
+		if (result == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<ProfilerDevice>::adopt(result);
+	}
+
+	bool ProfilerDevice::is_active()
+	{
+		return s_active.load(BAN::memory_order_relaxed);
+	}
+
+	bool ProfilerDevice::is_profiling(pid_t pid)
+	{
+		if (!is_active())
+			return false;
+		const pid_t target = s_target_pid.load(BAN::memory_order_relaxed);
+		return target == 0 || target == pid;
+	}
+
+	uint64_t ProfilerDevice::next_sample_ns()
+	{
+		if (!is_active() || !s_records.is_initialized())
+			return BAN::numeric_limits<uint64_t>::max();
+		return s_records.current_data().next_sample_ns;
+	}
+
+	void ProfilerDevice::record(const profile_record& record)
+	{
+		s_records.push([&record](profile_record& entry) {
+			entry = record;
+			entry.cpu = Processor::current_index();
+		});
+	}
+
+	static uint32_t walk_kernel_stack(const InterruptStack& interrupt_stack, const InterruptRegisters& interrupt_registers, uintptr_t* stack, uintptr_t& user_bp)
+	{
+		const auto& thread = Thread::current();
+
+		// frames of the interrupted code are above the interrupt frame on the same stack,
+		// this also stops the walk if we interrupted code running on the processor stack
+		const uintptr_t stack_bottom = reinterpret_cast<uintptr_t>(&interrupt_registers);
+		const uintptr_t stack_top = thread.kernel_stack_top();
+
+#if ARCH(x86_64)
+		uintptr_t bp = interrupt_registers.rbp;
+#elif ARCH(i686)
+		uintptr_t bp = interrupt_registers.ebp;
+#endif
+
+		uint32_t depth = 0;
+		stack[depth++] = interrupt_stack.ip;
+
+		if (stack_bottom < thread.kernel_stack_bottom() || stack_bottom >= stack_top)
+			return depth;
+
+		while (depth < PROFILE_MAX_DEPTH)
+		{
+			if (bp < stack_bottom || bp + 2 * sizeof(uintptr_t) > stack_top || bp % sizeof(uintptr_t))
+				break;
+
+			const auto* frame = reinterpret_cast<const uintptr_t*>(bp);
+			if (frame[1] == 0)
+				break;
+			stack[depth++] = frame[1];
+
+			// the outermost kernel frame saved the userspace frame pointer on syscall entry
+			if (frame[0] < USERSPACE_END)
+			{
+				user_bp = frame[0];
+				break;
+			}
+
+			if (frame[0] <= bp)
+				break;
+			bp = frame[0];
+		}
+
+		return depth;
+	}
+
+	static uint32_t walk_user_stack(uintptr_t ip, uintptr_t bp, uintptr_t* stack)
+	{
+		uint32_t depth = 0;
+		stack[depth++] = ip;
+
+		while (depth < PROFILE_MAX_DEPTH)
+		{
+			if (bp == 0 || bp % sizeof(uintptr_t) || bp + 2 * sizeof(uintptr_t) > USERSPACE_END)
+				break;
+
+			// we are in an interrupt handler and cannot demand page, just give up on unmapped frames
+			uintptr_t frame[2];
+			if (!safe_user_memcpy_no_paging(frame, reinterpret_cast<const void*>(bp), sizeof(frame)))
+				break;
+			if (frame[1] == 0)
+				break;
+			stack[depth++] = frame[1];
+
+			if (frame[0] <= bp)
+				break;
+			bp = frame[0];
+		}
+
+		return depth;
+	}
+
+	void ProfilerDevice::on_timer_interrupt(const InterruptStack& interrupt_stack, const InterruptRegisters& interrupt_registers)
+	{
+		ASSERT(Processor::get_interrupt_state() == InterruptState::Disabled);
+
+		if (!s_records.is_initialized() || !is_active())
+			return;
+
+		auto& data = s_records.current_data();
+
+		const uint64_t current_ns = SystemTimer::get().ns_since_boot();
+		if (current_ns < data.next_sample_ns)
+			return;
+		data.next_sample_ns = current_ns + s_interval_ns.load(BAN::memory_order_relaxed);
+
+		auto& thread = Thread::current();
+		const pid_t pid = thread.has_process() ? thread.process().pid() : 0;
+		if (!is_profiling(pid))
+			return;
+
+		profile_record record;
+		record.type = PROFILE_RECORD_SAMPLE;
+		record.pid = pid;
+		record.tid = thread.tid();
+		record.timestamp_ns = current_ns;
+		record.sample.flags = Processor::scheduler().is_idle() ? PROFILE_SAMPLE_IDLE : 0;
+		record.sample.kernel_depth = 0;
+		record.sample.user_depth = 0;
+
+		if (GDT::is_user_segment(interrupt_stack.cs))
+		{
+#if ARCH(x86_64)
+			const uintptr_t bp = interrupt_registers.rbp;
+#elif ARCH(i686)
+			const uintptr_t bp = interrupt_registers.ebp;
+#endif
+			record.sample.user_depth = walk_user_stack(interrupt_stack.ip, bp, record.sample.user_stack);
+		}
+		else
+		{
+			uintptr_t user_bp = 0;
+			record.sample.kernel_depth = walk_kernel_stack(interrupt_stack, interrupt_registers, record.sample.kernel_stack, user_bp);
+
+			// userspace threads enter the kernel at the top of their kernel stack
+			if (thread.is_userspace() && thread.has_process())
+			{
+				const auto& user_interrupt_stack = *reinterpret_cast<const InterruptStack*>(thread.kernel_stack_top() - sizeof(InterruptStack));
+				if (GDT::is_user_segment(user_interrupt_stack.cs))
+					record.sample.user_depth = walk_user_stack(user_interrupt_stack.ip, user_bp, record.sample.user_stack);
+			}
+		}
+
+		ProfilerDevice::record(record);
+	}
+
+	void ProfilerDevice::record_mmap(pid_t pid, vaddr_t address, size_t size, off_t offset, BAN::StringView path)
+	{
+		if (!is_profiling(pid))
+			return;
+
+		profile_record record;
+		record.type = PROFILE_RECORD_MMAP;
+		record.pid = pid;
+		record.tid = Thread::current_tid();
+		record.timestamp_ns = SystemTimer::get().ns_since_boot();
+		record.map.address = address;
+		record.map.size = size;
+		record.map.offset = offset;
+
+		const size_t path_len = BAN::Math::min<size_t>(path.size(), PROFILE_MAX_PATH - 1);
+		memcpy(record.map.path, path.data(), path_len);
+		record.map.path[path_len] = '\0';
+
+		ProfilerDevice::record(record);
+	}
+
+	BAN::ErrorOr<long> ProfilerDevice::ioctl_impl(unsigned long request, void* arg)
+	{
+		switch (request)
+		{
+			case PROFILE_START:
+			{
+				profile_config config;
+				TRY(read_from_user(arg, &config, sizeof(config)));
+				if (config.pid < 0 || config.frequency_hz == 0 || config.frequency_hz > s_max_frequency_hz)
+					return BAN::Error::from_errno(EINVAL);
+
+				TRY(s_records.initialize());
+
+				s_target_pid.store(config.pid, BAN::memory_order_relaxed);
+				s_interval_ns.store(1'000'000'000 / config.frequency_hz, BAN::memory_order_relaxed);
+				s_active.store(true, BAN::memory_order_release);
+
+				// idle processors may not have a timer armed at all
+				Processor::start_profiling();
+
+				return 0;
+			}
+			case PROFILE_STOP:
+				s_active.store(false, BAN::memory_order_release);
+				return 0;
+		}
+
+		return CharacterDevice::ioctl_impl(request, arg);
+	}
+
+	BAN::ErrorOr<size_t> ProfilerDevice::read_impl(off_t, BAN::ByteSpan buffer)
+	{
+		if (buffer.size() < sizeof(profile_record))
+			return BAN::Error::from_errno(EINVAL);
+
+		LockGuard _(m_mutex);
+
+		const BAN::Span<profile_record> records(reinterpret_cast<profile_record*>(buffer.data()), buffer.size() / sizeof(profile_record));
+
+		for (;;)
+		{
+			const size_t count = s_records.drain(records,
+				[](profile_record& record, size_t cpu, uint64_t dropped) {
+					record.type = PROFILE_RECORD_DROPPED;
+					record.cpu = cpu;
+					record.pid = 0;
+					record.tid = 0;
+					record.timestamp_ns = 0;
+					record.dropped.count = dropped;
+				}
+			);
+			if (count > 0)
+				return count * sizeof(profile_record);
+
+			TRY(s_records.wait_for_entries(m_mutex));
+		}
+	}
+
+	bool ProfilerDevice::can_read_impl() const
+	{
+		return s_records.has_entries();
+	}
+
+}
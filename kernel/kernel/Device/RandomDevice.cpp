@@ -18,14 +18,7 @@ namespace Kernel
 
 	BAN::ErrorOr<size_t> RandomDevice::read_impl(off_t, BAN::ByteSpan buffer)
 	{
-		size_t nwritten = 0;
-		while (nwritten < buffer.size())
-		{
-			const uint64_t random = Random::get_u64();
-			const size_t to_copy = BAN::Math::min(buffer.size() - nwritten, sizeof(random));
-			memcpy(buffer.data() + nwritten, &random, to_copy);
-			nwritten += to_copy;
-		}
+		Random::get_bytes(buffer);
 		return buffer.size();
 	}
 
@@ -0,0 +1,74 @@
+#include <BAN/Atomic.h>
+#include <kernel/Device/DeviceNumbers.h>
+#include <kernel/Device/SyscallTraceDevice.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/PerProcessorRing.h>
+#include <kernel/Processor.h>
+
+#include <sys/sysmacros.h>
+
+namespace Kernel
+{
+
+	static PerProcessorRing<syscall_trace_event, 2048> s_events;
+
+	BAN::ErrorOr<BAN::RefPtr<SyscallTraceDevice>> SyscallTraceDevice::create(mode_t mode, uid_t uid, gid_t gid)
+	{
+		static uint32_t minor = 0;
+		auto* result = new SyscallTraceDevice(mode, uid, gid, makedev(DeviceNumber::SyscallTrace, minor++));
+		if (result == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<SyscallTraceDevice>::adopt(result);
+	}
+
+	BAN::ErrorOr<void> SyscallTraceDevice::initialize_buffers()
+	{
+		return s_events.initialize();
+	}
+
+	void SyscallTraceDevice::record(const syscall_trace_event& event)
+	{
+		s_events.push([&event](syscall_trace_event& entry) {
+			entry = event;
+			entry.cpu = Processor::current_index();
+		});
+	}
+
+	BAN::ErrorOr<size_t> SyscallTraceDevice::read_impl(off_t, BAN::ByteSpan buffer)
+	{
+		if (buffer.size() < sizeof(syscall_trace_event))
+			return BAN::Error::from_errno(EINVAL);
+
+		LockGuard _(m_mutex);
+
+		const BAN::Span<syscall_trace_event> events(reinterpret_cast<syscall_trace_event*>(buffer.data()), buffer.size() / sizeof(syscall_trace_event));
+
+		for (;;)
+		{
+			const size_t count = s_events.drain(events,
+				[](syscall_trace_event& event, size_t cpu, uint64_t dropped) {
+					event = {
+						.pid = 0,
+						.tid = 0,
+						.syscall = SYSCALL_TRACE_DROPPED,
+						.cpu = static_cast<unsigned>(cpu),
+						.args = { static_cast<long>(dropped), 0, 0, 0, 0 },
+						.ret = 0,
+						.entry_ns = 0,
+						.exit_ns = 0,
+					};
+				}
+			);
+			if (count > 0)
+				return count * sizeof(syscall_trace_event);
+
+			TRY(s_events.wait_for_entries(m_mutex));
+		}
+	}
+
+	bool SyscallTraceDevice::can_read_impl() const
+	{
+		return s_events.has_entries();
+	}
+
+}
@@ -35,78 +35,103 @@ namespace Kernel
 
 	Epoll::~Epoll()
 	{
-		for (auto& [inode, _] : m_listening_events)
-			inode->del_epoll(this);
+		for (auto& [inode, listeners] : m_listeners)
+			for (auto& [_, listener] : listeners)
+				inode->del_epoll(listener.ptr());
 	}
 
 	BAN::ErrorOr<void> Epoll::ctl(int op, int fd, BAN::RefPtr<Inode> inode, epoll_event event)
 	{
 		LockGuard _(m_mutex);
 
-		auto it = m_listening_events.find(inode);
+		auto it = m_listeners.find(inode);
 
 		switch (op)
 		{
 			case EPOLL_CTL_ADD:
 			{
-				bool contains_inode = (it != m_listening_events.end());
-				if (!contains_inode)
-					it = TRY(m_listening_events.emplace(inode));
-				if (it->value.has_fd(fd))
+				if ((event.events & EPOLLEXCLUSIVE) && (event.events & EPOLLONESHOT))
+					return BAN::Error::from_errno(EINVAL);
+
+				const bool contains_inode = (it != m_listeners.end());
+				if (contains_inode && it->value.contains(fd))
 					return BAN::Error::from_errno(EEXIST);
 
+				auto listener = TRY(BAN::UniqPtr<EpollListener>::create());
+				listener->epoll = this;
+				listener->inode = inode.ptr();
+				listener->fd = fd;
+				listener->event = event;
+
+				if (!contains_inode)
+					it = TRY(m_listeners.emplace(inode));
+
+				auto& new_listener = *listener;
+				if (auto ret = it->value.insert(fd, BAN::move(listener)); ret.is_error())
 				{
-					SpinLockGuard _(m_ready_lock);
-					TRY(m_ready_events.reserve(m_listening_events.size()));
+					if (it->value.empty())
+						m_listeners.remove(it);
+					return ret.release_error();
 				}
-				TRY(m_processing_events.reserve(m_listening_events.size()));
 
-				if (!contains_inode)
-					TRY(inode->add_epoll(this));
-				TRY(it->value.add_fd(fd, event));
+				if (auto ret = inode->add_epoll(&new_listener); ret.is_error())
+				{
+					it->value.remove(fd);
+					if (it->value.empty())
+						m_listeners.remove(it);
+					return ret.release_error();
+				}
 
+				// report events that are already pending
 				SpinLockGuard _(m_ready_lock);
-				auto ready_it = m_ready_events.find(inode);
-				if (ready_it == m_ready_events.end())
-					ready_it = MUST(m_ready_events.insert(inode, 0));
-				ready_it->value |= event.events | EPOLLHUP | EPOLLERR;
+				new_listener.ready_events = event.events | EPOLLHUP | EPOLLERR;
+				append_to_ready_list(new_listener);
 				m_thread_blocker.unblock();
 
 				return {};
 			}
 			case EPOLL_CTL_MOD:
 			{
-				if (it == m_listening_events.end())
+				if (it == m_listeners.end())
 					return BAN::Error::from_errno(ENOENT);
-				if (!it->value.has_fd(fd))
+				auto listener_it = it->value.find(fd);
+				if (listener_it == it->value.end())
 					return BAN::Error::from_errno(ENOENT);
+				auto& listener = *listener_it->value;
 
-				it->value.events[fd] = event;
+				if (listener.is_exclusive() || (event.events & EPOLLEXCLUSIVE))
+					return BAN::Error::from_errno(EINVAL);
 
 				SpinLockGuard _(m_ready_lock);
-				auto ready_it = m_ready_events.find(inode);
-				if (ready_it == m_ready_events.end())
-					ready_it = MUST(m_ready_events.insert(inode, 0));
-				ready_it->value |= event.events | EPOLLHUP | EPOLLERR;
+				listener.event = event;
+				listener.ready_events |= event.events | EPOLLHUP | EPOLLERR;
+				if (!listener.in_ready_list)
+					append_to_ready_list(listener);
 				m_thread_blocker.unblock();
 
 				return {};
 			}
 			case EPOLL_CTL_DEL:
 			{
-				if (it == m_listening_events.end())
+				if (it == m_listeners.end())
 					return BAN::Error::from_errno(ENOENT);
-				if (!it->value.has_fd(fd))
+				auto listener_it = it->value.find(fd);
+				if (listener_it == it->value.end())
 					return BAN::Error::from_errno(ENOENT);
-				it->value.remove_fd(fd);
-				if (it->value.empty())
+				auto& listener = *listener_it->value;
+
+				// after this the inode will no longer notify this listener
+				inode->del_epoll(&listener);
+
 				{
-					inode->del_epoll(this);
-					m_listening_events.remove(it);
-					m_processing_events.remove(inode);
 					SpinLockGuard _(m_ready_lock);
-					m_ready_events.remove(inode);
+					remove_from_ready_list(listener);
 				}
+
+				it->value.remove(listener_it);
+				if (it->value.empty())
+					m_listeners.remove(it);
+
 				return {};
 			}
 		}
@@ -126,54 +151,41 @@ namespace Kernel
 			{
 				LockGuard _(m_mutex);
 
+				// Take the whole ready list for processing. Listeners keep their in_ready_list
+				// flag so notifications during processing only update their ready_events.
+				EpollListener* processing;
+				EpollListener* processing_tail;
+
 				{
 					SpinLockGuard _(m_ready_lock);
-
-					while (!m_ready_events.empty())
-					{
-						auto [inode, events] = *m_ready_events.begin();
-						m_ready_events.remove(m_ready_events.begin());
-
-						ASSERT(events);
-
-						if (auto it = m_processing_events.find(inode); it != m_processing_events.end())
-							it->value |= events;
-						else
-							MUST(m_processing_events.insert(inode, events));
-					}
+					processing = m_ready_head;
+					processing_tail = m_ready_tail;
+					m_ready_head = nullptr;
+					m_ready_tail = nullptr;
 				}
 
-				for (auto it = m_processing_events.begin(); it != m_processing_events.end() && event_count < event_span.size();)
+				while (processing && event_count < event_span.size())
 				{
-					auto& [inode, events] = *it;
-
-#define REMOVE_IT() \
-					({ \
-						m_processing_events.remove(it); \
-						if (event_count > 0) \
-							break; \
-						it = m_processing_events.begin(); \
-						continue; \
-					})
-
-					auto listen_it = m_listening_events.find(inode);
-					if (listen_it == m_listening_events.end())
-						REMOVE_IT();
-					auto& listen = listen_it->value;
+					auto& listener = *processing;
+					processing = (processing == processing_tail) ? nullptr : listener.ready_next;
+
+					uint32_t events;
+					uint32_t listen_events;
 
 					{
-						uint32_t listen_mask = EPOLLHUP | EPOLLERR;
-						for (const auto& [_, events] : listen.events)
-							listen_mask |= events.events;
-						events &= listen_mask;
+						SpinLockGuard _(m_ready_lock);
+						events = listener.ready_events;
+						listen_events = listener.event.events;
+						listener.ready_events = 0;
 					}
 
-					if (events == 0)
-						REMOVE_IT();
+					if (listen_events == 0)
+						events = 0;
+					events &= listen_events | EPOLLHUP | EPOLLERR;
 
 					{
 #define CHECK_EVENT_BIT(mask, func) \
-						if ((events & mask) && !inode->func()) \
+						if ((events & mask) && !listener.inode->func()) \
 							events &= ~mask;
 						CHECK_EVENT_BIT(EPOLLIN, can_read);
 						CHECK_EVENT_BIT(EPOLLOUT, can_write);
@@ -182,33 +194,42 @@ namespace Kernel
 #undef CHECK_EVENT_BIT
 					}
 
-					if (events == 0)
-						REMOVE_IT();
+					if (events)
+					{
+						event_span[event_count++] = {
+							.events = events,
+							.data = listener.event.data,
+						};
+					}
 
-#undef REMOVE_IT
+					const bool level_triggered = !(listen_events & (EPOLLET | EPOLLONESHOT));
 
-					for (auto& [_, listen_event] : listen.events)
-					{
-						if (event_count >= event_span.size())
-							break;
+					SpinLockGuard _(m_ready_lock);
 
-						const auto new_events = (listen_event.events | EPOLLHUP | EPOLLERR) & events;
-						if (new_events == 0)
-							continue;
+					if (events && (listen_events & EPOLLONESHOT))
+						listener.event.events = 0;
 
-						event_span[event_count++] = {
-							.events = new_events,
-							.data = listen_event.data,
-						};
+					// level triggered listeners stay ready until the events are no longer active
+					if (events && level_triggered)
+						listener.ready_events |= events;
 
-						if (listen_event.events & EPOLLONESHOT)
-							listen_event.events = 0;
-						// this doesn't work with multiple of the same inode
-						if (listen_event.events & EPOLLET)
-							events &= ~new_events;
-					}
+					if (listener.ready_events)
+						append_to_ready_list(listener);
+					else
+						listener.in_ready_list = false;
+				}
 
-					it++;
+				if (processing)
+				{
+					// put unprocessed listeners back to the front of the ready list
+					SpinLockGuard _(m_ready_lock);
+					processing->ready_prev = nullptr;
+					processing_tail->ready_next = m_ready_head;
+					if (m_ready_head)
+						m_ready_head->ready_prev = processing_tail;
+					else
+						m_ready_tail = processing_tail;
+					m_ready_head = processing;
 				}
 			}
 
@@ -220,28 +241,62 @@ namespace Kernel
 				break;
 
 			SpinLockGuard guard(m_ready_lock);
-			if (!m_ready_events.empty())
+			if (m_ready_head != nullptr)
 				continue;
 
+			m_waiters++;
 			BlockableSpinLock block(m_ready_lock);
-			TRY(Thread::current().block_or_eintr_or_waketime_ns(m_thread_blocker, waketime_ns, false, &block));
+			auto ret = Thread::current().block_or_eintr_or_waketime_ns(m_thread_blocker, waketime_ns, false, &block);
+			m_waiters--;
+			TRY(ret);
 		}
 
 		return event_count;
 	}
 
-	void Epoll::notify(BAN::RefPtr<Inode> inode, uint32_t event)
+	void Epoll::notify(EpollListener& listener, uint32_t event)
 	{
 		ASSERT(event);
 
 		SpinLockGuard _(m_ready_lock);
 
-		if (auto it = m_ready_events.find(inode); it != m_ready_events.end())
-			it->value |= event;
-		else
-			MUST(m_ready_events.insert(inode, event));
+		if (!listener.listens_for(event))
+			return;
+
+		listener.ready_events |= event;
+		if (!listener.in_ready_list)
+			append_to_ready_list(listener);
 
 		m_thread_blocker.unblock();
 	}
 
+	void Epoll::append_to_ready_list(EpollListener& listener)
+	{
+		listener.in_ready_list = true;
+		listener.ready_prev = m_ready_tail;
+		listener.ready_next = nullptr;
+		if (m_ready_tail)
+			m_ready_tail->ready_next = &listener;
+		else
+			m_ready_head = &listener;
+		m_ready_tail = &listener;
+	}
+
+	void Epoll::remove_from_ready_list(EpollListener& listener)
+	{
+		if (!listener.in_ready_list)
+			return;
+		if (listener.ready_prev)
+			listener.ready_prev->ready_next = listener.ready_next;
+		else
+			m_ready_head = listener.ready_next;
+		if (listener.ready_next)
+			listener.ready_next->ready_prev = listener.ready_prev;
+		else
+			m_ready_tail = listener.ready_prev;
+		listener.in_ready_list = false;
+		listener.ready_prev = nullptr;
+		listener.ready_next = nullptr;
+	}
+
 }
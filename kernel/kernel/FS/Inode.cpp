@@ -190,6 +190,20 @@ namespace Kernel
 		return recvmsg_impl(message, flags);
 	}
 
+	BAN::ErrorOr<size_t> Inode::recvmmsg(BAN::Span<mmsghdr> messages, int flags)
+	{
+		if (!mode().ifsock())
+			return BAN::Error::from_errno(ENOTSOCK);
+		ASSERT(!messages.empty());
+		return recvmmsg_impl(messages, flags);
+	}
+
+	BAN::ErrorOr<size_t> Inode::recvmmsg_impl(BAN::Span<mmsghdr> messages, int flags)
+	{
+		messages[0].msg_len = TRY(recvmsg_impl(messages[0].msg_hdr, flags));
+		return 1;
+	}
+
 	BAN::ErrorOr<size_t> Inode::sendmsg(const msghdr& message, int flags)
 	{
 		if (!mode().ifsock())
@@ -241,6 +255,71 @@ namespace Kernel
 		return write_impl(offset, buffer);
 	}
 
+	BAN::ErrorOr<size_t> Inode::readv(off_t offset, BAN::Span<const BAN::ByteSpan> buffers)
+	{
+		if (mode().ifdir())
+			return BAN::Error::from_errno(EISDIR);
+		return readv_impl(offset, buffers);
+	}
+
+	BAN::ErrorOr<size_t> Inode::writev(off_t offset, BAN::Span<const BAN::ConstByteSpan> buffers)
+	{
+		if (mode().ifdir())
+			return BAN::Error::from_errno(EISDIR);
+		if (auto* fs = filesystem(); fs && (fs->flag() & ST_RDONLY))
+			return BAN::Error::from_errno(EROFS);
+		return writev_impl(offset, buffers);
+	}
+
+	BAN::ErrorOr<size_t> Inode::readv_impl(off_t offset, BAN::Span<const BAN::ByteSpan> buffers)
+	{
+		size_t total_read = 0;
+		for (size_t i = 0; i < buffers.size(); i++)
+		{
+			if (buffers[i].empty())
+				continue;
+			// NOTE: don't block on a later buffer if we already got some data
+			if (total_read && !mode().ifreg() && !can_read())
+				break;
+
+			auto nread_or_error = read_impl(offset + total_read, buffers[i]);
+			if (nread_or_error.is_error())
+			{
+				if (total_read)
+					break;
+				return nread_or_error.release_error();
+			}
+
+			total_read += nread_or_error.value();
+			if (nread_or_error.value() < buffers[i].size())
+				break;
+		}
+		return total_read;
+	}
+
+	BAN::ErrorOr<size_t> Inode::writev_impl(off_t offset, BAN::Span<const BAN::ConstByteSpan> buffers)
+	{
+		size_t total_written = 0;
+		for (size_t i = 0; i < buffers.size(); i++)
+		{
+			if (buffers[i].empty())
+				continue;
+
+			auto nwritten_or_error = write_impl(offset + total_written, buffers[i]);
+			if (nwritten_or_error.is_error())
+			{
+				if (total_written)
+					break;
+				return nwritten_or_error.release_error();
+			}
+
+			total_written += nwritten_or_error.value();
+			if (nwritten_or_error.value() < buffers[i].size())
+				break;
+		}
+		return total_written;
+	}
+
 	BAN::ErrorOr<void> Inode::truncate(size_t size)
 	{
 		if (mode().ifdir())
@@ -341,21 +420,21 @@ namespace Kernel
 		}
 	}
 
-	BAN::ErrorOr<void> Inode::add_epoll(class Epoll* epoll)
+	BAN::ErrorOr<void> Inode::add_epoll(EpollListener* listener)
 	{
 		SpinLockGuard _(m_epoll_lock);
-		TRY(m_epolls.push_back(epoll));
+		TRY(m_epoll_listeners.push_back(listener));
 		return {};
 	}
 
-	void Inode::del_epoll(class Epoll* epoll)
+	void Inode::del_epoll(EpollListener* listener)
 	{
 		SpinLockGuard _(m_epoll_lock);
-		for (auto it = m_epolls.begin(); it != m_epolls.end(); it++)
+		for (auto it = m_epoll_listeners.begin(); it != m_epoll_listeners.end(); it++)
 		{
-			if (*it != epoll)
+			if (*it != listener)
 				continue;
-			m_epolls.remove(it);
+			m_epoll_listeners.remove(it);
 			break;
 		}
 	}
@@ -363,8 +442,42 @@ namespace Kernel
 	void Inode::epoll_notify(uint32_t event)
 	{
 		SpinLockGuard _(m_epoll_lock);
-		for (auto* epoll : m_epolls)
-			epoll->notify(this, event);
+
+		size_t exclusive_count = 0;
+		for (auto* listener : m_epoll_listeners)
+		{
+			if (!listener->is_exclusive())
+				listener->epoll->notify(*listener, event);
+			else if (listener->listens_for(event))
+				exclusive_count++;
+		}
+
+		if (exclusive_count == 0)
+			return;
+
+		// Only one of the exclusive listeners interested in this event is woken up. Rotate
+		// the starting point and prefer an epoll that has an idle thread waiting on it.
+		const size_t start = m_epoll_exclusive_rotor++ % exclusive_count;
+
+		EpollListener* target = nullptr;
+		size_t target_priority = BAN::numeric_limits<size_t>::max();
+
+		size_t index = 0;
+		for (auto* listener : m_epoll_listeners)
+		{
+			if (!listener->is_exclusive() || !listener->listens_for(event))
+				continue;
+			const size_t distance = (index++ + exclusive_count - start) % exclusive_count;
+			const size_t priority = distance + (listener->epoll->has_waiters() ? 0 : exclusive_count);
+			if (priority >= target_priority)
+				continue;
+			target = listener;
+			target_priority = priority;
+		}
+
+		// NOTE: listener events can be modified concurrently by EPOLL_CTL_MOD
+		if (target != nullptr)
+			target->epoll->notify(*target, event);
 	}
 
 }
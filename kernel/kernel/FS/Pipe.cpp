@@ -1,18 +1,18 @@
 #include <BAN/HashMap.h>
 #include <kernel/FS/Pipe.h>
 #include <kernel/Lock/LockGuard.h>
+#include <kernel/Memory/kmalloc.h>
 #include <kernel/Thread.h>
 #include <kernel/Timer/Timer.h>
 
 #include <fcntl.h>
+#include <limits.h>
 #include <sys/epoll.h>
 #include <sys/ioctl.h>
 
 namespace Kernel
 {
 
-	static constexpr size_t s_pipe_buffer_size = 0x10000;
-
 	static Mutex s_named_pipe_mutex;
 	static BAN::HashMap<BAN::RefPtr<Inode>, BAN::WeakPtr<Pipe>> s_named_pipes;
 
@@ -50,7 +50,7 @@ namespace Kernel
 				if (pipe_ptr == nullptr)
 					return BAN::Error::from_errno(ENOMEM);
 				pipe = BAN::RefPtr<Pipe>::adopt(pipe_ptr);
-				pipe->m_buffer = TRY(ByteRingBuffer::create(s_pipe_buffer_size));
+				TRY(pipe->m_buffers.resize(default_capacity / PAGE_SIZE));
 				pipe->m_named_inode = inode;
 
 				it->value = TRY(pipe->get_weak_ptr());
@@ -60,9 +60,15 @@ namespace Kernel
 		LockGuard _(pipe->m_mutex);
 
 		if (status_flags & O_RDONLY)
+		{
 			pipe->m_reading_count++;
+			pipe->m_write_blocker.unblock();
+		}
 		if (status_flags & O_WRONLY)
+		{
 			pipe->m_writing_count++;
+			pipe->m_read_blocker.unblock();
+		}
 
 		if (status_flags & O_NONBLOCK)
 		{
@@ -72,8 +78,9 @@ namespace Kernel
 		}
 
 		auto& block_value = (status_flags & O_WRONLY) ? pipe->m_reading_count : pipe->m_writing_count;
+		auto& blocker = (status_flags & O_WRONLY) ? pipe->m_write_blocker : pipe->m_read_blocker;
 		while (block_value == 0)
-			TRY(Thread::current().block_or_eintr_indefinite(pipe->m_thread_blocker, &pipe->m_mutex));
+			TRY(Thread::current().block_or_eintr_indefinite(blocker, &pipe->m_mutex));
 		return BAN::RefPtr<Inode>(pipe);
 	}
 
@@ -100,7 +107,7 @@ namespace Kernel
 		if (pipe_ptr == nullptr)
 			return BAN::Error::from_errno(ENOMEM);
 		auto pipe = BAN::RefPtr<Pipe>::adopt(pipe_ptr);
-		pipe->m_buffer = TRY(ByteRingBuffer::create(s_pipe_buffer_size));
+		TRY(pipe->m_buffers.resize(default_capacity / PAGE_SIZE));
 		pipe->m_reading_count++;
 		pipe->m_writing_count++;
 		return BAN::RefPtr<Inode>(pipe);
@@ -127,6 +134,11 @@ namespace Kernel
 
 	Pipe::~Pipe()
 	{
+		for (size_t i = 0; i < m_buffer_count; i++)
+			kfree(buffer_at(i).page);
+		if (m_spare_page)
+			kfree(m_spare_page);
+
 		if (!m_named_inode)
 			return;
 		LockGuard _(s_named_pipe_mutex);
@@ -170,7 +182,8 @@ namespace Kernel
 			epoll_notify(EPOLLERR);
 		}
 
-		m_thread_blocker.unblock();
+		m_read_blocker.unblock();
+		m_write_blocker.unblock();
 	}
 
 	BAN::ErrorOr<void> Pipe::sync_inode(SyncType type)
@@ -211,56 +224,336 @@ namespace Kernel
 		return {};
 	}
 
-	BAN::ErrorOr<size_t> Pipe::read_impl(off_t, BAN::ByteSpan buffer)
+	BAN::ErrorOr<size_t> Pipe::read_impl(off_t offset, BAN::ByteSpan buffer)
 	{
-		LockGuard _(m_mutex);
+		return readv_impl(offset, { &buffer, 1 });
+	}
 
-		while (m_buffer->empty())
+	BAN::ErrorOr<size_t> Pipe::write_impl(off_t offset, BAN::ConstByteSpan buffer)
+	{
+		return writev_impl(offset, { &buffer, 1 });
+	}
+
+	size_t Pipe::free_bytes() const
+	{
+		size_t result = (m_buffers.size() - m_buffer_count) * PAGE_SIZE;
+		if (m_buffer_count > 0)
 		{
-			if (m_writing_count == 0)
-				return 0;
-			TRY(Thread::current().block_or_eintr_indefinite(m_thread_blocker, &m_mutex));
+			const auto& tail = m_buffers[(m_buffer_head + m_buffer_count - 1) % m_buffers.size()];
+			result += PAGE_SIZE - tail.offset - tail.size;
 		}
+		return result;
+	}
 
-		const size_t to_copy = BAN::Math::min<size_t>(buffer.size(), m_buffer->size());
-		memcpy(buffer.data(), m_buffer->get_data().data(), to_copy);
-		m_buffer->pop(to_copy);
-
-		m_atime = SystemTimer::get().real_time();
-
-		epoll_notify(EPOLLOUT);
+	uint8_t* Pipe::allocate_page()
+	{
+		if (auto* page = m_spare_page)
+		{
+			m_spare_page = nullptr;
+			return page;
+		}
+		return static_cast<uint8_t*>(kmalloc(PAGE_SIZE));
+	}
 
-		m_thread_blocker.unblock();
+	void Pipe::release_page(uint8_t* page)
+	{
+		// keep one page around so a pipe that is drained and refilled doesn't hit the allocator
+		if (m_spare_page == nullptr)
+			m_spare_page = page;
+		else
+			kfree(page);
+	}
 
-		return to_copy;
+	BAN::ErrorOr<void> Pipe::wait_for_data(bool nonblock)
+	{
+		while (m_data_size == 0)
+		{
+			if (m_writing_count == 0)
+				return {};
+			if (nonblock)
+				return BAN::Error::from_errno(EAGAIN);
+			TRY(Thread::current().block_or_eintr_indefinite(m_read_blocker, &m_mutex));
+		}
+		return {};
 	}
 
-	BAN::ErrorOr<size_t> Pipe::write_impl(off_t, BAN::ConstByteSpan buffer)
+	BAN::ErrorOr<void> Pipe::wait_for_space(size_t required_space, bool nonblock)
 	{
-		LockGuard _(m_mutex);
+		for (;;)
+		{
+			if (m_reading_count == 0)
+			{
+				Thread::current().add_signal(SIGPIPE, {});
+				return BAN::Error::from_errno(EPIPE);
+			}
+			if (free_bytes() >= required_space)
+				return {};
+			if (nonblock)
+				return BAN::Error::from_errno(EAGAIN);
+			TRY(Thread::current().block_or_eintr_indefinite(m_write_blocker, &m_mutex));
+		}
+	}
 
-		while (m_buffer->full())
+	BAN::ErrorOr<void> Pipe::wait_for_free_buffer(bool nonblock)
+	{
+		for (;;)
 		{
 			if (m_reading_count == 0)
 			{
 				Thread::current().add_signal(SIGPIPE, {});
 				return BAN::Error::from_errno(EPIPE);
 			}
-			TRY(Thread::current().block_or_eintr_indefinite(m_thread_blocker, &m_mutex));
+			if (m_buffer_count < m_buffers.size())
+				return {};
+			if (nonblock)
+				return BAN::Error::from_errno(EAGAIN);
+			TRY(Thread::current().block_or_eintr_indefinite(m_write_blocker, &m_mutex));
 		}
+	}
 
-		const size_t to_copy = BAN::Math::min(buffer.size(), m_buffer->free());
-		m_buffer->push(buffer.slice(0, to_copy));
+	void Pipe::on_data_removed(size_t free_before, size_t buffer_count_before)
+	{
+		m_atime = SystemTimer::get().real_time();
+
+		epoll_notify(EPOLLOUT);
 
+		// blocked writers never need more than PIPE_BUF bytes, blocked splices a free buffer slot
+		if (free_before < PIPE_BUF && free_bytes() >= PIPE_BUF)
+			m_write_blocker.unblock();
+		else if (buffer_count_before == m_buffers.size() && m_buffer_count < m_buffers.size())
+			m_write_blocker.unblock();
+	}
+
+	void Pipe::on_data_added(size_t size_before)
+	{
 		timespec current_time = SystemTimer::get().real_time();
 		m_mtime = current_time;
 		m_ctime = current_time;
 
 		epoll_notify(EPOLLIN);
 
-		m_thread_blocker.unblock();
+		// readers only block on an empty pipe
+		if (size_before == 0)
+			m_read_blocker.unblock();
+	}
+
+	BAN::ErrorOr<size_t> Pipe::set_capacity(size_t new_capacity)
+	{
+		new_capacity = BAN::Math::max<size_t>(BAN::Math::div_round_up<size_t>(new_capacity, PAGE_SIZE), 1) * PAGE_SIZE;
+		if (new_capacity > max_capacity)
+			return BAN::Error::from_errno(EINVAL);
+
+		LockGuard _(m_mutex);
+
+		const size_t new_buffer_count = new_capacity / PAGE_SIZE;
+		if (new_buffer_count < m_buffer_count)
+			return BAN::Error::from_errno(EBUSY);
+
+		BAN::Vector<PipeBuffer> new_buffers;
+		TRY(new_buffers.resize(new_buffer_count));
+		for (size_t i = 0; i < m_buffer_count; i++)
+			new_buffers[i] = buffer_at(i);
+
+		const size_t free_before = free_bytes();
+		const bool had_free_buffer = m_buffer_count < m_buffers.size();
+
+		m_buffers = BAN::move(new_buffers);
+		m_buffer_head = 0;
+
+		if ((free_before < PIPE_BUF && free_bytes() >= PIPE_BUF) || (!had_free_buffer && m_buffer_count < m_buffers.size()))
+		{
+			epoll_notify(EPOLLOUT);
+			m_write_blocker.unblock();
+		}
+
+		return new_capacity;
+	}
+
+	BAN::ErrorOr<size_t> Pipe::readv_impl(off_t, BAN::Span<const BAN::ByteSpan> buffers)
+	{
+		LockGuard _(m_mutex);
+
+		TRY(wait_for_data(false));
+		if (m_data_size == 0)
+			return 0;
+
+		const size_t free_before = free_bytes();
+		const size_t buffer_count_before = m_buffer_count;
+
+		size_t total_copied = 0;
+		for (const auto& buffer : buffers)
+		{
+			size_t buffer_copied = 0;
+			while (buffer_copied < buffer.size() && m_buffer_count > 0)
+			{
+				auto& head = buffer_at(0);
+
+				const size_t to_copy = BAN::Math::min<size_t>(buffer.size() - buffer_copied, head.size);
+				memcpy(buffer.data() + buffer_copied, head.page + head.offset, to_copy);
+				head.offset += to_copy;
+				head.size -= to_copy;
+				buffer_copied += to_copy;
+
+				if (head.size == 0)
+				{
+					release_page(head.page);
+					m_buffer_head = (m_buffer_head + 1) % m_buffers.size();
+					m_buffer_count--;
+				}
+			}
+
+			total_copied += buffer_copied;
+			if (m_buffer_count == 0)
+				break;
+		}
+
+		m_data_size -= total_copied;
+
+		on_data_removed(free_before, buffer_count_before);
+
+		return total_copied;
+	}
+
+	BAN::ErrorOr<size_t> Pipe::writev_impl(off_t, BAN::Span<const BAN::ConstByteSpan> buffers)
+	{
+		size_t total_size = 0;
+		for (const auto& buffer : buffers)
+			total_size += buffer.size();
+
+		// writes of at most PIPE_BUF bytes are not interleaved with other writes
+		const size_t required_space = (total_size <= PIPE_BUF) ? BAN::Math::max<size_t>(total_size, 1) : 1;
+
+		LockGuard _(m_mutex);
+
+		TRY(wait_for_space(required_space, false));
+
+		const size_t size_before = m_data_size;
+
+		size_t total_copied = 0;
+		for (const auto& buffer : buffers)
+		{
+			size_t buffer_copied = 0;
+			while (buffer_copied < buffer.size())
+			{
+				PipeBuffer* tail = m_buffer_count ? &buffer_at(m_buffer_count - 1) : nullptr;
+				if (tail == nullptr || tail->offset + tail->size == PAGE_SIZE)
+				{
+					if (m_buffer_count == m_buffers.size())
+						break;
+					auto* page = allocate_page();
+					if (page == nullptr)
+						break;
+					tail = &buffer_at(m_buffer_count++);
+					*tail = { .page = page, .offset = 0, .size = 0 };
+				}
+
+				const size_t to_copy = BAN::Math::min<size_t>(buffer.size() - buffer_copied, PAGE_SIZE - tail->offset - tail->size);
+				memcpy(tail->page + tail->offset + tail->size, buffer.data() + buffer_copied, to_copy);
+				tail->size += to_copy;
+				buffer_copied += to_copy;
+			}
+
+			total_copied += buffer_copied;
+			if (buffer_copied < buffer.size())
+				break;
+		}
+
+		if (total_copied == 0 && total_size > 0)
+			return BAN::Error::from_errno(ENOMEM);
+
+		m_data_size += total_copied;
+
+		on_data_added(size_before);
+
+		return total_copied;
+	}
+
+	BAN::ErrorOr<size_t> Pipe::splice(Pipe& source, Pipe& target, size_t count, bool nonblock_in, bool nonblock_out)
+	{
+		ASSERT(&source != &target);
+
+		if (count == 0)
+			return 0;
+
+		constexpr size_t max_pages = 16;
+
+		// pipe mutexes are always taken in address order so two splices between
+		// the same pipes in opposite directions can't deadlock
+		Pipe& first  = (&source < &target) ? source : target;
+		Pipe& second = (&source < &target) ? target : source;
 
-		return to_copy;
+		for (;;)
+		{
+			{
+				LockGuard _(target.m_mutex);
+				TRY(target.wait_for_free_buffer(nonblock_out));
+			}
+
+			{
+				LockGuard _(source.m_mutex);
+				TRY(source.wait_for_data(nonblock_in));
+				if (source.m_data_size == 0)
+					return 0;
+			}
+
+			LockGuard _0(first.m_mutex);
+			LockGuard _1(second.m_mutex);
+
+			// either pipe may have changed while neither was locked, start over
+			// so the waits above see the new state
+			if (target.m_reading_count == 0 || target.m_buffer_count == target.m_buffers.size())
+				continue;
+			if (source.m_data_size == 0)
+				continue;
+
+			const size_t source_free_before = source.free_bytes();
+			const size_t source_buffer_count_before = source.m_buffer_count;
+			const size_t target_size_before = target.m_data_size;
+
+			// pages are not merged, so every moved page takes a whole buffer slot.
+			// data is moved only into slots that are known to be free, so it never
+			// has to be put back and stays in order
+			size_t moved_bytes = 0;
+			size_t moved_pages = 0;
+			while (moved_pages < max_pages && moved_bytes < count && source.m_buffer_count > 0 && target.m_buffer_count < target.m_buffers.size())
+			{
+				auto& head = source.buffer_at(0);
+
+				if (head.size <= count - moved_bytes)
+				{
+					// whole buffer fits, pass the page itself
+					target.buffer_at(target.m_buffer_count++) = head;
+					moved_bytes += head.size;
+					moved_pages++;
+					source.m_buffer_head = (source.m_buffer_head + 1) % source.m_buffers.size();
+					source.m_buffer_count--;
+					continue;
+				}
+
+				auto* page = target.allocate_page();
+				if (page == nullptr)
+					break;
+
+				const size_t to_copy = count - moved_bytes;
+				memcpy(page, head.page + head.offset, to_copy);
+				head.offset += to_copy;
+				head.size -= to_copy;
+				target.buffer_at(target.m_buffer_count++) = { .page = page, .offset = 0, .size = static_cast<uint32_t>(to_copy) };
+				moved_bytes += to_copy;
+				moved_pages++;
+			}
+
+			if (moved_bytes == 0)
+				return BAN::Error::from_errno(ENOMEM);
+
+			source.m_data_size -= moved_bytes;
+			target.m_data_size += moved_bytes;
+
+			source.on_data_removed(source_free_before, source_buffer_count_before);
+			target.on_data_added(target_size_before);
+
+			return moved_bytes;
+		}
 	}
 
 	BAN::ErrorOr<void> Pipe::truncate_impl(size_t)
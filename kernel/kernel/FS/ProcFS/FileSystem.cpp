@@ -1,13 +1,31 @@
 #include <kernel/BootInfo.h>
+#include <kernel/BootTimeline.h>
 #include <kernel/FS/ProcFS/FileSystem.h>
 #include <kernel/FS/ProcFS/Inode.h>
+#include <kernel/IRQAffinity.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Process.h>
+#include <kernel/Tracepoint.h>
 
 namespace Kernel
 {
 
 	static ProcFileSystem* s_instance = nullptr;
 
+	template<BAN::ErrorOr<BAN::String> (*format)()>
+	static BAN::ErrorOr<size_t> read_formatted(off_t offset, BAN::ByteSpan buffer, void*)
+	{
+		ASSERT(offset >= 0);
+
+		auto string = TRY(format());
+		if (static_cast<size_t>(offset) >= string.size())
+			return 0;
+
+		const size_t bytes = BAN::Math::min<size_t>(string.size() - offset, buffer.size());
+		memcpy(buffer.data(), string.data() + offset, bytes);
+		return bytes;
+	}
+
 	void ProcFileSystem::initialize()
 	{
 		ASSERT(s_instance == nullptr);
@@ -48,6 +66,43 @@ namespace Kernel
 			nullptr, nullptr, *s_instance, 0444, 0, 0)
 		);
 		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*self_inode, "self"_sv));
+
+		auto processes_inode = MUST(ProcROInode::create_new(
+			[](off_t offset, BAN::ByteSpan buffer, void*) -> BAN::ErrorOr<size_t>
+			{
+				return Process::proc_processes(offset, buffer);
+			},
+			*s_instance, nullptr, 0444, 0, 0
+		));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*processes_inode, "processes"_sv));
+
+		auto lockstat_inode = MUST(ProcROInode::create_new(read_formatted<LockClass::format_all>, *s_instance, nullptr, 0444, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*lockstat_inode, "lockstat"_sv));
+
+		auto tracepoints_inode = MUST(ProcROInode::create_new(read_formatted<Tracepoints::format_counts>, *s_instance, nullptr, 0444, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*tracepoints_inode, "tracepoints"_sv));
+
+		auto trace_inode = MUST(ProcROInode::create_new(read_formatted<Tracepoints::format_events>, *s_instance, nullptr, 0400, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*trace_inode, "trace"_sv));
+
+		auto interrupts_inode = MUST(ProcROInode::create_new(read_formatted<IRQAffinity::format_counts>, *s_instance, nullptr, 0444, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*interrupts_inode, "interrupts"_sv));
+
+		auto irq_affinity_inode = MUST(ProcRWInode::create_new(
+			read_formatted<IRQAffinity::format_affinities>,
+			[](off_t, BAN::ConstByteSpan buffer, void*) -> BAN::ErrorOr<size_t>
+			{
+				return IRQAffinity::write_affinities(buffer);
+			},
+			*s_instance, nullptr, 0644, 0, 0
+		));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*irq_affinity_inode, "irq_affinity"_sv));
+
+		auto boot_timeline_inode = MUST(ProcROInode::create_new(read_formatted<BootTimeline::format>, *s_instance, nullptr, 0444, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*boot_timeline_inode, "boot_timeline"_sv));
+
+		auto zeroed_pages_inode = MUST(ProcROInode::create_new(read_formatted<Heap::format_zeroed_page_pool>, *s_instance, nullptr, 0444, 0, 0));
+		MUST(static_cast<TmpDirectoryInode*>(s_instance->root_inode().ptr())->link_inode(*zeroed_pages_inode, "zeroed_pages"_sv));
 	}
 
 	void ProcFileSystem::post_scheduler_initialize()
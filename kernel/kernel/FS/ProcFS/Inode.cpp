@@ -21,9 +21,11 @@ namespace Kernel
 		TRY(inode->link_inode(*MUST(ProcROProcessInode::create_new(process, &Process::proc_cmdline, fs, 0444)), "cmdline"_sv));
 		TRY(inode->link_inode(*MUST(ProcROProcessInode::create_new(process, &Process::proc_environ, fs, 0400)), "environ"_sv));
 		TRY(inode->link_inode(*MUST(ProcROProcessInode::create_new(process, &Process::proc_cputime, fs, 0444)), "cputime"_sv));
+		TRY(inode->link_inode(*MUST(ProcROProcessInode::create_new(process, &Process::proc_stat, fs, 0444)), "stat"_sv));
 		TRY(inode->link_inode(*MUST(ProcSymlinkProcessInode::create_new(process, &Process::proc_cwd, fs, 0777)), "cwd"_sv));
 		TRY(inode->link_inode(*MUST(ProcSymlinkProcessInode::create_new(process, &Process::proc_exe, fs, 0777)), "exe"_sv));
 		TRY(inode->link_inode(*MUST(ProcFDDirectoryInode::create_new(process, fs, 0500)), "fd"_sv));
+		TRY(inode->link_inode(*MUST(ProcTaskDirectoryInode::create_new(process, fs, 0555)), "task"_sv));
 
 		return inode;
 	}
@@ -41,9 +43,11 @@ namespace Kernel
 		(void)TmpDirectoryInode::unlink_impl("cmdline"_sv);
 		(void)TmpDirectoryInode::unlink_impl("environ"_sv);
 		(void)TmpDirectoryInode::unlink_impl("cputime"_sv);
+		(void)TmpDirectoryInode::unlink_impl("stat"_sv);
 		(void)TmpDirectoryInode::unlink_impl("cwd"_sv);
 		(void)TmpDirectoryInode::unlink_impl("exe"_sv);
 		(void)TmpDirectoryInode::unlink_impl("fd"_sv);
+		(void)TmpDirectoryInode::unlink_impl("task"_sv);
 	}
 
 	BAN::ErrorOr<BAN::RefPtr<ProcROProcessInode>> ProcROProcessInode::create_new(Process& process, size_t (Process::*callback)(off_t, BAN::ByteSpan) const, TmpFileSystem& fs, mode_t mode)
@@ -123,6 +127,39 @@ namespace Kernel
 		return TRY(m_callback(offset, buffer, m_argument));
 	}
 
+	BAN::ErrorOr<BAN::RefPtr<ProcRWInode>> ProcRWInode::create_new(read_callback_t read_callback, write_callback_t write_callback, TmpFileSystem& fs, void* argument, mode_t mode, uid_t uid, gid_t gid)
+	{
+		auto inode_info = create_inode_info(Mode::IFREG | mode, uid, gid);
+
+		auto* inode_ptr = new ProcRWInode(read_callback, write_callback, fs, argument, inode_info);
+		if (inode_ptr == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<ProcRWInode>::adopt(inode_ptr);
+	}
+
+	ProcRWInode::ProcRWInode(read_callback_t read_callback, write_callback_t write_callback, TmpFileSystem& fs, void* argument, const TmpInodeInfo& inode_info)
+		: TmpInode(fs, MUST(fs.allocate_inode(inode_info)), inode_info)
+		, m_read_callback(read_callback)
+		, m_write_callback(write_callback)
+		, m_argument(argument)
+	{
+		m_mode |= Inode::Mode::IFREG;
+	}
+
+	BAN::ErrorOr<size_t> ProcRWInode::read_impl(off_t offset, BAN::ByteSpan buffer)
+	{
+		if (offset < 0)
+			return BAN::Error::from_errno(EINVAL);
+		return TRY(m_read_callback(offset, buffer, m_argument));
+	}
+
+	BAN::ErrorOr<size_t> ProcRWInode::write_impl(off_t offset, BAN::ConstByteSpan buffer)
+	{
+		if (offset < 0)
+			return BAN::Error::from_errno(EINVAL);
+		return TRY(m_write_callback(offset, buffer, m_argument));
+	}
+
 	BAN::ErrorOr<BAN::RefPtr<ProcSymlinkInode>> ProcSymlinkInode::create_new(BAN::ErrorOr<BAN::String> (*callback)(void*), void (*destructor)(void*), void* data, TmpFileSystem& fs, mode_t mode, uid_t uid, gid_t gid)
 	{
 		auto inode_info = create_inode_info(Mode::IFLNK | mode, uid, gid);
@@ -180,7 +217,7 @@ namespace Kernel
 			if (!isdigit(ch))
 				return BAN::Error::from_errno(ENOENT);
 			fd = (fd * 10) + (ch - '0');
-			if (fd > OPEN_MAX)
+			if (fd > m_process.open_file_descriptor_set().get_max_open_fd())
 				return BAN::Error::from_errno(ENOENT);
 		}
 
@@ -217,7 +254,8 @@ namespace Kernel
 
 		auto& ofds = m_process.open_file_descriptor_set();
 
-		for (size_t fd = 0; fd < OPEN_MAX; fd++)
+		const int max_fd = ofds.get_max_open_fd();
+		for (int fd = 0; fd <= max_fd; fd++)
 		{
 			if (ofds.inode_of(fd).is_error())
 				continue;
@@ -244,4 +282,143 @@ namespace Kernel
 		return 0;
 	}
 
+	BAN::ErrorOr<BAN::RefPtr<ProcTaskDirectoryInode>> ProcTaskDirectoryInode::create_new(Process& process, TmpFileSystem& fs, mode_t mode)
+	{
+		auto inode_info = create_inode_info(Mode::IFDIR | mode, 0, 0);
+
+		auto* inode_ptr = new ProcTaskDirectoryInode(process, fs, inode_info);
+		if (inode_ptr == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<ProcTaskDirectoryInode>::adopt(inode_ptr);
+	}
+
+	ProcTaskDirectoryInode::ProcTaskDirectoryInode(Process& process, TmpFileSystem& fs, const TmpInodeInfo& inode_info)
+		: TmpInode(fs, MUST(fs.allocate_inode(inode_info)), inode_info)
+		, m_process(process)
+	{
+		m_uid = process.credentials().ruid();
+		m_gid = process.credentials().rgid();
+		ASSERT(mode().ifdir());
+	}
+
+	BAN::ErrorOr<BAN::RefPtr<Inode>> ProcTaskDirectoryInode::find_inode_impl(BAN::StringView name)
+	{
+		if (name.empty())
+			return BAN::Error::from_errno(ENOENT);
+
+		pid_t tid = 0;
+		for (char ch : name)
+		{
+			if (!isdigit(ch))
+				return BAN::Error::from_errno(ENOENT);
+			if (tid > (INT32_MAX - (ch - '0')) / 10)
+				return BAN::Error::from_errno(ENOENT);
+			tid = (tid * 10) + (ch - '0');
+		}
+
+		if (!m_process.has_thread(tid))
+			return BAN::Error::from_errno(ENOENT);
+
+		auto inode = TRY(ProcTidDirectoryInode::create_new(m_process, tid, m_fs, 0555));
+		return BAN::RefPtr<Inode>(BAN::move(inode));
+	}
+
+	BAN::ErrorOr<size_t> ProcTaskDirectoryInode::list_next_inodes_impl(off_t offset, struct dirent* list, size_t list_len)
+	{
+		if (list_len == 0)
+			return BAN::Error::from_errno(ENOBUFS);
+
+		const auto thread_ids = TRY(m_process.thread_ids());
+		if (offset < 0 || static_cast<size_t>(offset) >= thread_ids.size())
+			return 0;
+
+		list[0] = {
+			.d_ino = 0,
+			.d_type = DT_DIR,
+			.d_name = {},
+		};
+
+		size_t index = 0;
+		BAN::Formatter::print(
+			[&](char ch) {
+				list[0].d_name[index++] = ch;
+				list[0].d_name[index] = '\0';
+			}, "{}", thread_ids[offset]
+		);
+
+		return 1;
+	}
+
+	BAN::ErrorOr<BAN::RefPtr<ProcTidDirectoryInode>> ProcTidDirectoryInode::create_new(Process& process, pid_t tid, TmpFileSystem& fs, mode_t mode)
+	{
+		auto inode_info = create_inode_info(Mode::IFDIR | mode, 0, 0);
+
+		auto* inode_ptr = new ProcTidDirectoryInode(process, tid, fs, inode_info);
+		if (inode_ptr == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<ProcTidDirectoryInode>::adopt(inode_ptr);
+	}
+
+	ProcTidDirectoryInode::ProcTidDirectoryInode(Process& process, pid_t tid, TmpFileSystem& fs, const TmpInodeInfo& inode_info)
+		: TmpInode(fs, MUST(fs.allocate_inode(inode_info)), inode_info)
+		, m_process(process)
+		, m_tid(tid)
+	{
+		m_uid = process.credentials().ruid();
+		m_gid = process.credentials().rgid();
+		ASSERT(mode().ifdir());
+	}
+
+	BAN::ErrorOr<BAN::RefPtr<Inode>> ProcTidDirectoryInode::find_inode_impl(BAN::StringView name)
+	{
+		if (name != "stat"_sv)
+			return BAN::Error::from_errno(ENOENT);
+		auto inode = TRY(ProcROThreadInode::create_new(m_process, m_tid, &Process::proc_thread_stat, m_fs, 0444));
+		return BAN::RefPtr<Inode>(BAN::move(inode));
+	}
+
+	BAN::ErrorOr<size_t> ProcTidDirectoryInode::list_next_inodes_impl(off_t offset, struct dirent* list, size_t list_len)
+	{
+		if (list_len == 0)
+			return BAN::Error::from_errno(ENOBUFS);
+		if (offset != 0)
+			return 0;
+
+		list[0] = {
+			.d_ino = 0,
+			.d_type = DT_REG,
+			.d_name = "stat",
+		};
+
+		return 1;
+	}
+
+	BAN::ErrorOr<BAN::RefPtr<ProcROThreadInode>> ProcROThreadInode::create_new(Process& process, pid_t tid, size_t (Process::*callback)(pid_t, off_t, BAN::ByteSpan) const, TmpFileSystem& fs, mode_t mode)
+	{
+		auto inode_info = create_inode_info(Mode::IFREG | mode, 0, 0);
+
+		auto* inode_ptr = new ProcROThreadInode(process, tid, callback, fs, inode_info);
+		if (inode_ptr == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		return BAN::RefPtr<ProcROThreadInode>::adopt(inode_ptr);
+	}
+
+	ProcROThreadInode::ProcROThreadInode(Process& process, pid_t tid, size_t (Process::*callback)(pid_t, off_t, BAN::ByteSpan) const, TmpFileSystem& fs, const TmpInodeInfo& inode_info)
+		: TmpInode(fs, MUST(fs.allocate_inode(inode_info)), inode_info)
+		, m_process(process)
+		, m_tid(tid)
+		, m_callback(callback)
+	{
+		m_mode |= Inode::Mode::IFREG;
+		m_uid = process.credentials().ruid();
+		m_gid = process.credentials().rgid();
+	}
+
+	BAN::ErrorOr<size_t> ProcROThreadInode::read_impl(off_t offset, BAN::ByteSpan buffer)
+	{
+		if (offset < 0)
+			return BAN::Error::from_errno(EINVAL);
+		return (m_process.*m_callback)(m_tid, offset, buffer);
+	}
+
 }
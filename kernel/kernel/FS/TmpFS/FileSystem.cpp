@@ -33,27 +33,21 @@ namespace Kernel
 
 	BAN::ErrorOr<void> TmpFileSystem::initialize(mode_t mode, uid_t uid, gid_t gid)
 	{
-		paddr_t data_paddr = Heap::get().take_free_page();
+		paddr_t data_paddr = Heap::get().take_zeroed_page();
 		if (data_paddr == 0)
 			return BAN::Error::from_errno(ENOMEM);
 		m_used_pages++;
 
 		m_data_pages.set_paddr(data_paddr);
 		m_data_pages.set_flags(PageInfo::Flags::Present);
-		PageTable::with_fast_page(data_paddr, [&] {
-			memset(PageTable::fast_page_as_ptr(), 0x00, PAGE_SIZE);
-		});
 
-		paddr_t inodes_paddr = Heap::get().take_free_page();
+		paddr_t inodes_paddr = Heap::get().take_zeroed_page();
 		if (inodes_paddr == 0)
 			return BAN::Error::from_errno(ENOMEM);
 		m_used_pages++;
 
 		m_inode_pages.set_paddr(inodes_paddr);
 		m_inode_pages.set_flags(PageInfo::Flags::Present);
-		PageTable::with_fast_page(inodes_paddr, [&] {
-			memset(PageTable::fast_page_as_ptr(), 0x00, PAGE_SIZE);
-		});
 
 		m_root_inode = TRY(TmpDirectoryInode::create_root(*this, mode, uid, gid));
 
@@ -76,8 +70,8 @@ namespace Kernel
 		TmpInodeInfo inode_info;
 
 		auto inode_location = find_inode(ino);
-		PageTable::with_fast_page(inode_location.paddr, [&] {
-			inode_info = PageTable::fast_page_as_sized<TmpInodeInfo>(inode_location.index);
+		PageTable::with_physical_page(inode_location.paddr, [&](void* page) {
+			inode_info = static_cast<TmpInodeInfo*>(page)[inode_location.index];
 		});
 
 		auto inode = TRY(TmpInode::create_from_existing(*this, ino, inode_info));
@@ -107,8 +101,8 @@ namespace Kernel
 		LockGuard _(m_mutex);
 
 		const auto inode_location = find_inode(ino);
-		PageTable::with_fast_page(inode_location.paddr, [&] {
-			out = PageTable::fast_page_as_sized<TmpInodeInfo>(inode_location.index);
+		PageTable::with_physical_page(inode_location.paddr, [&](void* page) {
+			out = static_cast<TmpInodeInfo*>(page)[inode_location.index];
 		});
 	}
 
@@ -117,8 +111,8 @@ namespace Kernel
 		LockGuard _(m_mutex);
 
 		const auto inode_location = find_inode(ino);
-		PageTable::with_fast_page(inode_location.paddr, [&] {
-			auto& inode_info = PageTable::fast_page_as_sized<TmpInodeInfo>(inode_location.index);
+		PageTable::with_physical_page(inode_location.paddr, [&](void* page) {
+			auto& inode_info = static_cast<TmpInodeInfo*>(page)[inode_location.index];
 			inode_info = info;
 		});
 	}
@@ -128,8 +122,8 @@ namespace Kernel
 		LockGuard _(m_mutex);
 
 		const auto inode_location = find_inode(ino);
-		PageTable::with_fast_page(inode_location.paddr, [&] {
-			auto& inode_info = PageTable::fast_page_as_sized<TmpInodeInfo>(inode_location.index);
+		PageTable::with_physical_page(inode_location.paddr, [&](void* page) {
+			auto& inode_info = static_cast<TmpInodeInfo*>(page)[inode_location.index];
 			ASSERT(inode_info.nlink == 0);
 			for (auto paddr : inode_info.tmp_blocks.block)
 				ASSERT(paddr == 0);
@@ -149,22 +143,19 @@ namespace Kernel
 		for (size_t layer0_index = 0; layer0_index < page_infos_per_page; layer0_index++)
 		{
 			PageInfo layer0_page;
-			PageTable::with_fast_page(m_inode_pages.paddr(), [&] {
-				layer0_page = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+			PageTable::with_physical_page(m_inode_pages.paddr(), [&](void* page) {
+				layer0_page = static_cast<PageInfo*>(page)[layer0_index];
 			});
 
 			if (!(layer0_page.flags() & PageInfo::Flags::Present))
 			{
 				if (m_used_pages >= m_max_pages)
 					return BAN::Error::from_errno(ENOSPC);
-				const paddr_t paddr = Heap::get().take_free_page();
+				const paddr_t paddr = Heap::get().take_zeroed_page();
 				if (paddr == 0)
 					return BAN::Error::from_errno(ENOMEM);
-				PageTable::with_fast_page(paddr, [&] {
-					memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-				});
-				PageTable::with_fast_page(m_inode_pages.paddr(), [&] {
-					auto& page_info = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+				PageTable::with_physical_page(m_inode_pages.paddr(), [&](void* page) {
+					auto& page_info = static_cast<PageInfo*>(page)[layer0_index];
 					page_info.set_paddr(paddr);
 					page_info.set_flags(PageInfo::Flags::Present);
 					layer0_page = page_info;
@@ -175,22 +166,19 @@ namespace Kernel
 			for (size_t layer1_index = 0; layer1_index < page_infos_per_page; layer1_index++)
 			{
 				PageInfo layer1_page;
-				PageTable::with_fast_page(layer0_page.paddr(), [&] {
-					layer1_page = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+				PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+					layer1_page = static_cast<PageInfo*>(page)[layer1_index];
 				});
 
 				if (!(layer1_page.flags() & PageInfo::Flags::Present))
 				{
 					if (m_used_pages >= m_max_pages)
 						return BAN::Error::from_errno(ENOSPC);
-					const paddr_t paddr = Heap::get().take_free_page();
+					const paddr_t paddr = Heap::get().take_zeroed_page();
 					if (paddr == 0)
 						return BAN::Error::from_errno(ENOMEM);
-					PageTable::with_fast_page(paddr, [&] {
-						memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-					});
-					PageTable::with_fast_page(layer0_page.paddr(), [&] {
-						auto& page_info = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+					PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+						auto& page_info = static_cast<PageInfo*>(page)[layer1_index];
 						page_info.set_paddr(paddr);
 						page_info.set_flags(PageInfo::Flags::Present);
 						layer1_page = page_info;
@@ -200,10 +188,10 @@ namespace Kernel
 
 				size_t layer2_index = SIZE_MAX;
 
-				PageTable::with_fast_page(layer1_page.paddr(), [&] {
+				PageTable::with_physical_page(layer1_page.paddr(), [&](void* page) {
 					for (size_t i = 0; i < PAGE_SIZE / sizeof(TmpInodeInfo); i++)
 					{
-						auto& inode_info = PageTable::fast_page_as_sized<TmpInodeInfo>(i);
+						auto& inode_info = static_cast<TmpInodeInfo*>(page)[i];
 						if (inode_info.mode != 0)
 							continue;
 						inode_info = info;
@@ -240,14 +228,14 @@ namespace Kernel
 		ASSERT(layer0_index < page_infos_per_page);
 
 		PageInfo layer0_page;
-		PageTable::with_fast_page(m_inode_pages.paddr(), [&] {
-			layer0_page = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+		PageTable::with_physical_page(m_inode_pages.paddr(), [&](void* page) {
+			layer0_page = static_cast<PageInfo*>(page)[layer0_index];
 		});
 		ASSERT(layer0_page.flags() & PageInfo::Flags::Present);
 
 		PageInfo layer1_page;
-		PageTable::with_fast_page(layer0_page.paddr(), [&] {
-			layer1_page = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+		PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+			layer1_page = static_cast<PageInfo*>(page)[layer1_index];
 		});
 		ASSERT(layer1_page.flags() & PageInfo::Flags::Present);
 
@@ -271,26 +259,26 @@ namespace Kernel
 		ASSERT(layer0_index < page_infos_per_page);
 
 		PageInfo layer0_page;
-		PageTable::with_fast_page(m_data_pages.paddr(), [&] {
-			layer0_page = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+		PageTable::with_physical_page(m_data_pages.paddr(), [&](void* page) {
+			layer0_page = static_cast<PageInfo*>(page)[layer0_index];
 		});
 		ASSERT(layer0_page.flags() & PageInfo::Flags::Present);
 
 		PageInfo layer1_page;
-		PageTable::with_fast_page(layer0_page.paddr(), [&] {
-			layer1_page = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+		PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+			layer1_page = static_cast<PageInfo*>(page)[layer1_index];
 		});
 		ASSERT(layer1_page.flags() & PageInfo::Flags::Present);
 
 		paddr_t page_to_free;
-		PageTable::with_fast_page(layer1_page.paddr(), [&] {
+		PageTable::with_physical_page(layer1_page.paddr(), [&](void* page) {
 			static_assert(sizeof(size_t) <= sizeof(PageInfo));
 
-			auto& allocated_pages = PageTable::fast_page_as<size_t>(PAGE_SIZE - sizeof(size_t));
+			auto& allocated_pages = static_cast<size_t*>(page)[PAGE_SIZE / sizeof(size_t) - 1];
 			ASSERT(allocated_pages > 0);
 			allocated_pages--;
 
-			auto& page_info = PageTable::fast_page_as_sized<PageInfo>(layer2_index);
+			auto& page_info = static_cast<PageInfo*>(page)[layer2_index];
 			ASSERT(page_info.flags() & PageInfo::Flags::Present);
 			page_to_free = page_info.paddr();
 			page_info.set_paddr(0);
@@ -314,20 +302,20 @@ namespace Kernel
 		ASSERT(layer0_index < page_infos_per_page);
 
 		PageInfo layer0_page;
-		PageTable::with_fast_page(m_data_pages.paddr(), [&] {
-			layer0_page = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+		PageTable::with_physical_page(m_data_pages.paddr(), [&](void* page) {
+			layer0_page = static_cast<PageInfo*>(page)[layer0_index];
 		});
 		ASSERT(layer0_page.flags() & PageInfo::Flags::Present);
 
 		PageInfo layer1_page;
-		PageTable::with_fast_page(layer0_page.paddr(), [&] {
-			layer1_page = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+		PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+			layer1_page = static_cast<PageInfo*>(page)[layer1_index];
 		});
 		ASSERT(layer1_page.flags() & PageInfo::Flags::Present);
 
 		PageInfo layer2_page;
-		PageTable::with_fast_page(layer1_page.paddr(), [&] {
-			layer2_page = PageTable::fast_page_as_sized<PageInfo>(layer2_index);
+		PageTable::with_physical_page(layer1_page.paddr(), [&](void* page) {
+			layer2_page = static_cast<PageInfo*>(page)[layer2_index];
 		});
 		ASSERT(layer2_page.flags() & PageInfo::Flags::Present);
 
@@ -341,12 +329,9 @@ namespace Kernel
 		if (m_used_pages >= m_max_pages)
 			return BAN::Error::from_errno(ENOSPC);
 
-		const paddr_t new_block = Heap::get().take_free_page();
+		const paddr_t new_block = Heap::get().take_zeroed_page();
 		if (new_block == 0)
 			return BAN::Error::from_errno(ENOMEM);
-		PageTable::with_fast_page(new_block, [] {
-			memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-		});
 		BAN::ScopeGuard block_deleter([new_block] { Heap::get().release_page(new_block); });
 
 		constexpr size_t page_infos_per_page = PAGE_SIZE / sizeof(PageInfo);
@@ -354,22 +339,19 @@ namespace Kernel
 		for (size_t layer0_index = 0; layer0_index < PAGE_SIZE / sizeof(PageInfo); layer0_index++)
 		{
 			PageInfo layer0_page;
-			PageTable::with_fast_page(m_data_pages.paddr(), [&] {
-				layer0_page = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+			PageTable::with_physical_page(m_data_pages.paddr(), [&](void* page) {
+				layer0_page = static_cast<PageInfo*>(page)[layer0_index];
 			});
 
 			if (!(layer0_page.flags() & PageInfo::Flags::Present))
 			{
 				if (m_used_pages + 1 >= m_max_pages)
 					return BAN::Error::from_errno(ENOSPC);
-				const paddr_t paddr = Heap::get().take_free_page();
+				const paddr_t paddr = Heap::get().take_zeroed_page();
 				if (paddr == 0)
 					return BAN::Error::from_errno(ENOMEM);
-				PageTable::with_fast_page(paddr, [&] {
-					memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-				});
-				PageTable::with_fast_page(m_data_pages.paddr(), [&] {
-					auto& page_info = PageTable::fast_page_as_sized<PageInfo>(layer0_index);
+				PageTable::with_physical_page(m_data_pages.paddr(), [&](void* page) {
+					auto& page_info = static_cast<PageInfo*>(page)[layer0_index];
 					page_info.set_paddr(paddr);
 					page_info.set_flags(PageInfo::Flags::Present);
 					layer0_page = page_info;
@@ -380,22 +362,19 @@ namespace Kernel
 			for (size_t layer1_index = 0; layer1_index < PAGE_SIZE / sizeof(PageInfo); layer1_index++)
 			{
 				PageInfo layer1_page;
-				PageTable::with_fast_page(layer0_page.paddr(), [&] {
-					layer1_page = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+				PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+					layer1_page = static_cast<PageInfo*>(page)[layer1_index];
 				});
 
 				if (!(layer1_page.flags() & PageInfo::Flags::Present))
 				{
 					if (m_used_pages + 1 >= m_max_pages)
 						return BAN::Error::from_errno(ENOSPC);
-					const paddr_t paddr = Heap::get().take_free_page();
+					const paddr_t paddr = Heap::get().take_zeroed_page();
 					if (paddr == 0)
 						return BAN::Error::from_errno(ENOMEM);
-					PageTable::with_fast_page(paddr, [&] {
-						memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-					});
-					PageTable::with_fast_page(layer0_page.paddr(), [&] {
-						auto& page_info = PageTable::fast_page_as_sized<PageInfo>(layer1_index);
+					PageTable::with_physical_page(layer0_page.paddr(), [&](void* page) {
+						auto& page_info = static_cast<PageInfo*>(page)[layer1_index];
 						page_info.set_paddr(paddr);
 						page_info.set_flags(PageInfo::Flags::Present);
 						layer1_page = page_info;
@@ -405,17 +384,17 @@ namespace Kernel
 
 				size_t layer2_index = SIZE_MAX;
 
-				PageTable::with_fast_page(layer1_page.paddr(), [&] {
+				PageTable::with_physical_page(layer1_page.paddr(), [&](void* page) {
 					constexpr size_t pages_per_block = page_infos_per_page - 1;
 					static_assert(sizeof(size_t) <= sizeof(PageInfo));
 
-					auto& allocated_pages = PageTable::fast_page_as<size_t>(PAGE_SIZE - sizeof(size_t));
+					auto& allocated_pages = static_cast<size_t*>(page)[PAGE_SIZE / sizeof(size_t) - 1];
 					if (allocated_pages == pages_per_block)
 						return;
 
 					for (size_t i = 0; i < pages_per_block; i++)
 					{
-						auto& page_info = PageTable::fast_page_as_sized<PageInfo>(i);
+						auto& page_info = static_cast<PageInfo*>(page)[i];
 						if (page_info.flags() & PageInfo::Flags::Present)
 							continue;
 						page_info.set_paddr(new_block);
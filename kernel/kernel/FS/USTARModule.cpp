@@ -69,8 +69,8 @@ namespace Kernel
 					sizeof(m_data_buffer) - m_data_size,
 					PAGE_SIZE - (m_offset % PAGE_SIZE)
 				);
-				PageTable::with_fast_page((m_module.start + m_offset) & PAGE_ADDR_MASK, [&] {
-					memcpy(m_data_buffer + m_data_size, PageTable::fast_page_as_ptr(m_offset % PAGE_SIZE), to_copy);
+				PageTable::with_physical_page((m_module.start + m_offset) & PAGE_ADDR_MASK, [&](void* page) {
+					memcpy(m_data_buffer + m_data_size, static_cast<uint8_t*>(page) + m_offset % PAGE_SIZE, to_copy);
 				});
 				m_data_size += to_copy;
 				m_offset += to_copy;
@@ -0,0 +1,264 @@
+#include <BAN/Atomic.h>
+#include <kernel/Futex.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/LockStats.h>
+#include <kernel/Thread.h>
+#include <kernel/ThreadBlocker.h>
+
+#include <sys/futex.h>
+
+namespace Kernel
+{
+
+	struct FutexBucket;
+
+	struct FutexWaiter
+	{
+		Futex::Key key;
+		uint32_t bitset;
+
+		// changes only when requeued, with both the old and the new bucket locked
+		BAN::Atomic<FutexBucket*> bucket;
+
+		// protected by bucket's lock
+		bool woken { false };
+		FutexWaiter* prev { nullptr };
+		FutexWaiter* next { nullptr };
+
+		ThreadBlocker blocker;
+	};
+
+	static LockClass s_futex_bucket_lock_class { "futex_bucket" };
+
+	struct FutexBucket
+	{
+		Mutex mutex { s_futex_bucket_lock_class };
+		FutexWaiter* head { nullptr };
+		FutexWaiter* tail { nullptr };
+
+		void append(FutexWaiter& waiter)
+		{
+			waiter.prev = tail;
+			waiter.next = nullptr;
+			(tail ? tail->next : head) = &waiter;
+			tail = &waiter;
+		}
+
+		void remove(FutexWaiter& waiter)
+		{
+			(waiter.prev ? waiter.prev->next : head) = waiter.next;
+			(waiter.next ? waiter.next->prev : tail) = waiter.prev;
+			waiter.prev = nullptr;
+			waiter.next = nullptr;
+		}
+	};
+
+	static constexpr size_t s_bucket_count = 256;
+	static FutexBucket s_buckets[s_bucket_count];
+
+	static FutexBucket& bucket_of(const Futex::Key& key)
+	{
+		uint64_t hash = (key.paddr / sizeof(uint32_t)) ^ (reinterpret_cast<uintptr_t>(key.owner) / 16);
+		hash *= 0x9E3779B97F4A7C15;
+		return s_buckets[hash >> (64 - BAN::Math::ilog2(s_bucket_count))];
+	}
+
+	static void lock_buckets(FutexBucket& bucket1, FutexBucket& bucket2)
+	{
+		if (&bucket1 == &bucket2)
+			bucket1.mutex.lock();
+		else if (&bucket1 < &bucket2)
+		{
+			bucket1.mutex.lock();
+			bucket2.mutex.lock();
+		}
+		else
+		{
+			bucket2.mutex.lock();
+			bucket1.mutex.lock();
+		}
+	}
+
+	static void unlock_buckets(FutexBucket& bucket1, FutexBucket& bucket2)
+	{
+		bucket1.mutex.unlock();
+		if (&bucket1 != &bucket2)
+			bucket2.mutex.unlock();
+	}
+
+	// Locks the bucket the waiter is currently queued in
+	static FutexBucket& lock_waiter_bucket(FutexWaiter& waiter)
+	{
+		for (;;)
+		{
+			auto* bucket = waiter.bucket.load();
+			bucket->mutex.lock();
+			if (waiter.bucket.load() == bucket)
+				return *bucket;
+			bucket->mutex.unlock();
+		}
+	}
+
+	// You must hold bucket's lock when calling this
+	static size_t wake_in_bucket(FutexBucket& bucket, const Futex::Key& key, uint32_t count, uint32_t bitset)
+	{
+		size_t woken = 0;
+		for (auto* waiter = bucket.head; waiter && woken < count;)
+		{
+			auto* next = waiter->next;
+			if (waiter->key == key && (waiter->bitset & bitset))
+			{
+				bucket.remove(*waiter);
+				// NOTE: waiter can't return before it has locked this bucket
+				waiter->woken = true;
+				waiter->blocker.unblock();
+				woken++;
+			}
+			waiter = next;
+		}
+		return woken;
+	}
+
+	BAN::ErrorOr<void> Futex::wait(Key key, const uint32_t* addr, uint32_t value, uint32_t bitset, uint64_t wake_time_ns)
+	{
+		FutexWaiter waiter {
+			.key = key,
+			.bitset = bitset,
+			.bucket = &bucket_of(key),
+		};
+
+		auto* bucket = waiter.bucket.load();
+		bucket->mutex.lock();
+
+		if (BAN::atomic_load(*addr) != value)
+		{
+			bucket->mutex.unlock();
+			return BAN::Error::from_errno(EAGAIN);
+		}
+
+		bucket->append(waiter);
+
+		for (;;)
+		{
+			auto ret = Thread::current().block_or_eintr_or_waketime_ns(waiter.blocker, wake_time_ns, true, &bucket->mutex);
+
+			// we may have been requeued while blocking
+			bucket->mutex.unlock();
+			bucket = &lock_waiter_bucket(waiter);
+
+			if (waiter.woken)
+			{
+				bucket->mutex.unlock();
+				return {};
+			}
+
+			if (ret.is_error())
+			{
+				bucket->remove(waiter);
+				bucket->mutex.unlock();
+				return ret.release_error();
+			}
+		}
+	}
+
+	size_t Futex::wake(Key key, uint32_t count, uint32_t bitset)
+	{
+		auto& bucket = bucket_of(key);
+		LockGuard _(bucket.mutex);
+		return wake_in_bucket(bucket, key, count, bitset);
+	}
+
+	BAN::ErrorOr<size_t> Futex::requeue(Key key, const uint32_t* addr, Key target, uint32_t wake_count, uint32_t requeue_count, BAN::Optional<uint32_t> compare_value)
+	{
+		auto& bucket = bucket_of(key);
+		auto& target_bucket = bucket_of(target);
+
+		lock_buckets(bucket, target_bucket);
+
+		if (compare_value.has_value() && BAN::atomic_load(*addr) != compare_value.value())
+		{
+			unlock_buckets(bucket, target_bucket);
+			return BAN::Error::from_errno(EAGAIN);
+		}
+
+		const size_t woken = wake_in_bucket(bucket, key, wake_count, FUTEX_BITSET_MATCH_ANY);
+
+		size_t requeued = 0;
+		for (auto* waiter = bucket.head; waiter && requeued < requeue_count;)
+		{
+			auto* next = waiter->next;
+			if (waiter->key == key)
+			{
+				bucket.remove(*waiter);
+				waiter->key = target;
+				waiter->bucket.store(&target_bucket);
+				target_bucket.append(*waiter);
+				requeued++;
+			}
+			waiter = next;
+		}
+
+		unlock_buckets(bucket, target_bucket);
+
+		return woken + requeued;
+	}
+
+	BAN::ErrorOr<size_t> Futex::wake_op(Key key, Key key2, uint32_t* addr2, uint32_t wake_count, uint32_t wake_count2, uint32_t operation)
+	{
+		const uint32_t op = (operation >> 28) & 0x7;
+		const uint32_t cmp = (operation >> 24) & 0xF;
+		int32_t oparg  = static_cast<int32_t>(operation <<  8) >> 20;
+		int32_t cmparg = static_cast<int32_t>(operation << 20) >> 20;
+
+		if (operation & (FUTEX_OP_OPARG_SHIFT << 28))
+		{
+			if (oparg < 0 || oparg > 31)
+				return BAN::Error::from_errno(EINVAL);
+			oparg = 1u << oparg;
+		}
+
+		if (op > FUTEX_OP_XOR || cmp > FUTEX_OP_CMP_GE)
+			return BAN::Error::from_errno(ENOSYS);
+
+		auto& bucket = bucket_of(key);
+		auto& bucket2 = bucket_of(key2);
+
+		lock_buckets(bucket, bucket2);
+
+		uint32_t old_value = BAN::atomic_load(*addr2);
+		for (;;)
+		{
+			uint32_t new_value = 0;
+			switch (op)
+			{
+				case FUTEX_OP_SET:  new_value = oparg;              break;
+				case FUTEX_OP_ADD:  new_value = old_value + oparg;  break;
+				case FUTEX_OP_OR:   new_value = old_value | oparg;  break;
+				case FUTEX_OP_ANDN: new_value = old_value & ~oparg; break;
+				case FUTEX_OP_XOR:  new_value = old_value ^ oparg;  break;
+			}
+			if (BAN::atomic_compare_exchange(*addr2, old_value, new_value))
+				break;
+		}
+
+		bool wake2 = false;
+		switch (cmp)
+		{
+			case FUTEX_OP_CMP_EQ: wake2 = static_cast<int32_t>(old_value) == cmparg; break;
+			case FUTEX_OP_CMP_NE: wake2 = static_cast<int32_t>(old_value) != cmparg; break;
+			case FUTEX_OP_CMP_LT: wake2 = static_cast<int32_t>(old_value) <  cmparg; break;
+			case FUTEX_OP_CMP_LE: wake2 = static_cast<int32_t>(old_value) <= cmparg; break;
+			case FUTEX_OP_CMP_GT: wake2 = static_cast<int32_t>(old_value) >  cmparg; break;
+			case FUTEX_OP_CMP_GE: wake2 = static_cast<int32_t>(old_value) >= cmparg; break;
+		}
+
+		size_t woken = wake_in_bucket(bucket, key, wake_count, FUTEX_BITSET_MATCH_ANY);
+		if (wake2)
+			woken += wake_in_bucket(bucket2, key2, wake_count2, FUTEX_BITSET_MATCH_ANY);
+
+		unlock_buckets(bucket, bucket2);
+
+		return woken;
+	}
+
+}
@@ -1,15 +1,19 @@
 #include <BAN/Array.h>
 #include <BAN/Errors.h>
+#include <kernel/Device/ProfilerDevice.h>
 #include <kernel/GDT.h>
 #include <kernel/IDT.h>
 #include <kernel/InterruptController.h>
 #include <kernel/InterruptNumbers.h>
 #include <kernel/InterruptStack.h>
+#include <kernel/IRQAffinity.h>
 #include <kernel/Memory/kmalloc.h>
 #include <kernel/Panic.h>
 #include <kernel/Process.h>
+#include <kernel/Random.h>
 #include <kernel/Scheduler.h>
 #include <kernel/Timer/PIT.h>
+#include <kernel/Tracepoint.h>
 
 #define ISR_LIST_X X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) X(31)
 #define IRQ_LIST_X  X(  0) X(  1) X(  2) X(  3) X(  4) X(  5) X(  6) X(  7) X(  8) X(  9) X( 10) X( 11) X( 12) X( 13) X( 14) X( 15) X( 16) X( 17) X( 18) X( 19) X( 20) X( 21) X( 22) X( 23) X( 24) X( 25) X( 26) X( 27) X( 28) X( 29) X( 30) X( 31) \
@@ -164,22 +168,35 @@ namespace Kernel
 	extern "C" uint8_t safe_user_strncpy_end[];
 	extern "C" uint8_t safe_user_strncpy_fault[];
 
+	extern "C" uint8_t safe_user_memcpy_no_paging[];
+	extern "C" uint8_t safe_user_memcpy_no_paging_end[];
+	extern "C" uint8_t safe_user_memcpy_no_paging_fault[];
+
 	struct safe_user_page_fault
 	{
 		const uint8_t* ip_start;
 		const uint8_t* ip_end;
 		const uint8_t* ip_fault;
+		bool demand_paging;
 	};
 	static constexpr safe_user_page_fault s_safe_user_page_faults[] {
 		{
 			.ip_start = safe_user_memcpy,
 			.ip_end   = safe_user_memcpy_end,
 			.ip_fault = safe_user_memcpy_fault,
+			.demand_paging = true,
 		},
 		{
 			.ip_start = safe_user_strncpy,
 			.ip_end   = safe_user_strncpy_end,
 			.ip_fault = safe_user_strncpy_fault,
+			.demand_paging = true,
+		},
+		{
+			.ip_start = safe_user_memcpy_no_paging,
+			.ip_end   = safe_user_memcpy_no_paging_end,
+			.ip_fault = safe_user_memcpy_no_paging_fault,
+			.demand_paging = false,
 		},
 	};
 
@@ -210,8 +227,10 @@ namespace Kernel
 
 				const uint8_t* ip = reinterpret_cast<const uint8_t*>(interrupt_stack->ip);
 
-				if (!g_safe_user_alloc_nonexisting) for (const auto& safe_user : s_safe_user_page_faults)
+				for (const auto& safe_user : s_safe_user_page_faults)
 				{
+					if (g_safe_user_alloc_nonexisting && safe_user.demand_paging)
+						continue;
 					if (ip < safe_user.ip_start || ip >= safe_user.ip_end)
 						continue;
 					interrupt_stack->ip = reinterpret_cast<vaddr_t>(safe_user.ip_fault);
@@ -221,6 +240,8 @@ namespace Kernel
 				uintptr_t cr2;
 				asm volatile("mov %%cr2, %0" : "=r"(cr2));
 
+				TRACEPOINT(PageFault, cr2, error, interrupt_stack->ip);
+
 				Processor::set_interrupt_state(InterruptState::Enabled);
 				auto result = Process::current().allocate_page_for_demand_paging(cr2, page_fault_error.write, page_fault_error.instruction);
 				Processor::set_interrupt_state(InterruptState::Disabled);
@@ -425,7 +446,7 @@ namespace Kernel
 		Processor::scheduler().reschedule_if_needed();
 	}
 
-	extern "C" void cpp_timer_handler()
+	extern "C" void cpp_timer_handler(const InterruptStack* interrupt_stack, const InterruptRegisters* interrupt_registers)
 	{
 		if (g_paniced)
 		{
@@ -438,9 +459,14 @@ namespace Kernel
 		if (!InterruptController::get().is_in_service(IRQ_TIMER - IRQ_VECTOR_BASE))
 			return;
 
+		TRACEPOINT(IRQEntry, IRQ_TIMER - IRQ_VECTOR_BASE);
+
 		if (Processor::current_is_bsp())
 			Process::update_alarm_queue();
 
+		if (ProfilerDevice::is_active())
+			ProfilerDevice::on_timer_interrupt(*interrupt_stack, *interrupt_registers);
+
 		Processor::scheduler().on_timer_interrupt();
 
 		InterruptController::get().eoi(IRQ_TIMER - IRQ_VECTOR_BASE);
@@ -463,6 +489,11 @@ namespace Kernel
 		if (!InterruptController::get().is_in_service(irq))
 			return;
 
+		TRACEPOINT(IRQEntry, irq);
+
+		Random::add_interrupt_entropy(irq);
+		IRQAffinity::on_irq(irq);
+
 		if (auto* handler = s_interruptables[irq])
 			handler->handle_irq();
 		else
@@ -0,0 +1,419 @@
+#include <BAN/ScopeGuard.h>
+#include <kernel/IORing.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Process.h>
+#include <kernel/Timer/Timer.h>
+#include <kernel/UserCopy.h>
+
+#include <poll.h>
+
+namespace Kernel
+{
+
+	BAN::ErrorOr<BAN::RefPtr<IORing>> IORing::create(uint32_t entries, vaddr_t user_shared, uint64_t address_space_id)
+	{
+		ASSERT(entries && (entries & (entries - 1)) == 0);
+		auto epoll = TRY(Epoll::create());
+		auto* ioring_ptr = new IORing(entries, user_shared, address_space_id, BAN::move(epoll));
+		if (ioring_ptr == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		auto ioring = BAN::RefPtr<IORing>::adopt(ioring_ptr);
+		TRY(ioring->m_pending.reserve(ioring->m_cq_entries));
+		return ioring;
+	}
+
+	IORing::IORing(uint32_t entries, vaddr_t user_shared, uint64_t address_space_id, BAN::RefPtr<Epoll> epoll)
+		: m_epoll(BAN::move(epoll))
+		, m_user_shared(user_shared)
+		, m_address_space_id(address_space_id)
+		, m_sq_entries(entries)
+		, m_cq_entries(entries * 2)
+	{
+		m_ino = 0;
+		m_mode = Mode::IRUSR | Mode::IWUSR;
+		m_nlink = 0;
+		m_uid = 0;
+		m_gid = 0;
+		m_size = 0;
+		m_atime = {};
+		m_mtime = {};
+		m_ctime = {};
+		m_blksize = PAGE_SIZE;
+		m_blocks = 0;
+		m_dev = 0;
+		m_rdev = 0;
+		m_kind = InodeKind::IORING;
+	}
+
+	BAN::ErrorOr<uint64_t> IORing::timeout_to_waketime_ns(const timespec& timeout)
+	{
+		if (timeout.tv_sec < 0 || timeout.tv_nsec < 0 || timeout.tv_nsec >= 1'000'000'000)
+			return BAN::Error::from_errno(EINVAL);
+
+		const uint64_t current_ns = SystemTimer::get().ns_since_boot();
+		if (BAN::Math::will_multiplication_overflow<uint64_t>(timeout.tv_sec, 1'000'000'000))
+			return BAN::numeric_limits<uint64_t>::max();
+		if (BAN::Math::will_addition_overflow<uint64_t>(timeout.tv_sec * 1'000'000'000, timeout.tv_nsec))
+			return BAN::numeric_limits<uint64_t>::max();
+		if (BAN::Math::will_addition_overflow<uint64_t>(timeout.tv_sec * 1'000'000'000 + timeout.tv_nsec, current_ns))
+			return BAN::numeric_limits<uint64_t>::max();
+		return timeout.tv_sec * 1'000'000'000 + timeout.tv_nsec + current_ns;
+	}
+
+	BAN::ErrorOr<size_t> IORing::enter(Process& process, uint32_t to_submit, uint32_t min_complete, const timespec* timeout)
+	{
+		// NOTE: the shared ring is addressed through a user pointer which only refers to the
+		//       ring in the address space it was created in. After exec or in a forked child
+		//       the same address may be unmapped or belong to unrelated memory.
+		if (process.address_space_id() != m_address_space_id)
+			return BAN::Error::from_errno(EBADF);
+
+		const uint64_t waketime_ns = timeout
+			? TRY(timeout_to_waketime_ns(*timeout))
+			: BAN::numeric_limits<uint64_t>::max();
+
+		LockGuard _(m_mutex);
+
+		uint32_t sq_tail;
+		TRY(read_from_user(&shared()->sq_tail, &sq_tail, sizeof(uint32_t)));
+		if (sq_tail - m_sq_head > m_sq_entries)
+			return BAN::Error::from_errno(EINVAL);
+		to_submit = BAN::Math::min(to_submit, sq_tail - m_sq_head);
+
+		uint32_t submitted = 0;
+		BAN::Optional<BAN::Error> submit_error;
+		while (submitted < to_submit)
+		{
+			// every submitted operation must have space for its completion
+			auto completions = completions_available();
+			if (completions.is_error())
+			{
+				submit_error = completions.release_error();
+				break;
+			}
+			if (m_pending.size() + completions.value() >= m_cq_entries)
+				break;
+
+			ioring_sqe sqe;
+			if (auto ret = read_from_user(&sqes()[m_sq_head & (m_sq_entries - 1)], &sqe, sizeof(ioring_sqe)); ret.is_error())
+			{
+				submit_error = ret.release_error();
+				break;
+			}
+			m_sq_head++;
+			submitted++;
+
+			if (auto ret = submit(process, sqe); ret.is_error())
+			{
+				submit_error = ret.release_error();
+				break;
+			}
+		}
+
+		// NOTE: consumed entries must be published even if a later submission failed,
+		//       otherwise userspace would submit them again on the next enter
+		TRY(write_to_user(&shared()->sq_head, &m_sq_head, sizeof(uint32_t)));
+
+		if (submit_error.has_value())
+		{
+			if (submitted == 0)
+				return submit_error.release_value();
+			return submitted;
+		}
+
+		if (to_submit > 0 && submitted == 0)
+			return BAN::Error::from_errno(EBUSY);
+
+		for (;;)
+		{
+			TRY(process_pending(process));
+
+			if (TRY(completions_available()) >= min_complete)
+				break;
+			if (m_pending.empty())
+				break;
+
+			const uint64_t current_ns = SystemTimer::get().ns_since_boot();
+			if (current_ns >= waketime_ns)
+				break;
+
+			uint64_t wait_until_ns = waketime_ns;
+			for (const auto& operation : m_pending)
+				if (operation.sqe.opcode == IORING_OP_TIMEOUT)
+					wait_until_ns = BAN::Math::min(wait_until_ns, operation.waketime_ns);
+
+			epoll_event events[16];
+			auto ret = m_epoll->wait(BAN::Span<epoll_event>(events, 16), wait_until_ns);
+			if (ret.is_error())
+			{
+				if (submitted > 0)
+					break;
+				return ret.release_error();
+			}
+		}
+
+		return submitted;
+	}
+
+	BAN::ErrorOr<void> IORing::submit(Process& process, const ioring_sqe& sqe)
+	{
+		if (sqe.opcode == IORING_OP_TIMEOUT)
+		{
+			timespec timeout;
+			if (auto ret = read_from_user(reinterpret_cast<const void*>(sqe.addr), &timeout, sizeof(timespec)); ret.is_error())
+				return post_completion(sqe.user_data, -static_cast<int32_t>(ret.error().get_error_code()));
+			auto waketime_ns = timeout_to_waketime_ns(timeout);
+			if (waketime_ns.is_error())
+				return post_completion(sqe.user_data, -static_cast<int32_t>(waketime_ns.error().get_error_code()));
+
+			MUST(m_pending.push_back({
+				.sqe = sqe,
+				.description = {},
+				.waketime_ns = waketime_ns.value(),
+				.epoll_key = -1,
+			}));
+
+			return {};
+		}
+
+		if (sqe.opcode > IORING_OP_POLL)
+			return post_completion(sqe.user_data, -EINVAL);
+
+		if (sqe.opcode == IORING_OP_NOP)
+			return post_completion(sqe.user_data, 0);
+
+		auto description_or_error = process.open_file_descriptor_set().get_description(sqe.fd);
+		if (description_or_error.is_error())
+			return post_completion(sqe.user_data, -static_cast<int32_t>(description_or_error.error().get_error_code()));
+		auto description = description_or_error.release_value();
+
+		if (auto result = try_execute(process, sqe, *description); result.has_value())
+			return post_completion(sqe.user_data, result.value());
+
+		uint32_t events = 0;
+		switch (sqe.opcode)
+		{
+			case IORING_OP_READ:
+			case IORING_OP_RECVMSG:
+			case IORING_OP_ACCEPT:
+				events = EPOLLIN;
+				break;
+			case IORING_OP_WRITE:
+			case IORING_OP_SENDMSG:
+				events = EPOLLOUT;
+				break;
+			case IORING_OP_POLL:
+				events = sqe.op_flags & (POLLIN | POLLOUT);
+				break;
+		}
+
+		const int epoll_key = m_next_epoll_key;
+		m_next_epoll_key = (m_next_epoll_key + 1) & BAN::numeric_limits<int>::max();
+
+		if (auto ret = m_epoll->ctl(EPOLL_CTL_ADD, epoll_key, description->file.inode, { .events = events, .data = { .fd = epoll_key } }); ret.is_error())
+			return post_completion(sqe.user_data, -static_cast<int32_t>(ret.error().get_error_code()));
+
+		MUST(m_pending.push_back({
+			.sqe = sqe,
+			.description = BAN::move(description),
+			.waketime_ns = 0,
+			.epoll_key = epoll_key,
+		}));
+
+		return {};
+	}
+
+	BAN::ErrorOr<void> IORing::process_pending(Process& process)
+	{
+		const uint64_t current_ns = SystemTimer::get().ns_since_boot();
+
+		for (size_t i = 0; i < m_pending.size();)
+		{
+			auto& operation = m_pending[i];
+
+			BAN::Optional<int32_t> result;
+			if (operation.sqe.opcode == IORING_OP_TIMEOUT)
+			{
+				if (current_ns >= operation.waketime_ns)
+					result = -ETIME;
+			}
+			else
+			{
+				result = try_execute(process, operation.sqe, *operation.description);
+			}
+
+			if (!result.has_value())
+			{
+				i++;
+				continue;
+			}
+
+			if (operation.description)
+				(void)m_epoll->ctl(EPOLL_CTL_DEL, operation.epoll_key, operation.description->file.inode, {});
+
+			const uint64_t user_data = operation.sqe.user_data;
+			m_pending.remove(i);
+
+			TRY(post_completion(user_data, result.value()));
+		}
+
+		return {};
+	}
+
+	BAN::Optional<int32_t> IORing::try_execute(Process& process, const ioring_sqe& sqe, OpenFileDescription& description)
+	{
+		auto& inode = *description.file.inode;
+
+		const bool ready_to_read  = inode.can_read()  || inode.has_error() || inode.has_hungup();
+		const bool ready_to_write = inode.can_write() || inode.has_error() || inode.has_hungup();
+
+		switch (sqe.opcode)
+		{
+			case IORING_OP_READ:
+			case IORING_OP_RECVMSG:
+			case IORING_OP_ACCEPT:
+				if (!ready_to_read)
+					return {};
+				break;
+			case IORING_OP_WRITE:
+			case IORING_OP_SENDMSG:
+				if (!ready_to_write)
+					return {};
+				break;
+			case IORING_OP_FSYNC:
+				break;
+			case IORING_OP_POLL:
+			{
+				int32_t revents = 0;
+				if ((sqe.op_flags & POLLIN) && inode.can_read())
+					revents |= POLLIN;
+				if ((sqe.op_flags & POLLOUT) && inode.can_write())
+					revents |= POLLOUT;
+				if (inode.has_error())
+					revents |= POLLERR;
+				if (inode.has_hungup())
+					revents |= POLLHUP;
+				if (revents == 0)
+					return {};
+				return revents;
+			}
+			default:
+				ASSERT_NOT_REACHED();
+		}
+
+		auto result = execute(process, sqe, description);
+		if (!result.is_error())
+			return static_cast<int32_t>(result.value());
+
+		const auto error_code = result.error().get_error_code();
+		if (error_code == EAGAIN || error_code == EWOULDBLOCK)
+			return {};
+		return -static_cast<int32_t>(error_code);
+	}
+
+	BAN::ErrorOr<long> IORing::execute(Process& process, const ioring_sqe& sqe, OpenFileDescription& description)
+	{
+		// NOTE: sqe.fd is not looked up again as it may have been closed and reused since submit.
+		//       Operations are forced non-blocking as a race with another reader or writer would
+		//       otherwise block the whole ring while m_mutex is held
+
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+		TRY(regions.reserve(2));
+
+		const off_t offset = sqe.off;
+		const off_t* offset_override = (sqe.off == IORING_OFFSET_CURRENT) ? nullptr : &offset;
+
+		switch (sqe.opcode)
+		{
+			case IORING_OP_READ:
+			{
+				auto* buffer = reinterpret_cast<uint8_t*>(sqe.addr);
+				TRY(regions.push_back(TRY(process.validate_and_pin_pointer_access(buffer, sqe.len, true))));
+				const size_t nread = TRY(OpenFileDescriptorSet::read(description, { buffer, sqe.len }, offset_override, true));
+				Thread::current().account_read_bytes(nread);
+				return nread;
+			}
+			case IORING_OP_WRITE:
+			{
+				const auto* buffer = reinterpret_cast<const uint8_t*>(sqe.addr);
+				TRY(regions.push_back(TRY(process.validate_and_pin_pointer_access(buffer, sqe.len, false))));
+				const size_t nwrite = TRY(OpenFileDescriptorSet::write(description, { buffer, sqe.len }, offset_override, true));
+				Thread::current().account_write_bytes(nwrite);
+				return nwrite;
+			}
+			case IORING_OP_RECVMSG:
+			{
+				auto* user_message = reinterpret_cast<msghdr*>(sqe.addr);
+				msghdr message;
+				TRY(read_from_user(user_message, &message, sizeof(msghdr)));
+				TRY(process.pin_message_buffers(message, true, regions));
+				const size_t nrecv = TRY(OpenFileDescriptorSet::recvmsg(description, message, sqe.op_flags, true));
+				Thread::current().account_read_bytes(nrecv);
+				TRY(write_to_user(user_message, &message, sizeof(msghdr)));
+				return nrecv;
+			}
+			case IORING_OP_SENDMSG:
+			{
+				const auto* user_message = reinterpret_cast<const msghdr*>(sqe.addr);
+				msghdr message;
+				TRY(read_from_user(user_message, &message, sizeof(msghdr)));
+				TRY(process.pin_message_buffers(message, false, regions));
+				const size_t nsend = TRY(OpenFileDescriptorSet::sendmsg(description, message, sqe.op_flags, true));
+				Thread::current().account_write_bytes(nsend);
+				return nsend;
+			}
+			case IORING_OP_ACCEPT:
+			{
+				auto* address = reinterpret_cast<sockaddr*>(sqe.addr);
+				auto* address_len = reinterpret_cast<socklen_t*>(sqe.off);
+				if (!address != !address_len)
+					return BAN::Error::from_errno(EINVAL);
+				if (address_len)
+				{
+					TRY(regions.push_back(TRY(process.validate_and_pin_pointer_access(address_len, sizeof(socklen_t), true))));
+					TRY(regions.push_back(TRY(process.validate_and_pin_pointer_access(address, *address_len, true))));
+				}
+				return TRY(OpenFileDescriptorSet::accept(description, address, address_len, sqe.op_flags, true));
+			}
+			case IORING_OP_FSYNC:
+				TRY(description.file.inode->fsync());
+				return 0;
+			default:
+				ASSERT_NOT_REACHED();
+		}
+	}
+
+	BAN::ErrorOr<uint32_t> IORing::completions_available() const
+	{
+		uint32_t cq_head;
+		TRY(read_from_user(&shared()->cq_head, &cq_head, sizeof(uint32_t)));
+		return BAN::Math::min(m_cq_tail - cq_head, m_cq_entries);
+	}
+
+	BAN::ErrorOr<void> IORing::post_completion(uint64_t user_data, int32_t result)
+	{
+		if (TRY(completions_available()) >= m_cq_entries)
+		{
+			m_cq_overflow++;
+			TRY(write_to_user(&shared()->cq_overflow, &m_cq_overflow, sizeof(uint32_t)));
+			return {};
+		}
+
+		const ioring_cqe cqe {
+			.user_data = user_data,
+			.res = result,
+			.flags = 0,
+		};
+		TRY(write_to_user(&cqes()[m_cq_tail & (m_cq_entries - 1)], &cqe, sizeof(ioring_cqe)));
+
+		m_cq_tail++;
+		TRY(write_to_user(&shared()->cq_tail, &m_cq_tail, sizeof(uint32_t)));
+
+		return {};
+	}
+
+}
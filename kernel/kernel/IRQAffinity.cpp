@@ -0,0 +1,190 @@
+#include <BAN/Array.h>
+#include <kernel/IRQAffinity.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/LockStats.h>
+#include <kernel/Lock/Mutex.h>
+#include <kernel/Lock/SpinLock.h>
+#include <kernel/Processor.h>
+
+namespace Kernel
+{
+
+	struct IRQRoute
+	{
+		IRQAffinity::retarget_t retarget { nullptr };
+		void* data { nullptr };
+		uint8_t processor_index { 0 };
+	};
+
+	static LockClass s_route_lock_class { "irq_affinity" };
+	static SpinLock s_route_lock { s_route_lock_class };
+	static BAN::Array<IRQRoute, IRQAffinity::irq_count> s_routes;
+
+	// serializes retargeting, callbacks may touch device registers and map memory
+	static Mutex s_retarget_mutex;
+
+	static BAN::Atomic<uint8_t> s_next_spread_index { 0 };
+
+	// counter of irq on processor index cpu is at [cpu * irq_count + irq]
+	static BAN::Atomic<BAN::Atomic<uint64_t>*> s_counts { nullptr };
+	static size_t s_count_processors { 0 };
+
+	BAN::ErrorOr<void> IRQAffinity::initialize()
+	{
+		ASSERT(s_counts.load(BAN::memory_order_relaxed) == nullptr);
+
+		const size_t processor_count = Processor::count();
+
+		auto* counts = new BAN::Atomic<uint64_t>[processor_count * irq_count];
+		if (counts == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		for (size_t i = 0; i < processor_count * irq_count; i++)
+			counts[i].store(0, BAN::memory_order_relaxed);
+
+		s_count_processors = processor_count;
+		s_counts.store(counts, BAN::memory_order_release);
+
+		return {};
+	}
+
+	ProcessorID IRQAffinity::register_irq(uint8_t irq, retarget_t retarget, void* data, bool spread)
+	{
+		ASSERT(irq < irq_count);
+
+		uint8_t processor_index = 0;
+		if (spread && Processor::count() > 1)
+			processor_index = s_next_spread_index++ % Processor::count();
+
+		SpinLockGuard _(s_route_lock);
+		s_routes[irq] = {
+			.retarget = retarget,
+			.data = data,
+			.processor_index = processor_index,
+		};
+
+		// processor indices are assigned only after all processors are started,
+		// before that the only processor taking interrupts is the bsp
+		if (Processor::count() == 0)
+			return Processor::bsp_id();
+		return Processor::id_from_index(processor_index);
+	}
+
+	BAN::ErrorOr<void> IRQAffinity::set_affinity(uint8_t irq, uint8_t processor_index)
+	{
+		if (irq >= irq_count || processor_index >= Processor::count())
+			return BAN::Error::from_errno(EINVAL);
+
+		LockGuard retarget_guard(s_retarget_mutex);
+
+		IRQRoute route;
+		{
+			SpinLockGuard _(s_route_lock);
+			route = s_routes[irq];
+		}
+
+		if (route.retarget == nullptr)
+			return BAN::Error::from_errno(ENODEV);
+		if (route.processor_index == processor_index)
+			return {};
+
+		TRY(route.retarget(irq, Processor::id_from_index(processor_index), route.data));
+
+		SpinLockGuard _(s_route_lock);
+		s_routes[irq].processor_index = processor_index;
+
+		return {};
+	}
+
+	void IRQAffinity::on_irq(uint8_t irq)
+	{
+		auto* counts = s_counts.load(BAN::memory_order_acquire);
+		if (counts == nullptr || irq >= irq_count)
+			return;
+
+		const uint8_t processor_index = Processor::current_index();
+		if (processor_index >= s_count_processors)
+			return;
+
+		// only the owning processor writes its counters
+		auto& count = counts[processor_index * irq_count + irq];
+		count.store(count.load(BAN::memory_order_relaxed) + 1, BAN::memory_order_relaxed);
+	}
+
+	BAN::ErrorOr<BAN::String> IRQAffinity::format_counts()
+	{
+		auto* counts = s_counts.load(BAN::memory_order_acquire);
+
+		BAN::String result;
+		for (size_t irq = 0; irq < irq_count; irq++)
+		{
+			uint8_t processor_index;
+			{
+				SpinLockGuard _(s_route_lock);
+				if (s_routes[irq].retarget == nullptr)
+					continue;
+				processor_index = s_routes[irq].processor_index;
+			}
+
+			TRY(result.append(TRY(BAN::String::formatted("{} {}", irq, processor_index))));
+			for (size_t cpu = 0; counts && cpu < s_count_processors; cpu++)
+				TRY(result.append(TRY(BAN::String::formatted(" {}", counts[cpu * irq_count + irq].load(BAN::memory_order_relaxed)))));
+			TRY(result.push_back('\n'));
+		}
+		return result;
+	}
+
+	BAN::ErrorOr<BAN::String> IRQAffinity::format_affinities()
+	{
+		BAN::String result;
+		for (size_t irq = 0; irq < irq_count; irq++)
+		{
+			uint8_t processor_index;
+			{
+				SpinLockGuard _(s_route_lock);
+				if (s_routes[irq].retarget == nullptr)
+					continue;
+				processor_index = s_routes[irq].processor_index;
+			}
+			TRY(result.append(TRY(BAN::String::formatted("{} {}\n", irq, processor_index))));
+		}
+		return result;
+	}
+
+	BAN::ErrorOr<size_t> IRQAffinity::write_affinities(BAN::ConstByteSpan buffer)
+	{
+		size_t i = 0;
+
+		const auto skip_spaces =
+			[&]()
+			{
+				while (i < buffer.size() && (buffer[i] == ' ' || buffer[i] == '\t' || buffer[i] == '\n'))
+					i++;
+			};
+
+		const auto parse_number =
+			[&]() -> BAN::ErrorOr<uint32_t>
+			{
+				if (i >= buffer.size() || buffer[i] < '0' || buffer[i] > '9')
+					return BAN::Error::from_errno(EINVAL);
+				uint32_t value = 0;
+				for (; i < buffer.size() && buffer[i] >= '0' && buffer[i] <= '9'; i++)
+				{
+					value = value * 10 + (buffer[i] - '0');
+					if (value > 0xFF)
+						return BAN::Error::from_errno(EINVAL);
+				}
+				return value;
+			};
+
+		for (skip_spaces(); i < buffer.size(); skip_spaces())
+		{
+			const uint32_t irq = TRY(parse_number());
+			skip_spaces();
+			const uint32_t processor_index = TRY(parse_number());
+			TRY(set_affinity(irq, processor_index));
+		}
+
+		return buffer.size();
+	}
+
+}
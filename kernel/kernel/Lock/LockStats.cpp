@@ -0,0 +1,73 @@
+#include <kernel/Lock/LockStats.h>
+
+namespace Kernel
+{
+
+	BAN::Atomic<bool> LockClass::s_enabled { false };
+	BAN::Atomic<LockClass*> LockClass::s_first { nullptr };
+
+	LockClass::LockClass(const char* name)
+		: m_name(name)
+	{
+		LockClass* first = s_first.load(BAN::MemoryOrder::memory_order_relaxed);
+		do
+			m_next = first;
+		while (!s_first.compare_exchange(first, this, BAN::MemoryOrder::memory_order_release));
+	}
+
+	void LockClass::reset_all()
+	{
+		for (auto* lock_class = s_first.load(BAN::MemoryOrder::memory_order_acquire); lock_class; lock_class = lock_class->m_next)
+		{
+			lock_class->m_acquisitions.store(0, BAN::MemoryOrder::memory_order_relaxed);
+			lock_class->m_contended.store(0, BAN::MemoryOrder::memory_order_relaxed);
+			lock_class->m_wait_cycles.store(0, BAN::MemoryOrder::memory_order_relaxed);
+			lock_class->m_hold_cycles.store(0, BAN::MemoryOrder::memory_order_relaxed);
+			lock_class->m_max_hold_cycles.store(0, BAN::MemoryOrder::memory_order_relaxed);
+		}
+	}
+
+	BAN::ErrorOr<BAN::String> LockClass::format_all()
+	{
+		BAN::String result;
+		for (auto* lock_class = s_first.load(BAN::MemoryOrder::memory_order_acquire); lock_class; lock_class = lock_class->m_next)
+		{
+			TRY(result.append(TRY(BAN::String::formatted("{} {} {} {} {} {}\n",
+				lock_class->m_name,
+				lock_class->m_acquisitions.load(BAN::MemoryOrder::memory_order_relaxed),
+				lock_class->m_contended.load(BAN::MemoryOrder::memory_order_relaxed),
+				lock_class->m_wait_cycles.load(BAN::MemoryOrder::memory_order_relaxed),
+				lock_class->m_hold_cycles.load(BAN::MemoryOrder::memory_order_relaxed),
+				lock_class->m_max_hold_cycles.load(BAN::MemoryOrder::memory_order_relaxed)
+			))));
+		}
+		return result;
+	}
+
+	uint64_t LockClass::on_acquire(uint64_t wait_start)
+	{
+		const uint64_t current = now();
+
+		m_acquisitions.add_fetch(1, BAN::MemoryOrder::memory_order_relaxed);
+		if (wait_start)
+		{
+			m_contended.add_fetch(1, BAN::MemoryOrder::memory_order_relaxed);
+			m_wait_cycles.add_fetch(current - wait_start, BAN::MemoryOrder::memory_order_relaxed);
+		}
+
+		return current;
+	}
+
+	void LockClass::on_release(uint64_t hold_start)
+	{
+		const uint64_t hold_cycles = now() - hold_start;
+
+		m_hold_cycles.add_fetch(hold_cycles, BAN::MemoryOrder::memory_order_relaxed);
+
+		uint64_t max_hold_cycles = m_max_hold_cycles.load(BAN::MemoryOrder::memory_order_relaxed);
+		while (hold_cycles > max_hold_cycles)
+			if (m_max_hold_cycles.compare_exchange(max_hold_cycles, hold_cycles, BAN::MemoryOrder::memory_order_relaxed))
+				break;
+	}
+
+}
@@ -1,3 +1,4 @@
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/Mutex.h>
 #include <kernel/Thread.h>
 
@@ -15,6 +16,8 @@ namespace Kernel
 			if (!m_locker.compare_exchange(expected, tid))
 				return false;
 			ASSERT(m_lock_depth == 0);
+			if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+				m_hold_start = m_lock_class->on_acquire(0);
 			if (tid)
 				Thread::current().add_mutex();
 		}
@@ -30,14 +33,19 @@ namespace Kernel
 		else
 		{
 			ASSERT(!tid || !Thread::current().has_spinlock());
+			uint64_t wait_start = 0;
 			pid_t expected = -1;
 			while (!m_locker.compare_exchange(expected, tid))
 			{
 				ASSERT(Processor::get_interrupt_state() == InterruptState::Enabled);
+				if (wait_start == 0 && LockClass::is_enabled())
+					wait_start = LockClass::now();
 				Processor::yield();
 				expected = -1;
 			}
 			ASSERT(m_lock_depth == 0);
+			if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+				m_hold_start = m_lock_class->on_acquire(wait_start);
 			if (tid)
 				Thread::current().add_mutex();
 		}
@@ -51,6 +59,11 @@ namespace Kernel
 		ASSERT(m_lock_depth > 0);
 		if (--m_lock_depth == 0)
 		{
+			if (m_hold_start) [[unlikely]]
+			{
+				m_lock_class->on_release(m_hold_start);
+				m_hold_start = 0;
+			}
 			m_locker = -1;
 			if (tid)
 				Thread::current().remove_mutex();
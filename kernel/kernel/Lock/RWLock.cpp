@@ -1,5 +1,5 @@
-
 #include <kernel/Lock/BlockableSpinLock.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/RWLock.h>
 #include <kernel/Thread.h>
 
@@ -9,12 +9,17 @@ namespace Kernel
 	void RWLock::rd_lock()
 	{
 		SpinLockGuard _(m_lock);
+		uint64_t wait_start = 0;
 		while (m_writers_waiting > 0 || m_writer != -1)
 		{
+			if (wait_start == 0 && LockClass::is_enabled())
+				wait_start = LockClass::now();
 			BlockableSpinLock block(m_lock);
 			m_thread_blocker.block_indefinite(&block);
 		}
 		m_readers_active++;
+		if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_lock_class->on_acquire(wait_start);
 	}
 
 	void RWLock::rd_unlock()
@@ -34,9 +39,12 @@ namespace Kernel
 
 		SpinLockGuard _(m_lock);
 
+		uint64_t wait_start = 0;
 		m_writers_waiting++;
 		while (m_readers_active > 0 || m_writer != -1)
 		{
+			if (wait_start == 0 && LockClass::is_enabled())
+				wait_start = LockClass::now();
 			BlockableSpinLock block(m_lock);
 			m_thread_blocker.block_indefinite(&block);
 		}
@@ -44,6 +52,9 @@ namespace Kernel
 
 		m_writer = Thread::current_tid();
 		m_writer_depth = 1;
+
+		if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_write_hold_start = m_lock_class->on_acquire(wait_start);
 	}
 
 	void RWLock::wr_unlock()
@@ -51,6 +62,11 @@ namespace Kernel
 		if (--m_writer_depth != 0)
 			return;
 		SpinLockGuard _(m_lock);
+		if (m_write_hold_start) [[unlikely]]
+		{
+			m_lock_class->on_release(m_write_hold_start);
+			m_write_hold_start = 0;
+		}
 		m_writer = -1;
 		m_thread_blocker.unblock();
 	}
@@ -1,3 +1,4 @@
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/SpinLock.h>
 #include <kernel/Thread.h>
 
@@ -12,13 +13,19 @@ namespace Kernel
 		auto id = Processor::current_id().as_u32();
 		ASSERT(m_locker.load(BAN::MemoryOrder::memory_order_relaxed) != id);
 
+		uint64_t wait_start = 0;
 		auto expected = PROCESSOR_NONE.as_u32();
 		while (!m_locker.compare_exchange(expected, id, BAN::MemoryOrder::memory_order_acquire))
 		{
+			if (wait_start == 0 && LockClass::is_enabled())
+				wait_start = LockClass::now();
 			Processor::pause();
 			expected = PROCESSOR_NONE.as_u32();
 		}
 
+		if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_hold_start = m_lock_class->on_acquire(wait_start);
+
 		if (Thread::current_tid())
 			Thread::current().add_spinlock();
 
@@ -36,6 +43,9 @@ namespace Kernel
 		if (!m_locker.compare_exchange(expected, id, BAN::MemoryOrder::memory_order_acquire))
 			return false;
 
+		if (LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_hold_start = m_lock_class->on_acquire(0);
+
 		if (Thread::current_tid())
 			Thread::current().add_spinlock();
 
@@ -46,6 +56,11 @@ namespace Kernel
 	{
 		ASSERT(Processor::get_interrupt_state() == InterruptState::Disabled);
 		ASSERT(current_processor_has_lock());
+		if (m_hold_start) [[unlikely]]
+		{
+			m_lock_class->on_release(m_hold_start);
+			m_hold_start = 0;
+		}
 		m_locker.store(PROCESSOR_NONE.as_u32(), BAN::MemoryOrder::memory_order_release);
 		if (Thread::current_tid())
 			Thread::current().remove_spinlock();
@@ -59,16 +74,20 @@ namespace Kernel
 
 		auto id = Processor::current_id().as_u32();
 
+		uint64_t wait_start = 0;
 		ProcessorID::value_type expected = PROCESSOR_NONE.as_u32();
 		while (!m_locker.compare_exchange(expected, id, BAN::MemoryOrder::memory_order_acq_rel))
 		{
 			if (expected == id)
 				break;
+			if (wait_start == 0 && LockClass::is_enabled())
+				wait_start = LockClass::now();
 			Processor::pause();
 			expected = PROCESSOR_NONE.as_u32();
 		}
 
-		m_lock_depth++;
+		if (m_lock_depth++ == 0 && LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_hold_start = m_lock_class->on_acquire(wait_start);
 
 		if (Thread::current_tid())
 			Thread::current().add_spinlock();
@@ -87,7 +106,8 @@ namespace Kernel
 			if (expected != id)
 				return false;
 
-		m_lock_depth++;
+		if (m_lock_depth++ == 0 && LockClass::is_enabled() && m_lock_class) [[unlikely]]
+			m_hold_start = m_lock_class->on_acquire(0);
 
 		if (Thread::current_tid())
 			Thread::current().add_spinlock();
@@ -101,7 +121,14 @@ namespace Kernel
 		ASSERT(current_processor_has_lock());
 		ASSERT(m_lock_depth > 0);
 		if (--m_lock_depth == 0)
+		{
+			if (m_hold_start) [[unlikely]]
+			{
+				m_lock_class->on_release(m_hold_start);
+				m_hold_start = 0;
+			}
 			m_locker.store(PROCESSOR_NONE.as_u32(), BAN::MemoryOrder::memory_order_release);
+		}
 		if (Thread::current_tid())
 			Thread::current().remove_spinlock();
 		Processor::set_interrupt_state(state);
@@ -1,6 +1,7 @@
 #include <kernel/Lock/LockGuard.h>
 #include <kernel/Memory/FileBackedRegion.h>
 #include <kernel/Memory/Heap.h>
+#include <kernel/Thread.h>
 
 #include <BAN/ScopeGuard.h>
 
@@ -97,7 +98,7 @@ namespace Kernel
 			return;
 
 		uint8_t page_buffer[PAGE_SIZE];
-		PageTable::with_per_cpu_fast_page(pages[page_index], [&](void* addr) {
+		PageTable::with_physical_page(pages[page_index], [&](void* addr) {
 			memcpy(page_buffer, addr, PAGE_SIZE);
 		});
 
@@ -153,6 +154,9 @@ namespace Kernel
 
 				const size_t bytes = BAN::Math::min<size_t>(m_inode->size() - offset, PAGE_SIZE);
 
+				if (Thread::current_tid())
+					Thread::current().statistics().major_page_faults++;
+
 				TRY(m_inode->read(offset, BAN::ByteSpan(page_buffer, bytes)));
 				memset(page_buffer + bytes, 0, PAGE_SIZE - bytes);
 
@@ -163,7 +167,7 @@ namespace Kernel
 						m_shared_data->pages[shared_page_index] = Heap::get().take_free_page();
 						if (m_shared_data->pages[shared_page_index] == 0)
 							return BAN::Error::from_errno(ENOMEM);
-						PageTable::with_per_cpu_fast_page(m_shared_data->pages[shared_page_index], [&](void* addr) {
+						PageTable::with_physical_page(m_shared_data->pages[shared_page_index], [&](void* addr) {
 							memcpy(addr, page_buffer, PAGE_SIZE);
 						});
 						shared_data_has_correct_page = true;
@@ -182,11 +186,11 @@ namespace Kernel
 					return BAN::Error::from_errno(ENOMEM);
 				if (!shared_data_has_correct_page)
 				{
-					PageTable::with_per_cpu_fast_page(m_shared_data->pages[shared_page_index], [&](void* addr) {
+					PageTable::with_physical_page(m_shared_data->pages[shared_page_index], [&](void* addr) {
 						memcpy(page_buffer, addr, PAGE_SIZE);
 					});
 				}
-				PageTable::with_per_cpu_fast_page(paddr, [&](void* addr) {
+				PageTable::with_physical_page(paddr, [&](void* addr) {
 					memcpy(addr, page_buffer, PAGE_SIZE);
 				});
 				m_dirty_pages[local_page_index] = paddr;
@@ -211,7 +215,7 @@ namespace Kernel
 				return BAN::Error::from_errno(ENOMEM);
 
 			ASSERT(&m_page_table == &PageTable::current());
-			PageTable::with_per_cpu_fast_page(paddr, [vaddr](void* addr) {
+			PageTable::with_physical_page(paddr, [vaddr](void* addr) {
 				memcpy(addr, reinterpret_cast<void*>(vaddr), PAGE_SIZE);
 			});
 
@@ -241,7 +245,7 @@ namespace Kernel
 				return BAN::Error::from_errno(ENOMEM);
 
 			ASSERT(&m_page_table == &PageTable::current() || &m_page_table == &PageTable::kernel());
-			PageTable::with_per_cpu_fast_page(paddr, [&](void* addr) {
+			PageTable::with_physical_page(paddr, [&](void* addr) {
 				memcpy(addr, reinterpret_cast<void*>(vaddr), PAGE_SIZE);
 			});
 
@@ -1,6 +1,7 @@
 #include <kernel/BootInfo.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/PageTable.h>
+#include <kernel/Processor.h>
 
 #include <BAN/Sort.h>
 
@@ -179,13 +180,145 @@ namespace Kernel
 
 	paddr_t Heap::take_free_page()
 	{
-		SpinLockGuard _(m_lock);
-		for (auto& range : m_physical_ranges)
-			if (range.free_pages() >= 1)
-				return range.reserve_page();
+		{
+			SpinLockGuard _(m_lock);
+			for (auto& range : m_physical_ranges)
+				if (range.free_pages() >= 1)
+					return range.reserve_page();
+		}
+
+		// pages in the zeroed page pool are free memory too
+		SpinLockGuard _(m_zeroed_page_lock);
+		if (m_zeroed_page_count > 0)
+			return m_zeroed_pages[--m_zeroed_page_count];
 		return 0;
 	}
 
+	paddr_t Heap::take_zeroed_page()
+	{
+		{
+			SpinLockGuard _(m_zeroed_page_lock);
+			if (m_zeroed_page_count > 0)
+			{
+				m_zeroed_page_hits++;
+				return m_zeroed_pages[--m_zeroed_page_count];
+			}
+		}
+
+		m_zeroed_page_misses++;
+
+		const paddr_t paddr = take_free_page();
+		if (paddr == 0)
+			return 0;
+		PageTable::with_physical_page(paddr, [](void* page) {
+			memset(page, 0, PAGE_SIZE);
+		});
+		return paddr;
+	}
+
+	static void zero_page_non_temporal(void* page)
+	{
+#if ARCH(x86_64)
+		// non-temporal stores bypass the cache, the page is not touched again
+		// until someone faults it in, possibly on another processor
+		auto* qwords = static_cast<uint64_t*>(page);
+		for (size_t i = 0; i < PAGE_SIZE / sizeof(uint64_t); i += 4)
+		{
+			asm volatile(
+				"movnti %1,  0(%0);"
+				"movnti %1,  8(%0);"
+				"movnti %1, 16(%0);"
+				"movnti %1, 24(%0);"
+				:: "r"(qwords + i), "r"(0ull)
+				: "memory"
+			);
+		}
+		asm volatile("sfence" ::: "memory");
+#else
+		memset(page, 0, PAGE_SIZE);
+#endif
+	}
+
+	bool Heap::fill_zeroed_page_pool()
+	{
+		ASSERT(Processor::get_interrupt_state() == InterruptState::Enabled);
+
+		{
+			SpinLockGuard _(m_zeroed_page_lock);
+			if (m_zeroed_page_count >= zeroed_page_pool_capacity)
+				return false;
+		}
+
+		// the idle thread does not resume where it was preempted, so the page
+		// must be in the pool before interrupts are enabled again
+		Processor::set_interrupt_state(InterruptState::Disabled);
+
+		paddr_t paddr = 0;
+		{
+			SpinLockGuard _(m_lock);
+
+			// keep free memory around for allocations that do not need zeroed pages
+			size_t free_pages = 0;
+			for (const auto& range : m_physical_ranges)
+				free_pages += range.free_pages();
+
+			if (free_pages > zeroed_page_pool_capacity)
+			{
+				for (auto& range : m_physical_ranges)
+				{
+					if (range.free_pages() == 0)
+						continue;
+					paddr = range.reserve_page();
+					break;
+				}
+			}
+		}
+
+		if (paddr == 0)
+		{
+			Processor::set_interrupt_state(InterruptState::Enabled);
+			return false;
+		}
+
+		PageTable::with_physical_page(paddr, [](void* page) {
+			zero_page_non_temporal(page);
+		});
+
+		bool added = false;
+		{
+			SpinLockGuard _(m_zeroed_page_lock);
+			if (m_zeroed_page_count < zeroed_page_pool_capacity)
+			{
+				m_zeroed_pages[m_zeroed_page_count++] = paddr;
+				added = true;
+			}
+		}
+
+		if (!added)
+			release_page(paddr);
+
+		Processor::set_interrupt_state(InterruptState::Enabled);
+		return added;
+	}
+
+	BAN::ErrorOr<BAN::String> Heap::format_zeroed_page_pool()
+	{
+		auto& heap = Heap::get();
+
+		size_t zeroed_page_count;
+		{
+			SpinLockGuard _(heap.m_zeroed_page_lock);
+			zeroed_page_count = heap.m_zeroed_page_count;
+		}
+
+		return BAN::String::formatted("{} {} {} {}\n",
+			zeroed_page_count,
+			zeroed_page_pool_capacity,
+			heap.m_zeroed_page_hits.load(),
+			heap.m_zeroed_page_misses.load()
+		);
+	}
+
 	void Heap::release_page(paddr_t paddr)
 	{
 		SpinLockGuard _(m_lock);
@@ -216,20 +349,28 @@ namespace Kernel
 
 	size_t Heap::used_pages() const
 	{
-		SpinLockGuard _(m_lock);
 		size_t result = 0;
-		for (const auto& range : m_physical_ranges)
-			result += range.used_pages();
-		return result;
+		{
+			SpinLockGuard _(m_lock);
+			for (const auto& range : m_physical_ranges)
+				result += range.used_pages();
+		}
+
+		SpinLockGuard _(m_zeroed_page_lock);
+		return result - m_zeroed_page_count;
 	}
 
 	size_t Heap::free_pages() const
 	{
-		SpinLockGuard _(m_lock);
 		size_t result = 0;
-		for (const auto& range : m_physical_ranges)
-			result += range.free_pages();
-		return result;
+		{
+			SpinLockGuard _(m_lock);
+			for (const auto& range : m_physical_ranges)
+				result += range.free_pages();
+		}
+
+		SpinLockGuard _(m_zeroed_page_lock);
+		return result + m_zeroed_page_count;
 	}
 
 }
@@ -55,7 +55,7 @@ namespace Kernel
 
 		if (physical_page == nullptr)
 		{
-			const paddr_t paddr = Heap::get().take_free_page();
+			const paddr_t paddr = Heap::get().take_zeroed_page();
 			if (paddr == 0)
 				return BAN::Error::from_errno(ENOMEM);
 
@@ -64,9 +64,6 @@ namespace Kernel
 				return BAN::Error::from_errno(ENOMEM);
 
 			m_page_table.map_page_at(paddr, vaddr, m_flags);
-			PageTable::with_per_cpu_fast_page(paddr, [](void* addr) {
-				memset(addr, 0x00, PAGE_SIZE);
-			});
 
 			return true;
 		}
@@ -93,7 +90,7 @@ namespace Kernel
 		m_page_table.map_page_at(paddr, vaddr, m_flags);
 
 		ASSERT(&m_page_table == &PageTable::current());
-		PageTable::with_per_cpu_fast_page(physical_page->paddr, [vaddr](void* addr) {
+		PageTable::with_physical_page(physical_page->paddr, [vaddr](void* addr) {
 			memcpy(reinterpret_cast<void*>(vaddr), addr, PAGE_SIZE);
 		});
 
@@ -180,7 +177,7 @@ namespace Kernel
 			const paddr_t paddr = m_page_table.physical_address_of(write_vaddr & PAGE_ADDR_MASK);
 			ASSERT(paddr);
 
-			PageTable::with_per_cpu_fast_page(paddr, [&](void* addr) {
+			PageTable::with_physical_page(paddr, [&](void* addr) {
 				memcpy(static_cast<uint8_t*>(addr) + page_offset, (void*)(buffer + written), bytes);
 			});
 
@@ -262,12 +262,9 @@ namespace Kernel
 		paddr_t paddr = m_object->paddrs[(vaddr - m_vaddr) / PAGE_SIZE];
 		if (paddr == 0)
 		{
-			paddr = Heap::get().take_free_page();
+			paddr = Heap::get().take_zeroed_page();
 			if (paddr == 0)
 				return BAN::Error::from_errno(ENOMEM);
-			PageTable::with_per_cpu_fast_page(paddr, [&](void* addr) {
-				memset(addr, 0x00, PAGE_SIZE);
-			});
 			m_object->paddrs[(vaddr - m_vaddr) / PAGE_SIZE] = paddr;
 		}
 
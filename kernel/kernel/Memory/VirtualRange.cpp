@@ -62,12 +62,9 @@ namespace Kernel
 		const size_t page_count = size() / PAGE_SIZE;
 		for (size_t i = 0; i < page_count; i++)
 		{
-			const auto paddr = Heap::get().take_free_page();
+			const auto paddr = Heap::get().take_zeroed_page();
 			if (paddr == 0)
 				return BAN::Error::from_errno(ENOMEM);
-			PageTable::with_fast_page(paddr, [] {
-				memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-			});
 			m_page_table.map_page_at(paddr, vaddr() + i * PAGE_SIZE, m_flags, PageTable::MemoryType::Normal, false);
 		}
 		m_page_table.invalidate_range(m_vaddr, page_count, true);
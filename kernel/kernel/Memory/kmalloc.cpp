@@ -1,3 +1,4 @@
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/kmalloc.h>
 #include <kernel/Memory/PageTable.h>
@@ -214,7 +215,8 @@ struct BitmapAllocator
 static uint8_t s_allocator_storage[s_max_allocator_count * sizeof(BitmapAllocator)];
 static BitmapAllocator* s_allocators[s_max_allocator_count] {};
 
-static Kernel::SpinLock s_kmalloc_lock;
+static Kernel::LockClass s_kmalloc_lock_class { "kmalloc" };
+static Kernel::SpinLock s_kmalloc_lock { s_kmalloc_lock_class };
 
 void kmalloc_initialize()
 {
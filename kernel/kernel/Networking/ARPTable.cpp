@@ -1,5 +1,8 @@
+#include <kernel/FS/ProcFS/FileSystem.h>
+#include <kernel/FS/ProcFS/Inode.h>
 #include <kernel/Networking/ARPTable.h>
 #include <kernel/Scheduler.h>
+#include <kernel/Thread.h>
 #include <kernel/Timer/Timer.h>
 
 namespace Kernel
@@ -14,15 +17,53 @@ namespace Kernel
 	static constexpr BAN::IPv4Address s_broadcast_ipv4 { 0xFFFFFFFF };
 	static constexpr BAN::MACAddress  s_broadcast_mac  {{ 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }};
 
+	// packets queued per unresolved neighbor, the oldest one is dropped on overflow
+	static constexpr size_t s_max_pending_packets = 8;
+
+	// unanswered broadcast requests are retransmitted after 250, 500 and 1000 ms
+	static constexpr uint32_t s_max_resolve_requests = 4;
+	static constexpr uint64_t s_resolve_timeout_ms = 250;
+
+	// entries go stale this long after their last confirmation. stale entries that
+	// are still in use are refreshed with unicast requests, unused ones are removed
+	static constexpr uint64_t s_reachable_time_ms = 30'000;
+	static constexpr uint32_t s_max_refresh_requests = 3;
+	static constexpr uint64_t s_refresh_timeout_ms = 1'000;
+
+	static constexpr uint64_t s_update_interval_ms = 100;
+
 	BAN::ErrorOr<BAN::UniqPtr<ARPTable>> ARPTable::create()
 	{
-		return TRY(BAN::UniqPtr<ARPTable>::create());
+		auto arp_table = TRY(BAN::UniqPtr<ARPTable>::create());
+
+		auto* thread = TRY(Thread::create_kernel([](void* arp_table_ptr) {
+			static_cast<ARPTable*>(arp_table_ptr)->update_thread();
+		}, arp_table.ptr()));
+		if (auto ret = Processor::scheduler().add_thread(thread); ret.is_error())
+		{
+			delete thread;
+			return ret.release_error();
+		}
+
+		auto& procfs = ProcFileSystem::get();
+		auto net_directory_or_error = procfs.root_inode()->find_inode("net"_sv);
+		if (net_directory_or_error.is_error())
+		{
+			TRY(procfs.root_inode()->create_directory("net"_sv, Inode::Mode::IFDIR | 0555, 0, 0));
+			net_directory_or_error = procfs.root_inode()->find_inode("net"_sv);
+		}
+		auto net_directory = TRY(BAN::move(net_directory_or_error));
+
+		auto arp_inode = TRY(ProcROInode::create_new(&ARPTable::read_proc_table, procfs, arp_table.ptr(), 0444, 0, 0));
+		TRY(net_directory->link_inode("arp"_sv, arp_inode));
+
+		return arp_table;
 	}
 
-	BAN::ErrorOr<BAN::MACAddress> ARPTable::get_mac_from_ipv4(NetworkInterface& interface, BAN::IPv4Address ipv4_address)
+	BAN::ErrorOr<BAN::Optional<BAN::MACAddress>> ARPTable::get_mac_or_queue_packet(NetworkInterface& interface, BAN::IPv4Address ipv4_address, BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload)
 	{
 		if (ipv4_address == s_broadcast_ipv4)
-			return s_broadcast_mac;
+			return BAN::Optional<BAN::MACAddress>(s_broadcast_mac);
 
 		const auto netmask = interface.get_netmask();
 		const bool same_subnet = ipv4_address.mask(netmask) == interface.get_ipv4_address().mask(netmask);
@@ -31,7 +72,7 @@ namespace Kernel
 		{
 			if (!same_subnet)
 				return BAN::Error::from_errno(EADDRNOTAVAIL);
-			return BAN::MACAddress {};
+			return BAN::Optional<BAN::MACAddress>(BAN::MACAddress {});
 		}
 
 		ASSERT(interface.type() == NetworkInterface::Type::Ethernet);
@@ -42,13 +83,59 @@ namespace Kernel
 		if (!same_subnet)
 			ipv4_address = interface.get_gateway();
 
+		const uint64_t current_ms = SystemTimer::get().ms_since_boot();
+
 		{
 			SpinLockGuard _(m_arp_table_lock);
+
 			auto it = m_arp_table.find(ipv4_address);
-			if (it != m_arp_table.end())
-				return it->value;
+			if (it != m_arp_table.end() && it->value.state != State::Incomplete)
+			{
+				it->value.last_used_ms = current_ms;
+				return BAN::Optional<BAN::MACAddress>(it->value.mac);
+			}
+
+			const bool is_new_entry = (it == m_arp_table.end());
+			if (is_new_entry)
+			{
+				it = TRY(m_arp_table.emplace(ipv4_address));
+				it->value.interface = &interface;
+				it->value.requests_sent = 1;
+				it->value.last_used_ms = current_ms;
+				it->value.next_request_ms = current_ms + s_resolve_timeout_ms;
+			}
+
+			PendingPacket packet;
+			packet.offload = offload;
+
+			size_t packet_size = 0;
+			for (const auto& buffer : buffers)
+				packet_size += buffer.size();
+			TRY(packet.data.resize(packet_size));
+
+			size_t offset = 0;
+			for (const auto& buffer : buffers)
+			{
+				memcpy(packet.data.data() + offset, buffer.data(), buffer.size());
+				offset += buffer.size();
+			}
+
+			auto& pending_packets = it->value.pending_packets;
+			if (pending_packets.size() >= s_max_pending_packets)
+				pending_packets.remove(0);
+			TRY(pending_packets.push_back(BAN::move(packet)));
+
+			if (!is_new_entry)
+				return BAN::Optional<BAN::MACAddress>();
 		}
 
+		TRY(send_request(interface, ipv4_address, s_broadcast_mac));
+
+		return BAN::Optional<BAN::MACAddress>();
+	}
+
+	BAN::ErrorOr<void> ARPTable::send_request(NetworkInterface& interface, BAN::IPv4Address ipv4_address, BAN::MACAddress dst_mac)
+	{
 		const auto arp_request = ARPPacket {
 			.htype = 0x0001,
 			.ptype = EtherType::IPv4,
@@ -61,21 +148,97 @@ namespace Kernel
 			.tpa = ipv4_address,
 		};
 
-		TRY(interface.send_with_ethernet_header(s_broadcast_mac, EtherType::ARP, BAN::ConstByteSpan::from(arp_request)));
+		return interface.send_with_ethernet_header(dst_mac, EtherType::ARP, BAN::ConstByteSpan::from(arp_request));
+	}
+
+	void ARPTable::send_pending_packets(NetworkInterface& interface, BAN::MACAddress dst_mac, BAN::Vector<PendingPacket>&& pending_packets)
+	{
+		for (const auto& packet : pending_packets)
+		{
+			const BAN::ConstByteSpan buffer_array[] { BAN::ConstByteSpan(packet.data.span()) };
+			if (auto ret = interface.send_with_ethernet_header(dst_mac, EtherType::IPv4, buffer_array, packet.offload); ret.is_error())
+				dwarnln_if(DEBUG_ARP, "Failed to send queued packet: {}", ret.error());
+		}
+	}
+
+	void ARPTable::update_thread()
+	{
+		struct RequestInfo
+		{
+			BAN::RefPtr<NetworkInterface> interface;
+			BAN::IPv4Address ipv4_address;
+			BAN::MACAddress dst_mac;
+		};
+
+		BAN::Vector<RequestInfo> requests;
 
-		uint64_t timeout = SystemTimer::get().ms_since_boot() + 1'000;
-		while (SystemTimer::get().ms_since_boot() < timeout)
+		for (;;)
 		{
+			SystemTimer::get().sleep_for_ms(s_update_interval_ms);
+
+			const uint64_t current_ms = SystemTimer::get().ms_since_boot();
+
 			{
 				SpinLockGuard _(m_arp_table_lock);
-				auto it = m_arp_table.find(ipv4_address);
-				if (it != m_arp_table.end())
-					return it->value;
+
+				for (auto it = m_arp_table.begin(); it != m_arp_table.end();)
+				{
+					auto& entry = it->value;
+
+					if (entry.state == State::Reachable && current_ms >= entry.confirmed_ms + s_reachable_time_ms)
+					{
+						if (current_ms >= entry.last_used_ms + s_reachable_time_ms)
+						{
+							dprintln_if(DEBUG_ARP, "Removing unused entry for {}", it->key);
+							it = m_arp_table.remove(it);
+							continue;
+						}
+
+						entry.state = State::Stale;
+						entry.requests_sent = 0;
+						entry.next_request_ms = current_ms;
+					}
+
+					if (entry.state == State::Reachable || current_ms < entry.next_request_ms)
+					{
+						it++;
+						continue;
+					}
+
+					const bool is_incomplete = (entry.state == State::Incomplete);
+					if (entry.requests_sent >= (is_incomplete ? s_max_resolve_requests : s_max_refresh_requests))
+					{
+						if (is_incomplete)
+							dwarnln_if(DEBUG_ARP, "Could not resolve {}, dropping {} packets", it->key, entry.pending_packets.size());
+						else
+							dprintln_if(DEBUG_ARP, "Entry for {} timed out", it->key);
+						it = m_arp_table.remove(it);
+						continue;
+					}
+
+					const auto request = RequestInfo {
+						.interface = entry.interface,
+						.ipv4_address = it->key,
+						.dst_mac = is_incomplete ? s_broadcast_mac : entry.mac,
+					};
+					if (requests.push_back(request).is_error())
+						break;
+
+					entry.requests_sent++;
+					entry.next_request_ms = current_ms + (is_incomplete
+						? s_resolve_timeout_ms << (entry.requests_sent - 1)
+						: s_refresh_timeout_ms
+					);
+
+					it++;
+				}
 			}
-			Processor::yield();
-		}
 
-		return BAN::Error::from_errno(ETIMEDOUT);
+			for (const auto& request : requests)
+				if (auto ret = send_request(*request.interface, request.ipv4_address, request.dst_mac); ret.is_error())
+					dwarnln_if(DEBUG_ARP, "Failed to send ARP request: {}", ret.error());
+			requests.clear();
+		}
 	}
 
 	BAN::ErrorOr<void> ARPTable::handle_arp_packet(NetworkInterface& interface, BAN::ConstByteSpan buffer)
@@ -94,53 +257,110 @@ namespace Kernel
 			return {};
 		}
 
-		switch (packet.oper)
+		if (packet.oper != ARPOperation::Request && packet.oper != ARPOperation::Reply)
 		{
-			case ARPOperation::Request:
-			{
-				if (packet.tpa == interface.get_ipv4_address())
-				{
-					const auto arp_reply = ARPPacket {
-						.htype = 0x0001,
-						.ptype = EtherType::IPv4,
-						.hlen = 0x06,
-						.plen = 0x04,
-						.oper = ARPOperation::Reply,
-						.sha = interface.get_mac_address(),
-						.spa = interface.get_ipv4_address(),
-						.tha = packet.sha,
-						.tpa = packet.spa,
-					};
-					TRY(interface.send_with_ethernet_header(packet.sha, EtherType::ARP, BAN::ConstByteSpan::from(arp_reply)));
-				}
-				break;
-			}
-			case ARPOperation::Reply:
+			dprintln("Unhandled ARP packet (oper {4H})", (uint16_t)packet.oper);
+			return {};
+		}
+
+		const auto our_ipv4 = interface.get_ipv4_address();
+
+		if (our_ipv4 != BAN::IPv4Address { 0 } && packet.spa == our_ipv4)
+		{
+			if (packet.sha != interface.get_mac_address())
+				dwarnln("ARP: {} is also claimed by {}", packet.spa, packet.sha);
+			return {};
+		}
+
+		// Gratuitous ARP (spa == tpa) only updates neighbors we already know, new entries
+		// are created from packets that are addressed to us. Probes with sender 0.0.0.0
+		// don't tell anything about the sender.
+		const bool is_addressed_to_us = (our_ipv4 != BAN::IPv4Address { 0 } && packet.tpa == our_ipv4);
+		if (packet.spa != BAN::IPv4Address { 0 })
+		{
+			const uint64_t current_ms = SystemTimer::get().ms_since_boot();
+
+			BAN::Vector<PendingPacket> pending_packets;
+
 			{
 				SpinLockGuard _(m_arp_table_lock);
+
 				auto it = m_arp_table.find(packet.spa);
+				if (it == m_arp_table.end() && is_addressed_to_us)
+				{
+					it = TRY(m_arp_table.emplace(packet.spa));
+					it->value.last_used_ms = current_ms;
+				}
 
 				if (it != m_arp_table.end())
 				{
-					if (it->value != packet.sha)
-					{
+					auto& entry = it->value;
+					if (entry.state == State::Incomplete)
+						dprintln_if(DEBUG_ARP, "Assign IPv4 {} MAC to {}", packet.spa, packet.sha);
+					else if (entry.mac != packet.sha)
 						dprintln("Update IPv4 {} MAC to {}", packet.spa, packet.sha);
-						it->value = packet.sha;
-					}
-				}
-				else
-				{
-					TRY(m_arp_table.insert(packet.spa, packet.sha));
-					dprintln("Assign IPv4 {} MAC to {}", packet.spa, packet.sha);
+
+					entry.interface = &interface;
+					entry.mac = packet.sha;
+					entry.state = State::Reachable;
+					entry.requests_sent = 0;
+					entry.confirmed_ms = current_ms;
+					pending_packets = BAN::move(entry.pending_packets);
 				}
-				break;
 			}
-			default:
-				dprintln("Unhandled ARP packet (oper {4H})", (uint16_t)packet.oper);
-				break;
+
+			if (!pending_packets.empty())
+				send_pending_packets(interface, packet.sha, BAN::move(pending_packets));
+		}
+
+		if (packet.oper == ARPOperation::Request && is_addressed_to_us)
+		{
+			const auto arp_reply = ARPPacket {
+				.htype = 0x0001,
+				.ptype = EtherType::IPv4,
+				.hlen = 0x06,
+				.plen = 0x04,
+				.oper = ARPOperation::Reply,
+				.sha = interface.get_mac_address(),
+				.spa = our_ipv4,
+				.tha = packet.sha,
+				.tpa = packet.spa,
+			};
+			TRY(interface.send_with_ethernet_header(packet.sha, EtherType::ARP, BAN::ConstByteSpan::from(arp_reply)));
 		}
 
 		return {};
 	}
 
+	BAN::ErrorOr<size_t> ARPTable::read_proc_table(off_t offset, BAN::ByteSpan buffer, void* arp_table_ptr)
+	{
+		ASSERT(offset >= 0);
+
+		auto& arp_table = *static_cast<ARPTable*>(arp_table_ptr);
+
+		auto string = TRY(BAN::String::formatted("address mac state interface\n"));
+
+		SpinLockGuard _(arp_table.m_arp_table_lock);
+		for (const auto& [ipv4_address, entry] : arp_table.m_arp_table)
+		{
+			const char* state = "";
+			switch (entry.state)
+			{
+				case State::Incomplete: state = "incomplete"; break;
+				case State::Reachable:  state = "reachable";  break;
+				case State::Stale:      state = "stale";      break;
+			}
+			TRY(string.append(TRY(BAN::String::formatted("{} {} {} {}\n",
+				ipv4_address, entry.mac, state, entry.interface ? entry.interface->name() : "-"_sv
+			))));
+		}
+
+		if (static_cast<size_t>(offset) >= string.size())
+			return 0;
+
+		const size_t bytes = BAN::Math::min<size_t>(string.size() - offset, buffer.size());
+		memcpy(buffer.data(), string.data() + offset, bytes);
+		return bytes;
+	}
+
 }
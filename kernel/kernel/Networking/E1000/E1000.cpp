@@ -283,40 +283,119 @@ namespace Kernel
 		return {};
 	}
 
-	BAN::ErrorOr<void> E1000::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers)
+	uint32_t E1000::offload_features() const
 	{
+		return OFFLOAD_TX_CKSUM_IPV4
+			| OFFLOAD_TX_CKSUM_TCP
+			| OFFLOAD_TX_CKSUM_UDP
+			| OFFLOAD_TX_TSO;
+	}
+
+	BAN::ErrorOr<void> E1000::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload)
+	{
+		size_t packet_size = 0;
+		for (const auto& buffer : buffers)
+			packet_size += buffer.size();
+
+		// offloaded packets are sent as a context descriptor followed by extended data descriptors
+		const bool use_extended = offload.checksums || offload.tso_mss;
+		const uint32_t data_descriptor_count = BAN::Math::div_round_up<size_t>(packet_size, E1000_TX_BUFFER_SIZE);
+		const uint32_t descriptor_count = data_descriptor_count + use_extended;
+		ASSERT(use_extended || data_descriptor_count == 1);
+		ASSERT(descriptor_count <= E1000_TX_DESCRIPTOR_COUNT / 2);
+
 		const auto interrupt_state = Processor::get_interrupt_state();
 		Processor::set_interrupt_state(InterruptState::Disabled);
 
-		const uint32_t tx_current_nowrap = m_tx_head.fetch_add(1);
-		const uint32_t tx_current = tx_current_nowrap % E1000_TX_DESCRIPTOR_COUNT;
+		const uint32_t tx_first_nowrap = m_tx_head.fetch_add(descriptor_count);
 
-		auto& descriptor = reinterpret_cast<volatile e1000_tx_desc*>(m_tx_descriptor_region->vaddr())[tx_current];
-		while (descriptor.status == 0)
-			Processor::yield();
+		auto* tx_descriptors = reinterpret_cast<volatile e1000_tx_desc*>(m_tx_descriptor_region->vaddr());
+		for (uint32_t i = 0; i < descriptor_count; i++)
+			while (tx_descriptors[(tx_first_nowrap + i) % E1000_TX_DESCRIPTOR_COUNT].status == 0)
+				Processor::yield();
 
-		auto* tx_buffer = reinterpret_cast<uint8_t*>(m_tx_buffer_region->vaddr() + E1000_TX_BUFFER_SIZE * tx_current);
+		uint32_t tx_current = tx_first_nowrap % E1000_TX_DESCRIPTOR_COUNT;
 
-		size_t packet_size = 0;
-		for (const auto& buffer : buffers)
+		if (use_extended)
 		{
-			ASSERT(packet_size + buffer.size() <= E1000_TX_BUFFER_SIZE);
-			memcpy(tx_buffer + packet_size, buffer.data(), buffer.size());
-			packet_size += buffer.size();
+			uint8_t tucmd = TUCMD_DEXT | TUCMD_RS | TUCMD_IP;
+			if (offload.checksums & CKSUM_TCP)
+				tucmd |= TUCMD_TCP;
+			if (offload.tso_mss)
+				tucmd |= TUCMD_TSE;
+
+			// NOTE: checksum offsets within IPv4, TCP and UDP headers
+			const uint8_t l4_checksum_offset = (offload.checksums & CKSUM_TCP) ? 16 : 6;
+
+			auto& context = reinterpret_cast<volatile e1000_tx_context_desc*>(m_tx_descriptor_region->vaddr())[tx_current];
+			context.ipcss = offload.l3_offset;
+			context.ipcso = offload.l3_offset + 10;
+			context.ipcse = offload.l4_offset - 1;
+			context.tucss = offload.l4_offset;
+			context.tucso = offload.l4_offset + l4_checksum_offset;
+			context.tucse = 0;
+			context.cmd_and_length = e1000_tx_cmd_and_length(tucmd, DTYP_CONTEXT, offload.tso_mss ? packet_size - offload.header_size : 0);
+			context.hdrlen = offload.tso_mss ? offload.header_size : 0;
+			context.mss = offload.tso_mss;
+			context.status = 0;
+
+			tx_current = (tx_current + 1) % E1000_TX_DESCRIPTOR_COUNT;
 		}
 
-		descriptor.length = packet_size;
-		descriptor.status = 0;
-		descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+		size_t buffer_offset = 0;
+		for (uint32_t i = 0; i < data_descriptor_count; i++)
+		{
+			const paddr_t tx_buffer_paddr = m_tx_buffer_region->paddr() + E1000_TX_BUFFER_SIZE * tx_current;
+			auto* tx_buffer = reinterpret_cast<uint8_t*>(m_tx_buffer_region->vaddr() + E1000_TX_BUFFER_SIZE * tx_current);
+			const size_t length = gather_buffers(buffers, buffer_offset, { tx_buffer, E1000_TX_BUFFER_SIZE });
+
+			const bool is_last = (i == data_descriptor_count - 1);
+
+			if (!use_extended)
+			{
+				auto& descriptor = tx_descriptors[tx_current];
+				descriptor.addr = tx_buffer_paddr;
+				descriptor.length = length;
+				descriptor.cso = 0;
+				descriptor.css = 0;
+				descriptor.special = 0;
+				descriptor.status = 0;
+				descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
+			}
+			else
+			{
+				uint8_t dcmd = DCMD_DEXT | DCMD_IFCS | DCMD_RS;
+				if (offload.tso_mss)
+					dcmd |= DCMD_TSE;
+				if (is_last)
+					dcmd |= DCMD_EOP;
+
+				uint8_t popts = 0;
+				if (offload.checksums & CKSUM_IPV4)
+					popts |= POPTS_IXSM;
+				if (offload.checksums & (CKSUM_TCP | CKSUM_UDP))
+					popts |= POPTS_TXSM;
+
+				// NOTE: context descriptor may have overwritten the address
+				auto& descriptor = reinterpret_cast<volatile e1000_tx_data_desc*>(m_tx_descriptor_region->vaddr())[tx_current];
+				descriptor.addr = tx_buffer_paddr;
+				descriptor.cmd_and_length = e1000_tx_cmd_and_length(dcmd, DTYP_DATA, length);
+				descriptor.popts = popts;
+				descriptor.special = 0;
+				descriptor.status = 0;
+			}
+
+			tx_current = (tx_current + 1) % E1000_TX_DESCRIPTOR_COUNT;
+		}
 
-		while (tx_current_nowrap != m_tx_commit.load())
+		while (tx_first_nowrap != m_tx_commit.load())
 			Processor::pause();
-		write32(REG_TDT, (tx_current + 1) % E1000_TX_DESCRIPTOR_COUNT);
-		m_tx_commit.add_fetch(1);
+		write32(REG_TDT, tx_current);
+		m_tx_commit.add_fetch(descriptor_count);
 
 		Processor::set_interrupt_state(interrupt_state);
 
-		dprintln_if(DEBUG_E1000, "sent {} bytes", packet_size);
+		dprintln_if(DEBUG_E1000, "sent {} bytes using {} descriptors", packet_size, descriptor_count);
 
 		return {};
 	}
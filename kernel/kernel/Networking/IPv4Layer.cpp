@@ -1,3 +1,4 @@
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/SpinLock.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/PageTable.h>
@@ -18,6 +19,9 @@ namespace Kernel
 		DF = 1 << 14,
 	};
 
+	LockClass IPv4Layer::s_connection_bucket_lock_class { "ipv4_connection_bucket" };
+	LockClass IPv4Layer::s_bound_socket_lock_class { "ipv4_bound_sockets" };
+
 	BAN::ErrorOr<BAN::UniqPtr<IPv4Layer>> IPv4Layer::create()
 	{
 		auto ipv4_manager = TRY(BAN::UniqPtr<IPv4Layer>::create());
@@ -43,12 +47,124 @@ namespace Kernel
 		return header;
 	}
 
-	void IPv4Layer::unbind_socket(uint16_t port)
+	void IPv4Layer::unbind_socket(const NetworkSocket& socket, uint16_t port)
 	{
 		SpinLockGuard _(m_bound_socket_lock);
 		auto it = m_bound_sockets.find(port);
 		ASSERT(it != m_bound_sockets.end());
-		m_bound_sockets.remove(it);
+
+		auto& bound_sockets = it->value;
+		for (size_t i = 0; i < bound_sockets.size(); i++)
+		{
+			if (bound_sockets[i].owner != &socket)
+				continue;
+			bound_sockets.remove(i);
+			if (bound_sockets.empty())
+				m_bound_sockets.remove(it);
+			return;
+		}
+
+		ASSERT_NOT_REACHED();
+	}
+
+	BAN::hash_t IPv4Layer::ConnectionKey::hash() const
+	{
+		uint64_t hash = local_address.raw;
+		hash = (hash << 32) | remote_address.raw;
+		hash ^= (static_cast<uint64_t>(local_port) << 48) | (static_cast<uint64_t>(remote_port) << 32) | protocol;
+		hash *= 0x9E3779B97F4A7C15;
+		return hash >> 32;
+	}
+
+	BAN::Optional<IPv4Layer::ConnectionKey> IPv4Layer::connection_key(const NetworkSocket& socket, const sockaddr* remote_address, socklen_t remote_address_len)
+	{
+		if (!socket.is_bound() || socket.address()->sa_family != AF_INET)
+			return {};
+		if (remote_address->sa_family != AF_INET || remote_address_len < static_cast<socklen_t>(sizeof(sockaddr_in)))
+			return {};
+
+		const auto& local_in = *reinterpret_cast<const sockaddr_in*>(socket.address());
+		const auto& remote_in = *reinterpret_cast<const sockaddr_in*>(remote_address);
+
+		// packets are matched with their destination address, which is never INADDR_ANY
+		if (local_in.sin_addr.s_addr == INADDR_ANY)
+			return {};
+
+		return ConnectionKey {
+			.local_address = BAN::IPv4Address { local_in.sin_addr.s_addr },
+			.remote_address = BAN::IPv4Address { remote_in.sin_addr.s_addr },
+			.local_port = BAN::network_endian_to_host(local_in.sin_port),
+			.remote_port = BAN::network_endian_to_host(remote_in.sin_port),
+			.protocol = socket.protocol(),
+		};
+	}
+
+	IPv4Layer::ConnectionBucket& IPv4Layer::connection_bucket(const ConnectionKey& key)
+	{
+		return m_connection_buckets[key.hash() % s_connection_bucket_count];
+	}
+
+	BAN::ErrorOr<void> IPv4Layer::add_connection(BAN::RefPtr<NetworkSocket> socket, const sockaddr* remote_address, socklen_t remote_address_len)
+	{
+		const auto key = connection_key(*socket, remote_address, remote_address_len);
+		if (!key.has_value())
+			return BAN::Error::from_errno(EINVAL);
+
+		auto& bucket = connection_bucket(key.value());
+		SpinLockGuard _(bucket.lock);
+		for (const auto& connection : bucket.connections)
+			if (connection.key == key.value() && connection.socket.valid())
+				return BAN::Error::from_errno(EADDRINUSE);
+		TRY(bucket.connections.push_back({
+			.key = key.value(),
+			.owner = socket.ptr(),
+			.socket = TRY(socket->get_weak_ptr()),
+		}));
+		return {};
+	}
+
+	void IPv4Layer::remove_connection(const NetworkSocket& socket, const sockaddr* remote_address, socklen_t remote_address_len)
+	{
+		const auto key = connection_key(socket, remote_address, remote_address_len);
+		if (!key.has_value())
+			return;
+
+		auto& bucket = connection_bucket(key.value());
+		SpinLockGuard _(bucket.lock);
+		for (size_t i = 0; i < bucket.connections.size(); i++)
+		{
+			if (bucket.connections[i].owner != &socket)
+				continue;
+			bucket.connections.remove(i);
+			return;
+		}
+	}
+
+	BAN::RefPtr<NetworkSocket> IPv4Layer::find_connected_socket(const ConnectionKey& key)
+	{
+		auto& bucket = connection_bucket(key);
+		SpinLockGuard _(bucket.lock);
+		for (const auto& connection : bucket.connections)
+			if (connection.key == key)
+				return connection.socket.lock();
+		return {};
+	}
+
+	BAN::RefPtr<NetworkSocket> IPv4Layer::find_bound_socket(const ConnectionKey& key)
+	{
+		SpinLockGuard _(m_bound_socket_lock);
+
+		auto it = m_bound_sockets.find(key.local_port);
+		if (it == m_bound_sockets.end())
+			return {};
+
+		const auto& bound_sockets = it->value;
+		const size_t first = (bound_sockets.size() == 1) ? 0 : key.hash() % bound_sockets.size();
+		for (size_t i = 0; i < bound_sockets.size(); i++)
+			if (auto socket = bound_sockets[(first + i) % bound_sockets.size()].socket.lock())
+				return socket;
+
+		return {};
 	}
 
 	BAN::ErrorOr<in_port_t> IPv4Layer::find_free_port()
@@ -149,9 +265,32 @@ namespace Kernel
 			bind_address.sin_port = BAN::host_to_network_endian(TRY(find_free_port()));
 		const uint16_t port = BAN::network_endian_to_host(bind_address.sin_port);
 
-		if (m_bound_sockets.contains(port))
-			return BAN::Error::from_errno(EADDRINUSE);
-		TRY(m_bound_sockets.insert(port, TRY(socket->get_weak_ptr())));
+		auto it = m_bound_sockets.find(port);
+		if (it != m_bound_sockets.end())
+		{
+			// all sockets sharing a port must have SO_REUSEPORT set and be owned by the same user
+			if (!socket->reuse_port())
+				return BAN::Error::from_errno(EADDRINUSE);
+			// NOTE: sockets unbind themselves before they are freed, and that has to
+			//       wait for this lock, so owners are valid here
+			for (const auto& bound_socket : it->value)
+			{
+				const auto* other = bound_socket.owner;
+				if (!other->reuse_port() || other->protocol() != socket->protocol() || other->uid() != socket->uid())
+					return BAN::Error::from_errno(EADDRINUSE);
+			}
+		}
+		else
+		{
+			it = TRY(m_bound_sockets.emplace(port));
+		}
+
+		if (auto ret = it->value.push_back({ .owner = socket.ptr(), .socket = TRY(socket->get_weak_ptr()) }); ret.is_error())
+		{
+			if (it->value.empty())
+				m_bound_sockets.remove(it);
+			return ret.release_error();
+		}
 
 		socket->bind_address_and_port(reinterpret_cast<struct sockaddr*>(&bind_address), sizeof(bind_address));
 
@@ -166,15 +305,18 @@ namespace Kernel
 		sockaddr_in* in_addr = reinterpret_cast<sockaddr_in*>(address);
 
 		SpinLockGuard _(m_bound_socket_lock);
-		for (auto& [bound_port, bound_socket] : m_bound_sockets)
+		for (auto& [bound_port, bound_sockets] : m_bound_sockets)
 		{
-			if (socket != bound_socket.lock())
-				continue;
-			// FIXME: sockets should have bound address
-			in_addr->sin_family = AF_INET;
-			in_addr->sin_port = bound_port;
-			in_addr->sin_addr.s_addr = INADDR_ANY;
-			return {};
+			for (const auto& bound_socket : bound_sockets)
+			{
+				if (socket.ptr() != bound_socket.owner)
+					continue;
+				// FIXME: sockets should have bound address
+				in_addr->sin_family = AF_INET;
+				in_addr->sin_port = bound_port;
+				in_addr->sin_addr.s_addr = INADDR_ANY;
+				return {};
+			}
 		}
 
 		return {};
@@ -192,40 +334,91 @@ namespace Kernel
 		auto& sockaddr_in = *reinterpret_cast<const struct sockaddr_in*>(address);
 		auto dst_port = BAN::host_to_network_endian(sockaddr_in.sin_port);
 		auto dst_ipv4 = BAN::IPv4Address { sockaddr_in.sin_addr.s_addr };
-		auto dst_mac = TRY(m_arp_table->get_mac_from_ipv4(*interface, dst_ipv4));
 
 		if (interface->type() == NetworkInterface::Type::Loopback)
 		{
-			BAN::RefPtr<NetworkSocket> receiver;
+			const auto receiver = find_bound_socket({
+				.local_address = dst_ipv4,
+				.remote_address = interface->get_ipv4_address(),
+				.local_port = dst_port,
+				.remote_port = socket.bound_port(),
+				.protocol = socket.protocol(),
+			});
 
+			if (!receiver)
+				return BAN::Error::from_errno(EADDRNOTAVAIL);
+
+			// Local datagrams are handed directly to the receiving socket, skipping header
+			// building, checksums and the loopback thread. TCP segments still go through the
+			// interface, as TCP sockets send while holding their own lock and receiving locks
+			// the peer, so delivering them in the sender's context could deadlock.
+			if (socket.protocol() == NetworkProtocol::UDP && receiver->protocol() == NetworkProtocol::UDP)
 			{
-				SpinLockGuard _(m_bound_socket_lock);
-				auto receiver_it = m_bound_sockets.find(dst_port);
-				if (receiver_it != m_bound_sockets.end())
-					receiver = receiver_it->value.lock();
+				if (sizeof(IPv4Header) + socket.protocol_header_size() + payload.size() > interface->payload_mtu())
+					return BAN::Error::from_errno(EMSGSIZE);
+
+				struct sockaddr_in sender;
+				sender.sin_family = AF_INET;
+				sender.sin_port = BAN::host_to_network_endian(socket.bound_port());
+				sender.sin_addr.s_addr = interface->get_ipv4_address().raw;
+				static_cast<UDPSocket*>(receiver.ptr())->receive_payload(payload, reinterpret_cast<const sockaddr*>(&sender), sizeof(sender));
+				return {};
 			}
+		}
 
-			if (!receiver)
-				return BAN::Error::from_errno(EADDRNOTAVAIL);
+		const size_t packet_size = sizeof(IPv4Header) + socket.protocol_header_size() + payload.size();
+
+		TransmitOffload offload {
+			.checksums   = 0,
+			.l3_offset   = 0,
+			.l4_offset   = sizeof(IPv4Header),
+			.header_size = 0,
+			.tso_mss     = 0,
+		};
+
+		// NOTE: segments must respect the peer's mss even when they would fit in the interface mtu
+		const bool exceeds_mtu = packet_size > interface->payload_mtu();
+		const bool exceeds_mss = socket.segmentation_mss() && payload.size() > socket.segmentation_mss();
+		if (exceeds_mtu || exceeds_mss)
+		{
+			if (!(interface->offload_features() & OFFLOAD_TX_TSO) || socket.segmentation_mss() == 0 || packet_size > 0xFFFF)
+				return BAN::Error::from_errno(EMSGSIZE);
+			offload.header_size = sizeof(IPv4Header) + socket.protocol_header_size();
+			offload.tso_mss = BAN::Math::min<size_t>(socket.segmentation_mss(), interface->payload_mtu() - offload.header_size);
+			// NOTE: ipv4 header changes for every segment
+			offload.checksums |= CKSUM_IPV4;
 		}
 
-		const auto ipv4_header = get_ipv4_header(
-			sizeof(IPv4Header) + socket.protocol_header_size() + payload.size(),
+		uint32_t protocol_checksum = 0;
+		switch (socket.protocol())
+		{
+			case NetworkProtocol::TCP: protocol_checksum = CKSUM_TCP; break;
+			case NetworkProtocol::UDP: protocol_checksum = CKSUM_UDP; break;
+			default: break;
+		}
+		if (offload.tso_mss || (interface->offload_features() & protocol_checksum))
+			offload.checksums |= protocol_checksum;
+
+		auto ipv4_header = get_ipv4_header(
+			packet_size,
 			interface->get_ipv4_address(),
 			dst_ipv4,
 			socket.protocol()
 		);
+		if (offload.checksums & CKSUM_IPV4)
+			ipv4_header.checksum = 0;
 
+		// NOTE: segmented packets have the tcp length added by the interface
 		const auto pseudo_header = PseudoHeader {
 			.src_ipv4 = interface->get_ipv4_address(),
 			.dst_ipv4 = dst_ipv4,
 			.protocol = socket.protocol(),
-			.length = socket.protocol_header_size() + payload.size()
+			.length = offload.tso_mss ? 0 : socket.protocol_header_size() + payload.size()
 		};
 
 		uint8_t protocol_header_buffer[32];
 		auto protocol_header = BAN::ByteSpan::from(protocol_header_buffer).slice(0, socket.protocol_header_size());
-		socket.get_protocol_header(protocol_header, payload, dst_port, pseudo_header);
+		socket.get_protocol_header(protocol_header, payload, dst_port, pseudo_header, !!(offload.checksums & protocol_checksum));
 
 		const BAN::ConstByteSpan buffers[] {
 			BAN::ConstByteSpan::from(ipv4_header),
@@ -233,7 +426,7 @@ namespace Kernel
 			payload,
 		};
 
-		TRY(interface->send_with_ethernet_header(dst_mac, EtherType::IPv4, buffers));
+		TRY(m_arp_table->send_ipv4_packet(*interface, dst_ipv4, buffers, offload));
 
 		return {};
 	}
@@ -282,8 +475,6 @@ namespace Kernel
 				{
 					case ICMPType::EchoRequest:
 					{
-						const auto dst_mac = TRY(m_arp_table->get_mac_from_ipv4(interface, src_ipv4));
-
 						const auto send_ipv4_header = get_ipv4_header(
 							ipv4_data.size(),
 							interface.get_ipv4_address(),
@@ -308,7 +499,7 @@ namespace Kernel
 							send_buffers + 1, sizeof(send_buffers) / sizeof(*send_buffers) - 1
 						});
 
-						TRY(interface.send_with_ethernet_header(dst_mac, EtherType::IPv4, send_buffers));
+						TRY(m_arp_table->send_ipv4_packet(interface, src_ipv4, send_buffers));
 
 						break;
 					}
@@ -357,18 +548,19 @@ namespace Kernel
 		ASSERT(dst_port != NetworkSocket::PORT_NONE);
 		ASSERT(src_port != NetworkSocket::PORT_NONE);
 
-		BAN::RefPtr<Kernel::NetworkSocket> bound_socket;
+		const auto connection_key = ConnectionKey {
+			.local_address = ipv4_header.dst_address,
+			.remote_address = src_ipv4,
+			.local_port = dst_port,
+			.remote_port = src_port,
+			.protocol = ipv4_header.protocol,
+		};
 
-		{
-			SpinLockGuard _(m_bound_socket_lock);
-			auto it = m_bound_sockets.find(dst_port);
-			if (it == m_bound_sockets.end())
-			{
-				dprintln_if(DEBUG_IPV4, "no one is listening on port {}", dst_port);
-				return {};
-			}
-			bound_socket = it->value.lock();
-		}
+		// established connections are found by their 4-tuple, other packets
+		// (e.g. SYNs) go to the socket bound to the destination port
+		auto bound_socket = find_connected_socket(connection_key);
+		if (!bound_socket)
+			bound_socket = find_bound_socket(connection_key);
 
 		if (!bound_socket)
 		{
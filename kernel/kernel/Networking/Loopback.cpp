@@ -40,6 +40,7 @@ namespace Kernel
 			loopback->m_descriptors[i] = {
 				.addr = reinterpret_cast<uint8_t*>(loopback->m_buffer->vaddr()) + i * buffer_size,
 				.size = 0,
+				.validated_cksums = 0,
 				.state = 0,
 			};
 		}
@@ -56,7 +57,7 @@ namespace Kernel
 			Processor::yield();
 	}
 
-	BAN::ErrorOr<void> LoopbackInterface::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers)
+	BAN::ErrorOr<void> LoopbackInterface::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload)
 	{
 		const auto interrupt_state = Processor::get_interrupt_state();
 		Processor::set_interrupt_state(InterruptState::Disabled);
@@ -89,6 +90,7 @@ namespace Kernel
 
 		m_buffer_lock.lock();
 		descriptor.size = packet_size;
+		descriptor.validated_cksums = offload.checksums;
 		descriptor.state = 2;
 		m_thread_blocker.unblock();
 		m_buffer_lock.unlock(interrupt_state);
@@ -111,7 +113,7 @@ namespace Kernel
 
 				m_buffer_lock.unlock(InterruptState::Enabled);
 
-				NetworkManager::get().on_receive(*this, BAN::ConstByteSpan { descriptor.addr, descriptor.size }, 0);
+				NetworkManager::get().on_receive(*this, BAN::ConstByteSpan { descriptor.addr, descriptor.size }, descriptor.validated_cksums);
 
 				m_buffer_lock.lock();
 
@@ -135,5 +135,22 @@ namespace Kernel
 		return CharacterDevice::ioctl_impl(request, arg);
 	}
 
+	size_t NetworkInterface::gather_buffers(BAN::Span<const BAN::ConstByteSpan>& buffers, size_t& offset, BAN::ByteSpan destination)
+	{
+		size_t ncopied = 0;
+		while (!buffers.empty() && ncopied < destination.size())
+		{
+			const size_t to_copy = BAN::Math::min(buffers[0].size() - offset, destination.size() - ncopied);
+			memcpy(destination.data() + ncopied, buffers[0].data() + offset, to_copy);
+			ncopied += to_copy;
+			offset += to_copy;
+
+			if (offset < buffers[0].size())
+				continue;
+			buffers = buffers.slice(1);
+			offset = 0;
+		}
+		return ncopied;
+	}
 
 }
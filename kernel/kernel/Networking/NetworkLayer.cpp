@@ -3,6 +3,61 @@
 namespace Kernel
 {
 
+	// Sums buffer as 32 bit words into 64 bit accumulators. Using multiple
+	// accumulators allows the additions to be executed in parallel and the
+	// carries are only folded once at the end. Accumulators cannot overflow
+	// with buffers smaller than 16 GiB.
+	static uint64_t sum_checksum_words(const uint8_t* data, size_t size)
+	{
+		uint64_t sum0 = 0;
+		uint64_t sum1 = 0;
+		uint64_t sum2 = 0;
+		uint64_t sum3 = 0;
+
+		for (; size >= 16; data += 16, size -= 16)
+		{
+			uint32_t words[4];
+			memcpy(words, data, sizeof(words));
+			sum0 += words[0];
+			sum1 += words[1];
+			sum2 += words[2];
+			sum3 += words[3];
+		}
+
+		uint64_t sum = sum0 + sum1 + sum2 + sum3;
+
+		for (; size >= 4; data += 4, size -= 4)
+		{
+			uint32_t word;
+			memcpy(&word, data, sizeof(word));
+			sum += word;
+		}
+
+		if (size >= 2)
+		{
+			uint16_t word;
+			memcpy(&word, data, sizeof(word));
+			sum += word;
+			data += 2;
+			size -= 2;
+		}
+
+		if (size)
+			sum += *data;
+
+		return sum;
+	}
+
+	static uint32_t fold_checksum(uint64_t sum)
+	{
+		sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+		sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+		sum = (sum & 0xFFFF) + (sum >> 16);
+		sum = (sum & 0xFFFF) + (sum >> 16);
+		sum = (sum & 0xFFFF) + (sum >> 16);
+		return sum;
+	}
+
 	uint16_t calculate_internet_checksum(BAN::ConstByteSpan buffer)
 	{
 		return calculate_internet_checksum({ &buffer, 1 });
@@ -11,27 +66,24 @@ namespace Kernel
 	uint16_t calculate_internet_checksum(BAN::Span<const BAN::ConstByteSpan> buffers)
 	{
 		uint32_t checksum = 0;
+		bool odd_offset = false;
 
 		for (size_t i = 0; i < buffers.size(); i++)
 		{
-			auto buffer = buffers[i];
-
-			const uint16_t* buffer_u16 = reinterpret_cast<const uint16_t*>(buffer.data());
-			for (size_t j = 0; j < buffer.size() / 2; j++)
-				checksum += buffer_u16[j];
-
-			if (buffer.size() % 2)
-			{
-				// NOTE: we only allow last buffer to be odd-length
-				ASSERT(i == buffers.size() - 1);
-				checksum += buffer[buffer.size() - 1];
-			}
-		}
+			const auto buffer = buffers[i];
+
+			uint32_t partial = fold_checksum(sum_checksum_words(buffer.data(), buffer.size()));
 
-		while (checksum >> 16)
-			checksum = (checksum & 0xFFFF) + (checksum >> 16);
+			// NOTE: if buffer starts at an odd offset, its bytes are on the wrong halves
+			//       of 16 bit words. Byte swapping the partial sum fixes this (RFC 1071)
+			if (odd_offset)
+				partial = ((partial & 0xFF) << 8) | (partial >> 8);
+			checksum += partial;
+
+			odd_offset ^= (buffer.size() % 2);
+		}
 
-		return BAN::host_to_network_endian<uint16_t>(~checksum);
+		return BAN::host_to_network_endian<uint16_t>(~fold_checksum(checksum));
 	}
 
 }
@@ -1,6 +1,7 @@
 #include <BAN/Endianness.h>
 #include <BAN/UniqPtr.h>
 #include <kernel/FS/DevFS/FileSystem.h>
+#include <kernel/Lock/LockGuard.h>
 #include <kernel/Networking/E1000/E1000.h>
 #include <kernel/Networking/E1000/E1000E.h>
 #include <kernel/Networking/ICMP.h>
@@ -69,7 +70,10 @@ namespace Kernel
 
 	BAN::ErrorOr<void> NetworkManager::add_interface(BAN::RefPtr<NetworkInterface> interface)
 	{
-		TRY(m_interfaces.push_back(interface));
+		{
+			LockGuard _(m_interface_lock);
+			TRY(m_interfaces.push_back(interface));
+		}
 		DevFileSystem::get().add_device(interface);
 		return {};
 	}
@@ -203,20 +203,80 @@ namespace Kernel
 		return 0;
 	}
 
-	BAN::ErrorOr<void> RTL8169::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers)
+	uint32_t RTL8169::offload_features() const
+	{
+		return OFFLOAD_TX_CKSUM_IPV4
+			| OFFLOAD_TX_CKSUM_TCP
+			| OFFLOAD_TX_CKSUM_UDP
+			| OFFLOAD_TX_TSO;
+	}
+
+	void RTL8169::get_tx_offload_bits(const TransmitOffload& offload, uint32_t& command, uint32_t& vlan) const
+	{
+		command = 0;
+		vlan = 0;
+
+		const uint32_t mss = BAN::Math::min<uint32_t>(offload.tso_mss, RTL8169_TX_MSS_MAX);
+
+		// NOTE: 8169 uses the original descriptor layout, newer chips have offload bits in the second dword
+		if (m_pci_device.device_id() == 0x8169)
+		{
+			if (mss)
+				command |= RTL8169_DESC_CMD_LGSEN | (mss << RTL8169_TX_V1_MSS_SHIFT);
+			else if (offload.checksums)
+			{
+				command |= RTL8169_TX_V1_IP_CS;
+				if (offload.checksums & CKSUM_TCP)
+					command |= RTL8169_TX_V1_TCP_CS;
+				if (offload.checksums & CKSUM_UDP)
+					command |= RTL8169_TX_V1_UDP_CS;
+			}
+			return;
+		}
+
+		if (mss)
+		{
+			command |= RTL8169_TX_V2_GTSENV4 | (offload.l4_offset << RTL8169_TX_V2_GTTCPHO_SHIFT);
+			vlan |= mss << RTL8169_TX_V2_MSS_SHIFT;
+		}
+		else if (offload.checksums)
+		{
+			vlan |= RTL8169_TX_V2_IPV4_CS | (offload.l4_offset << RTL8169_TX_V2_TCPHO_SHIFT);
+			if (offload.checksums & CKSUM_TCP)
+				vlan |= RTL8169_TX_V2_TCP_CS;
+			if (offload.checksums & CKSUM_UDP)
+				vlan |= RTL8169_TX_V2_UDP_CS;
+		}
+	}
+
+	BAN::ErrorOr<void> RTL8169::send_raw_bytes(BAN::Span<const BAN::ConstByteSpan> buffers, const TransmitOffload& offload)
 	{
 		if (!link_up())
 			return BAN::Error::from_errno(EADDRNOTAVAIL);
 
+		size_t packet_size = 0;
+		for (const auto& buffer : buffers)
+			packet_size += buffer.size();
+
+		// segmented packets may span multiple descriptors
+		const uint32_t descriptor_count = BAN::Math::div_round_up<size_t>(packet_size, s_buffer_size);
+		ASSERT(offload.tso_mss || descriptor_count == 1);
+		ASSERT(descriptor_count <= m_tx_descriptor_count / 2);
+
+		uint32_t offload_command, offload_vlan;
+		get_tx_offload_bits(offload, offload_command, offload_vlan);
+
 		const auto interrupt_state = Processor::get_interrupt_state();
 		Processor::set_interrupt_state(InterruptState::Disabled);
 
-		const uint32_t tx_current_nowrap = m_tx_head.fetch_add(1);
-		const uint32_t tx_current = tx_current_nowrap % m_tx_descriptor_count;
+		const uint32_t tx_first_nowrap = m_tx_head.fetch_add(descriptor_count);
 
-		auto& descriptor = reinterpret_cast<volatile RTL8169Descriptor*>(m_tx_descriptor_region->vaddr())[tx_current];
-		if (descriptor.command & RTL8169_DESC_CMD_OWN)
+		auto* tx_descriptors = reinterpret_cast<volatile RTL8169Descriptor*>(m_tx_descriptor_region->vaddr());
+		for (uint32_t i = 0; i < descriptor_count; i++)
 		{
+			auto& descriptor = tx_descriptors[(tx_first_nowrap + i) % m_tx_descriptor_count];
+			if (!(descriptor.command & RTL8169_DESC_CMD_OWN))
+				continue;
 			SpinLockGuard guard(m_tx_lock);
 			while (descriptor.command & RTL8169_DESC_CMD_OWN)
 			{
@@ -225,29 +285,38 @@ namespace Kernel
 			}
 		}
 
-		auto* tx_buffer = reinterpret_cast<uint8_t*>(m_tx_buffer_region->vaddr() + tx_current * s_buffer_size);
-
-		// write packet
-		size_t packet_size = 0;
-		for (const auto& buffer : buffers)
+		// write packet, ownership of the first descriptor is given to NIC last
+		size_t buffer_offset = 0;
+		uint32_t first_command = 0;
+		for (uint32_t i = 0; i < descriptor_count; i++)
 		{
-			ASSERT(packet_size + buffer.size() <= s_buffer_size);
-			memcpy(tx_buffer + packet_size, buffer.data(), buffer.size());
-			packet_size += buffer.size();
+			const uint32_t tx_current = (tx_first_nowrap + i) % m_tx_descriptor_count;
+
+			auto* tx_buffer = reinterpret_cast<uint8_t*>(m_tx_buffer_region->vaddr() + tx_current * s_buffer_size);
+			const size_t length = gather_buffers(buffers, buffer_offset, { tx_buffer, s_buffer_size });
+
+			uint32_t command = length | offload_command | RTL8169_DESC_CMD_OWN;
+			if (i == 0)
+				command |= RTL8169_DESC_CMD_FS;
+			if (i == descriptor_count - 1)
+				command |= RTL8169_DESC_CMD_LS;
+			if (tx_current == m_tx_descriptor_count - 1)
+				command |= RTL8169_DESC_CMD_EOR;
+
+			auto& descriptor = tx_descriptors[tx_current];
+			descriptor.vlan = offload_vlan;
+			if (i == 0)
+				first_command = command;
+			else
+				descriptor.command = command;
 		}
-
-		// give packet ownership to NIC
-		uint32_t command = packet_size | RTL8169_DESC_CMD_OWN | RTL8169_DESC_CMD_LS | RTL8169_DESC_CMD_FS;
-		if (tx_current == m_tx_descriptor_count - 1)
-			command |= RTL8169_DESC_CMD_EOR;
-		descriptor.command = command;
+		tx_descriptors[tx_first_nowrap % m_tx_descriptor_count].command = first_command;
 
 		// ring tx queue doorbell
-		if (tx_current_nowrap == m_tx_commit.load())
-			m_io_bar_region->write8(RTL8169_IO_TPPoll, RTL8169_TPPoll_NPQ);
-		while (tx_current_nowrap != m_tx_commit.load())
+		while (tx_first_nowrap != m_tx_commit.load())
 			Processor::pause();
-		m_tx_commit.add_fetch(1);
+		m_io_bar_region->write8(RTL8169_IO_TPPoll, RTL8169_TPPoll_NPQ);
+		m_tx_commit.add_fetch(descriptor_count);
 
 		Processor::set_interrupt_state(interrupt_state);
 
@@ -94,6 +94,12 @@ namespace Kernel
 		return_inode->m_mutex.lock();
 		memcpy(&return_inode->m_address, &m_address, m_address_len);
 		return_inode->m_address_len = m_address_len;
+		if (auto& local_in = reinterpret_cast<sockaddr_in&>(return_inode->m_address); local_in.sin_addr.s_addr == INADDR_ANY)
+		{
+			auto interface_or_error = interface(reinterpret_cast<const sockaddr*>(&connection.target.address), connection.target.address_len);
+			if (!interface_or_error.is_error())
+				local_in.sin_addr.s_addr = interface_or_error.value()->get_ipv4_address().raw;
+		}
 		return_inode->m_listen_parent = this;
 		return_inode->m_connection_info.emplace(connection.target);
 		return_inode->m_recv_window.start_seq = connection.target_start_seq;
@@ -107,6 +113,16 @@ namespace Kernel
 
 		TRY(m_listen_children.emplace(listen_key, return_inode));
 
+		// packets of this connection no longer have to go through the listening socket.
+		// if this fails, they are still redirected with the listen children map
+		return_inode->m_mutex.lock();
+		return_inode->m_has_connection_entry = !m_network_layer.add_connection(
+			return_inode,
+			reinterpret_cast<const sockaddr*>(&connection.target.address),
+			connection.target.address_len
+		).is_error();
+		return_inode->m_mutex.unlock();
+
 		const uint64_t wake_time_ms = SystemTimer::get().ms_since_boot() + 5000;
 		while (!return_inode->m_has_connected)
 			TRY(Thread::current().block_or_eintr_or_waketime_ms(return_inode->m_thread_blocker, wake_time_ms, true, &m_mutex));
@@ -155,6 +171,8 @@ namespace Kernel
 		m_connection_info.emplace(sockaddr_storage {}, address_len, true);
 		memcpy(&m_connection_info->address, address, address_len);
 
+		m_has_connection_entry = !m_network_layer.add_connection(this, address, address_len).is_error();
+
 		m_next_flags = SYN;
 		if (m_network_layer.sendto(*this, {}, address, address_len).is_error())
 		{
@@ -335,6 +353,9 @@ namespace Kernel
 					case SO_RCVBUF:
 						result = m_recv_window.buffer->capacity();
 						break;
+					case SO_REUSEPORT:
+						result = m_reuse_port;
+						break;
 					default:
 						dwarnln("getsockopt(SOL_SOCKET, {})", option);
 						return BAN::Error::from_errno(ENOPROTOOPT);
@@ -377,6 +398,11 @@ namespace Kernel
 							return BAN::Error::from_errno(EINVAL);
 						m_keep_alive = *static_cast<const int*>(value);
 						break;
+					case SO_REUSEPORT:
+						if (value_len != sizeof(int))
+							return BAN::Error::from_errno(EINVAL);
+						m_reuse_port = *static_cast<const int*>(value);
+						break;
 					default:
 						dwarnln("setsockopt(SOL_SOCKET, {})", option);
 						return BAN::Error::from_errno(ENOPROTOOPT);
@@ -450,6 +476,17 @@ namespace Kernel
 		return BAN::Error::from_errno(ECONNRESET);
 	}
 
+	size_t TCPSocket::max_send_segment_size(const sockaddr* target, socklen_t target_len)
+	{
+		auto interface_or_error = interface(target, target_len);
+		if (interface_or_error.is_error())
+			return m_send_window.mss;
+		if (!(interface_or_error.value()->offload_features() & OFFLOAD_TX_TSO))
+			return m_send_window.mss;
+		// interface segments the payload, make sure the ip total length does not overflow
+		return 0xFFFF - m_network_layer.header_size() - protocol_header_size();
+	}
+
 	TCPSocket::ListenKey::ListenKey(const sockaddr* addr, socklen_t addr_len)
 	{
 		ASSERT(addr->sa_family == AF_INET);
@@ -515,7 +552,7 @@ namespace Kernel
 		return result;
 	}
 
-	void TCPSocket::get_protocol_header(BAN::ByteSpan header_buffer, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader pseudo_header)
+	void TCPSocket::get_protocol_header(BAN::ByteSpan header_buffer, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader pseudo_header, bool checksum_offload)
 	{
 		ASSERT(m_next_flags);
 		ASSERT(m_mutex.locker() == Thread::current().tid());
@@ -561,12 +598,20 @@ namespace Kernel
 			m_send_window.current_seq = m_send_window.start_seq;
 		}
 
-		const BAN::ConstByteSpan buffers[] {
-			BAN::ConstByteSpan::from(pseudo_header),
-			header_buffer,
-			payload,
-		};
-		header.checksum = calculate_internet_checksum({ buffers, sizeof(buffers) / sizeof(*buffers) });
+		if (checksum_offload)
+		{
+			// non-inverted pseudo header checksum
+			header.checksum = static_cast<uint16_t>(~calculate_internet_checksum(BAN::ConstByteSpan::from(pseudo_header)));
+		}
+		else
+		{
+			const BAN::ConstByteSpan buffers[] {
+				BAN::ConstByteSpan::from(pseudo_header),
+				header_buffer,
+				payload,
+			};
+			header.checksum = calculate_internet_checksum({ buffers, sizeof(buffers) / sizeof(*buffers) });
+		}
 
 		dprintln_if(DEBUG_TCP, "sending {} {8b}", (uint8_t)m_state, header.flags);
 		dprintln_if(DEBUG_TCP, "  ack {}", (uint32_t)header.ack_number);
@@ -811,12 +856,21 @@ namespace Kernel
 
 	void TCPSocket::set_connection_as_closed()
 	{
+		if (m_has_connection_entry)
+		{
+			m_network_layer.remove_connection(*this,
+				reinterpret_cast<const sockaddr*>(&m_connection_info->address),
+				m_connection_info->address_len
+			);
+			m_has_connection_entry = false;
+		}
+
 		if (is_bound())
 		{
 			// NOTE: Only listen socket can unbind the socket as
 			//       listen socket is always alive to redirect packets
 			if (!m_listen_parent)
-				m_network_layer.unbind_socket(bound_port());
+				m_network_layer.unbind_socket(*this, bound_port());
 			else
 				m_listen_parent->remove_listen_child(this);
 			m_address.ss_family = AF_UNSPEC;
@@ -940,9 +994,11 @@ namespace Kernel
 
 				m_send_window.current_seq = m_send_window.start_seq + send_offset;
 
+				const size_t segment_size = max_send_segment_size(target_address, target_address_len);
+
 				for (size_t i = 0; i < total_send;)
 				{
-					const size_t to_send = BAN::Math::min<size_t>(total_send - i, m_send_window.mss);
+					const size_t to_send = BAN::Math::min<size_t>(total_send - i, segment_size);
 
 					auto message = m_send_window.buffer->get_data().slice(send_offset + i, to_send);
 
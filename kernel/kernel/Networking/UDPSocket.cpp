@@ -30,12 +30,12 @@ namespace Kernel
 	UDPSocket::~UDPSocket()
 	{
 		if (is_bound())
-			m_network_layer.unbind_socket(bound_port());
+			m_network_layer.unbind_socket(*this, bound_port());
 		m_address.ss_family = AF_UNSPEC;
 		m_address_len = 0;
 	}
 
-	void UDPSocket::get_protocol_header(BAN::ByteSpan header_buffer, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader pseudo_header)
+	void UDPSocket::get_protocol_header(BAN::ByteSpan header_buffer, BAN::ConstByteSpan payload, uint16_t dst_port, PseudoHeader pseudo_header, bool checksum_offload)
 	{
 		ASSERT(header_buffer.size() == protocol_header_size());
 
@@ -47,6 +47,13 @@ namespace Kernel
 			.checksum = 0,
 		};
 
+		if (checksum_offload)
+		{
+			// non-inverted pseudo header checksum
+			header.checksum = static_cast<uint16_t>(~calculate_internet_checksum(BAN::ConstByteSpan::from(pseudo_header)));
+			return;
+		}
+
 		const BAN::ConstByteSpan buffers[] {
 			BAN::ConstByteSpan::from(pseudo_header),
 			header_buffer,
@@ -107,6 +114,11 @@ namespace Kernel
 			}
 		}
 
+		receive_payload(packet.slice(sizeof(UDPHeader)), sender, sender_len);
+	}
+
+	void UDPSocket::receive_payload(BAN::ConstByteSpan payload, const sockaddr* sender, socklen_t sender_len)
+	{
 		SpinLockGuard _(m_packet_lock);
 
 		if (m_packets.full())
@@ -115,8 +127,6 @@ namespace Kernel
 			return;
 		}
 
-		const auto payload = packet.slice(sizeof(UDPHeader));
-
 		if (m_packet_total_size + payload.size() > m_packet_buffer->size())
 		{
 			dwarnln("Packet buffer full, dropping packet");
@@ -156,7 +166,7 @@ namespace Kernel
 		return m_network_layer.bind_socket_to_address(this, address, address_len);
 	}
 
-	BAN::ErrorOr<size_t> UDPSocket::recvmsg_impl(msghdr& message, int flags)
+	BAN::ErrorOr<void> UDPSocket::validate_recvmsg(msghdr& message, int flags)
 	{
 		flags &= (MSG_OOB | MSG_PEEK | MSG_WAITALL);
 		if (flags != 0)
@@ -177,7 +187,12 @@ namespace Kernel
 			return BAN::Error::from_errno(EINVAL);
 		}
 
-		SpinLockGuard guard(m_packet_lock);
+		return {};
+	}
+
+	BAN::ErrorOr<void> UDPSocket::wait_for_packet()
+	{
+		ASSERT(m_packet_lock.current_processor_has_lock());
 
 		while (m_packets.empty())
 		{
@@ -185,6 +200,13 @@ namespace Kernel
 			TRY(Thread::current().block_or_eintr_indefinite(m_packet_thread_blocker, &block));
 		}
 
+		return {};
+	}
+
+	size_t UDPSocket::receive_queued_packet(msghdr& message)
+	{
+		ASSERT(m_packet_lock.current_processor_has_lock());
+
 		auto packet_info = m_packets.front();
 		m_packets.pop();
 
@@ -198,11 +220,11 @@ namespace Kernel
 			const size_t nrecv = BAN::Math::min<size_t>(message.msg_iov[i].iov_len, packet_info.packet_size - total_recv);
 			memcpy(message.msg_iov[i].iov_base, packet_buffer + total_recv, nrecv);
 			total_recv += nrecv;
-
-			if (nrecv < packet_info.packet_size)
-				message.msg_flags |= MSG_TRUNC;
 		}
 
+		if (total_recv < packet_info.packet_size)
+			message.msg_flags |= MSG_TRUNC;
+
 		memmove(
 			packet_buffer,
 			packet_buffer + packet_info.packet_size,
@@ -221,6 +243,33 @@ namespace Kernel
 		return total_recv;
 	}
 
+	BAN::ErrorOr<size_t> UDPSocket::recvmsg_impl(msghdr& message, int flags)
+	{
+		TRY(validate_recvmsg(message, flags));
+
+		SpinLockGuard _(m_packet_lock);
+		TRY(wait_for_packet());
+		return receive_queued_packet(message);
+	}
+
+	BAN::ErrorOr<size_t> UDPSocket::recvmmsg_impl(BAN::Span<mmsghdr> messages, int flags)
+	{
+		for (auto& message : messages)
+			TRY(validate_recvmsg(message.msg_hdr, flags));
+
+		SpinLockGuard _(m_packet_lock);
+		TRY(wait_for_packet());
+
+		size_t count = 0;
+		while (count < messages.size() && !m_packets.empty())
+		{
+			messages[count].msg_len = receive_queued_packet(messages[count].msg_hdr);
+			count++;
+		}
+
+		return count;
+	}
+
 	BAN::ErrorOr<size_t> UDPSocket::sendmsg_impl(const msghdr& message, int flags)
 	{
 		if (flags & ~(MSG_NOSIGNAL | MSG_DONTWAIT))
@@ -295,6 +344,9 @@ namespace Kernel
 					case SO_RCVBUF:
 						result = m_packet_buffer->size();
 						break;
+					case SO_REUSEPORT:
+						result = m_reuse_port;
+						break;
 					default:
 						dwarnln("getsockopt(SOLSOCKET, {})", option);
 						return BAN::Error::from_errno(ENOPROTOOPT);
@@ -317,14 +369,21 @@ namespace Kernel
 
 	BAN::ErrorOr<void> UDPSocket::setsockopt_impl(int level, int option, const void* value, socklen_t value_len)
 	{
-		(void)value;
-		(void)value_len;
-
 		switch (level)
 		{
 			case SOL_SOCKET:
-				dwarnln("setsockopt(SOL_SOCKET, {})", option);
-				return BAN::Error::from_errno(ENOPROTOOPT);
+				switch (option)
+				{
+					case SO_REUSEPORT:
+						if (value_len != sizeof(int))
+							return BAN::Error::from_errno(EINVAL);
+						m_reuse_port = *static_cast<const int*>(value);
+						break;
+					default:
+						dwarnln("setsockopt(SOL_SOCKET, {})", option);
+						return BAN::Error::from_errno(ENOPROTOOPT);
+				}
+				break;
 			case IPPROTO_UDP:
 				dwarnln("setsockopt(IPPROTO_UDP, {})", option);
 				return BAN::Error::from_errno(ENOPROTOOPT);
@@ -18,6 +18,7 @@ namespace Kernel
 	static Mutex s_bound_socket_lock;
 
 	static constexpr size_t s_packet_buffer_size = 0x10000;
+	static_assert(BAN::Math::is_power_of_two(s_packet_buffer_size));
 
 	static BAN::ErrorOr<BAN::StringView> validate_sockaddr_un(const sockaddr* address, socklen_t address_len)
 	{
@@ -85,6 +86,9 @@ namespace Kernel
 			{
 				connection->m_info.get<ConnectionInfo>().target_closed = true;
 				connection->epoll_notify(EPOLLHUP);
+
+				// readers check target_closed while holding the packet lock
+				LockGuard _(connection->m_packet_lock);
 				connection->m_packet_thread_blocker.unblock();
 			}
 		}
@@ -312,8 +316,241 @@ namespace Kernel
 		ASSERT_NOT_REACHED();
 	}
 
+	static void write_ancillary_data(msghdr& message, cmsghdr*& cheader, size_t& cheader_len, BAN::Vector<OpenFileDescriptorSet::FDWrapper>& fds_to_open, BAN::Optional<struct ucred>& ucred_to_recv)
+	{
+		if (!fds_to_open.empty()) do
+		{
+			if (cheader == nullptr)
+			{
+				dwarnln("no space to receive {} fds", fds_to_open.size());
+				message.msg_flags |= MSG_CTRUNC;
+				break;
+			}
+
+			const size_t max_fd_count = (cheader->cmsg_len - sizeof(cmsghdr)) / sizeof(int);
+			if (max_fd_count < fds_to_open.size())
+				message.msg_flags |= MSG_CTRUNC;
+
+			const size_t fd_count = BAN::Math::min(fds_to_open.size(), max_fd_count);
+			const size_t fds_opened = Process::current().open_file_descriptor_set().open_all_fd_wrappers(fds_to_open.span().slice(0, fd_count));
+
+			auto* fd_data = reinterpret_cast<int*>(CMSG_DATA(cheader));
+			for (size_t i = 0; i < fds_opened; i++)
+				fd_data[i] = fds_to_open[i].fd();
+
+			const size_t header_length = CMSG_LEN(fds_opened * sizeof(int));
+			cheader->cmsg_level = SOL_SOCKET;
+			cheader->cmsg_type = SCM_RIGHTS;
+			cheader->cmsg_len = header_length;
+			cheader = CMSG_NXTHDR(&message, cheader);
+			if (cheader != nullptr)
+				cheader->cmsg_len = message.msg_controllen - header_length;
+			cheader_len += header_length;
+		} while (false);
+
+		if (ucred_to_recv.has_value()) do
+		{
+			if (cheader == nullptr || cheader->cmsg_len - sizeof(cmsghdr) < sizeof(struct ucred))
+			{
+				dwarnln("no space to receive credentials");
+				message.msg_flags |= MSG_CTRUNC;
+				break;
+			}
+
+			*reinterpret_cast<struct ucred*>(CMSG_DATA(cheader)) = ucred_to_recv.value();
+
+			const size_t header_length = CMSG_LEN(sizeof(struct ucred));
+			cheader->cmsg_level = SOL_SOCKET;
+			cheader->cmsg_type = SCM_CREDENTIALS;
+			cheader->cmsg_len = header_length;
+			cheader = CMSG_NXTHDR(&message, cheader);
+			if (cheader != nullptr)
+				cheader->cmsg_len = message.msg_controllen - header_length;
+			cheader_len += header_length;
+		} while (false);
+	}
+
+	size_t UnixDomainSocket::stream_free_space() const
+	{
+		return s_packet_buffer_size - (m_stream_write_pos - m_stream_read_pos);
+	}
+
+	BAN::ErrorOr<size_t> UnixDomainSocket::add_stream_data(const msghdr& message, PacketInfo&& packet_info, bool dont_block)
+	{
+		ASSERT(is_streaming());
+
+		if (packet_info.size == 0)
+			return 0;
+
+		size_t bytes_copied = 0;
+
+		{
+			LockGuard _(m_stream_write_lock);
+
+			while (stream_free_space() == 0)
+			{
+				if (dont_block)
+					return BAN::Error::from_errno(EAGAIN);
+
+				// readers check m_stream_writers_waiting after advancing the read
+				// position, so either we see the new space or they see us waiting
+				m_stream_writers_waiting++;
+				BAN::ErrorOr<void> ret {};
+				if (stream_free_space() == 0)
+					ret = Thread::current().block_or_eintr_indefinite(m_stream_write_blocker, &m_stream_write_lock);
+				m_stream_writers_waiting--;
+				TRY(ret);
+			}
+
+			// only writers advance the write position and they hold m_stream_write_lock.
+			// NOTE: the lock is released while blocking, so this must be read after waiting
+			const size_t write_pos = m_stream_write_pos.load(BAN::memory_order_relaxed);
+
+			const size_t to_copy_total = BAN::Math::min(stream_free_space(), packet_info.size);
+
+			// ancillary data must be visible before the bytes it is attached to
+			if (!packet_info.fds.empty() || packet_info.ucred.has_value())
+			{
+				LockGuard _(m_stream_ancillary_lock);
+				TRY(m_stream_ancillary.push({
+					.offset = write_pos,
+					.size = to_copy_total,
+					.fds = BAN::move(packet_info.fds),
+					.ucred = BAN::move(packet_info.ucred),
+				}));
+				m_stream_ancillary_count++;
+			}
+
+			uint8_t* buffer_u8 = reinterpret_cast<uint8_t*>(m_packet_buffer->vaddr());
+
+			for (int i = 0; i < message.msg_iovlen && bytes_copied < to_copy_total; i++)
+			{
+				const uint8_t* iov_base_u8 = static_cast<const uint8_t*>(message.msg_iov[i].iov_base);
+
+				const size_t to_copy = BAN::Math::min(message.msg_iov[i].iov_len, to_copy_total - bytes_copied);
+
+				const size_t copy_offset = (write_pos + bytes_copied) % s_packet_buffer_size;
+				const size_t before_wrap = BAN::Math::min(to_copy, s_packet_buffer_size - copy_offset);
+				memcpy(buffer_u8 + copy_offset, iov_base_u8, before_wrap);
+				if (const size_t after_wrap = to_copy - before_wrap)
+					memcpy(buffer_u8, iov_base_u8 + before_wrap, after_wrap);
+
+				bytes_copied += to_copy;
+			}
+
+			ASSERT(bytes_copied == to_copy_total);
+			m_stream_write_pos.store(write_pos + bytes_copied);
+		}
+
+		if (m_stream_readers_waiting > 0)
+		{
+			LockGuard _(m_packet_lock);
+			m_packet_thread_blocker.unblock();
+		}
+
+		epoll_notify(EPOLLIN);
+
+		return bytes_copied;
+	}
+
+	BAN::ErrorOr<size_t> UnixDomainSocket::recvmsg_stream(msghdr& message)
+	{
+		ASSERT(is_streaming());
+
+		auto& connection_info = m_info.get<ConnectionInfo>();
+
+		size_t total_recv = 0;
+
+		{
+			LockGuard _(m_packet_lock);
+
+			while (m_stream_write_pos == m_stream_read_pos)
+			{
+				bool expected = true;
+				if (connection_info.target_closed.compare_exchange(expected, false))
+					return 0;
+				if (!connection_info.connection)
+					return BAN::Error::from_errno(ENOTCONN);
+
+				// writers check m_stream_readers_waiting after advancing the write
+				// position, so either we see the new data or they see us waiting
+				m_stream_readers_waiting++;
+				BAN::ErrorOr<void> ret {};
+				if (m_stream_write_pos == m_stream_read_pos)
+					ret = Thread::current().block_or_eintr_indefinite(m_packet_thread_blocker, &m_packet_lock);
+				m_stream_readers_waiting--;
+				TRY(ret);
+			}
+
+			// only readers advance the read position and they hold m_packet_lock.
+			// NOTE: the lock is released while blocking, so this must be read after waiting
+			const size_t read_pos = m_stream_read_pos.load(BAN::memory_order_relaxed);
+
+			size_t to_recv = m_stream_write_pos - read_pos;
+
+			auto* cheader = CMSG_FIRSTHDR(&message);
+			if (cheader != nullptr)
+				cheader->cmsg_len = message.msg_controllen;
+			size_t cheader_len = 0;
+
+			message.msg_flags = 0;
+
+			// on linux ancillary data is a barrier on stream sockets, lets do the same
+			if (m_stream_ancillary_count > 0)
+			{
+				LockGuard _(m_stream_ancillary_lock);
+
+				if (!m_stream_ancillary.empty() && m_stream_ancillary.front().offset == read_pos)
+				{
+					auto& ancillary = m_stream_ancillary.front();
+					write_ancillary_data(message, cheader, cheader_len, ancillary.fds, ancillary.ucred);
+					to_recv = BAN::Math::min(to_recv, ancillary.size);
+					m_stream_ancillary.pop();
+					m_stream_ancillary_count--;
+				}
+
+				if (!m_stream_ancillary.empty())
+					to_recv = BAN::Math::min(to_recv, m_stream_ancillary.front().offset - read_pos);
+			}
+
+			message.msg_controllen = cheader_len;
+
+			const uint8_t* buffer_u8 = reinterpret_cast<const uint8_t*>(m_packet_buffer->vaddr());
+
+			for (int i = 0; i < message.msg_iovlen && total_recv < to_recv; i++)
+			{
+				uint8_t* iov_base_u8 = static_cast<uint8_t*>(message.msg_iov[i].iov_base);
+
+				const size_t to_copy = BAN::Math::min(message.msg_iov[i].iov_len, to_recv - total_recv);
+
+				const size_t copy_offset = (read_pos + total_recv) % s_packet_buffer_size;
+				const size_t before_wrap = BAN::Math::min(to_copy, s_packet_buffer_size - copy_offset);
+				memcpy(iov_base_u8, buffer_u8 + copy_offset, before_wrap);
+				if (const size_t after_wrap = to_copy - before_wrap)
+					memcpy(iov_base_u8 + before_wrap, buffer_u8, after_wrap);
+
+				total_recv += to_copy;
+			}
+
+			m_stream_read_pos.store(read_pos + total_recv);
+		}
+
+		if (m_stream_writers_waiting > 0)
+		{
+			LockGuard _(m_stream_write_lock);
+			m_stream_write_blocker.unblock();
+		}
+
+		if (auto connection = connection_info.connection.lock())
+			connection->epoll_notify(EPOLLOUT);
+
+		return total_recv;
+	}
+
 	BAN::ErrorOr<size_t> UnixDomainSocket::add_packet(const msghdr& packet, PacketInfo&& packet_info, bool dont_block)
 	{
+		ASSERT(!is_streaming());
+
 		LockGuard _(m_packet_lock);
 
 		const auto has_space =
@@ -321,8 +558,6 @@ namespace Kernel
 			{
 				if (m_packet_infos.full())
 					return false;
-				if (is_streaming())
-					return m_packet_size_total < m_packet_buffer->size();
 				return m_packet_size_total + packet_info.size <= m_packet_buffer->size();
 			};
 
@@ -333,12 +568,6 @@ namespace Kernel
 			TRY(Thread::current().block_or_eintr_indefinite(m_packet_thread_blocker, &m_packet_lock));
 		}
 
-		if (auto available = m_packet_buffer->size() - m_packet_size_total; available < packet_info.size)
-		{
-			ASSERT(is_streaming());
-			packet_info.size = available;
-		}
-
 		uint8_t* packet_buffer_base_u8 = reinterpret_cast<uint8_t*>(m_packet_buffer->vaddr());
 
 		size_t bytes_copied = 0;
@@ -381,12 +610,21 @@ namespace Kernel
 				return false;
 		}
 
+		if (is_streaming())
+			return m_stream_write_pos != m_stream_read_pos;
+
 		LockGuard _(m_packet_lock);
 		return m_packet_size_total > 0;
 	}
 
 	bool UnixDomainSocket::can_write_impl() const
 	{
+		if (is_streaming())
+		{
+			auto target = m_info.get<ConnectionInfo>().connection.lock();
+			return !target || target->stream_free_space() > 0;
+		}
+
 		return m_bytes_sent < m_sndbuf;
 	}
 
@@ -401,7 +639,7 @@ namespace Kernel
 		return false;
 	}
 
-	BAN::ErrorOr<size_t> UnixDomainSocket::recvmsg_impl(msghdr& message, int flags)
+	static BAN::ErrorOr<void> validate_recvmsg_flags(int flags)
 	{
 		flags &= (MSG_OOB | MSG_PEEK | MSG_WAITALL);
 		if (flags != 0)
@@ -409,17 +647,21 @@ namespace Kernel
 			dwarnln("TODO: recvmsg with flags 0x{H}", flags);
 			return BAN::Error::from_errno(ENOTSUP);
 		}
+		return {};
+	}
 
-		LockGuard _(m_packet_lock);
+	BAN::ErrorOr<bool> UnixDomainSocket::wait_for_packet()
+	{
+		ASSERT(m_packet_lock.is_locked_by_current_thread());
 
-		while (m_packet_size_total == 0)
+		while (m_packet_infos.empty())
 		{
 			if (m_info.has<ConnectionInfo>())
 			{
 				auto& connection_info = m_info.get<ConnectionInfo>();
 				bool expected = true;
 				if (connection_info.target_closed.compare_exchange(expected, false))
-					return 0;
+					return false;
 				if (!connection_info.connection)
 					return BAN::Error::from_errno(ENOTCONN);
 			}
@@ -427,131 +669,115 @@ namespace Kernel
 			TRY(Thread::current().block_or_eintr_indefinite(m_packet_thread_blocker, &m_packet_lock));
 		}
 
-		auto* cheader = CMSG_FIRSTHDR(&message);
-		if (cheader != nullptr)
-			cheader->cmsg_len = message.msg_controllen;
-		size_t cheader_len = 0;
+		return true;
+	}
 
-		uint8_t* packet_buffer_base_u8 = reinterpret_cast<uint8_t*>(m_packet_buffer->vaddr());
+	BAN::ErrorOr<size_t> UnixDomainSocket::recvmsg_impl(msghdr& message, int flags)
+	{
+		TRY(validate_recvmsg_flags(flags));
 
-		message.msg_flags = 0;
+		if (is_streaming())
+			return recvmsg_stream(message);
 
-		int iov_index = 0;
-		size_t iov_offset = 0;
-		size_t total_recv = 0;
+		LockGuard _(m_packet_lock);
 
-		while (!m_packet_infos.empty() && iov_index < message.msg_iovlen)
-		{
-			auto& packet_info = m_packet_infos.front();
+		if (!TRY(wait_for_packet()))
+			return 0;
 
-			auto fds_to_open = BAN::move(packet_info.fds);
-			auto ucred_to_recv = BAN::move(packet_info.ucred);
-			const bool had_ancillary_data = !fds_to_open.empty() || ucred_to_recv.has_value();
+		const size_t total_recv = receive_queued_packet(message);
 
-			if (!fds_to_open.empty()) do
-			{
-				if (cheader == nullptr)
-				{
-					dwarnln("no space to receive {} fds", fds_to_open.size());
-					message.msg_flags |= MSG_CTRUNC;
-					break;
-				}
+		m_packet_thread_blocker.unblock();
 
-				const size_t max_fd_count = (cheader->cmsg_len - sizeof(cmsghdr)) / sizeof(int);
-				if (max_fd_count < fds_to_open.size())
-					message.msg_flags |= MSG_CTRUNC;
+		return total_recv;
+	}
 
-				const size_t fd_count = BAN::Math::min(fds_to_open.size(), max_fd_count);
-				const size_t fds_opened = Process::current().open_file_descriptor_set().open_all_fd_wrappers(fds_to_open.span().slice(0, fd_count));
+	BAN::ErrorOr<size_t> UnixDomainSocket::recvmmsg_impl(BAN::Span<mmsghdr> messages, int flags)
+	{
+		TRY(validate_recvmsg_flags(flags));
 
-				auto* fd_data = reinterpret_cast<int*>(CMSG_DATA(cheader));
-				for (size_t i = 0; i < fds_opened; i++)
-					fd_data[i] = fds_to_open[i].fd();
+		if (is_streaming())
+			return Socket::recvmmsg_impl(messages, flags);
 
-				const size_t header_length = CMSG_LEN(fds_opened * sizeof(int));
-				cheader->cmsg_level = SOL_SOCKET;
-				cheader->cmsg_type = SCM_RIGHTS;
-				cheader->cmsg_len = header_length;
-				cheader = CMSG_NXTHDR(&message, cheader);
-				if (cheader != nullptr)
-					cheader->cmsg_len = message.msg_controllen - header_length;
-				cheader_len += header_length;
-			} while (false);
+		LockGuard _(m_packet_lock);
 
-			if (ucred_to_recv.has_value()) do
-			{
-				if (cheader == nullptr || cheader->cmsg_len - sizeof(cmsghdr) < sizeof(struct ucred))
-				{
-					dwarnln("no space to receive credentials");
-					message.msg_flags |= MSG_CTRUNC;
-					break;
-				}
+		if (!TRY(wait_for_packet()))
+		{
+			messages[0].msg_len = 0;
+			return 1;
+		}
 
-				*reinterpret_cast<struct ucred*>(CMSG_DATA(cheader)) = ucred_to_recv.value();
+		size_t count = 0;
+		while (count < messages.size() && !m_packet_infos.empty())
+		{
+			messages[count].msg_len = receive_queued_packet(messages[count].msg_hdr);
+			count++;
+		}
 
-				const size_t header_length = CMSG_LEN(sizeof(struct ucred));
-				cheader->cmsg_level = SOL_SOCKET;
-				cheader->cmsg_type = SCM_CREDENTIALS;
-				cheader->cmsg_len = header_length;
-				cheader = CMSG_NXTHDR(&message, cheader);
-				if (cheader != nullptr)
-					cheader->cmsg_len = message.msg_controllen - header_length;
-				cheader_len += header_length;
-			} while (false);
+		m_packet_thread_blocker.unblock();
 
-			size_t packet_received = 0;
-			while (iov_index < message.msg_iovlen && packet_received < packet_info.size)
-			{
-				auto& iov = message.msg_iov[iov_index];
-				uint8_t* iov_base = static_cast<uint8_t*>(iov.iov_base);
+		return count;
+	}
 
-				const size_t nrecv = BAN::Math::min<size_t>(iov.iov_len - iov_offset, packet_info.size - packet_received);
+	size_t UnixDomainSocket::receive_queued_packet(msghdr& message)
+	{
+		ASSERT(m_packet_lock.is_locked_by_current_thread());
+		ASSERT(!m_packet_infos.empty());
 
-				const size_t copy_offset = (m_packet_buffer_tail + packet_received) % m_packet_buffer->size();
-				const size_t before_wrap = BAN::Math::min<size_t>(nrecv, m_packet_buffer->size() - copy_offset);
-				memcpy(iov_base + iov_offset, packet_buffer_base_u8 + copy_offset, before_wrap);
-				if (const size_t after_wrap = nrecv - before_wrap)
-					memcpy(iov_base + iov_offset + before_wrap, packet_buffer_base_u8, after_wrap);
+		auto* cheader = CMSG_FIRSTHDR(&message);
+		if (cheader != nullptr)
+			cheader->cmsg_len = message.msg_controllen;
+		size_t cheader_len = 0;
 
-				packet_received += nrecv;
+		uint8_t* packet_buffer_base_u8 = reinterpret_cast<uint8_t*>(m_packet_buffer->vaddr());
 
-				iov_offset += nrecv;
-				if (iov_offset >= iov.iov_len)
-				{
-					iov_offset = 0;
-					iov_index++;
-				}
-			}
+		message.msg_flags = 0;
 
-			if (!is_streaming() && packet_received < packet_info.size)
-				message.msg_flags |= MSG_TRUNC;
+		int iov_index = 0;
+		size_t iov_offset = 0;
+		size_t total_recv = 0;
 
-			const size_t to_discard = is_streaming() ? packet_received : packet_info.size;
+		auto packet_info = BAN::move(m_packet_infos.front());
+		m_packet_infos.pop();
 
-			packet_info.size -= to_discard;
-			if (packet_info.size == 0)
-				m_packet_infos.pop();
+		write_ancillary_data(message, cheader, cheader_len, packet_info.fds, packet_info.ucred);
 
-			m_packet_buffer_tail = (m_packet_buffer_tail + to_discard) % m_packet_buffer->size();
-			m_packet_size_total -= to_discard;
+		while (iov_index < message.msg_iovlen && total_recv < packet_info.size)
+		{
+			auto& iov = message.msg_iov[iov_index];
+			uint8_t* iov_base = static_cast<uint8_t*>(iov.iov_base);
 
-			total_recv += packet_received;
+			const size_t nrecv = BAN::Math::min<size_t>(iov.iov_len - iov_offset, packet_info.size - total_recv);
 
-			if (auto sender = packet_info.sender.lock())
+			const size_t copy_offset = (m_packet_buffer_tail + total_recv) % m_packet_buffer->size();
+			const size_t before_wrap = BAN::Math::min<size_t>(nrecv, m_packet_buffer->size() - copy_offset);
+			memcpy(iov_base + iov_offset, packet_buffer_base_u8 + copy_offset, before_wrap);
+			if (const size_t after_wrap = nrecv - before_wrap)
+				memcpy(iov_base + iov_offset + before_wrap, packet_buffer_base_u8, after_wrap);
+
+			total_recv += nrecv;
+
+			iov_offset += nrecv;
+			if (iov_offset >= iov.iov_len)
 			{
-				sender->m_bytes_sent -= to_discard;
-				sender->epoll_notify(EPOLLOUT);
+				iov_offset = 0;
+				iov_index++;
 			}
+		}
 
-			// on linux ancillary data is a barrier on stream sockets, lets do the same
-			if (!is_streaming() || had_ancillary_data)
-				break;
+		if (total_recv < packet_info.size)
+			message.msg_flags |= MSG_TRUNC;
+
+		m_packet_buffer_tail = (m_packet_buffer_tail + packet_info.size) % m_packet_buffer->size();
+		m_packet_size_total -= packet_info.size;
+
+		if (auto sender = packet_info.sender.lock())
+		{
+			sender->m_bytes_sent -= packet_info.size;
+			sender->epoll_notify(EPOLLOUT);
 		}
 
 		message.msg_controllen = cheader_len;
 
-		m_packet_thread_blocker.unblock();
-
 		return total_recv;
 	}
 
@@ -651,6 +877,8 @@ namespace Kernel
 			auto target = connection_info.connection.lock();
 			if (!target)
 				return BAN::Error::from_errno(ENOTCONN);
+			if (is_streaming())
+				return TRY(target->add_stream_data(message, BAN::move(packet_info), flags & MSG_DONTWAIT));
 			const size_t bytes_sent = TRY(target->add_packet(message, BAN::move(packet_info), flags & MSG_DONTWAIT));
 			m_bytes_sent += bytes_sent;
 			return bytes_sent;
@@ -4,6 +4,8 @@
 #include <kernel/Networking/NetworkManager.h>
 #include <kernel/OpenFileDescriptorSet.h>
 #include <kernel/Process.h>
+#include <kernel/Processor.h>
+#include <kernel/Timer/Timer.h>
 #include <kernel/UserCopy.h>
 
 #include <fcntl.h>
@@ -36,13 +38,27 @@ namespace Kernel
 	OpenFileDescriptorSet::~OpenFileDescriptorSet()
 	{
 		close_all();
+		delete m_table.load();
 	}
 
 	OpenFileDescriptorSet& OpenFileDescriptorSet::operator=(OpenFileDescriptorSet&& other)
 	{
 		LockGuard _(m_mutex);
-		for (size_t i = 0; i < m_open_files.size(); i++)
-			m_open_files[i] = BAN::move(other.m_open_files[i]);
+		LockGuard __(other.m_mutex);
+
+		for (int fd = 0; fd < static_cast<int>(fd_table_size()); fd++)
+			if (description_at(fd))
+				set_description(fd, {});
+
+		auto* old_table = m_table.exchange(other.m_table.exchange(nullptr));
+		other.synchronize_lookups();
+		synchronize_lookups();
+		delete old_table;
+
+		m_open_fds = BAN::move(other.m_open_fds);
+		m_cloexec_files = BAN::move(other.m_cloexec_files);
+		m_nofile_limit = other.m_nofile_limit;
+
 		return *this;
 	}
 
@@ -52,17 +68,27 @@ namespace Kernel
 
 		close_all();
 
-		for (int fd = 0; fd < static_cast<int>(other.m_open_files.size()); fd++)
+		LockGuard __(other.m_mutex);
+
+		m_nofile_limit = other.m_nofile_limit;
+
+		const int other_max_fd = other.get_max_open_fd();
+		if (other_max_fd < 0)
+			return {};
+
+		TRY(reserve_fd_table(other_max_fd + 1));
+
+		for (int fd = 0; fd <= other_max_fd; fd++)
 		{
-			if (other.validate_fd(fd).is_error())
+			auto* open_file = other.description_at(fd);
+			if (open_file == nullptr)
 				continue;
 
-			auto& open_file = m_open_files[fd];
-			open_file = other.m_open_files[fd];
+			set_description(fd, open_file);
 			open_file->file.inode->on_clone(open_file->status_flags);
 		}
 
-		for (size_t i = 0; i < m_cloexec_files.size(); i++)
+		for (size_t i = 0; i < BAN::Math::min(m_cloexec_files.size(), other.m_cloexec_files.size()); i++)
 			m_cloexec_files[i] = other.m_cloexec_files[i];
 
 		return {};
@@ -92,7 +118,7 @@ namespace Kernel
 		LockGuard _(m_mutex);
 
 		const int fd = TRY(get_free_fd());
-		m_open_files[fd] = TRY(BAN::RefPtr<OpenFileDescription>::create(BAN::move(file), 0, flags & status_mask));
+		set_description(fd, TRY(BAN::RefPtr<OpenFileDescription>::create(BAN::move(file), 0, flags & status_mask)));
 		if (flags & O_CLOEXEC)
 			add_cloexec(fd);
 
@@ -183,7 +209,7 @@ namespace Kernel
 		LockGuard _(m_mutex);
 
 		const int fd = TRY(get_free_fd());
-		m_open_files[fd] = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket, socket_sv), 0, O_RDWR | sock_info.status_flags));
+		set_description(fd, TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket, socket_sv), 0, O_RDWR | sock_info.status_flags)));
 		if (sock_info.cloexec)
 			add_cloexec(fd);
 
@@ -200,9 +226,12 @@ namespace Kernel
 
 		LockGuard _(m_mutex);
 
+		auto description1 = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket1, "<socketpair>"_sv), 0, O_RDWR | sock_info.status_flags));
+		auto description2 = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket2, "<socketpair>"_sv), 0, O_RDWR | sock_info.status_flags));
+
 		TRY(get_free_fd_pair(socket_vector));
-		m_open_files[socket_vector[0]] = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket1, "<socketpair>"_sv), 0, O_RDWR | sock_info.status_flags));
-		m_open_files[socket_vector[1]] = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(socket2, "<socketpair>"_sv), 0, O_RDWR | sock_info.status_flags));
+		set_description(socket_vector[0], BAN::move(description1));
+		set_description(socket_vector[1], BAN::move(description2));
 		if (sock_info.cloexec)
 		{
 			add_cloexec(socket_vector[0]);
@@ -219,8 +248,10 @@ namespace Kernel
 		TRY(get_free_fd_pair(fds));
 
 		auto pipe = TRY(Pipe::create(m_credentials.euid(), m_credentials.egid()));
-		m_open_files[fds[0]] = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(pipe, "<pipe rd>"_sv), 0, O_RDONLY));
-		m_open_files[fds[1]] = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(pipe, "<pipe wr>"_sv), 0, O_WRONLY));
+		auto description_rd = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(pipe, "<pipe rd>"_sv), 0, O_RDONLY));
+		auto description_wr = TRY(BAN::RefPtr<OpenFileDescription>::create(VirtualFileSystem::File(pipe, "<pipe wr>"_sv), 0, O_WRONLY));
+		set_description(fds[0], BAN::move(description_rd));
+		set_description(fds[1], BAN::move(description_wr));
 
 		ASSERT(!is_cloexec(fds[0]));
 		ASSERT(!is_cloexec(fds[1]));
@@ -230,7 +261,7 @@ namespace Kernel
 
 	BAN::ErrorOr<int> OpenFileDescriptorSet::dup2(int fildes, int fildes2)
 	{
-		if (fildes2 < 0 || fildes2 >= (int)m_open_files.size())
+		if (fildes2 < 0 || static_cast<rlim_t>(fildes2) >= m_nofile_limit.rlim_cur)
 			return BAN::Error::from_errno(EBADF);
 
 		LockGuard _(m_mutex);
@@ -239,10 +270,12 @@ namespace Kernel
 		if (fildes == fildes2)
 			return fildes;
 
+		TRY(reserve_fd_table(fildes2 + 1));
+
 		(void)close(fildes2);
 
-		auto& open_file = m_open_files[fildes2];
-		open_file = m_open_files[fildes];
+		auto* open_file = description_at(fildes);
+		set_description(fildes2, open_file);
 		open_file->file.inode->on_clone(open_file->status_flags);
 
 		ASSERT(!is_cloexec(fildes2));
@@ -265,16 +298,17 @@ namespace Kernel
 
 				TRY(validate_fd(fd));
 
-				inode = m_open_files[fd]->file.inode;
+				auto* open_file = description_at(fd);
+				inode = open_file->file.inode;
 
 				switch (flock.l_whence)
 				{
 					case SEEK_SET:
 						break;
 					case SEEK_CUR:
-						if (BAN::Math::will_addition_overflow(flock.l_start, m_open_files[fd]->offset))
+						if (BAN::Math::will_addition_overflow(flock.l_start, open_file->offset))
 							return BAN::Error::from_errno(EOVERFLOW);
-						flock.l_start += m_open_files[fd]->offset;
+						flock.l_start += open_file->offset;
 						break;
 					case SEEK_END:
 						if (BAN::Math::will_addition_overflow(flock.l_start, inode->size()))
@@ -316,15 +350,18 @@ namespace Kernel
 
 		TRY(validate_fd(fd));
 
+		auto* open_file = description_at(fd);
+
 		switch (cmd)
 		{
 			case F_DUPFD:
 			case F_DUPFD_CLOEXEC:
 			{
-				const int new_fd = TRY(get_free_fd());
+				if (extra > static_cast<uintptr_t>(BAN::numeric_limits<int>::max()))
+					return BAN::Error::from_errno(EINVAL);
+				const int new_fd = TRY(get_free_fd(extra));
 
-				auto& open_file = m_open_files[new_fd];
-				open_file = m_open_files[fd];
+				set_description(new_fd, open_file);
 				open_file->file.inode->on_clone(open_file->status_flags);
 				if (cmd == F_DUPFD_CLOEXEC)
 					add_cloexec(new_fd);
@@ -340,12 +377,25 @@ namespace Kernel
 					remove_cloexec(fd);
 				return 0;
 			case F_GETFL:
-				return m_open_files[fd]->status_flags;
+				return open_file->status_flags;
 			case F_SETFL:
 				extra &= O_APPEND | O_DSYNC | O_NONBLOCK | O_RSYNC | O_SYNC;
-				m_open_files[fd]->status_flags &= O_ACCMODE;
-				m_open_files[fd]->status_flags |= extra;
+				open_file->status_flags &= O_ACCMODE;
+				open_file->status_flags |= extra;
 				return 0;
+			case F_GETPIPE_SZ:
+				if (!open_file->file.inode->is_pipe())
+					return BAN::Error::from_errno(EBADF);
+				return static_cast<Pipe*>(open_file->file.inode.ptr())->capacity();
+			case F_SETPIPE_SZ:
+				if (!open_file->file.inode->is_pipe())
+					return BAN::Error::from_errno(EBADF);
+				// negative sizes are invalid, don't let them wrap to huge ones
+				if (extra > static_cast<uintptr_t>(BAN::numeric_limits<int>::max()))
+					return BAN::Error::from_errno(EINVAL);
+				if (extra > Pipe::max_user_capacity && !Process::current().credentials().is_superuser())
+					return BAN::Error::from_errno(EPERM);
+				return TRY(static_cast<Pipe*>(open_file->file.inode.ptr())->set_capacity(extra));
 			default:
 				break;
 		}
@@ -370,14 +420,14 @@ namespace Kernel
 					int enabled;
 					TRY(read_from_user(arg, &enabled, sizeof(int)));
 					if (enabled)
-						m_open_files[fd]->status_flags |= O_NONBLOCK;
+						description_at(fd)->status_flags |= O_NONBLOCK;
 					else
-						m_open_files[fd]->status_flags &= ~O_NONBLOCK;
+						description_at(fd)->status_flags &= ~O_NONBLOCK;
 					return 0;
 				}
 			}
 
-			inode = m_open_files[fd]->file.inode;
+			inode = description_at(fd)->file.inode;
 		}
 
 		return inode->ioctl(request, arg);
@@ -389,6 +439,8 @@ namespace Kernel
 
 		TRY(validate_fd(fd));
 
+		auto* open_file = description_at(fd);
+
 		off_t base_offset;
 		switch (whence)
 		{
@@ -396,10 +448,10 @@ namespace Kernel
 				base_offset = 0;
 				break;
 			case SEEK_CUR:
-				base_offset = m_open_files[fd]->offset;
+				base_offset = open_file->offset;
 				break;
 			case SEEK_END:
-				base_offset = m_open_files[fd]->file.inode->size();
+				base_offset = open_file->file.inode->size();
 				break;
 			default:
 				return BAN::Error::from_errno(EINVAL);
@@ -412,23 +464,21 @@ namespace Kernel
 		if (new_offset < 0)
 			return BAN::Error::from_errno(EINVAL);
 
-		m_open_files[fd]->offset = new_offset;
+		open_file->offset = new_offset;
 
 		return new_offset;
 	}
 
 	BAN::ErrorOr<off_t> OpenFileDescriptorSet::tell(int fd) const
 	{
-		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return m_open_files[fd]->offset;
+		auto open_file = TRY(get_description(fd));
+		return open_file->offset;
 	}
 
 	BAN::ErrorOr<void> OpenFileDescriptorSet::truncate(int fd, off_t length)
 	{
-		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return m_open_files[fd]->file.inode->truncate(length);
+		auto open_file = TRY(get_description(fd));
+		return open_file->file.inode->truncate(length);
 	}
 
 	BAN::ErrorOr<void> OpenFileDescriptorSet::close(int fd)
@@ -440,10 +490,10 @@ namespace Kernel
 
 			TRY(validate_fd(fd));
 
-			open_file = m_open_files[fd];
+			open_file = description_at(fd);
 
-			m_open_files[fd]->file.inode->on_close(m_open_files[fd]->status_flags);
-			m_open_files[fd] = {};
+			open_file->file.inode->on_close(open_file->status_flags);
+			set_description(fd, {});
 			remove_cloexec(fd);
 		}
 
@@ -475,20 +525,23 @@ namespace Kernel
 	void OpenFileDescriptorSet::close_all()
 	{
 		LockGuard _(m_mutex);
-		for (int fd = 0; fd < static_cast<int>(m_open_files.size()); fd++)
-			(void)close(fd);
+		for (int fd = get_max_open_fd(); fd >= 0; fd--)
+			if (description_at(fd))
+				(void)close(fd);
 	}
 
 	void OpenFileDescriptorSet::close_cloexec()
 	{
 		LockGuard _(m_mutex);
-		for (int fd = 0; fd < static_cast<int>(m_open_files.size()); fd++)
+		for (int fd = get_max_open_fd(); fd >= 0; fd--)
 			if (is_cloexec(fd))
 				(void)close(fd);
 	}
 
 	bool OpenFileDescriptorSet::is_cloexec(int fd)
 	{
+		if (static_cast<size_t>(fd / 32) >= m_cloexec_files.size())
+			return false;
 		return m_cloexec_files[fd / 32] & (1u << (fd % 32));
 	}
 
@@ -653,7 +706,7 @@ namespace Kernel
 		{
 			TRY(validate_fd(fd));
 
-			auto& flock = m_open_files[fd]->flock;
+			auto& flock = description_at(fd)->flock;
 			switch (op & ~LOCK_NB)
 			{
 				case LOCK_UN:
@@ -701,34 +754,150 @@ namespace Kernel
 	}
 
 	BAN::ErrorOr<size_t> OpenFileDescriptorSet::read(int fd, BAN::ByteSpan buffer)
+	{
+		auto open_file = TRY(get_description(fd));
+		return read(*open_file, buffer, nullptr, false);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::read(OpenFileDescription& open_file, BAN::ByteSpan buffer, const off_t* offset_override, bool force_nonblock)
+	{
+		if (!(open_file.status_flags & O_RDONLY))
+			return BAN::Error::from_errno(EBADF);
+
+		auto inode = open_file.file.inode;
+		const bool is_nonblock = force_nonblock || (open_file.status_flags & O_NONBLOCK);
+		const off_t offset = offset_override ? *offset_override : open_file.offset;
+
+		if (inode->mode().ifsock())
+		{
+			if (offset_override)
+				return BAN::Error::from_errno(ESPIPE);
+
+			iovec iov {
+				.iov_base = buffer.data(),
+				.iov_len = buffer.size(),
+			};
+
+			msghdr message {
+				.msg_name = nullptr,
+				.msg_namelen = 0,
+				.msg_iov = &iov,
+				.msg_iovlen = 1,
+				.msg_control = nullptr,
+				.msg_controllen = 0,
+				.msg_flags = 0,
+			};
+
+			return recvmsg(open_file, message, 0, force_nonblock);
+		}
+
+		size_t nread;
+		{
+			if (!inode->can_read() && inode->has_hungup())
+				return 0;
+			// FIXME: race condition, pass flags to read
+			if (is_nonblock && !inode->can_read())
+				return BAN::Error::from_errno(EAGAIN);
+			nread = TRY(inode->read(offset, buffer));
+		}
+
+		if (offset_override)
+			return nread;
+
+		// NOTE: race condition with offset, its UB per POSIX
+		open_file.offset = offset + nread;
+		return nread;
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::write(int fd, BAN::ConstByteSpan buffer)
+	{
+		auto open_file = TRY(get_description(fd));
+		return write(*open_file, buffer, nullptr, false);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::write(OpenFileDescription& open_file, BAN::ConstByteSpan buffer, const off_t* offset_override, bool force_nonblock)
+	{
+		if (!(open_file.status_flags & O_WRONLY))
+			return BAN::Error::from_errno(EBADF);
+
+		auto inode = open_file.file.inode;
+		const bool is_nonblock = force_nonblock || (open_file.status_flags & O_NONBLOCK);
+
+		off_t offset;
+		if (offset_override)
+			offset = *offset_override;
+		else
+			offset = (open_file.status_flags & O_APPEND) ? inode->size() : open_file.offset;
+
+		if (inode->mode().ifsock())
+		{
+			if (offset_override)
+				return BAN::Error::from_errno(ESPIPE);
+
+			iovec iov {
+				.iov_base = const_cast<uint8_t*>(buffer.data()),
+				.iov_len = buffer.size(),
+			};
+
+			msghdr message {
+				.msg_name = nullptr,
+				.msg_namelen = 0,
+				.msg_iov = &iov,
+				.msg_iovlen = 1,
+				.msg_control = nullptr,
+				.msg_controllen = 0,
+				.msg_flags = 0,
+			};
+
+			return sendmsg(open_file, message, 0, force_nonblock);
+		}
+
+		size_t nwrite;
+		{
+			if (inode->has_error())
+			{
+				Thread::current().add_signal(SIGPIPE, {});
+				return BAN::Error::from_errno(EPIPE);
+			}
+			if (is_nonblock && !inode->can_write())
+				return BAN::Error::from_errno(EAGAIN);
+			// FIXME: race condition, pass flags to write
+			nwrite = TRY(inode->write(offset, buffer));
+		}
+
+		if (offset_override)
+			return nwrite;
+
+		// NOTE: race condition with offset, its UB per POSIX
+		open_file.offset = offset + nwrite;
+		return nwrite;
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::readv(int fd, BAN::Span<const iovec> iovs, const off_t* offset_override)
 	{
 		BAN::RefPtr<Inode> inode;
 		bool is_nonblock;
 		off_t offset;
 
 		{
-			LockGuard _(m_mutex);
-			TRY(validate_fd(fd));
-			auto& open_file = m_open_files[fd];
+			auto open_file = TRY(get_description(fd));
 			if (!(open_file->status_flags & O_RDONLY))
 				return BAN::Error::from_errno(EBADF);
 			inode = open_file->file.inode;
 			is_nonblock = !!(open_file->status_flags & O_NONBLOCK);
-			offset = open_file->offset;
+			offset = offset_override ? *offset_override : open_file->offset;
 		}
 
 		if (inode->mode().ifsock())
 		{
-			iovec iov {
-				.iov_base = buffer.data(),
-				.iov_len = buffer.size(),
-			};
+			if (offset_override)
+				return BAN::Error::from_errno(ESPIPE);
 
 			msghdr message {
 				.msg_name = nullptr,
 				.msg_namelen = 0,
-				.msg_iov = &iov,
-				.msg_iovlen = 1,
+				.msg_iov = const_cast<iovec*>(iovs.data()),
+				.msg_iovlen = static_cast<int>(iovs.size()),
 				.msg_control = nullptr,
 				.msg_controllen = 0,
 				.msg_flags = 0,
@@ -737,6 +906,11 @@ namespace Kernel
 			return recvmsg(fd, message, 0);
 		}
 
+		BAN::Vector<BAN::ByteSpan> buffers;
+		TRY(buffers.resize(iovs.size()));
+		for (size_t i = 0; i < iovs.size(); i++)
+			buffers[i] = { static_cast<uint8_t*>(iovs[i].iov_base), iovs[i].iov_len };
+
 		size_t nread;
 		{
 			if (!inode->can_read() && inode->has_hungup())
@@ -744,45 +918,46 @@ namespace Kernel
 			// FIXME: race condition, pass flags to read
 			if (is_nonblock && !inode->can_read())
 				return BAN::Error::from_errno(EAGAIN);
-			nread = TRY(inode->read(offset, buffer));
+			nread = TRY(inode->readv(offset, buffers.span()));
 		}
 
-		LockGuard _(m_mutex);
+		if (offset_override)
+			return nread;
+
 		// NOTE: race condition with offset, its UB per POSIX
-		if (!validate_fd(fd).is_error())
-			m_open_files[fd]->offset = offset + nread;
+		if (auto open_file = get_description(fd); !open_file.is_error())
+			open_file.value()->offset = offset + nread;
 		return nread;
 	}
 
-	BAN::ErrorOr<size_t> OpenFileDescriptorSet::write(int fd, BAN::ConstByteSpan buffer)
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::writev(int fd, BAN::Span<const iovec> iovs, const off_t* offset_override)
 	{
 		BAN::RefPtr<Inode> inode;
 		bool is_nonblock;
 		off_t offset;
 
 		{
-			LockGuard _(m_mutex);
-			TRY(validate_fd(fd));
-			auto& open_file = m_open_files[fd];
+			auto open_file = TRY(get_description(fd));
 			if (!(open_file->status_flags & O_WRONLY))
 				return BAN::Error::from_errno(EBADF);
 			inode = open_file->file.inode;
 			is_nonblock = !!(open_file->status_flags & O_NONBLOCK);
-			offset = (open_file->status_flags & O_APPEND) ? inode->size() : open_file->offset;
+			if (offset_override)
+				offset = *offset_override;
+			else
+				offset = (open_file->status_flags & O_APPEND) ? inode->size() : open_file->offset;
 		}
 
 		if (inode->mode().ifsock())
 		{
-			iovec iov {
-				.iov_base = const_cast<uint8_t*>(buffer.data()),
-				.iov_len = buffer.size(),
-			};
+			if (offset_override)
+				return BAN::Error::from_errno(ESPIPE);
 
 			msghdr message {
 				.msg_name = nullptr,
 				.msg_namelen = 0,
-				.msg_iov = &iov,
-				.msg_iovlen = 1,
+				.msg_iov = const_cast<iovec*>(iovs.data()),
+				.msg_iovlen = static_cast<int>(iovs.size()),
 				.msg_control = nullptr,
 				.msg_controllen = 0,
 				.msg_flags = 0,
@@ -791,6 +966,11 @@ namespace Kernel
 			return sendmsg(fd, message, 0);
 		}
 
+		BAN::Vector<BAN::ConstByteSpan> buffers;
+		TRY(buffers.resize(iovs.size()));
+		for (size_t i = 0; i < iovs.size(); i++)
+			buffers[i] = { static_cast<const uint8_t*>(iovs[i].iov_base), iovs[i].iov_len };
+
 		size_t nwrite;
 		{
 			if (inode->has_error())
@@ -801,25 +981,229 @@ namespace Kernel
 			if (is_nonblock && !inode->can_write())
 				return BAN::Error::from_errno(EAGAIN);
 			// FIXME: race condition, pass flags to write
-			nwrite = TRY(inode->write(offset, buffer));
+			nwrite = TRY(inode->writev(offset, buffers.span()));
 		}
 
-		LockGuard _(m_mutex);
+		if (offset_override)
+			return nwrite;
+
 		// NOTE: race condition with offset, its UB per POSIX
-		if (!validate_fd(fd).is_error())
-			m_open_files[fd]->offset = offset + nwrite;
+		if (auto open_file = get_description(fd); !open_file.is_error())
+			open_file.value()->offset = offset + nwrite;
 		return nwrite;
 	}
 
+	static BAN::ErrorOr<size_t> splice_read(Inode& inode, bool is_nonblock, off_t offset, BAN::ByteSpan buffer)
+	{
+		if (inode.mode().ifsock())
+		{
+			iovec iov {
+				.iov_base = buffer.data(),
+				.iov_len = buffer.size(),
+			};
+
+			msghdr message {
+				.msg_name = nullptr,
+				.msg_namelen = 0,
+				.msg_iov = &iov,
+				.msg_iovlen = 1,
+				.msg_control = nullptr,
+				.msg_controllen = 0,
+				.msg_flags = 0,
+			};
+
+			if (is_nonblock && !inode.can_read())
+				return BAN::Error::from_errno(EAGAIN);
+			return inode.recvmsg(message, 0);
+		}
+
+		if (!inode.can_read() && inode.has_hungup())
+			return 0;
+		if (is_nonblock && !inode.can_read())
+			return BAN::Error::from_errno(EAGAIN);
+		return inode.read(offset, buffer);
+	}
+
+	static BAN::ErrorOr<size_t> splice_write(Inode& inode, bool is_nonblock, off_t offset, BAN::ConstByteSpan buffer)
+	{
+		if (inode.mode().ifsock())
+		{
+			iovec iov {
+				.iov_base = const_cast<uint8_t*>(buffer.data()),
+				.iov_len = buffer.size(),
+			};
+
+			msghdr message {
+				.msg_name = nullptr,
+				.msg_namelen = 0,
+				.msg_iov = &iov,
+				.msg_iovlen = 1,
+				.msg_control = nullptr,
+				.msg_controllen = 0,
+				.msg_flags = 0,
+			};
+
+			if (inode.has_hungup())
+			{
+				Thread::current().add_signal(SIGPIPE, {});
+				return BAN::Error::from_errno(EPIPE);
+			}
+			if (is_nonblock && !inode.can_write())
+				return BAN::Error::from_errno(EAGAIN);
+			return inode.sendmsg(message, is_nonblock ? MSG_DONTWAIT : 0);
+		}
+
+		if (inode.has_error())
+		{
+			Thread::current().add_signal(SIGPIPE, {});
+			return BAN::Error::from_errno(EPIPE);
+		}
+		if (is_nonblock && !inode.can_write())
+			return BAN::Error::from_errno(EAGAIN);
+		return inode.write(offset, buffer);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::splice(int fd_in, off_t* offset_in, int fd_out, off_t* offset_out, size_t count, bool force_nonblock)
+	{
+		BAN::RefPtr<Inode> inode_in;
+		BAN::RefPtr<Inode> inode_out;
+		bool is_nonblock_in;
+		bool is_nonblock_out;
+		off_t current_in;
+		off_t current_out;
+
+		{
+			auto open_file_in = TRY(get_description(fd_in));
+			auto open_file_out = TRY(get_description(fd_out));
+			if (!(open_file_in->status_flags & O_RDONLY) || !(open_file_out->status_flags & O_WRONLY))
+				return BAN::Error::from_errno(EBADF);
+
+			inode_in = open_file_in->file.inode;
+			inode_out = open_file_out->file.inode;
+			if (inode_in->mode().ifdir() || inode_out->mode().ifdir())
+				return BAN::Error::from_errno(EISDIR);
+			if ((offset_in && !inode_in->mode().ifreg()) || (offset_out && !inode_out->mode().ifreg()))
+				return BAN::Error::from_errno(ESPIPE);
+
+			is_nonblock_in = force_nonblock || (open_file_in->status_flags & O_NONBLOCK);
+			is_nonblock_out = force_nonblock || (open_file_out->status_flags & O_NONBLOCK);
+
+			current_in = offset_in ? *offset_in : open_file_in->offset;
+			if (offset_out)
+				current_out = *offset_out;
+			else if (open_file_out->status_flags & O_APPEND)
+				current_out = inode_out->size();
+			else
+				current_out = open_file_out->offset;
+		}
+
+		if (current_in < 0 || current_out < 0)
+			return BAN::Error::from_errno(EINVAL);
+
+		if (inode_in == inode_out && inode_in->mode().ifreg())
+		{
+			const off_t count_off = BAN::Math::min<size_t>(count, BAN::numeric_limits<off_t>::max() / 2);
+			if (current_in < current_out + count_off && current_out < current_in + count_off)
+				return BAN::Error::from_errno(EINVAL);
+		}
+
+		// pipe to pipe transfers can pass whole pages instead of copying
+		if (inode_in->is_pipe() && inode_out->is_pipe() && inode_in != inode_out)
+		{
+			return Pipe::splice(
+				static_cast<Pipe&>(*inode_in),
+				static_cast<Pipe&>(*inode_out),
+				count,
+				is_nonblock_in,
+				is_nonblock_out
+			);
+		}
+
+		// NOTE: streams can't be read past the first chunk without possibly blocking forever
+		const bool is_stream_in = inode_in->mode().ifsock() || inode_in->mode().ififo() || inode_in->mode().ifchr();
+
+		BAN::Vector<uint8_t> buffer;
+		TRY(buffer.resize(BAN::Math::min<size_t>(count, 16 * PAGE_SIZE)));
+
+		size_t ntransferred = 0;
+		BAN::Optional<BAN::Error> error;
+
+		while (ntransferred < count)
+		{
+			// NOTE: bytes read from a stream can't be put back, don't consume
+			//       anything before a nonblocking target can take some of it
+			if (is_stream_in && is_nonblock_out && !inode_out->can_write())
+			{
+				error = BAN::Error::from_errno(EAGAIN);
+				break;
+			}
+
+			const size_t to_read = BAN::Math::min(count - ntransferred, buffer.size());
+
+			auto read_ret = splice_read(*inode_in, is_nonblock_in, current_in, buffer.span().slice(0, to_read));
+			if (read_ret.is_error())
+			{
+				error = read_ret.release_error();
+				break;
+			}
+
+			const size_t nread = read_ret.value();
+			if (nread == 0)
+				break;
+
+			// NOTE: everything consumed from a stream has to be written out, so
+			//       the target is written in blocking mode. only hard errors
+			//       of the target (e.g. EPIPE) can still drop the consumed bytes
+			const bool is_nonblock_write = is_nonblock_out && !is_stream_in;
+
+			size_t nwritten = 0;
+			while (nwritten < nread)
+			{
+				auto write_ret = splice_write(*inode_out, is_nonblock_write, current_out + nwritten, buffer.span().slice(nwritten, nread - nwritten));
+				if (write_ret.is_error())
+				{
+					error = write_ret.release_error();
+					break;
+				}
+				if (write_ret.value() == 0)
+					break;
+				nwritten += write_ret.value();
+			}
+
+			current_in += nwritten;
+			current_out += nwritten;
+			ntransferred += nwritten;
+
+			if (error.has_value() || nwritten < nread || is_stream_in)
+				break;
+		}
+
+		if (offset_in)
+			*offset_in = current_in;
+		if (offset_out)
+			*offset_out = current_out;
+
+		if (!offset_in || !offset_out)
+		{
+			// NOTE: race condition with offset, its UB per POSIX
+			if (auto open_file_in = get_description(fd_in); !offset_in && !is_stream_in && !open_file_in.is_error())
+				open_file_in.value()->offset = current_in;
+			if (auto open_file_out = get_description(fd_out); !offset_out && !open_file_out.is_error())
+				open_file_out.value()->offset = current_out;
+		}
+
+		if (ntransferred == 0 && error.has_value())
+			return error.release_value();
+		return ntransferred;
+	}
+
 	BAN::ErrorOr<size_t> OpenFileDescriptorSet::read_dir_entries(int fd, struct dirent* list, size_t list_len)
 	{
 		BAN::RefPtr<Inode> inode;
 		off_t offset;
 
 		{
-			LockGuard _(m_mutex);
-			TRY(validate_fd(fd));
-			auto& open_file = m_open_files[fd];
+			auto open_file = TRY(get_description(fd));
 			if (!(open_file->status_flags & O_RDONLY))
 				return BAN::Error::from_errno(EACCES);
 			inode = open_file->file.inode;
@@ -835,130 +1219,377 @@ namespace Kernel
 			if (ret.is_error())
 				continue;
 
-			LockGuard _(m_mutex);
 			// NOTE: race condition with offset, its UB per POSIX
-			if (!validate_fd(fd).is_error())
-				m_open_files[fd]->offset = offset;
+			if (auto open_file = get_description(fd); !open_file.is_error())
+				open_file.value()->offset = offset;
 			return ret;
 		}
 	}
 
 	BAN::ErrorOr<size_t> OpenFileDescriptorSet::recvmsg(int fd, msghdr& message, int flags)
+	{
+		auto open_file = TRY(get_description(fd));
+		return recvmsg(*open_file, message, flags, false);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::recvmsg(OpenFileDescription& open_file, msghdr& message, int flags, bool force_nonblock)
+	{
+		auto inode = open_file.file.inode;
+		if (!inode->mode().ifsock())
+			return BAN::Error::from_errno(ENOTSOCK);
+		const bool is_nonblock = force_nonblock || (open_file.status_flags & O_NONBLOCK);
+
+		if (is_nonblock && !inode->can_read())
+			return BAN::Error::from_errno(EAGAIN);
+		return inode->recvmsg(message, flags);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::sendmsg(int fd, const msghdr& message, int flags)
+	{
+		auto open_file = TRY(get_description(fd));
+		return sendmsg(*open_file, message, flags, false);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::sendmsg(OpenFileDescription& open_file, const msghdr& message, int flags, bool force_nonblock)
+	{
+		auto inode = open_file.file.inode;
+		if (!inode->mode().ifsock())
+			return BAN::Error::from_errno(ENOTSOCK);
+		const bool is_nonblock = force_nonblock || (open_file.status_flags & O_NONBLOCK);
+
+		if (inode->has_hungup())
+		{
+			if (!(flags & MSG_NOSIGNAL))
+				Thread::current().add_signal(SIGPIPE, {});
+			return BAN::Error::from_errno(EPIPE);
+		}
+		if (is_nonblock && !inode->can_write())
+			return BAN::Error::from_errno(EAGAIN);
+		return inode->sendmsg(message, flags | (is_nonblock ? MSG_DONTWAIT : 0));
+	}
+
+	BAN::ErrorOr<long> OpenFileDescriptorSet::accept(OpenFileDescription& open_file, sockaddr* address, socklen_t* address_len, int flags, bool force_nonblock)
+	{
+		auto inode = open_file.file.inode;
+		if (!inode->mode().ifsock())
+			return BAN::Error::from_errno(ENOTSOCK);
+		const bool is_nonblock = force_nonblock || (open_file.status_flags & O_NONBLOCK);
+
+		if (flags & ~(SOCK_NONBLOCK | SOCK_CLOEXEC))
+			return BAN::Error::from_errno(EINVAL);
+
+		int open_flags = 0;
+		if (flags & SOCK_NONBLOCK)
+			open_flags |= O_NONBLOCK;
+		if (flags & SOCK_CLOEXEC)
+			open_flags |= O_CLOEXEC;
+
+		// FIXME: race condition, pass flags to accept
+		if (is_nonblock && !inode->can_read())
+			return BAN::Error::from_errno(EAGAIN);
+		return inode->accept(address, address_len, open_flags);
+	}
+
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::recvmmsg(int fd, BAN::Span<mmsghdr> messages, int flags, uint64_t waketime_ns)
 	{
 		BAN::RefPtr<Inode> inode;
 		bool is_nonblock;
 
 		{
-			LockGuard _(m_mutex);
-			TRY(validate_fd(fd));
-			auto& open_file = m_open_files[fd];
+			auto open_file = TRY(get_description(fd));
 			if (!open_file->file.inode->mode().ifsock())
 				return BAN::Error::from_errno(ENOTSOCK);
 			inode = open_file->file.inode;
 			is_nonblock = !!(open_file->status_flags & O_NONBLOCK);
 		}
 
-		if (is_nonblock && !inode->can_read())
-			return BAN::Error::from_errno(EAGAIN);
-		return inode->recvmsg(message, flags);
+		const bool wait_for_one = !!(flags & MSG_WAITFORONE);
+		flags &= ~MSG_WAITFORONE;
+
+		size_t count = 0;
+		while (count < messages.size())
+		{
+			if ((is_nonblock || (wait_for_one && count > 0)) && !inode->can_read())
+			{
+				if (count == 0)
+					return BAN::Error::from_errno(EAGAIN);
+				break;
+			}
+
+			auto ret = inode->recvmmsg(messages.slice(count), flags);
+			if (ret.is_error())
+			{
+				if (count == 0)
+					return ret.release_error();
+				break;
+			}
+			count += ret.value();
+
+			// NOTE: an empty message marks end of file, which is reported only once.
+			//       Receiving again would block forever on a blocking socket
+			if (ret.value() > 0 && messages[count - 1].msg_len == 0)
+				break;
+
+			if (SystemTimer::get().ns_since_boot() >= waketime_ns)
+				break;
+		}
+
+		return count;
 	}
 
-	BAN::ErrorOr<size_t> OpenFileDescriptorSet::sendmsg(int fd, const msghdr& message, int flags)
+	BAN::ErrorOr<size_t> OpenFileDescriptorSet::sendmmsg(int fd, BAN::Span<mmsghdr> messages, int flags)
 	{
 		BAN::RefPtr<Inode> inode;
 		bool is_nonblock;
 
 		{
-			LockGuard _(m_mutex);
-			TRY(validate_fd(fd));
-			auto& open_file = m_open_files[fd];
+			auto open_file = TRY(get_description(fd));
 			if (!open_file->file.inode->mode().ifsock())
 				return BAN::Error::from_errno(ENOTSOCK);
 			inode = open_file->file.inode;
 			is_nonblock = !!(open_file->status_flags & O_NONBLOCK);
 		}
 
-		if (inode->has_hungup())
+		const auto send_one =
+			[&](const msghdr& message) -> BAN::ErrorOr<size_t>
+			{
+				if (inode->has_hungup())
+				{
+					if (!(flags & MSG_NOSIGNAL))
+						Thread::current().add_signal(SIGPIPE, {});
+					return BAN::Error::from_errno(EPIPE);
+				}
+				if (is_nonblock && !inode->can_write())
+					return BAN::Error::from_errno(EAGAIN);
+				return inode->sendmsg(message, flags | (is_nonblock ? MSG_DONTWAIT : 0));
+			};
+
+		size_t count = 0;
+		for (; count < messages.size(); count++)
 		{
-			if (!(flags & MSG_NOSIGNAL))
-				Thread::current().add_signal(SIGPIPE, {});
-			return BAN::Error::from_errno(EPIPE);
+			auto ret = send_one(messages[count].msg_hdr);
+			if (ret.is_error())
+			{
+				if (count == 0)
+					return ret.release_error();
+				break;
+			}
+			messages[count].msg_len = ret.value();
 		}
-		if (is_nonblock && !inode->can_write())
-			return BAN::Error::from_errno(EAGAIN);
-		return inode->sendmsg(message, flags | (is_nonblock ? MSG_DONTWAIT : 0));
+
+		return count;
 	}
 
 	int OpenFileDescriptorSet::get_max_open_fd() const
 	{
 		LockGuard _(m_mutex);
-		for (int fd = m_open_files.size() - 1; fd > 0; fd--)
-			if (m_open_files[fd])
-				return fd;
+		for (size_t i = m_open_fds.size(); i > 0; i--)
+			if (m_open_fds[i - 1])
+				return (i - 1) * 32 + 31 - BAN::Math::clz(m_open_fds[i - 1]);
 		return -1;
 	}
 
-	BAN::ErrorOr<VirtualFileSystem::File> OpenFileDescriptorSet::file_of(int fd) const
+	rlimit OpenFileDescriptorSet::get_nofile_limit() const
 	{
 		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return TRY(m_open_files[fd]->file.clone());
+		return m_nofile_limit;
 	}
 
-	BAN::ErrorOr<BAN::String> OpenFileDescriptorSet::path_of(int fd) const
+	BAN::ErrorOr<void> OpenFileDescriptorSet::set_nofile_limit(const rlimit& limit)
 	{
+		if (limit.rlim_cur > limit.rlim_max)
+			return BAN::Error::from_errno(EINVAL);
+
 		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
+
+		if (limit.rlim_max > m_nofile_limit.rlim_max && m_credentials.euid() != 0)
+			return BAN::Error::from_errno(EPERM);
+		if (limit.rlim_max > default_nofile_hard_limit)
+			return BAN::Error::from_errno(EPERM);
+
+		m_nofile_limit = limit;
+		return {};
+	}
+
+	BAN::ErrorOr<VirtualFileSystem::File> OpenFileDescriptorSet::file_of(int fd) const
+	{
+		auto open_file = TRY(get_description(fd));
+		return TRY(open_file->file.clone());
+	}
+
+	BAN::ErrorOr<BAN::String> OpenFileDescriptorSet::path_of(int fd) const
+	{
+		auto open_file = TRY(get_description(fd));
 		BAN::String path;
-		TRY(path.append(m_open_files[fd]->file.canonical_path));
+		TRY(path.append(open_file->file.canonical_path));
 		return path;
 	}
 
 	BAN::ErrorOr<BAN::RefPtr<Inode>> OpenFileDescriptorSet::inode_of(int fd)
 	{
-		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return m_open_files[fd]->file.inode;
+		auto open_file = TRY(get_description(fd));
+		return open_file->file.inode;
 	}
 
 	BAN::ErrorOr<int> OpenFileDescriptorSet::status_flags_of(int fd) const
 	{
-		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return m_open_files[fd]->status_flags;
+		auto open_file = TRY(get_description(fd));
+		return open_file->status_flags;
 	}
 
-	BAN::ErrorOr<void> OpenFileDescriptorSet::validate_fd(int fd) const
+	BAN::ErrorOr<BAN::RefPtr<OpenFileDescriptorSet::OpenFileDescription>> OpenFileDescriptorSet::get_description(int fd) const
 	{
-		LockGuard _(m_mutex);
-		if (fd < 0 || fd >= (int)m_open_files.size())
+		if (fd < 0)
 			return BAN::Error::from_errno(EBADF);
-		if (!m_open_files[fd])
+
+		// NOTE: interrupts are disabled so writers never have to wait for a preempted lookup
+		const auto state = Processor::get_interrupt_state();
+		Processor::set_interrupt_state(InterruptState::Disabled);
+
+		const uint32_t epoch = m_lookup_epoch.load() & 1;
+		m_active_lookups[epoch]++;
+
+		BAN::RefPtr<OpenFileDescription> open_file;
+		if (auto* table = m_table.load(); table && static_cast<size_t>(fd) < table->files.size())
+			open_file = BAN::atomic_load(table->files[fd]);
+
+		m_active_lookups[epoch]--;
+
+		Processor::set_interrupt_state(state);
+
+		if (!open_file)
 			return BAN::Error::from_errno(EBADF);
+		return open_file;
+	}
+
+	OpenFileDescriptorSet::OpenFileDescription* OpenFileDescriptorSet::description_at(int fd) const
+	{
+		ASSERT(m_mutex.is_locked_by_current_thread());
+		auto* table = m_table.load();
+		if (fd < 0 || table == nullptr || static_cast<size_t>(fd) >= table->files.size())
+			return nullptr;
+		return table->files[fd];
+	}
+
+	void OpenFileDescriptorSet::set_description(int fd, BAN::RefPtr<OpenFileDescription> open_file)
+	{
+		ASSERT(m_mutex.is_locked_by_current_thread());
+		ASSERT(fd >= 0 && static_cast<size_t>(fd) < fd_table_size());
+
+		auto* new_open_file = open_file.ptr();
+		if (new_open_file)
+			new_open_file->ref();
+
+		auto* old_open_file = BAN::atomic_exchange(m_table.load()->files[fd], new_open_file);
+
+		if (new_open_file)
+			m_open_fds[fd / 32] |= 1u << (fd % 32);
+		else
+			m_open_fds[fd / 32] &= ~(1u << (fd % 32));
+
+		if (old_open_file)
+		{
+			synchronize_lookups();
+			old_open_file->unref();
+		}
+	}
+
+	BAN::ErrorOr<void> OpenFileDescriptorSet::reserve_fd_table(size_t size)
+	{
+		ASSERT(m_mutex.is_locked_by_current_thread());
+
+		const size_t old_size = fd_table_size();
+		if (size <= old_size)
+			return {};
+
+		// grow geometrically but don't allocate much past the soft limit
+		const size_t limit = BAN::Math::div_round_up<size_t>(BAN::Math::max<rlim_t>(m_nofile_limit.rlim_cur, 32), 32) * 32;
+		const size_t new_size = BAN::Math::max(size, BAN::Math::min(BAN::Math::max<size_t>(old_size * 2, 32), limit));
+
+		TRY(m_open_fds.resize(BAN::Math::div_round_up<size_t>(new_size, 32), 0));
+		TRY(m_cloexec_files.resize(BAN::Math::div_round_up<size_t>(new_size, 32), 0));
+
+		auto* new_table = new FileTable;
+		if (new_table == nullptr)
+			return BAN::Error::from_errno(ENOMEM);
+		if (auto ret = new_table->files.resize(new_size, nullptr); ret.is_error())
+		{
+			delete new_table;
+			return ret.release_error();
+		}
+
+		auto* old_table = m_table.load();
+		for (size_t i = 0; i < old_size; i++)
+			new_table->files[i] = old_table->files[i];
+
+		m_table.store(new_table);
+
+		if (old_table)
+		{
+			synchronize_lookups();
+			delete old_table;
+		}
+
 		return {};
 	}
 
-	BAN::ErrorOr<int> OpenFileDescriptorSet::get_free_fd() const
+	size_t OpenFileDescriptorSet::fd_table_size() const
+	{
+		auto* table = m_table.load();
+		return table ? table->files.size() : 0;
+	}
+
+	void OpenFileDescriptorSet::synchronize_lookups() const
+	{
+		// Flip the epoch twice so lookups that started before the flip are drained
+		// from both counters. New lookups use the other counter so this can't starve.
+		for (size_t i = 0; i < 2; i++)
+		{
+			const uint32_t epoch = m_lookup_epoch++ & 1;
+			while (m_active_lookups[epoch].load())
+				Processor::pause();
+		}
+	}
+
+	BAN::ErrorOr<void> OpenFileDescriptorSet::validate_fd(int fd) const
 	{
 		LockGuard _(m_mutex);
-		for (int fd = 0; fd < (int)m_open_files.size(); fd++)
-			if (!m_open_files[fd])
-				return fd;
-		return BAN::Error::from_errno(EMFILE);
+		if (description_at(fd) == nullptr)
+			return BAN::Error::from_errno(EBADF);
+		return {};
 	}
 
-	BAN::ErrorOr<void> OpenFileDescriptorSet::get_free_fd_pair(int fds[2]) const
+	BAN::ErrorOr<int> OpenFileDescriptorSet::get_free_fd(int min_fd)
 	{
 		LockGuard _(m_mutex);
-		size_t found = 0;
-		for (int fd = 0; fd < (int)m_open_files.size(); fd++)
+
+		ASSERT(min_fd >= 0);
+
+		int fd = -1;
+		for (size_t i = min_fd / 32; i < m_open_fds.size() && fd == -1; i++)
 		{
-			if (!m_open_files[fd])
-				fds[found++] = fd;
-			if (found == 2)
-				return {};
+			uint32_t used = m_open_fds[i];
+			if (i == static_cast<size_t>(min_fd / 32))
+				used |= (1u << (min_fd % 32)) - 1;
+			if (used != 0xFFFFFFFF)
+				fd = i * 32 + BAN::Math::ctz(~used);
 		}
-		return BAN::Error::from_errno(EMFILE);
+		if (fd == -1)
+			fd = BAN::Math::max<int>(m_open_fds.size() * 32, min_fd);
+
+		if (static_cast<rlim_t>(fd) >= m_nofile_limit.rlim_cur)
+			return BAN::Error::from_errno(EMFILE);
+		TRY(reserve_fd_table(fd + 1));
+
+		return fd;
+	}
+
+	BAN::ErrorOr<void> OpenFileDescriptorSet::get_free_fd_pair(int fds[2])
+	{
+		LockGuard _(m_mutex);
+		fds[0] = TRY(get_free_fd());
+		fds[1] = TRY(get_free_fd(fds[0] + 1));
+		return {};
 	}
 
 	using FDWrapper = OpenFileDescriptorSet::FDWrapper;
@@ -999,9 +1630,8 @@ namespace Kernel
 
 	BAN::ErrorOr<FDWrapper> OpenFileDescriptorSet::get_fd_wrapper(int fd)
 	{
-		LockGuard _(m_mutex);
-		TRY(validate_fd(fd));
-		return FDWrapper { m_open_files[fd] };
+		auto open_file = TRY(get_description(fd));
+		return FDWrapper { BAN::move(open_file) };
 	}
 
 	size_t OpenFileDescriptorSet::open_all_fd_wrappers(BAN::Span<FDWrapper> fd_wrappers)
@@ -1015,7 +1645,7 @@ namespace Kernel
 				return i;
 
 			const int fd = fd_or_error.release_value();
-			m_open_files[fd] = BAN::move(fd_wrappers[i].m_description);
+			set_description(fd, BAN::move(fd_wrappers[i].m_description));
 			fd_wrappers[i].m_fd = fd;
 		}
 
@@ -5,6 +5,9 @@
 #include <kernel/Audio/Controller.h>
 #include <kernel/IDT.h>
 #include <kernel/IO.h>
+#include <kernel/IRQAffinity.h>
+#include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/Mutex.h>
 #include <kernel/Memory/PageTable.h>
 #include <kernel/MMIO.h>
 #include <kernel/Networking/NetworkManager.h>
@@ -75,6 +78,11 @@ namespace Kernel::PCI
 
 	static BAN::HashMap<uint8_t, BAN::UniqPtr<PCIPinInterrupt>> s_pci_pin_interrupts;
 
+	// devices are probed concurrently, these serialize the shared state of interrupt
+	// routing (including AML evaluation of _PRT) and the legacy configuration ports
+	static Mutex s_interrupt_routing_mutex;
+	static SpinLock s_config_port_lock;
+
 	static uint32_t get_device_io_address(uint8_t bus, uint8_t dev, uint8_t func)
 	{
 		 return 0x80000000
@@ -86,6 +94,7 @@ namespace Kernel::PCI
 	uint32_t PCIManager::read_config_dword(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset)
 	{
 		ASSERT(offset % 4 == 0);
+		SpinLockGuard _(s_config_port_lock);
 		IO::outl(CONFIG_ADDRESS, get_device_io_address(bus, dev, func) | offset);
 		return IO::inl(CONFIG_DATA);
 	}
@@ -106,6 +115,7 @@ namespace Kernel::PCI
 	void PCIManager::write_config_dword(uint8_t bus, uint8_t dev, uint8_t func, uint8_t offset, uint32_t value)
 	{
 		ASSERT(offset % 4 == 0);
+		SpinLockGuard _(s_config_port_lock);
 		IO::outl(CONFIG_ADDRESS, get_device_io_address(bus, dev, func) | offset);
 		IO::outl(CONFIG_DATA, value);
 	}
@@ -253,74 +263,166 @@ namespace Kernel::PCI
 		return {};
 	}
 
+	static void probe_device(void* _pci_device)
+	{
+		auto& pci_device = *static_cast<PCI::Device*>(_pci_device);
+		switch (pci_device.class_code())
+		{
+			case 0x01:
+			{
+				switch (pci_device.subclass())
+				{
+					case 0x01:
+						if (auto res = ATAController::create(pci_device); res.is_error())
+							dprintln("ATA: {}", res.error());
+						break;
+					case 0x06:
+						if (auto res = AHCIController::create(pci_device); res.is_error())
+							dprintln("AHCI: {}", res.error());
+						break;
+					case 0x08:
+						if (auto res = NVMeController::create(pci_device); res.is_error())
+							dprintln("NVMe: {}", res.error());
+						break;
+					default:
+						ASSERT_NOT_REACHED();
+				}
+				break;
+			}
+			case 0x02:
+			{
+				if (auto res = NetworkManager::get().add_interface(pci_device); res.is_error())
+					dprintln("{}", res.error());
+				break;
+			}
+			case 0x04:
+			{
+				switch (pci_device.subclass())
+				{
+					case 0x01:
+					case 0x03:
+						if (auto res = AudioController::create(pci_device); res.is_error())
+							dprintln("Sound Card: {}", res.error());
+						break;
+					default:
+						ASSERT_NOT_REACHED();
+				}
+				break;
+			}
+			case 0x0C:
+			{
+				switch (pci_device.subclass())
+				{
+					case 0x03:
+						if (auto res = USBManager::get().add_controller(pci_device); res.is_error())
+							dprintln("{}", res.error());
+						break;
+					default:
+						ASSERT_NOT_REACHED();
+				}
+				break;
+			}
+			default:
+				ASSERT_NOT_REACHED();
+		}
+	}
+
+	static BAN::String probe_name(const PCI::Device& pci_device)
+	{
+		return MUST(BAN::String::formatted("pci {2H}:{2H}.{H}", pci_device.bus(), pci_device.dev(), pci_device.func()));
+	}
+
+	static void probe_devices(void* _pci_devices)
+	{
+		for (auto* pci_device : *static_cast<BAN::Vector<PCI::Device*>*>(_pci_devices))
+		{
+			BootTimeline::Scope _(probe_name(*pci_device).sv());
+			probe_device(pci_device);
+		}
+	}
+
 	void PCIManager::initialize_devices(bool disable_usb)
 	{
+		// Drivers of different devices do not depend on each other, so they are probed
+		// concurrently. Storage and USB (which may hold the root filesystem) are kept in
+		// a separate group so VFS only has to wait for them. USB controllers get a thread
+		// each as devices behind them are named in hotplug order anyway.
 		for_each_device(
 			[&](PCI::Device& pci_device)
 			{
+				ProbeList list;
 				switch (pci_device.class_code())
 				{
 					case 0x01:
-					{
 						switch (pci_device.subclass())
 						{
 							case 0x01:
-								if (auto res = ATAController::create(pci_device); res.is_error())
-									dprintln("ATA: {}", res.error());
-								break;
 							case 0x06:
-								if (auto res = AHCIController::create(pci_device); res.is_error())
-									dprintln("AHCI: {}", res.error());
+								list = SCSIProbes;
 								break;
 							case 0x08:
-								if (auto res = NVMeController::create(pci_device); res.is_error())
-									dprintln("NVMe: {}", res.error());
+								list = NVMeProbes;
 								break;
 							default:
 								dprintln("unsupported storage device (pci {2H}.{2H}.{2H})", pci_device.class_code(), pci_device.subclass(), pci_device.prog_if());
-								break;
+								return;
 						}
 						break;
-					}
 					case 0x02:
-					{
-						if (auto res = NetworkManager::get().add_interface(pci_device); res.is_error())
-							dprintln("{}", res.error());
+						list = NetworkProbes;
 						break;
-					}
 					case 0x04:
-					{
-						switch (pci_device.subclass())
-						{
-							case 0x01:
-							case 0x03:
-								if (auto res = AudioController::create(pci_device); res.is_error())
-									dprintln("Sound Card: {}", res.error());
-								break;
-						}
+						if (pci_device.subclass() != 0x01 && pci_device.subclass() != 0x03)
+							return;
+						list = AudioProbes;
 						break;
-					}
 					case 0x0C:
-					{
-						switch (pci_device.subclass())
+						if (pci_device.subclass() != 0x03)
 						{
-							case 0x03:
-								if (disable_usb)
-									dprintln("USB support disabled, will not initialize {2H}.{2H}.{2H}", pci_device.class_code(), pci_device.subclass(), pci_device.prog_if());
-								else if (auto res = USBManager::get().add_controller(pci_device); res.is_error())
-									dprintln("{}", res.error());
-								break;
-							default:
-								dprintln("unsupported serial bus controller (pci {2H}.{2H}.{2H})", pci_device.class_code(), pci_device.subclass(), pci_device.prog_if());
-								break;
+							dprintln("unsupported serial bus controller (pci {2H}.{2H}.{2H})", pci_device.class_code(), pci_device.subclass(), pci_device.prog_if());
+							return;
 						}
-						break;
-					}
+						if (disable_usb)
+						{
+							dprintln("USB support disabled, will not initialize {2H}.{2H}.{2H}", pci_device.class_code(), pci_device.subclass(), pci_device.prog_if());
+							return;
+						}
+						m_storage_probes.spawn(probe_name(pci_device).sv(), probe_device, &pci_device);
+						return;
 					default:
-						break;
+						return;
 				}
+
+				MUST(m_ordered_probes[list].push_back(&pci_device));
 			}
 		);
+
+		constexpr struct { ProbeList list; const char* name; bool is_storage; } ordered_probes[] {
+			{ SCSIProbes,    "pci scsi",    true  },
+			{ NVMeProbes,    "pci nvme",    true  },
+			{ NetworkProbes, "pci network", false },
+			{ AudioProbes,   "pci audio",   false },
+		};
+		static_assert(sizeof(ordered_probes) / sizeof(*ordered_probes) == ProbeListCount);
+
+		for (const auto& [list, name, is_storage] : ordered_probes)
+		{
+			if (m_ordered_probes[list].empty())
+				continue;
+			auto& group = is_storage ? m_storage_probes : m_device_probes;
+			group.spawn(name, probe_devices, &m_ordered_probes[list]);
+		}
+	}
+
+	void PCIManager::wait_for_storage_devices()
+	{
+		m_storage_probes.wait();
+	}
+
+	void PCIManager::wait_for_all_devices()
+	{
+		m_storage_probes.wait();
+		m_device_probes.wait();
 	}
 
 	void PCI::Device::initialize(paddr_t pcie_paddr)
@@ -445,9 +547,10 @@ namespace Kernel::PCI
 		ASSERT_NOT_REACHED();
 	}
 
-	static constexpr uint64_t msi_message_address()
+	static uint64_t msi_message_address(ProcessorID target)
 	{
-		return 0xFEE00000;
+		// fixed delivery to a single local apic in physical destination mode
+		return 0xFEE00000 | (static_cast<uint64_t>(target.as_u32() & 0xFF) << 12);
 	}
 
 	static constexpr uint32_t msi_message_data(uint8_t irq)
@@ -477,6 +580,12 @@ namespace Kernel::PCI
 				write_word(*m_offset_msi_x + 0x02, msg_ctrl);
 			};
 
+		const auto retarget_msi =
+			[](uint8_t irq, ProcessorID target, void* device) -> BAN::ErrorOr<void>
+			{
+				return static_cast<PCI::Device*>(device)->set_msi_target(irq, target);
+			};
+
 		const uint8_t irq = get_interrupt(index);
 
 		switch (m_interrupt_mechanism)
@@ -490,6 +599,7 @@ namespace Kernel::PCI
 				disable_msi_x();
 
 				// TODO: allow failing
+				LockGuard _(s_interrupt_routing_mutex);
 				auto it = s_pci_pin_interrupts.find(irq);
 				if (it == s_pci_pin_interrupts.end())
 					it = MUST(s_pci_pin_interrupts.insert(irq, MUST(BAN::UniqPtr<PCIPinInterrupt>::create(irq))));
@@ -509,7 +619,8 @@ namespace Kernel::PCI
 				msg_ctrl |= 1u << 0;		// Enable
 				write_word(*m_offset_msi + 0x02, msg_ctrl);
 
-				const uint64_t msg_addr = msi_message_address();
+				const auto target = IRQAffinity::register_irq(irq, retarget_msi, this, true);
+				const uint64_t msg_addr = msi_message_address(target);
 				const uint32_t msg_data = msi_message_data(irq);
 
 				if (msg_ctrl & (1 << 7))
@@ -541,7 +652,8 @@ namespace Kernel::PCI
 				const uint32_t offset = dword1 & ~7u;
 				const uint8_t  bir    = dword1 &  7u;
 
-				const uint64_t msg_addr = msi_message_address();
+				const auto target = IRQAffinity::register_irq(irq, retarget_msi, this, true);
+				const uint64_t msg_addr = msi_message_address(target);
 				const uint32_t msg_data = msi_message_data(irq);
 
 				auto bar = MUST(allocate_bar_region(bir));
@@ -558,6 +670,49 @@ namespace Kernel::PCI
 		}
 	}
 
+	BAN::ErrorOr<void> PCI::Device::set_msi_target(uint8_t irq, ProcessorID target)
+	{
+		uint8_t index = 0;
+		while (index < m_reserved_interrupt_count && get_interrupt(index) != irq)
+			index++;
+		ASSERT(index < m_reserved_interrupt_count);
+
+		const uint64_t msg_addr = msi_message_address(target);
+
+		switch (m_interrupt_mechanism)
+		{
+			case InterruptMechanism::MSI:
+			{
+				// only the low dword holds the destination
+				write_dword(*m_offset_msi + 0x04, msg_addr & 0xFFFFFFFF);
+				return {};
+			}
+			case InterruptMechanism::MSIX:
+			{
+				const uint32_t dword1 = read_dword(*m_offset_msi_x + 0x04);
+				const uint32_t offset = dword1 & ~7u;
+				const uint8_t  bir    = dword1 &  7u;
+
+				auto bar = TRY(allocate_bar_region(bir));
+				ASSERT(bar->type() == BarType::MEM);
+
+				// mask the entry while its address is changed
+				auto& msi_x_entry = reinterpret_cast<volatile MSIXEntry*>(bar->vaddr() + offset)[index];
+				const uint32_t vector_ctrl = msi_x_entry.vector_ctrl;
+				msi_x_entry.vector_ctrl   = vector_ctrl | 1u;
+				msi_x_entry.msg_addr_low  = msg_addr & 0xFFFFFFFF;
+				msi_x_entry.msg_addr_high = msg_addr >> 32;
+				msi_x_entry.vector_ctrl   = vector_ctrl;
+				return {};
+			}
+			case InterruptMechanism::NONE:
+			case InterruptMechanism::PIN:
+				break;
+		}
+
+		ASSERT_NOT_REACHED();
+	}
+
 #pragma GCC diagnostic push
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic ignored "-Wstack-usage="
@@ -776,6 +931,8 @@ namespace Kernel::PCI
 		// FIXME: Allow "late" interrupt reserving
 		ASSERT(m_reserved_interrupt_count == 0);
 
+		LockGuard _(s_interrupt_routing_mutex);
+
 		const auto mechanism =
 			[this, count]() -> InterruptMechanism
 			{
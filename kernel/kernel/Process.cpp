@@ -2,24 +2,31 @@
 #include <BAN/Sort.h>
 #include <BAN/StringView.h>
 #include <kernel/ACPI/ACPI.h>
+#include <kernel/Device/ProfilerDevice.h>
+#include <kernel/Device/SyscallTraceDevice.h>
 #include <kernel/ELF.h>
 #include <kernel/Epoll.h>
 #include <kernel/FS/DevFS/FileSystem.h>
 #include <kernel/FS/EventFD.h>
 #include <kernel/FS/ProcFS/FileSystem.h>
 #include <kernel/FS/VirtualFileSystem.h>
+#include <kernel/Futex.h>
 #include <kernel/IDT.h>
 #include <kernel/InterruptController.h>
+#include <kernel/IORing.h>
 #include <kernel/Lock/BlockableSpinLock.h>
 #include <kernel/Lock/LockGuard.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Memory/FileBackedRegion.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/MemoryBackedRegion.h>
 #include <kernel/Process.h>
+#include <kernel/Random.h>
 #include <kernel/Scheduler.h>
 #include <kernel/Storage/StorageDevice.h>
 #include <kernel/Terminal/PseudoTerminal.h>
 #include <kernel/Timer/Timer.h>
+#include <kernel/Tracepoint.h>
 #include <kernel/UserCopy.h>
 
 #include <kernel/Banos.h>
@@ -32,6 +39,8 @@
 #include <sys/banan-os.h>
 #include <sys/eventfd.h>
 #include <sys/futex.h>
+#include <sys/lockstat.h>
+#include <sys/random.h>
 #include <sys/sysmacros.h>
 #include <sys/wait.h>
 
@@ -40,12 +49,19 @@
 namespace Kernel
 {
 
+	LockClass Process::s_memory_region_lock_class { "process_memory_regions" };
+	LockClass Process::s_process_lock_class { "process" };
+
 	static BAN::LinkedList<Process*> s_alarm_processes;
 	static BAN::Vector<Process*> s_processes;
-	static RecursiveSpinLock s_process_lock;
+	static LockClass s_process_list_lock_class { "process_list" };
+	static RecursiveSpinLock s_process_lock { s_process_list_lock_class };
+
+	// Held for reading while processes are inspected outside of s_process_lock,
+	// processes are not removed from s_processes while it is held
+	static RWLock s_process_snapshot_lock;
 
-	BAN::HashMap<paddr_t, BAN::UniqPtr<Process::futex_t>> Process::s_futexes;
-	Mutex Process::s_futex_lock;
+	static BAN::Atomic<uint64_t> s_next_address_space_id { 1 };
 
 	static void for_each_process(const BAN::Function<BAN::Iteration(Process&)>& callback)
 	{
@@ -110,6 +126,7 @@ namespace Kernel
 		process->m_root_file         = VirtualFileSystem::get().root_file();
 
 		process->m_page_table = BAN::UniqPtr<PageTable>::adopt(TRY(PageTable::create_userspace()));
+		process->m_address_space_id = s_next_address_space_id++;
 
 		TRY(process->m_cmdline.emplace_back());
 		TRY(process->m_cmdline.back().append(path));
@@ -392,7 +409,8 @@ namespace Kernel
 	void Process::cleanup_function(Thread* thread)
 	{
 		{
-			SpinLockGuard _(s_process_lock);
+			RWLockWRGuard _0(s_process_snapshot_lock);
+			SpinLockGuard _1(s_process_lock);
 			for (size_t i = 0; i < s_processes.size(); i++)
 			{
 				if (s_processes[i] != this)
@@ -426,6 +444,38 @@ namespace Kernel
 		thread->give_keep_alive_page_table(BAN::move(m_page_table));
 	}
 
+	static char thread_state(const Thread& thread)
+	{
+		switch (thread.state())
+		{
+			case Thread::State::NotStarted:
+				return PROC_STATE_RUNNING;
+			case Thread::State::Executing:
+				return thread.is_blocked() ? PROC_STATE_SLEEPING : PROC_STATE_RUNNING;
+			case Thread::State::Terminated:
+				return PROC_STATE_ZOMBIE;
+		}
+		ASSERT_NOT_REACHED();
+	}
+
+	static void add_thread_counters(proc_counters_t& counters, const Thread& thread)
+	{
+		uint64_t user_ns, system_ns;
+		thread.cpu_time_ns(user_ns, system_ns);
+
+		const auto& statistics = thread.statistics();
+		counters.user_ns              += user_ns;
+		counters.system_ns            += system_ns;
+		counters.voluntary_switches   += statistics.voluntary_switches;
+		counters.involuntary_switches += statistics.involuntary_switches;
+		counters.minor_faults         += statistics.minor_page_faults;
+		counters.major_faults         += statistics.major_page_faults;
+		counters.read_bytes           += statistics.read_bytes;
+		counters.write_bytes          += statistics.write_bytes;
+		counters.read_syscalls        += statistics.read_syscalls;
+		counters.write_syscalls       += statistics.write_syscalls;
+	}
+
 	bool Process::on_thread_exit(Thread& thread)
 	{
 		// TODO: if main thread exists, should we delete its stack?
@@ -434,6 +484,8 @@ namespace Kernel
 
 		ASSERT(m_threads.size() > 0);
 
+		add_thread_counters(m_exited_thread_counters, thread);
+
 		if (m_threads.size() == 1)
 		{
 			ASSERT(m_threads.front() == &thread);
@@ -549,8 +601,8 @@ namespace Kernel
 
 			const vaddr_t vaddr = master_addr + bytes_copied;
 			const paddr_t paddr = page_table.physical_address_of(vaddr & PAGE_ADDR_MASK);
-			PageTable::with_fast_page(paddr, [&] {
-				memcpy(buffer, PageTable::fast_page_as_ptr(vaddr % PAGE_SIZE), to_copy);
+			PageTable::with_physical_page(paddr, [&](void* page) {
+				memcpy(buffer, static_cast<uint8_t*>(page) + vaddr % PAGE_SIZE, to_copy);
 			});
 
 			TRY(region->copy_data_to_region(bytes_copied, buffer, to_copy));
@@ -625,12 +677,8 @@ namespace Kernel
 		return BAN::Error::from_errno(ENOMEM);
 	}
 
-	size_t Process::proc_meminfo(off_t offset, BAN::ByteSpan buffer) const
+	proc_meminfo_t Process::meminfo() const
 	{
-		ASSERT(offset >= 0);
-		if ((size_t)offset >= sizeof(proc_meminfo_t))
-			return 0;
-
 		proc_meminfo_t meminfo;
 		meminfo.page_size = PAGE_SIZE;
 		meminfo.virt_pages = 0;
@@ -653,6 +701,17 @@ namespace Kernel
 			}
 		}
 
+		return meminfo;
+	}
+
+	size_t Process::proc_meminfo(off_t offset, BAN::ByteSpan buffer) const
+	{
+		ASSERT(offset >= 0);
+		if ((size_t)offset >= sizeof(proc_meminfo_t))
+			return 0;
+
+		const auto meminfo = this->meminfo();
+
 		size_t bytes = BAN::Math::min<size_t>(sizeof(proc_meminfo_t) - offset, buffer.size());
 		memcpy(buffer.data(), (uint8_t*)&meminfo + offset, bytes);
 		return bytes;
@@ -718,6 +777,138 @@ namespace Kernel
 		return to_copy;
 	}
 
+	proc_stat_t Process::stat() const
+	{
+		proc_stat_t stat {};
+		stat.pid  = m_pid;
+		stat.ppid = m_parent;
+		stat.pgrp = m_pgrp;
+		stat.sid  = m_sid;
+		stat.meminfo = meminfo();
+
+		LockGuard _(m_process_lock);
+
+		stat.uid = m_credentials.ruid();
+		stat.gid = m_credentials.rgid();
+		stat.thread_count = m_threads.size();
+		stat.counters = m_exited_thread_counters;
+
+		if (m_is_exiting || m_threads.empty())
+			stat.state = PROC_STATE_ZOMBIE;
+		else if (m_stopped)
+			stat.state = PROC_STATE_STOPPED;
+		else
+		{
+			stat.state = PROC_STATE_SLEEPING;
+			for (auto* thread : m_threads)
+				if (thread_state(*thread) == PROC_STATE_RUNNING)
+					stat.state = PROC_STATE_RUNNING;
+		}
+
+		if (!m_threads.empty())
+			stat.last_cpu = m_threads.front()->statistics().last_processor;
+		for (auto* thread : m_threads)
+			add_thread_counters(stat.counters, *thread);
+
+		if (!m_cmdline.empty())
+		{
+			const size_t len = BAN::Math::min<size_t>(m_cmdline.front().size(), sizeof(stat.command) - 1);
+			memcpy(stat.command, m_cmdline.front().data(), len);
+		}
+
+		return stat;
+	}
+
+	size_t Process::proc_stat(off_t offset, BAN::ByteSpan buffer) const
+	{
+		ASSERT(offset >= 0);
+		if ((size_t)offset >= sizeof(proc_stat_t))
+			return 0;
+
+		const auto stat = this->stat();
+
+		size_t bytes = BAN::Math::min<size_t>(sizeof(proc_stat_t) - offset, buffer.size());
+		memcpy(buffer.data(), (uint8_t*)&stat + offset, bytes);
+		return bytes;
+	}
+
+	size_t Process::proc_thread_stat(pid_t tid, off_t offset, BAN::ByteSpan buffer) const
+	{
+		ASSERT(offset >= 0);
+		if ((size_t)offset >= sizeof(proc_thread_stat_t))
+			return 0;
+
+		proc_thread_stat_t stat {};
+
+		{
+			LockGuard _(m_process_lock);
+
+			const Thread* thread = nullptr;
+			for (auto* candidate : m_threads)
+				if (candidate->tid() == tid)
+					thread = candidate;
+			if (thread == nullptr)
+				return 0;
+
+			stat.tid = tid;
+			stat.state = m_stopped ? PROC_STATE_STOPPED : thread_state(*thread);
+			stat.last_cpu = thread->statistics().last_processor;
+			add_thread_counters(stat.counters, *thread);
+		}
+
+		size_t bytes = BAN::Math::min<size_t>(sizeof(proc_thread_stat_t) - offset, buffer.size());
+		memcpy(buffer.data(), (uint8_t*)&stat + offset, bytes);
+		return bytes;
+	}
+
+	BAN::ErrorOr<size_t> Process::proc_processes(off_t offset, BAN::ByteSpan buffer)
+	{
+		ASSERT(offset >= 0);
+
+		RWLockRDGuard _(s_process_snapshot_lock);
+
+		// per process locks are mutexes, so only collect the processes under the spinlock
+		BAN::Vector<Process*> processes;
+		{
+			SpinLockGuard _(s_process_lock);
+			TRY(processes.resize(s_processes.size()));
+			for (size_t i = 0; i < s_processes.size(); i++)
+				processes[i] = s_processes[i];
+		}
+
+		size_t written = 0;
+		for (size_t i = offset / sizeof(proc_stat_t); i < processes.size() && written < buffer.size(); i++)
+		{
+			const auto stat = processes[i]->stat();
+
+			const size_t stat_offset = (i == offset / sizeof(proc_stat_t)) ? offset % sizeof(proc_stat_t) : 0;
+			const size_t bytes = BAN::Math::min<size_t>(sizeof(proc_stat_t) - stat_offset, buffer.size() - written);
+			memcpy(buffer.data() + written, (uint8_t*)&stat + stat_offset, bytes);
+			written += bytes;
+		}
+
+		return written;
+	}
+
+	BAN::ErrorOr<BAN::Vector<pid_t>> Process::thread_ids() const
+	{
+		LockGuard _(m_process_lock);
+		BAN::Vector<pid_t> result;
+		TRY(result.resize(m_threads.size()));
+		for (size_t i = 0; i < m_threads.size(); i++)
+			result[i] = m_threads[i]->tid();
+		return result;
+	}
+
+	bool Process::has_thread(pid_t tid) const
+	{
+		LockGuard _(m_process_lock);
+		for (auto* thread : m_threads)
+			if (thread->tid() == tid)
+				return true;
+		return false;
+	}
+
 	BAN::ErrorOr<BAN::String> Process::proc_cwd() const
 	{
 		LockGuard _(m_process_lock);
@@ -873,6 +1064,7 @@ namespace Kernel
 			delete forked;
 		});
 		forked->m_page_table = BAN::move(page_table);
+		forked->m_address_space_id = s_next_address_space_id++;
 
 		Thread* thread = TRY(Thread::current().clone(forked, sp, ip));
 		BAN::ScopeGuard thread_deleter([thread] { delete thread; });
@@ -896,6 +1088,7 @@ namespace Kernel
 		forked->m_open_file_descriptors = BAN::move(*open_file_descriptors);
 		forked->m_mapped_regions = BAN::move(mapped_regions);
 		forked->m_has_called_exec = false;
+		forked->m_is_syscall_traced = m_is_syscall_traced.load();
 		memcpy(forked->m_signal_handlers, m_signal_handlers, sizeof(m_signal_handlers));
 
 		*child_exit_status = {};
@@ -1120,6 +1313,7 @@ namespace Kernel
 			m_open_file_descriptors.close_cloexec();
 			m_mapped_regions = BAN::move(new_mapped_regions);
 			m_page_table = BAN::move(new_page_table);
+			m_address_space_id = s_next_address_space_id++;
 
 			m_shared_page_vaddr = shared_page_vaddr;
 			m_threads.front()->update_processor_index_address();
@@ -1477,7 +1671,9 @@ namespace Kernel
 
 		auto* buffer_region = TRY(validate_and_pin_pointer_access(buffer, count, true));
 		BAN::ScopeGuard _([buffer_region] { buffer_region->unpin(); });
-		return TRY(m_open_file_descriptors.read(fd, BAN::ByteSpan(static_cast<uint8_t*>(buffer), count)));
+		const size_t nread = TRY(m_open_file_descriptors.read(fd, BAN::ByteSpan(static_cast<uint8_t*>(buffer), count)));
+		Thread::current().account_read_bytes(nread);
+		return nread;
 	}
 
 	BAN::ErrorOr<long> Process::sys_write(int fd, const void* buffer, size_t count)
@@ -1490,7 +1686,9 @@ namespace Kernel
 
 		auto* buffer_region = TRY(validate_and_pin_pointer_access(buffer, count, false));
 		BAN::ScopeGuard _([buffer_region] { buffer_region->unpin(); });
-		return TRY(m_open_file_descriptors.write(fd, BAN::ConstByteSpan(static_cast<const uint8_t*>(buffer), count)));
+		const size_t nwrite = TRY(m_open_file_descriptors.write(fd, BAN::ConstByteSpan(static_cast<const uint8_t*>(buffer), count)));
+		Thread::current().account_write_bytes(nwrite);
+		return nwrite;
 	}
 
 	BAN::ErrorOr<long> Process::sys_access(const char* user_path, int amode)
@@ -1682,7 +1880,9 @@ namespace Kernel
 		auto* buffer_region = TRY(validate_and_pin_pointer_access(buffer, count, true));
 		BAN::ScopeGuard _([buffer_region] { buffer_region->unpin(); });
 
-		return TRY(inode->read(offset, { reinterpret_cast<uint8_t*>(buffer), count }));
+		const size_t nread = TRY(inode->read(offset, { reinterpret_cast<uint8_t*>(buffer), count }));
+		Thread::current().account_read_bytes(nread);
+		return nread;
 	}
 
 	BAN::ErrorOr<long> Process::sys_pwrite(int fd, const void* buffer, size_t count, off_t offset)
@@ -1692,7 +1892,150 @@ namespace Kernel
 		auto* buffer_region = TRY(validate_and_pin_pointer_access(buffer, count, false));
 		BAN::ScopeGuard _([buffer_region] { buffer_region->unpin(); });
 
-		return TRY(inode->write(offset, { reinterpret_cast<const uint8_t*>(buffer), count }));	}
+		const size_t nwrite = TRY(inode->write(offset, { reinterpret_cast<const uint8_t*>(buffer), count }));
+		Thread::current().account_write_bytes(nwrite);
+		return nwrite;
+	}
+
+	BAN::ErrorOr<long> Process::sys_readv(int fd, const iovec* user_iov, int iovcnt)
+	{
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		const auto iovs = TRY(read_and_pin_iovecs(user_iov, iovcnt, true, regions));
+		const size_t nread = TRY(m_open_file_descriptors.readv(fd, iovs.span(), nullptr));
+		Thread::current().account_read_bytes(nread);
+		return nread;
+	}
+
+	BAN::ErrorOr<long> Process::sys_writev(int fd, const iovec* user_iov, int iovcnt)
+	{
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		const auto iovs = TRY(read_and_pin_iovecs(user_iov, iovcnt, false, regions));
+		const size_t nwrite = TRY(m_open_file_descriptors.writev(fd, iovs.span(), nullptr));
+		Thread::current().account_write_bytes(nwrite);
+		return nwrite;
+	}
+
+	BAN::ErrorOr<long> Process::sys_preadv(int fd, const iovec* user_iov, int iovcnt, off_t offset)
+	{
+		if (offset < 0)
+			return BAN::Error::from_errno(EINVAL);
+
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		const auto iovs = TRY(read_and_pin_iovecs(user_iov, iovcnt, true, regions));
+		const size_t nread = TRY(m_open_file_descriptors.readv(fd, iovs.span(), &offset));
+		Thread::current().account_read_bytes(nread);
+		return nread;
+	}
+
+	BAN::ErrorOr<long> Process::sys_pwritev(int fd, const iovec* user_iov, int iovcnt, off_t offset)
+	{
+		if (offset < 0)
+			return BAN::Error::from_errno(EINVAL);
+
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		const auto iovs = TRY(read_and_pin_iovecs(user_iov, iovcnt, false, regions));
+		const size_t nwrite = TRY(m_open_file_descriptors.writev(fd, iovs.span(), &offset));
+		Thread::current().account_write_bytes(nwrite);
+		return nwrite;
+	}
+
+	BAN::ErrorOr<long> Process::sys_sendfile(int out_fd, int in_fd, off_t* user_offset, size_t count)
+	{
+		off_t offset;
+		if (user_offset != nullptr)
+			TRY(read_from_user(user_offset, &offset, sizeof(off_t)));
+
+		const auto ret = TRY(m_open_file_descriptors.splice(in_fd, user_offset ? &offset : nullptr, out_fd, nullptr, count, false));
+		Thread::current().account_read_bytes(ret);
+		Thread::current().account_write_bytes(ret);
+
+		// NOTE: data has already been transferred, reporting an error here would make the caller retry it
+		if (user_offset != nullptr)
+			(void)write_to_user(user_offset, &offset, sizeof(off_t));
+
+		return ret;
+	}
+
+	BAN::ErrorOr<long> Process::sys_splice(const sys_splice_t* user_arguments)
+	{
+		sys_splice_t arguments;
+		TRY(read_from_user(user_arguments, &arguments, sizeof(sys_splice_t)));
+
+		if (arguments.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE | SPLICE_F_GIFT))
+			return BAN::Error::from_errno(EINVAL);
+
+		off_t offset_in, offset_out;
+		if (arguments.off_in != nullptr)
+			TRY(read_from_user(arguments.off_in, &offset_in, sizeof(off_t)));
+		if (arguments.off_out != nullptr)
+			TRY(read_from_user(arguments.off_out, &offset_out, sizeof(off_t)));
+
+		const auto ret = TRY(m_open_file_descriptors.splice(
+			arguments.fd_in, arguments.off_in ? &offset_in : nullptr,
+			arguments.fd_out, arguments.off_out ? &offset_out : nullptr,
+			arguments.len, !!(arguments.flags & SPLICE_F_NONBLOCK)
+		));
+		Thread::current().account_read_bytes(ret);
+		Thread::current().account_write_bytes(ret);
+
+		// NOTE: data has already been transferred, reporting an error here would make the caller retry it
+		if (arguments.off_in != nullptr)
+			(void)write_to_user(arguments.off_in, &offset_in, sizeof(off_t));
+		if (arguments.off_out != nullptr)
+			(void)write_to_user(arguments.off_out, &offset_out, sizeof(off_t));
+
+		return ret;
+	}
+
+	BAN::ErrorOr<long> Process::sys_copy_file_range(int fd_in, off_t* user_offset_in, int fd_out, off_t* user_offset_out, size_t count)
+	{
+		if (!TRY(m_open_file_descriptors.inode_of(fd_in))->mode().ifreg())
+			return BAN::Error::from_errno(EINVAL);
+		if (!TRY(m_open_file_descriptors.inode_of(fd_out))->mode().ifreg())
+			return BAN::Error::from_errno(EINVAL);
+
+		off_t offset_in, offset_out;
+		if (user_offset_in != nullptr)
+			TRY(read_from_user(user_offset_in, &offset_in, sizeof(off_t)));
+		if (user_offset_out != nullptr)
+			TRY(read_from_user(user_offset_out, &offset_out, sizeof(off_t)));
+
+		const auto ret = TRY(m_open_file_descriptors.splice(
+			fd_in, user_offset_in ? &offset_in : nullptr,
+			fd_out, user_offset_out ? &offset_out : nullptr,
+			count, false
+		));
+		Thread::current().account_read_bytes(ret);
+		Thread::current().account_write_bytes(ret);
+
+		// NOTE: data has already been transferred, reporting an error here would make the caller retry it
+		if (user_offset_in != nullptr)
+			(void)write_to_user(user_offset_in, &offset_in, sizeof(off_t));
+		if (user_offset_out != nullptr)
+			(void)write_to_user(user_offset_out, &offset_out, sizeof(off_t));
+
+		return ret;
+	}
 
 	BAN::ErrorOr<long> Process::sys_fchmodat(int fd, const char* user_path, mode_t mode, int flag)
 	{
@@ -1992,32 +2335,40 @@ namespace Kernel
 		return 0;
 	}
 
+	BAN::ErrorOr<void> Process::pin_message_buffers(const msghdr& message, bool needs_write, BAN::Vector<MemoryRegion*>& regions)
+	{
+		TRY(regions.reserve(regions.size() + !!message.msg_name + !!message.msg_control + !!message.msg_iov));
+
+		if (message.msg_name)
+			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_name, message.msg_namelen, needs_write))));
+		if (message.msg_control)
+			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_control, message.msg_controllen, needs_write))));
+		if (message.msg_iov)
+		{
+			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov, message.msg_iovlen * sizeof(iovec), needs_write))));
+			TRY(regions.reserve(regions.size() + message.msg_iovlen));
+			for (int i = 0; i < message.msg_iovlen; i++)
+				TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov[i].iov_base, message.msg_iov[i].iov_len, needs_write))));
+		}
+
+		return {};
+	}
+
 	BAN::ErrorOr<long> Process::sys_recvmsg(int socket, msghdr* user_message, int flags)
 	{
 		msghdr message;
 		TRY(read_from_user(user_message, &message, sizeof(msghdr)));
 
 		BAN::Vector<MemoryRegion*> regions;
-		TRY(regions.reserve(!!message.msg_name + !!message.msg_control + !!message.msg_iov));
-
 		BAN::ScopeGuard _([&regions] {
 			for (auto* region : regions)
 				region->unpin();
 		});
 
-		if (message.msg_name)
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_name, message.msg_namelen, true))));
-		if (message.msg_control)
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_control, message.msg_controllen, true))));
-		if (message.msg_iov)
-		{
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov, message.msg_iovlen * sizeof(iovec), true))));
-			TRY(regions.reserve(regions.size() + message.msg_iovlen));
-			for (int i = 0; i < message.msg_iovlen; i++)
-				TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov[i].iov_base, message.msg_iov[i].iov_len, true))));
-		}
+		TRY(pin_message_buffers(message, true, regions));
 
 		const auto ret = TRY(m_open_file_descriptors.recvmsg(socket, message, flags));
+		Thread::current().account_read_bytes(ret);
 
 		TRY(write_to_user(user_message, &message, sizeof(msghdr)));
 
@@ -2030,26 +2381,84 @@ namespace Kernel
 		TRY(read_from_user(user_message, &message, sizeof(msghdr)));
 
 		BAN::Vector<MemoryRegion*> regions;
-		TRY(regions.reserve(!!message.msg_name + !!message.msg_control + !!message.msg_iov));
-
 		BAN::ScopeGuard _([&regions] {
 			for (auto* region : regions)
 				region->unpin();
 		});
 
-		if (message.msg_name)
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_name, message.msg_namelen, false))));
-		if (message.msg_control)
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_control, message.msg_controllen, false))));
-		if (message.msg_iov)
+		TRY(pin_message_buffers(message, false, regions));
+
+		const size_t nsend = TRY(m_open_file_descriptors.sendmsg(socket, message, flags));
+		Thread::current().account_write_bytes(nsend);
+		return nsend;
+	}
+
+	BAN::ErrorOr<long> Process::sys_recvmmsg(int socket, mmsghdr* user_messages, unsigned int vlen, int flags, const timespec* user_timeout)
+	{
+		vlen = BAN::Math::min<unsigned int>(vlen, IOV_MAX);
+		if (vlen == 0)
+			return 0;
+
+		BAN::Vector<mmsghdr> messages;
+		TRY(messages.resize(vlen));
+		TRY(read_from_user(user_messages, messages.data(), vlen * sizeof(mmsghdr)));
+
+		uint64_t waketime_ns = BAN::numeric_limits<uint64_t>::max();
+		if (user_timeout)
 		{
-			TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov, message.msg_iovlen * sizeof(iovec), false))));
-			TRY(regions.reserve(regions.size() + message.msg_iovlen));
-			for (int i = 0; i < message.msg_iovlen; i++)
-				TRY(regions.push_back(TRY(validate_and_pin_pointer_access(message.msg_iov[i].iov_base, message.msg_iov[i].iov_len, false))));
+			timespec timeout;
+			TRY(read_from_user(user_timeout, &timeout, sizeof(timespec)));
+			waketime_ns =
+				SystemTimer::get().ns_since_boot() +
+				timeout.tv_sec * 1'000'000'000 +
+				timeout.tv_nsec;
 		}
 
-		return TRY(m_open_file_descriptors.sendmsg(socket, message, flags));
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		for (const auto& message : messages)
+			TRY(pin_message_buffers(message.msg_hdr, true, regions));
+
+		const size_t count = TRY(m_open_file_descriptors.recvmmsg(socket, messages.span(), flags, waketime_ns));
+		for (size_t i = 0; i < count; i++)
+			Thread::current().account_read_bytes(messages[i].msg_len);
+
+		TRY(write_to_user(user_messages, messages.data(), count * sizeof(mmsghdr)));
+
+		return count;
+	}
+
+	BAN::ErrorOr<long> Process::sys_sendmmsg(int socket, mmsghdr* user_messages, unsigned int vlen, int flags)
+	{
+		vlen = BAN::Math::min<unsigned int>(vlen, IOV_MAX);
+		if (vlen == 0)
+			return 0;
+
+		BAN::Vector<mmsghdr> messages;
+		TRY(messages.resize(vlen));
+		TRY(read_from_user(user_messages, messages.data(), vlen * sizeof(mmsghdr)));
+
+		BAN::Vector<MemoryRegion*> regions;
+		BAN::ScopeGuard _([&regions] {
+			for (auto* region : regions)
+				region->unpin();
+		});
+
+		for (const auto& message : messages)
+			TRY(pin_message_buffers(message.msg_hdr, false, regions));
+
+		const size_t count = TRY(m_open_file_descriptors.sendmmsg(socket, messages.span(), flags));
+		for (size_t i = 0; i < count; i++)
+			Thread::current().account_write_bytes(messages[i].msg_len);
+
+		for (size_t i = 0; i < count; i++)
+			TRY(write_to_user(&user_messages[i].msg_len, &messages[i].msg_len, sizeof(unsigned int)));
+
+		return count;
 	}
 
 	BAN::ErrorOr<long> Process::sys_ioctl(int fildes, unsigned long request, void* arg)
@@ -2241,27 +2650,33 @@ namespace Kernel
 		if (return_value || SystemTimer::get().ns_since_boot() >= waketime_ns)
 			return return_value;
 
-		uint32_t events_per_fd[OPEN_MAX] {};
+		BAN::HashMap<int, uint32_t> events_per_fd;
 		for (nfds_t i = 0; i < nfds; i++)
-			if (fds[i].fd >= 0 && fds[i].fd < OPEN_MAX)
-				events_per_fd[fds[i].fd] |= fds[i].events;
+		{
+			if (fds[i].fd < 0)
+				continue;
+			auto it = events_per_fd.find(fds[i].fd);
+			if (it == events_per_fd.end())
+				it = TRY(events_per_fd.insert(fds[i].fd, 0));
+			it->value |= fds[i].events;
+		}
 
 		size_t fd_count = 0;
 
 		auto epoll = TRY(Epoll::create());
-		for (int fd = 0; fd < OPEN_MAX; fd++)
+		for (const auto& [fd, poll_events] : events_per_fd)
 		{
-			if (events_per_fd[fd] == 0)
+			if (poll_events == 0)
 				continue;
 
 			auto inode = TRY(m_open_file_descriptors.inode_of(fd));
 
 			uint32_t events = 0;
-			if (events_per_fd[fd] & (POLLIN  | POLLRDNORM))
+			if (poll_events & (POLLIN  | POLLRDNORM))
 				events |= EPOLLIN;
-			if (events_per_fd[fd] & (POLLOUT | POLLWRNORM))
+			if (poll_events & (POLLOUT | POLLWRNORM))
 				events |= EPOLLOUT;
-			if (events_per_fd[fd] & POLLPRI)
+			if (poll_events & POLLPRI)
 				events |= EPOLLPRI;
 			// POLLRDBAND
 			// POLLWRBAND
@@ -2400,6 +2815,51 @@ namespace Kernel
 		));
 	}
 
+	BAN::ErrorOr<long> Process::sys_ioring_setup(unsigned entries, ioring_shared* user_shared, int flags)
+	{
+		if (flags & ~IORING_CLOEXEC)
+			return BAN::Error::from_errno(EINVAL);
+		if (entries == 0 || entries > IORING_MAX_ENTRIES || (entries & (entries - 1)))
+			return BAN::Error::from_errno(EINVAL);
+
+		{
+			auto* shared_region = TRY(validate_and_pin_pointer_access(user_shared, IORING_SHARED_SIZE(entries), true));
+			shared_region->unpin();
+		}
+
+		const ioring_shared shared {
+			.sq_head = 0,
+			.sq_tail = 0,
+			.cq_head = 0,
+			.cq_tail = 0,
+			.sq_entries = entries,
+			.cq_entries = entries * 2,
+			.cq_overflow = 0,
+			.__reserved = 0,
+		};
+		TRY(write_to_user(user_shared, &shared, sizeof(ioring_shared)));
+
+		return TRY(m_open_file_descriptors.open(
+			VirtualFileSystem::File {
+				TRY(IORing::create(entries, reinterpret_cast<vaddr_t>(user_shared), m_address_space_id)),
+				"<ioring>"_sv
+			}, (flags & IORING_CLOEXEC) ? O_CLOEXEC : 0
+		));
+	}
+
+	BAN::ErrorOr<long> Process::sys_ioring_enter(int fd, unsigned to_submit, unsigned min_complete, const timespec* user_timeout)
+	{
+		auto inode = TRY(m_open_file_descriptors.inode_of(fd));
+		if (!inode->is_ioring())
+			return BAN::Error::from_errno(EINVAL);
+
+		timespec timeout;
+		if (user_timeout != nullptr)
+			TRY(read_from_user(user_timeout, &timeout, sizeof(timespec)));
+
+		return TRY(static_cast<IORing*>(inode.ptr())->enter(*this, to_submit, min_complete, user_timeout ? &timeout : nullptr));
+	}
+
 	BAN::ErrorOr<long> Process::sys_pipe(int user_fildes[2])
 	{
 		int fildes[2];
@@ -2425,6 +2885,37 @@ namespace Kernel
 		return TRY(m_open_file_descriptors.fcntl(fildes, cmd, extra));
 	}
 
+	BAN::ErrorOr<long> Process::sys_getrlimit(int resource, rlimit* user_rlp)
+	{
+		rlimit limit;
+		switch (resource)
+		{
+			case RLIMIT_NOFILE:
+				limit = m_open_file_descriptors.get_nofile_limit();
+				break;
+			default:
+				return BAN::Error::from_errno(EINVAL);
+		}
+
+		TRY(write_to_user(user_rlp, &limit, sizeof(rlimit)));
+		return 0;
+	}
+
+	BAN::ErrorOr<long> Process::sys_setrlimit(int resource, const rlimit* user_rlp)
+	{
+		rlimit limit;
+		TRY(read_from_user(user_rlp, &limit, sizeof(rlimit)));
+
+		switch (resource)
+		{
+			case RLIMIT_NOFILE:
+				TRY(m_open_file_descriptors.set_nofile_limit(limit));
+				return 0;
+			default:
+				return BAN::Error::from_errno(EINVAL);
+		}
+	}
+
 	BAN::ErrorOr<long> Process::sys_seek(int fd, off_t offset, int whence)
 	{
 		return TRY(m_open_file_descriptors.seek(fd, offset, whence));
@@ -2805,6 +3296,11 @@ namespace Kernel
 
 		const vaddr_t region_vaddr = region->vaddr();
 		TRY(add_mapped_region(BAN::move(region)));
+
+		if ((args.prot & PROT_EXEC) && inode->mode().ifreg() && ProfilerDevice::is_profiling(pid()))
+			if (auto path = m_open_file_descriptors.path_of(args.fildes); !path.is_error())
+				ProfilerDevice::record_mmap(pid(), region_vaddr, args.len, args.off, path.value());
+
 		return region_vaddr;
 	}
 
@@ -3049,9 +3545,11 @@ namespace Kernel
 		switch (clock_id)
 		{
 			case CLOCK_MONOTONIC:
+			case CLOCK_MONOTONIC_COARSE:
 				tp = SystemTimer::get().time_since_boot();
 				break;
 			case CLOCK_REALTIME:
+			case CLOCK_REALTIME_COARSE:
 				tp = SystemTimer::get().real_time();
 				break;
 			case CLOCK_PROCESS_CPUTIME_ID:
@@ -3406,118 +3904,126 @@ namespace Kernel
 		return 0;
 	}
 
-	BAN::ErrorOr<long> Process::sys_futex(int op, const uint32_t* addr, uint32_t val, const timespec* user_abstime)
+	BAN::ErrorOr<long> Process::sys_futex(int op, const uint32_t* addr, uint32_t val, const timespec* user_abstime, const futex_args* user_args)
 	{
-		const vaddr_t vaddr = reinterpret_cast<vaddr_t>(addr);
-		if (vaddr % 4)
-			return BAN::Error::from_errno(EINVAL);
-
 		const bool is_realtime = (op & FUTEX_REALTIME);
 		const bool is_private = (op & FUTEX_PRIVATE);
 		op &= ~(FUTEX_PRIVATE | FUTEX_REALTIME);
 
-		auto* buffer_region = TRY(validate_and_pin_pointer_access(addr, sizeof(uint32_t), false));
-		BAN::ScopeGuard pin_guard([buffer_region] { buffer_region->unpin(); });
-
-		const paddr_t paddr = m_page_table->physical_address_of(vaddr & PAGE_ADDR_MASK) | (vaddr & ~PAGE_ADDR_MASK);
-		ASSERT(paddr != 0);
-
+		bool needs_args = false;
+		bool needs_addr2 = false;
 		switch (op)
 		{
 			case FUTEX_WAIT:
-				break;
 			case FUTEX_WAKE:
-				user_abstime = nullptr;
+				break;
+			case FUTEX_WAIT_BITSET:
+			case FUTEX_WAKE_BITSET:
+				needs_args = true;
+				break;
+			case FUTEX_REQUEUE:
+			case FUTEX_CMP_REQUEUE:
+			case FUTEX_WAKE_OP:
+				needs_args = true;
+				needs_addr2 = true;
 				break;
 			default:
 				return BAN::Error::from_errno(ENOSYS);
 		}
 
-		if (op == FUTEX_WAIT && BAN::atomic_load(*addr) != val)
-			return BAN::Error::from_errno(EAGAIN);
-
-		uint64_t wake_time_ns = BAN::numeric_limits<uint64_t>::max();
-
-		if (user_abstime != nullptr)
+		futex_args args {};
+		if (needs_args)
 		{
-			timespec abstime;
-			TRY(read_from_user(user_abstime, &abstime, sizeof(timespec)));
+			if (user_args == nullptr)
+				return BAN::Error::from_errno(EINVAL);
+			TRY(read_from_user(user_args, &args, sizeof(futex_args)));
+		}
 
-			const uint64_t abstime_ns = abstime.tv_sec * 1'000'000'000 + abstime.tv_nsec;
+		MemoryRegion* pinned_regions[2] {};
+		BAN::ScopeGuard pin_guard([&pinned_regions] {
+			for (auto* region : pinned_regions)
+				if (region != nullptr)
+					region->unpin();
+		});
 
-			if (!is_realtime)
-				wake_time_ns = abstime_ns;
-			else
+		const auto get_key =
+			[&](const uint32_t* address, bool write, MemoryRegion*& pinned_region) -> BAN::ErrorOr<Futex::Key>
 			{
-				const auto realtime = SystemTimer::get().real_time();
-				const uint64_t realtime_ns = realtime.tv_sec * 1'000'000'000 + realtime.tv_nsec;
-				if (abstime_ns <= realtime_ns)
-					return BAN::Error::from_errno(ETIMEDOUT);
-				wake_time_ns = SystemTimer::get().ns_since_boot() + (abstime_ns - realtime_ns);
-			}
-		}
+				const vaddr_t vaddr = reinterpret_cast<vaddr_t>(address);
+				if (vaddr % 4)
+					return BAN::Error::from_errno(EINVAL);
 
-		futex_t* futex;
+				pinned_region = TRY(validate_and_pin_pointer_access(address, sizeof(uint32_t), write));
 
-		{
-			auto& futex_lock = is_private ? m_futex_lock : s_futex_lock;
-			auto& futexes = is_private ? m_futexes : s_futexes;
+				const paddr_t paddr = m_page_table->physical_address_of(vaddr & PAGE_ADDR_MASK) | (vaddr & ~PAGE_ADDR_MASK);
+				ASSERT(paddr != 0);
 
-			LockGuard _(futex_lock);
+				return Futex::Key {
+					.paddr = paddr,
+					.owner = is_private ? this : nullptr,
+				};
+			};
 
-			auto it = futexes.find(paddr);
-			if (it != futexes.end())
-				futex = it->value.ptr();
-			else switch (op)
-			{
-				case FUTEX_WAIT:
-					futex = TRY(futexes.emplace(paddr, TRY(BAN::UniqPtr<futex_t>::create())))->value.ptr();
-					break;
-				case FUTEX_WAKE:
-					return 0;
-			}
-		}
+		const auto key = TRY(get_key(addr, false, pinned_regions[0]));
 
-		LockGuard _(futex->mutex);
+		Futex::Key key2 {};
+		if (needs_addr2)
+			key2 = TRY(get_key(args.addr2, op == FUTEX_WAKE_OP, pinned_regions[1]));
 
 		switch (op)
 		{
 			case FUTEX_WAIT:
+			case FUTEX_WAIT_BITSET:
 			{
+				const uint32_t bitset = (op == FUTEX_WAIT) ? FUTEX_BITSET_MATCH_ANY : args.value3;
+				if (bitset == 0)
+					return BAN::Error::from_errno(EINVAL);
+
 				if (BAN::atomic_load(*addr) != val)
 					return BAN::Error::from_errno(EAGAIN);
 
-				futex->waiters++;
-
-				// TODO: Deallocate unused futex objects at some point (?)
-				//       We don't want to do it on every operation as allocation
-				//       and deletion slows this down a lot and the same addresses
-				//       will be probably used again
-				BAN::ScopeGuard cleanup([futex] { futex->waiters--; });
+				uint64_t wake_time_ns = BAN::numeric_limits<uint64_t>::max();
 
-				for (;;)
+				if (user_abstime != nullptr)
 				{
-					TRY(Thread::current().block_or_eintr_or_waketime_ns(futex->blocker, wake_time_ns, true, &futex->mutex));
-					if (BAN::atomic_load(*addr) == val || futex->to_wakeup == 0)
-						continue;
-					futex->to_wakeup--;
-					return 0;
-				}
-			}
-			case FUTEX_WAKE:
-			{
-				if (BAN::Math::will_addition_overflow(futex->to_wakeup, val))
-					futex->to_wakeup = BAN::numeric_limits<uint32_t>::max();
-				else
-					futex->to_wakeup += val;
+					timespec abstime;
+					TRY(read_from_user(user_abstime, &abstime, sizeof(timespec)));
 
-				futex->to_wakeup = BAN::Math::min(futex->to_wakeup, futex->waiters);
+					const uint64_t abstime_ns = abstime.tv_sec * 1'000'000'000 + abstime.tv_nsec;
 
-				if (futex->to_wakeup > 0)
-					futex->blocker.unblock();
+					if (!is_realtime)
+						wake_time_ns = abstime_ns;
+					else
+					{
+						const auto realtime = SystemTimer::get().real_time();
+						const uint64_t realtime_ns = realtime.tv_sec * 1'000'000'000 + realtime.tv_nsec;
+						if (abstime_ns <= realtime_ns)
+							return BAN::Error::from_errno(ETIMEDOUT);
+						wake_time_ns = SystemTimer::get().ns_since_boot() + (abstime_ns - realtime_ns);
+					}
+				}
 
+				TRY(Futex::wait(key, addr, val, bitset, wake_time_ns));
 				return 0;
 			}
+			case FUTEX_WAKE:
+			case FUTEX_WAKE_BITSET:
+			{
+				const uint32_t bitset = (op == FUTEX_WAKE) ? FUTEX_BITSET_MATCH_ANY : args.value3;
+				if (bitset == 0)
+					return BAN::Error::from_errno(EINVAL);
+				return Futex::wake(key, val, bitset);
+			}
+			case FUTEX_REQUEUE:
+			case FUTEX_CMP_REQUEUE:
+			{
+				BAN::Optional<uint32_t> compare_value;
+				if (op == FUTEX_CMP_REQUEUE)
+					compare_value = args.value3;
+				return TRY(Futex::requeue(key, addr, key2, val, args.value2, compare_value));
+			}
+			case FUTEX_WAKE_OP:
+				return TRY(Futex::wake_op(key, key2, args.addr2, val, args.value2, args.value3));
 		}
 
 		ASSERT_NOT_REACHED();
@@ -3580,6 +4086,8 @@ namespace Kernel
 		LockGuard _1(m_process_lock);
 
 		TRY(m_threads.push_back(thread));
+		// process cpu time can no longer be read from this thread's shared page entry
+		Thread::current().update_shared_cpu_time();
 		if (auto ret = Processor::scheduler().add_thread(thread); ret.is_error())
 		{
 			m_threads.pop_back();
@@ -3698,6 +4206,91 @@ namespace Kernel
 		return BAN::Error::from_errno(ESRCH);
 	}
 
+	BAN::ErrorOr<long> Process::sys_syscall_trace(int target, pid_t id, int enable)
+	{
+		if (target != SYSCALL_TRACE_PROCESS && target != SYSCALL_TRACE_THREAD)
+			return BAN::Error::from_errno(EINVAL);
+
+		if (enable)
+			TRY(SyscallTraceDevice::initialize_buffers());
+
+		if (target == SYSCALL_TRACE_THREAD)
+		{
+			LockGuard _(m_process_lock);
+			for (auto* thread : m_threads)
+			{
+				if (thread->tid() != id)
+					continue;
+				thread->set_syscall_traced(enable);
+				return 0;
+			}
+			return BAN::Error::from_errno(ESRCH);
+		}
+
+		bool found = false;
+		bool allowed = false;
+		for_each_process(
+			[&](Process& process)
+			{
+				if (process.pid() != id)
+					return BAN::Iteration::Continue;
+				found = true;
+				allowed = m_credentials.is_superuser() || m_credentials.euid() == process.m_credentials.ruid();
+				if (allowed)
+					process.m_is_syscall_traced = enable;
+				return BAN::Iteration::Break;
+			}
+		);
+
+		if (!found)
+			return BAN::Error::from_errno(ESRCH);
+		if (!allowed)
+			return BAN::Error::from_errno(EPERM);
+		return 0;
+	}
+
+	BAN::ErrorOr<long> Process::sys_lockstat(int command)
+	{
+		if (!m_credentials.is_superuser())
+			return BAN::Error::from_errno(EPERM);
+
+		switch (command)
+		{
+			case LOCKSTAT_DISABLE:
+				LockClass::set_enabled(false);
+				TRY(Tracepoints::set_enabled(false));
+				return 0;
+			case LOCKSTAT_ENABLE:
+				TRY(Tracepoints::set_enabled(true));
+				LockClass::set_enabled(true);
+				return 0;
+			case LOCKSTAT_RESET:
+				LockClass::reset_all();
+				Tracepoints::reset();
+				return 0;
+		}
+
+		return BAN::Error::from_errno(EINVAL);
+	}
+
+	BAN::ErrorOr<long> Process::sys_getrandom(void* buffer, size_t count, unsigned flags)
+	{
+		// the generator is seeded before userspace starts, so there
+		// is nothing to wait for and all flags behave the same
+		if (flags & ~(GRND_NONBLOCK | GRND_RANDOM | GRND_INSECURE))
+			return BAN::Error::from_errno(EINVAL);
+
+		if (count == 0)
+			return 0;
+		count = BAN::Math::min<size_t>(count, BAN::numeric_limits<int>::max());
+
+		auto* buffer_region = TRY(validate_and_pin_pointer_access(buffer, count, true));
+		BAN::ScopeGuard _([buffer_region] { buffer_region->unpin(); });
+
+		Random::get_bytes(BAN::ByteSpan(static_cast<uint8_t*>(buffer), count));
+		return count;
+	}
+
 	BAN::ErrorOr<long> Process::sys_thread_detach(pid_t tid)
 	{
 		LockGuard _(m_process_lock);
@@ -4071,6 +4664,15 @@ namespace Kernel
 	{
 		ASSERT(&Process::current() == this);
 
+		// NOTE: major faults are also counted when pinning user memory or loading
+		//       executables, so minor faults are counted here instead of derived
+		auto& statistics = Thread::current().statistics();
+		const uint64_t old_major_page_faults = statistics.major_page_faults;
+		BAN::ScopeGuard count_page_fault([&] {
+			if (statistics.major_page_faults == old_major_page_faults)
+				statistics.minor_page_faults++;
+		});
+
 		const auto is_allocated =
 			[&]() -> bool
 			{
@@ -4106,6 +4708,32 @@ namespace Kernel
 		return region->allocate_page_containing(address, wants_write);
 	}
 
+	BAN::ErrorOr<BAN::Vector<iovec>> Process::read_and_pin_iovecs(const iovec* user_iov, int iovcnt, bool needs_write, BAN::Vector<MemoryRegion*>& regions)
+	{
+		if (iovcnt < 0 || iovcnt > IOV_MAX)
+			return BAN::Error::from_errno(EINVAL);
+
+		BAN::Vector<iovec> iovs;
+		TRY(iovs.resize(iovcnt));
+		if (iovcnt > 0)
+			TRY(read_from_user(user_iov, iovs.data(), iovcnt * sizeof(iovec)));
+
+		size_t total_size = 0;
+		for (const auto& iov : iovs)
+		{
+			if (BAN::Math::will_addition_overflow(total_size, iov.iov_len) || total_size + iov.iov_len > SSIZE_MAX)
+				return BAN::Error::from_errno(EINVAL);
+			total_size += iov.iov_len;
+		}
+
+		TRY(regions.reserve(regions.size() + iovs.size()));
+		for (const auto& iov : iovs)
+			if (iov.iov_len > 0)
+				TRY(regions.push_back(TRY(validate_and_pin_pointer_access(iov.iov_base, iov.iov_len, needs_write))));
+
+		return iovs;
+	}
+
 	BAN::ErrorOr<MemoryRegion*> Process::validate_and_pin_pointer_access(const void* ptr, size_t size, bool needs_write)
 	{
 		// TODO: allow pinning multiple regions?
@@ -6,6 +6,7 @@
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/kmalloc.h>
 #include <kernel/Processor.h>
+#include <kernel/Random.h>
 #include <kernel/Scheduler.h>
 #include <kernel/Terminal/TerminalDriver.h>
 #include <kernel/Thread.h>
@@ -41,6 +42,16 @@ namespace Kernel
 	static BAN::Array<Processor,   0xFF> s_processors;
 	static BAN::Array<ProcessorID, 0xFF> s_processor_ids { PROCESSOR_NONE };
 
+	struct MWaitState
+	{
+		uint32_t hint;
+		uint64_t target_residency_ns;
+	};
+
+	// usable MWAIT C-states from shallowest to deepest, empty if idle uses hlt
+	static BAN::Array<MWaitState, 7> s_mwait_states;
+	static size_t s_mwait_state_count { 0 };
+
 	extern "C" void asm_syscall_handler();
 	extern "C" void asm_yield_trampoline(uintptr_t);
 
@@ -229,6 +240,12 @@ namespace Kernel
 		if (CPUID::has_rdtscp())
 			shared_page.features |= API::SPF_RDTSCP;
 
+		// system timer ticks at 1000 Hz
+		shared_page.gettime_shared.coarse_resolution_ns = 1'000'000;
+
+		shared_page.random_generation = Random::generation();
+		shared_page.features |= API::SPF_GETRANDOM;
+
 		ASSERT(Processor::count() + sizeof(Kernel::API::SharedPage) <= PAGE_SIZE);
 	}
 
@@ -239,6 +256,38 @@ namespace Kernel
 		return s_processor_ids[index];
 	}
 
+	static void initialize_idle_states()
+	{
+		const uint32_t substates = CPUID::get_mwait_substates();
+		if (substates == 0)
+		{
+			dprintln("Idle processors halt with hlt");
+			return;
+		}
+
+		// CPUID does not report exit latencies, these are conservative guesses of
+		// how long the processor must stay idle for entering C1, C2, ... to pay off
+		constexpr uint64_t target_residencies_ns[] { 0, 20'000, 100'000, 400'000, 1'000'000, 2'000'000, 5'000'000 };
+		static_assert(sizeof(target_residencies_ns) / sizeof(*target_residencies_ns) == s_mwait_states.size());
+
+		// local apic timer may stop in states deeper than C1 and it is what
+		// wakes an idle processor for its next scheduled event
+		const size_t cstate_count = CPUID::has_arat() ? s_mwait_states.size() : 1;
+
+		for (size_t cstate = 0; cstate < cstate_count; cstate++)
+		{
+			// EDX holds the substate count of C0 in bits 3:0, C1 in bits 7:4, ...
+			if (((substates >> ((cstate + 1) * 4)) & 0x0F) == 0)
+				continue;
+			s_mwait_states[s_mwait_state_count++] = {
+				.hint = static_cast<uint32_t>(cstate << 4),
+				.target_residency_ns = target_residencies_ns[cstate],
+			};
+		}
+
+		dprintln("Idle processors wait with mwait, {} C-states", s_mwait_state_count);
+	}
+
 	void Processor::wait_until_processors_ready()
 	{
 		initialize_smp();
@@ -247,6 +296,7 @@ namespace Kernel
 		if (current_is_bsp())
 		{
 			initialize_shared_page();
+			initialize_idle_states();
 
 			s_processor_count = 1;
 			s_processor_ids[0] = current_id();
@@ -325,6 +375,8 @@ namespace Kernel
 			}
 		}
 
+		update_coarse_time(ns_since_boot_tsc());
+
 		shared_page.features |= API::SPF_GETTIME;
 	}
 
@@ -372,6 +424,29 @@ namespace Kernel
 		BAN::atomic_store(lgettime.seq, seq + 2, BAN::memory_order_release);
 	}
 
+	void Processor::update_coarse_time(uint64_t ns_since_boot)
+	{
+		auto& sgettime = shared_page().gettime_shared;
+
+		const auto seq = BAN::atomic_load(sgettime.coarse_seq, BAN::memory_order_relaxed);
+		BAN::atomic_store(sgettime.coarse_seq, seq + 1, BAN::memory_order_release);
+		sgettime.coarse_ns = ns_since_boot;
+		BAN::atomic_store(sgettime.coarse_seq, seq + 2, BAN::memory_order_release);
+	}
+
+	void Processor::update_shared_cpu_time(pid_t tid, uint64_t total_ns, uint64_t start_ns, uint32_t flags)
+	{
+		auto& cputime = shared_page().cpus[current_index()].cputime;
+
+		const auto seq = BAN::atomic_load(cputime.seq, BAN::memory_order_relaxed);
+		BAN::atomic_store(cputime.seq, seq + 1, BAN::memory_order_release);
+		cputime.tid      = tid;
+		cputime.flags    = flags;
+		cputime.total_ns = total_ns;
+		cputime.start_ns = start_ns;
+		BAN::atomic_store(cputime.seq, seq + 2, BAN::memory_order_release);
+	}
+
 	uint64_t Processor::ns_since_boot_tsc()
 	{
 		const auto& shared_page = Processor::shared_page();
@@ -490,11 +565,9 @@ namespace Kernel
 				case SMPMessage::Type::UpdateTSC:
 					update_tsc();
 					break;
-#if WITH_PROFILING
 				case SMPMessage::Type::StartProfiling:
-					processor.start_profiling();
+					processor.m_scheduler->update_wake_up_deadline();
 					break;
-#endif
 				case SMPMessage::Type::StackTrace:
 					dwarnln("Stack trace of CPU {}", current_id().as_u32());
 					Debug::dump_stack_trace();
@@ -608,7 +681,10 @@ namespace Kernel
 			storage->next = processor.m_smp_pending;
 		}
 
-		const bool needs_ipi = (storage->next == nullptr);
+		// an idle processor waiting in mwait is woken by the store to m_smp_pending.
+		// it publishes m_mwait_idle after arming the monitor and checks for messages
+		// after that, so either it sees this message or we see it is idle
+		const bool needs_ipi = (storage->next == nullptr) && !processor.m_mwait_idle.load();
 
 		if (send_ipi)
 		{
@@ -623,6 +699,19 @@ namespace Kernel
 		return needs_ipi;
 	}
 
+	void Processor::start_profiling()
+	{
+		const auto state = get_interrupt_state();
+		set_interrupt_state(InterruptState::Disabled);
+		scheduler().update_wake_up_deadline();
+		set_interrupt_state(state);
+
+		broadcast_smp_message({
+			.type = SMPMessage::Type::StartProfiling,
+			.dummy = 0,
+		});
+	}
+
 	void Processor::broadcast_smp_message(const SMPMessage& message)
 	{
 		if (!is_smp_enabled())
@@ -647,6 +736,64 @@ namespace Kernel
 		set_interrupt_state(state);
 	}
 
+	void Processor::idle()
+	{
+		ASSERT(get_interrupt_state() == InterruptState::Enabled);
+
+		// zero pages for page faults while there is nothing else to do. this is done one
+		// page per call so pending interrupts and new work get handled in between
+		if (Heap::get().fill_zeroed_page_pool())
+			return;
+
+		if (s_mwait_state_count == 0)
+		{
+			asm volatile("hlt");
+			return;
+		}
+
+		set_interrupt_state(InterruptState::Disabled);
+
+		auto& processor = s_processors[current_id().as_u32()];
+
+		asm volatile("monitor" :: "a"(&processor.m_smp_pending), "c"(0), "d"(0));
+		processor.m_mwait_idle.store(true);
+
+		if (processor.m_smp_pending.load() == nullptr)
+		{
+			// without the local apic timer deadline there is nothing to predict idle time from
+			uint64_t predicted_idle_ns = 0;
+			if (InterruptController::get().is_using_apic())
+			{
+				const uint64_t current_ns = SystemTimer::get().ns_since_boot();
+				const uint64_t deadline_ns = scheduler().wake_up_deadline_ns();
+				if (deadline_ns > current_ns)
+					predicted_idle_ns = deadline_ns - current_ns;
+			}
+
+			size_t state = 0;
+			while (state + 1 < s_mwait_state_count && s_mwait_states[state + 1].target_residency_ns <= predicted_idle_ns)
+				state++;
+
+			// sti takes effect after mwait has started, so an interrupt
+			// arriving between the check and mwait still wakes us
+			asm volatile("sti; mwait; cli" :: "a"(s_mwait_states[state].hint), "c"(0));
+		}
+
+		processor.m_mwait_idle.store(false);
+
+		// we may have been woken by a queued message instead of an ipi
+		handle_smp_messages();
+		scheduler().reschedule_if_needed();
+
+		set_interrupt_state(InterruptState::Enabled);
+	}
+
+	void Processor::leave_idle()
+	{
+		ASSERT(get_interrupt_state() == InterruptState::Disabled);
+		s_processors[current_id().as_u32()].m_mwait_idle.store(false);
+	}
+
 	Processor::LoadStats Processor::get_load_stats(size_t index)
 	{
 		ASSERT(index < Processor::count());
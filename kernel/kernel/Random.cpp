@@ -1,64 +1,254 @@
+#include <BAN/Array.h>
+#include <BAN/ChaCha20.h>
 #include <kernel/CPUID.h>
 #include <kernel/Debug.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Lock/SpinLock.h>
+#include <kernel/Processor.h>
 #include <kernel/Random.h>
 #include <kernel/Timer/Timer.h>
 
 namespace Kernel
 {
 
+	using BAN::ChaCha20;
 
-	// Constants and algorithm from https://en.wikipedia.org/wiki/Permuted_congruential_generator
+	static constexpr uint64_t s_reseed_interval_ns = 60'000'000'000;
 
-	static SpinLock s_rand_lock;
-	static uint64_t s_rand_seed = 0x4d595df4d0f33173;
-	static constexpr uint64_t s_rand_multiplier = 6364136223846793005;
-	static constexpr uint64_t s_rand_increment = 1442695040888963407;
+	struct BaseGenerator
+	{
+		uint32_t key[ChaCha20::key_words];
+		uint64_t nonce;
+		uint64_t last_reseed_ns;
+		bool has_rdseed;
+		bool has_rdrand;
+	};
+
+	struct alignas(64) ProcessorGenerator
+	{
+		uint32_t key[ChaCha20::key_words];
+		uint64_t generation;
+
+		// batched output for get_u32 and get_u64
+		uint32_t batch[ChaCha20::block_words - ChaCha20::key_words];
+		uint8_t batch_left;
+
+		// interrupt timing, mixed on every interrupt and folded to the base key on reseed
+		uint64_t entropy_pool[4];
+	};
+
+	static LockClass s_base_lock_class { "random_base" };
+	static SpinLock s_base_lock { s_base_lock_class };
+	static BaseGenerator s_base;
+	static BAN::Atomic<uint64_t> s_generation { 0 };
+	static BAN::Array<ProcessorGenerator, 0xFF> s_generators;
+
+	template<typename T>
+	static void secure_zero(T& object)
+	{
+		memset(&object, 0, sizeof(T));
+		asm volatile("" :: "r"(&object) : "memory");
+	}
+
+	static bool rdseed32(uint32_t& value)
+	{
+		uint8_t success;
+		asm volatile("rdseed %0; setc %1" : "=r"(value), "=qm"(success) :: "cc");
+		return success;
+	}
+
+	static bool rdrand32(uint32_t& value)
+	{
+		uint8_t success;
+		asm volatile("rdrand %0; setc %1" : "=r"(value), "=qm"(success) :: "cc");
+		return success;
+	}
+
+	// both instructions may fail transiently when the hardware source is exhausted
+	static uint32_t read_hardware_random(bool (*read)(uint32_t&))
+	{
+		uint32_t value;
+		for (size_t retry = 0; retry < 10; retry++)
+			if (read(value))
+				return value;
+		return 0;
+	}
+
+	static constexpr uint64_t rotl64(uint64_t value, int amount)
+	{
+		return (value << amount) | (value >> (64 - amount));
+	}
+
+	// SipHash round, cheap enough to run on every interrupt
+	static void fast_mix(uint64_t (&pool)[4])
+	{
+		pool[0] += pool[1]; pool[1] = rotl64(pool[1], 13); pool[1] ^= pool[0]; pool[0] = rotl64(pool[0], 32);
+		pool[2] += pool[3]; pool[3] = rotl64(pool[3], 16); pool[3] ^= pool[2];
+		pool[0] += pool[3]; pool[3] = rotl64(pool[3], 21); pool[3] ^= pool[0];
+		pool[2] += pool[1]; pool[1] = rotl64(pool[1], 17); pool[1] ^= pool[2]; pool[2] = rotl64(pool[2], 32);
+	}
+
+	// s_base_lock must be held
+	static void reseed_base_generator()
+	{
+		uint32_t seed[ChaCha20::key_words] {};
+
+		for (auto& word : seed)
+		{
+			if (s_base.has_rdseed)
+				word ^= read_hardware_random(rdseed32);
+			if (s_base.has_rdrand)
+				word ^= read_hardware_random(rdrand32);
+		}
+
+		// NOTE: pools of other processors are read without synchronization,
+		//       a torn read only affects which bits get mixed in
+		for (size_t i = 0; i < Processor::count(); i++)
+		{
+			const auto& pool = s_generators[i].entropy_pool;
+			for (size_t j = 0; j < 4; j++)
+			{
+				seed[j * 2 + 0] ^= static_cast<uint32_t>(pool[j]);
+				seed[j * 2 + 1] ^= static_cast<uint32_t>(pool[j] >> 32);
+			}
+		}
+
+		const uint64_t tsc = __builtin_ia32_rdtsc();
+		seed[0] ^= static_cast<uint32_t>(tsc);
+		seed[1] ^= static_cast<uint32_t>(tsc >> 32);
+
+		for (size_t i = 0; i < ChaCha20::key_words; i++)
+			s_base.key[i] ^= seed[i];
+
+		uint32_t block[ChaCha20::block_words];
+		ChaCha20::block(s_base.key, 0, s_base.nonce++, block);
+		for (size_t i = 0; i < ChaCha20::key_words; i++)
+			s_base.key[i] = block[i];
+
+		secure_zero(seed);
+		secure_zero(block);
+
+		s_base.last_reseed_ns = SystemTimer::get().ns_since_boot();
+
+		const uint64_t generation = s_generation.add_fetch(1, BAN::MemoryOrder::memory_order_release);
+		if (Processor::shared_page_paddr())
+			BAN::atomic_store(Processor::shared_page().random_generation, generation, BAN::MemoryOrder::memory_order_release);
+	}
+
+	// Interrupts must be disabled. Rekeys this processor's generator if the
+	// base generator was reseeded, reseeding the base first if it is due.
+	static ProcessorGenerator& current_generator()
+	{
+		auto& generator = s_generators[Processor::current_index()];
+
+		const auto is_reseed_due = [] {
+			return SystemTimer::get().ns_since_boot() - s_base.last_reseed_ns >= s_reseed_interval_ns;
+		};
+
+		if (is_reseed_due())
+		{
+			SpinLockGuard _(s_base_lock);
+			if (is_reseed_due())
+				reseed_base_generator();
+		}
+
+		if (generator.generation != s_generation.load(BAN::MemoryOrder::memory_order_acquire))
+		{
+			SpinLockGuard _(s_base_lock);
+
+			// fast key erasure, the base key used here is never used again
+			uint32_t block[ChaCha20::block_words];
+			ChaCha20::block(s_base.key, 0, s_base.nonce++, block);
+			for (size_t i = 0; i < ChaCha20::key_words; i++)
+			{
+				s_base.key[i]    = block[i];
+				generator.key[i] = block[ChaCha20::key_words + i];
+			}
+			secure_zero(block);
+
+			generator.generation = s_generation.load(BAN::MemoryOrder::memory_order_relaxed);
+			generator.batch_left = 0;
+		}
+
+		return generator;
+	}
+
+	// Replaces the generator key with the first half of a block and
+	// returns the second half in out
+	static void advance_generator(ProcessorGenerator& generator, uint32_t (&out)[ChaCha20::key_words])
+	{
+		uint32_t block[ChaCha20::block_words];
+		ChaCha20::block(generator.key, 0, 0, block);
+		for (size_t i = 0; i < ChaCha20::key_words; i++)
+		{
+			generator.key[i] = block[i];
+			out[i]           = block[ChaCha20::key_words + i];
+		}
+		secure_zero(block);
+	}
 
 	void Random::initialize()
 	{
 		uint32_t ecx, edx;
 		CPUID::get_features(ecx, edx);
 
-		if (ecx & CPUID::ECX_RDRND)
+		s_base.has_rdrand = ecx & CPUID::ECX_RDRND;
+		s_base.has_rdseed = CPUID::has_rdseed();
+
+		// seed the pools with something that differs between boots,
+		// interrupt timing improves them over time
+		const auto rt = SystemTimer::get().real_time();
+		for (auto& generator : s_generators)
 		{
-#if ARCH(x86_64)
-			asm volatile("rdrand %0" : "=r"(s_rand_seed) :: "flags");
-#elif ARCH(i686)
-			uint32_t lo, hi;
-			asm volatile(
-				"rdrand %[lo];"
-				"rdrand %[hi];"
-				: [lo]"=r"(lo), [hi]"=r"(hi)
-				:: "flags"
-			);
-			s_rand_seed = ((uint64_t)hi << 32) | lo;
-#else
-			#error
-#endif
-			dprintln("RNG seeded by RDRAND");
+			generator.entropy_pool[0] = rt.tv_sec;
+			generator.entropy_pool[1] = rt.tv_nsec;
 		}
-		else
+
 		{
-			auto rt = SystemTimer::get().real_time();
-			s_rand_seed ^= rt.tv_sec ^ rt.tv_nsec;
-			dprintln("RNG seeded by real time");
+			SpinLockGuard _(s_base_lock);
+			reseed_base_generator();
 		}
+
+		if (s_base.has_rdseed)
+			dprintln("RNG seeded by RDSEED and RDRAND");
+		else if (s_base.has_rdrand)
+			dprintln("RNG seeded by RDRAND");
+		else
+			dprintln("RNG seeded by real time");
+	}
+
+	uint64_t Random::generation()
+	{
+		return s_generation.load(BAN::MemoryOrder::memory_order_acquire);
+	}
+
+	void Random::add_interrupt_entropy(uint32_t irq)
+	{
+		auto& pool = s_generators[Processor::current_index()].entropy_pool;
+		pool[0] ^= __builtin_ia32_rdtsc();
+		pool[1] ^= irq;
+		fast_mix(pool);
 	}
 
 	uint32_t Random::get_u32()
 	{
-		constexpr auto rotr32 = [](uint32_t x, unsigned r) { return x >> r | x << (-r & 31); };
+		const auto state = Processor::get_interrupt_state();
+		Processor::set_interrupt_state(InterruptState::Disabled);
 
-		SpinLockGuard _(s_rand_lock);
+		auto& generator = current_generator();
+		if (generator.batch_left == 0)
+		{
+			advance_generator(generator, generator.batch);
+			generator.batch_left = sizeof(generator.batch) / sizeof(*generator.batch);
+		}
 
-		uint64_t x = s_rand_seed;
-		unsigned count = (unsigned)(x >> 59);
+		uint32_t& word = generator.batch[--generator.batch_left];
+		const uint32_t result = word;
+		word = 0;
 
-		s_rand_seed = x * s_rand_multiplier + s_rand_increment;
-		x ^= x >> 18;
+		Processor::set_interrupt_state(state);
 
-		return rotr32(x >> 27, count) % UINT32_MAX;
+		return result;
 	}
 
 	uint64_t Random::get_u64()
@@ -66,4 +256,28 @@ namespace Kernel
 		return ((uint64_t)get_u32() << 32) | get_u32();
 	}
 
+	void Random::get_bytes(BAN::ByteSpan buffer)
+	{
+		uint32_t key[ChaCha20::key_words];
+
+		{
+			const auto state = Processor::get_interrupt_state();
+			Processor::set_interrupt_state(InterruptState::Disabled);
+			advance_generator(current_generator(), key);
+			Processor::set_interrupt_state(state);
+		}
+
+		uint32_t block[ChaCha20::block_words];
+		for (uint64_t counter = 0; !buffer.empty(); counter++)
+		{
+			ChaCha20::block(key, counter, 0, block);
+			const size_t to_copy = BAN::Math::min(buffer.size(), ChaCha20::block_size);
+			memcpy(buffer.data(), block, to_copy);
+			buffer = buffer.slice(to_copy);
+		}
+
+		secure_zero(key);
+		secure_zero(block);
+	}
+
 }
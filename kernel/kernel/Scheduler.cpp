@@ -1,6 +1,7 @@
 #include <BAN/Optional.h>
 #include <BAN/Sort.h>
 #include <kernel/APIC.h>
+#include <kernel/Device/ProfilerDevice.h>
 #include <kernel/GDT.h>
 #include <kernel/InterruptController.h>
 #include <kernel/Lock/Mutex.h>
@@ -8,6 +9,7 @@
 #include <kernel/Scheduler.h>
 #include <kernel/Thread.h>
 #include <kernel/Timer/Timer.h>
+#include <kernel/Tracepoint.h>
 
 #define SCHEDULER_ASSERT 1
 
@@ -46,7 +48,7 @@ namespace Kernel
 
 	BAN::ErrorOr<void> Scheduler::initialize()
 	{
-		m_idle_thread = TRY(Thread::create_kernel([](void*) { asm volatile("1: hlt; jmp 1b"); }, nullptr));
+		m_idle_thread = TRY(Thread::create_kernel([](void*) { for (;;) Processor::idle(); }, nullptr));
 		ASSERT(m_idle_thread);
 
 		// each CPU does load balance at different times. This calulates the offset to other CPUs
@@ -140,8 +142,16 @@ namespace Kernel
 		if (m_run_list.empty() && (!m_current || !m_current->blocked) && current_thread().state() == Thread::State::Executing)
 			return;
 
+		// NOTE: current thread may be deleted below
+		const pid_t previous_tid = (Tracepoints::is_enabled() && m_current) ? m_current->thread->tid() : 0;
+
 		if (m_current == nullptr)
+		{
+			// an interrupt that ended mwait may switch away before idle() clears this,
+			// without clearing it other processors would keep skipping our wakeup ipis
+			Processor::leave_idle();
 			m_idle_ns += SystemTimer::get().ns_since_boot() - m_idle_start_ns;
+		}
 		else
 		{
 			switch (m_current->thread->state())
@@ -156,6 +166,10 @@ namespace Kernel
 					break;
 				case Thread::State::Executing:
 					m_current->thread->yield_registers() = *yield_registers;
+					if (m_current->blocked)
+						m_current->thread->m_statistics.voluntary_switches++;
+					else
+						m_current->thread->m_statistics.involuntary_switches++;
 					m_current->time_used_ns += SystemTimer::get().ns_since_boot() - m_current->last_start_ns;
 					add_current_to_most_loaded(m_current->blocked ? static_cast<void*>(&m_block_list) : &m_run_list);
 					if (!m_current->blocked)
@@ -196,6 +210,7 @@ namespace Kernel
 			*yield_registers = m_idle_thread->yield_registers();
 			m_idle_thread->m_state = Thread::State::Executing;
 			m_idle_start_ns        = SystemTimer::get().ns_since_boot();
+			TRACEPOINT(SchedulerSwitch, previous_tid, 0);
 			return;
 		}
 
@@ -213,6 +228,8 @@ namespace Kernel
 			thread->set_cpu_time_start();
 		}
 
+		thread->m_statistics.last_processor = Processor::current_index();
+
 		if (thread->is_userspace())
 		{
 			const vaddr_t kernel_stack_top = thread->kernel_stack_top();
@@ -228,6 +245,8 @@ namespace Kernel
 		*yield_registers = thread->yield_registers();
 
 		m_current->last_start_ns = SystemTimer::get().ns_since_boot();
+
+		TRACEPOINT(SchedulerSwitch, previous_tid, thread->tid());
 	}
 
 	void Scheduler::wake_up_sleeping_threads()
@@ -254,7 +273,10 @@ namespace Kernel
 			deadline_ns = BAN::Math::min(deadline_ns, m_block_list.front()->wake_time_ns);
 		if (Processor::is_smp_enabled())
 			deadline_ns = BAN::Math::min(deadline_ns, m_last_load_balance_ns + s_load_balance_interval_ns);
+		if (ProfilerDevice::is_active())
+			deadline_ns = BAN::Math::min(deadline_ns, ProfilerDevice::next_sample_ns());
 
+		m_wake_up_deadline_ns = deadline_ns;
 		static_cast<APIC&>(interrupt_controller).set_timer_dealine(deadline_ns);
 	}
 
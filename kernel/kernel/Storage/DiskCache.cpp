@@ -67,7 +67,7 @@ namespace Kernel
 		if (!(cache.sector_mask & (1 << page_cache_offset)))
 			return false;
 
-		PageTable::with_per_cpu_fast_page(cache.paddr, [&](void* addr) {
+		PageTable::with_physical_page(cache.paddr, [&](void* addr) {
 			memcpy(buffer.data(), static_cast<uint8_t*>(addr) + page_cache_offset * m_sector_size, m_sector_size);
 		});
 
@@ -108,7 +108,7 @@ namespace Kernel
 
 		auto& cache = m_cache[index];
 
-		PageTable::with_per_cpu_fast_page(cache.paddr, [&](void* addr) {
+		PageTable::with_physical_page(cache.paddr, [&](void* addr) {
 			memcpy(static_cast<uint8_t*>(addr) + page_cache_offset * m_sector_size, buffer.data(), m_sector_size);
 		});
 
@@ -134,7 +134,7 @@ namespace Kernel
 			if (cache.dirty_mask == 0)
 				return {};
 
-			PageTable::with_per_cpu_fast_page(cache.paddr, [&](void* addr) {
+			PageTable::with_physical_page(cache.paddr, [&](void* addr) {
 				memcpy(m_sync_cache.data(), addr, PAGE_SIZE);
 			});
 
@@ -165,7 +165,7 @@ namespace Kernel
 			{
 				dprintln_if(DEBUG_DISK_SYNC, "syncing {}->{}", temp_cache.first_sector + sector_start, temp_cache.first_sector + sector_start + sector_count);
 				auto data_slice = m_sync_cache.span().slice(sector_start * m_sector_size, sector_count * m_sector_size);
-				TRY(m_device.write_sectors_impl(temp_cache.first_sector + sector_start, sector_count, data_slice));
+				TRY(m_device.do_write_sectors(temp_cache.first_sector + sector_start, sector_count, data_slice));
 				temp_cache.dirty_mask &= ~(((1 << sector_count) - 1) << sector_start);
 				sector_start += sector_count + 1;
 				sector_count = 0;
@@ -176,7 +176,7 @@ namespace Kernel
 		{
 			dprintln_if(DEBUG_DISK_SYNC, "syncing {}->{}", temp_cache.first_sector + sector_start, temp_cache.first_sector + sector_start + sector_count);
 			auto data_slice = m_sync_cache.span().slice(sector_start * m_sector_size, sector_count * m_sector_size);
-			TRY(m_device.write_sectors_impl(temp_cache.first_sector + sector_start, sector_count, data_slice));
+			TRY(m_device.do_write_sectors(temp_cache.first_sector + sector_start, sector_count, data_slice));
 			temp_cache.dirty_mask &= ~(((1 << sector_count) - 1) << sector_start);
 		}
 
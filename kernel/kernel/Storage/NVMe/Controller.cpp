@@ -1,4 +1,5 @@
 #include <BAN/Array.h>
+#include <BAN/Atomic.h>
 #include <kernel/Device/DeviceNumbers.h>
 #include <kernel/FS/DevFS/FileSystem.h>
 #include <kernel/Memory/DMARegion.h>
@@ -12,7 +13,7 @@ namespace Kernel
 
 	static dev_t get_ctrl_dev_minor()
 	{
-		static dev_t minor = 0;
+		static BAN::Atomic<dev_t> minor = 0;
 		return minor++;
 	}
 
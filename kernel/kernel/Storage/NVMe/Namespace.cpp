@@ -1,3 +1,4 @@
+#include <BAN/Atomic.h>
 #include <kernel/Device/DeviceNumbers.h>
 #include <kernel/FS/DevFS/FileSystem.h>
 #include <kernel/Storage/NVMe/Controller.h>
@@ -10,7 +11,7 @@ namespace Kernel
 
 	static dev_t get_ns_dev_minor()
 	{
-		static dev_t minor = 0;
+		static BAN::Atomic<dev_t> minor = 0;
 		return minor++;
 	}
 
@@ -9,6 +9,7 @@
 #include <kernel/PCI.h>
 #include <kernel/Storage/StorageDevice.h>
 #include <kernel/Thread.h>
+#include <kernel/Tracepoint.h>
 
 namespace Kernel
 {
@@ -234,7 +235,7 @@ namespace Kernel
 		ASSERT(buffer.size() >= sector_count * sector_size());
 
 		if (!m_disk_cache.has_value())
-			return read_sectors_impl(lba, sector_count, buffer);
+			return do_read_sectors(lba, sector_count, buffer);
 
 		uint64_t sectors_done = 0;
 		while (sectors_done < sector_count)
@@ -253,7 +254,7 @@ namespace Kernel
 				while (needed_sector_bitmask & (static_cast<uint64_t>(1) << (i + len)))
 					len++;
 				auto segment_buffer = buffer.slice((sectors_done + i) * sector_size(), len * sector_size());
-				TRY(read_sectors_impl(lba + sectors_done + i, len, segment_buffer));
+				TRY(do_read_sectors(lba + sectors_done + i, len, segment_buffer));
 				for (uint32_t j = 0; j < len; j++)
 					(void)m_disk_cache->write_to_cache(lba + sectors_done + i + j, segment_buffer.slice(j * sector_size(), sector_size()), false);
 				needed_sector_bitmask &= ~(((static_cast<uint64_t>(1) << len) - 1) << i);
@@ -280,18 +281,34 @@ namespace Kernel
 		}
 
 		if (!m_disk_cache.has_value())
-			return write_sectors_impl(lba, sector_count, buffer);
+			return do_write_sectors(lba, sector_count, buffer);
 
 		for (uint8_t offset = 0; offset < sector_count; offset++)
 		{
 			auto sector_buffer = buffer.slice(offset * sector_size(), sector_size());
 			if (m_disk_cache->write_to_cache(lba + offset, sector_buffer, true).is_error())
-				TRY(write_sectors_impl(lba + offset, 1, sector_buffer));
+				TRY(do_write_sectors(lba + offset, 1, sector_buffer));
 		}
 
 		return {};
 	}
 
+	BAN::ErrorOr<void> StorageDevice::do_read_sectors(uint64_t lba, uint64_t sector_count, BAN::ByteSpan buffer)
+	{
+		TRACEPOINT(BlockIOSubmit, lba, sector_count, false);
+		auto result = read_sectors_impl(lba, sector_count, buffer);
+		TRACEPOINT(BlockIOComplete, lba, sector_count, result.is_error() ? result.error().get_error_code() : 0);
+		return result;
+	}
+
+	BAN::ErrorOr<void> StorageDevice::do_write_sectors(uint64_t lba, uint64_t sector_count, BAN::ConstByteSpan buffer)
+	{
+		TRACEPOINT(BlockIOSubmit, lba, sector_count, true);
+		auto result = write_sectors_impl(lba, sector_count, buffer);
+		TRACEPOINT(BlockIOComplete, lba, sector_count, result.is_error() ? result.error().get_error_code() : 0);
+		return result;
+	}
+
 	BAN::ErrorOr<void> StorageDevice::sync_blocks(uint64_t block, size_t block_count)
 	{
 		if (!m_disk_cache.has_value())
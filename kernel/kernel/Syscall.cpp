@@ -1,6 +1,7 @@
 #include <BAN/Bitcast.h>
 #include <kernel/API/Syscall.h>
 #include <kernel/Debug.h>
+#include <kernel/Device/SyscallTraceDevice.h>
 #include <kernel/InterruptStack.h>
 #include <kernel/Process.h>
 #include <kernel/Scheduler.h>
@@ -53,6 +54,9 @@ namespace Kernel
 
 		const char* process_path = Process::current().name();
 
+		const bool is_traced = Process::current().is_syscall_traced() || Thread::current().is_syscall_traced();
+		const uint64_t trace_entry_ns = is_traced ? SystemTimer::get().ns_since_boot() : 0;
+
 #if DUMP_ALL_SYSCALLS
 		dprintln("{} pid {}: {}", process_path, Process::current().pid(), s_syscall_names[syscall]);
 #endif
@@ -95,6 +99,28 @@ namespace Kernel
 		if (ret.is_error() && ret.error().is_kernel_error())
 			Kernel::panic("Kernel error while returning to userspace {}", ret.error());
 
+		Thread::current().account_syscall(syscall);
+
+		if (is_traced)
+		{
+			SyscallTraceDevice::record({
+				.pid = Process::current().pid(),
+				.tid = Thread::current().tid(),
+				.syscall = syscall,
+				.cpu = 0,
+				.args = {
+					static_cast<long>(arg1),
+					static_cast<long>(arg2),
+					static_cast<long>(arg3),
+					static_cast<long>(arg4),
+					static_cast<long>(arg5),
+				},
+				.ret = ret.is_error() ? -static_cast<long>(ret.error().get_error_code()) : ret.value(),
+				.entry_ns = trace_entry_ns,
+				.exit_ns = SystemTimer::get().ns_since_boot(),
+			});
+		}
+
 		Process::current().wait_while_stopped();
 
 		if (Thread::current().handle_signal_if_interrupted())
@@ -127,6 +153,8 @@ namespace Kernel
 			case SYS_CONNECT:
 			case SYS_RECVMSG:
 			case SYS_SENDMSG:
+			case SYS_RECVMMSG:
+			case SYS_SENDMMSG:
 			case SYS_FLOCK:
 			case SYS_FUTEX:
 				return true;
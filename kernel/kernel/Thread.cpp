@@ -216,8 +216,8 @@ namespace Kernel
 		thread->m_userspace_stack_size  = userspace_stack_size;
 
 		// Initialize stack for returning
-		PageTable::with_fast_page(thread->kernel_stack().paddr_of(thread->kernel_stack_top() - PAGE_SIZE), [=] {
-			uintptr_t cur_sp = PageTable::fast_page() + PAGE_SIZE;
+		PageTable::with_physical_page(thread->kernel_stack().paddr_of(thread->kernel_stack_top() - PAGE_SIZE), [=](void* page) {
+			uintptr_t cur_sp = reinterpret_cast<uintptr_t>(page) + PAGE_SIZE;
 			write_to_stack(cur_sp, 0x20 | 3);
 			write_to_stack(cur_sp, stack_pointer);
 			write_to_stack(cur_sp, 0x202);
@@ -308,6 +308,7 @@ namespace Kernel
 		SpinLockGuard _(m_cpu_time_lock);
 		ASSERT(m_cpu_time_start_ns == UINT64_MAX);
 		m_cpu_time_start_ns = SystemTimer::get().ns_since_boot();
+		publish_cpu_time();
 	}
 
 	void Thread::set_cpu_time_stop()
@@ -317,6 +318,33 @@ namespace Kernel
 		uint64_t& value = m_is_in_syscall ? m_cpu_time_system_ns : m_cpu_time_user_ns;
 		value += SystemTimer::get().ns_since_boot() - m_cpu_time_start_ns;
 		m_cpu_time_start_ns = UINT64_MAX;
+		publish_cpu_time();
+	}
+
+	void Thread::update_shared_cpu_time()
+	{
+		ASSERT(this == &Thread::current());
+		SpinLockGuard _(m_cpu_time_lock);
+		publish_cpu_time();
+	}
+
+	void Thread::publish_cpu_time() const
+	{
+		if (!m_is_userspace || !has_process() || m_cpu_time_start_ns == UINT64_MAX)
+			return Processor::update_shared_cpu_time(0, 0, 0, 0);
+
+		// NOTE: syscall entry and exit only move time between user and system,
+		//       so the published values stay valid until the thread is stopped
+		uint32_t flags = 0;
+		if (process().thread_count() == 1)
+			flags |= API::SPC_SINGLE_THREADED;
+
+		Processor::update_shared_cpu_time(
+			m_tid,
+			m_cpu_time_user_ns + m_cpu_time_system_ns,
+			m_cpu_time_start_ns,
+			flags
+		);
 	}
 
 	void Thread::set_is_in_syscall(bool is_in_syscall)
@@ -329,6 +357,40 @@ namespace Kernel
 		m_cpu_time_start_ns = current_ns;
 	}
 
+	bool Thread::is_blocked() const
+	{
+		return m_scheduler_node && m_scheduler_node->blocked;
+	}
+
+	void Thread::account_syscall(int syscall)
+	{
+		switch (syscall)
+		{
+			case SYS_READ:
+			case SYS_PREAD:
+			case SYS_READV:
+			case SYS_PREADV:
+			case SYS_RECVMSG:
+			case SYS_RECVMMSG:
+				m_statistics.read_syscalls++;
+				break;
+			case SYS_WRITE:
+			case SYS_PWRITE:
+			case SYS_WRITEV:
+			case SYS_PWRITEV:
+			case SYS_SENDMSG:
+			case SYS_SENDMMSG:
+				m_statistics.write_syscalls++;
+				break;
+			case SYS_SENDFILE:
+			case SYS_SPLICE:
+			case SYS_COPY_FILE_RANGE:
+				m_statistics.read_syscalls++;
+				m_statistics.write_syscalls++;
+				break;
+		}
+	}
+
 	void Thread::update_processor_index_address()
 	{
 		if (!is_userspace() || !has_process())
@@ -357,11 +419,11 @@ namespace Kernel
 		));
 
 		// NOTE: copy [sp, stack_end] so fork return works
-		PageTable::with_fast_page(thread->m_kernel_stack->paddr_of(thread->kernel_stack_top() - PAGE_SIZE), [&] {
+		PageTable::with_physical_page(thread->m_kernel_stack->paddr_of(thread->kernel_stack_top() - PAGE_SIZE), [&](void* page) {
 			const size_t ncopy = kernel_stack_top() - sp;
 			ASSERT(ncopy <= PAGE_SIZE);
 			memcpy(
-				PageTable::fast_page_as_ptr(PAGE_SIZE - ncopy),
+				static_cast<uint8_t*>(page) + PAGE_SIZE - ncopy,
 				reinterpret_cast<void*>(sp),
 				ncopy
 			);
@@ -410,8 +472,8 @@ namespace Kernel
 		m_signal_pending_mask = 0;
 		m_signal_block_mask = ~0ull;
 
-		PageTable::with_fast_page(kernel_stack().paddr_of(kernel_stack_top() - PAGE_SIZE), [&] {
-			uintptr_t sp = PageTable::fast_page() + PAGE_SIZE;
+		PageTable::with_physical_page(kernel_stack().paddr_of(kernel_stack_top() - PAGE_SIZE), [&](void* page) {
+			uintptr_t sp = reinterpret_cast<uintptr_t>(page) + PAGE_SIZE;
 			write_to_stack(sp, this);
 			write_to_stack(sp, &Thread::on_exit_trampoline);
 			write_to_stack(sp, m_process);
@@ -160,8 +160,10 @@ namespace Kernel
 		if (m_tsc_type == TSCType::None)
 			return;
 
-		// only update once per second
 		const uint64_t current_ns = Processor::ns_since_boot_tsc();
+		Processor::update_coarse_time(current_ns);
+
+		// only update once per second
 		if (current_ns < m_tsc_update_ns)
 			return;
 		m_tsc_update_ns = current_ns + 1'000'000'000;
@@ -0,0 +1,108 @@
+#include <BAN/Vector.h>
+#include <kernel/PerProcessorRing.h>
+#include <kernel/Processor.h>
+#include <kernel/Thread.h>
+#include <kernel/Timer/Timer.h>
+#include <kernel/Tracepoint.h>
+
+namespace Kernel
+{
+
+	static constexpr const char* s_tracepoint_names[] {
+		"sched_switch",
+		"page_fault",
+		"block_submit",
+		"block_complete",
+		"irq_entry",
+	};
+	static_assert(sizeof(s_tracepoint_names) / sizeof(*s_tracepoint_names) == Tracepoints::Count);
+
+	static constexpr size_t s_events_per_buffer = 256;
+
+	struct TraceEvent
+	{
+		uint64_t timestamp_ns;
+		uint64_t args[3];
+		pid_t tid;
+		Tracepoints::Id id;
+	};
+
+	struct TraceProcessorData
+	{
+		BAN::Atomic<uint64_t> counts[Tracepoints::Count];
+	};
+
+	// NOTE: the ring's tail marks the first event after the last reset, it is never drained
+	static PerProcessorRing<TraceEvent, s_events_per_buffer, TraceProcessorData> s_events;
+
+	BAN::Atomic<bool> Tracepoints::s_enabled { false };
+
+	BAN::ErrorOr<void> Tracepoints::set_enabled(bool enabled)
+	{
+		if (enabled)
+			TRY(s_events.initialize());
+		s_enabled.store(enabled, BAN::MemoryOrder::memory_order_relaxed);
+		return {};
+	}
+
+	void Tracepoints::reset()
+	{
+		for (size_t cpu = 0; cpu < s_events.buffer_count(); cpu++)
+		{
+			auto& buffer = s_events.buffer(cpu);
+			for (auto& count : buffer.data.counts)
+				count.store(0, BAN::memory_order_relaxed);
+			buffer.tail.store(buffer.head.load(BAN::memory_order_acquire), BAN::memory_order_relaxed);
+		}
+	}
+
+	void Tracepoints::hit(Id id, uint64_t arg0, uint64_t arg1, uint64_t arg2)
+	{
+		s_events.push_overwrite([&](TraceEvent& event) {
+			s_events.current_data().counts[id].add_fetch(1, BAN::memory_order_relaxed);
+			event = {
+				.timestamp_ns = SystemTimer::get().ns_since_boot(),
+				.args = { arg0, arg1, arg2 },
+				.tid = Thread::current_tid(),
+				.id = id,
+			};
+		});
+	}
+
+	BAN::ErrorOr<BAN::String> Tracepoints::format_counts()
+	{
+		BAN::String result;
+		for (size_t id = 0; id < Count; id++)
+		{
+			uint64_t count = 0;
+			for (size_t cpu = 0; cpu < s_events.buffer_count(); cpu++)
+				count += s_events.buffer(cpu).data.counts[id].load(BAN::memory_order_relaxed);
+			TRY(result.append(TRY(BAN::String::formatted("{} {}\n", s_tracepoint_names[id], count))));
+		}
+		return result;
+	}
+
+	BAN::ErrorOr<BAN::String> Tracepoints::format_events()
+	{
+		if (!s_events.is_initialized())
+			return BAN::String();
+
+		BAN::Vector<TraceEvent> events;
+		TRY(events.resize(s_events_per_buffer));
+
+		BAN::String result;
+		for (size_t cpu = 0; cpu < s_events.buffer_count(); cpu++)
+		{
+			for (const auto& event : s_events.snapshot(cpu, events.span()))
+			{
+				TRY(result.append(TRY(BAN::String::formatted("{} {} {} {} {} {} {}\n",
+					event.timestamp_ns, cpu, event.tid, s_tracepoint_names[event.id],
+					event.args[0], event.args[1], event.args[2]
+				))));
+			}
+		}
+
+		return result;
+	}
+
+}
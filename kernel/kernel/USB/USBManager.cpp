@@ -1,5 +1,6 @@
 #include <BAN/UniqPtr.h>
 
+#include <kernel/Lock/LockGuard.h>
 #include <kernel/USB/USBManager.h>
 #include <kernel/USB/XHCI/Controller.h>
 
@@ -80,6 +81,7 @@ namespace Kernel
 				return BAN::Error::from_errno(EINVAL);
 		}
 
+		LockGuard _(m_controller_lock);
 		TRY(m_controllers.push_back(BAN::move(controller)));
 
 		return {};
@@ -299,12 +299,9 @@ namespace Kernel
 		auto* scratchpad_buffer_array = reinterpret_cast<uint64_t*>(m_scratchpad_buffer_array->vaddr());
 		for (size_t i = 0; i < max_scratchpads; i++)
 		{
-			const paddr_t paddr = Heap::get().take_free_page();
+			const paddr_t paddr = Heap::get().take_zeroed_page();
 			if (paddr == 0)
 				return BAN::Error::from_errno(ENOMEM);
-			PageTable::with_fast_page(paddr, [] {
-				memset(PageTable::fast_page_as_ptr(), 0, PAGE_SIZE);
-			});
 			m_scratchpad_buffers[i] = paddr;
 			scratchpad_buffer_array[i] = paddr;
 		}
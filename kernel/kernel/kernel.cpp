@@ -2,6 +2,7 @@
 #include <kernel/APIC.h>
 #include <kernel/Arch.h>
 #include <kernel/BootInfo.h>
+#include <kernel/BootTimeline.h>
 #include <kernel/Debug.h>
 #include <kernel/Device/FramebufferDevice.h>
 #include <kernel/FS/DevFS/FileSystem.h>
@@ -11,6 +12,8 @@
 #include <kernel/IDT.h>
 #include <kernel/Input/PS2/Controller.h>
 #include <kernel/InterruptController.h>
+#include <kernel/IRQAffinity.h>
+#include <kernel/Lock/LockStats.h>
 #include <kernel/Memory/Heap.h>
 #include <kernel/Memory/kmalloc.h>
 #include <kernel/Memory/PageTable.h>
@@ -88,6 +91,8 @@ static void parse_command_line()
 			Kernel::g_disable_disk_write = true;
 		else if (argument == "nodebug")
 			g_disable_debug = true;
+		else if (argument == "lockstat")
+			Kernel::LockClass::set_enabled(true);
 		else if (argument.starts_with("ps2="))
 		{
 			if (argument.size() != 5 || !isdigit(argument[4]))
@@ -211,6 +216,8 @@ static void init2(void*)
 
 	SystemTimer::get().initialize_tsc();
 
+	MUST(IRQAffinity::initialize());
+
 	ProcFileSystem::get().post_scheduler_initialize();
 
 	auto console = MUST(DevFileSystem::get().root_inode()->find_inode(cmdline.console));
@@ -219,7 +226,10 @@ static void init2(void*)
 
 	// This only initializes PCIManager by enumerating available devices and choosing PCIe/legacy
 	// ACPI might require PCI access during its namespace initialization
-	PCI::PCIManager::initialize();
+	{
+		BootTimeline::Scope _("pci enumerate"_sv);
+		PCI::PCIManager::initialize();
+	}
 	dprintln("PCI initialized");
 
 	if (!cmdline.disable_usb)
@@ -230,6 +240,7 @@ static void init2(void*)
 
 	if (!cmdline.disable_acpi)
 	{
+		BootTimeline::Scope _("acpi"_sv);
 		if (auto ret = ACPI::ACPI::get().enter_acpi_mode(); ret.is_error())
 			dprintln("Failed to enter ACPI mode: {}", ret.error());
 		if (auto ret = ACPI::ACPI::get().initialize_acpi_devices(); ret.is_error())
@@ -246,17 +257,27 @@ static void init2(void*)
 	// Initialize empty keymap
 	MUST(LibInput::KeyboardLayout::initialize());
 
-	if (auto res = PS2Controller::initialize(cmdline.ps2_override); res.is_error())
-		dprintln("{}", res.error());
+	{
+		BootTimeline::Scope _("ps2"_sv);
+		if (auto res = PS2Controller::initialize(cmdline.ps2_override); res.is_error())
+			dprintln("{}", res.error());
+	}
 
 	MUST(NetworkManager::initialize());
 
 	// NOTE: PCI devices are the last ones to be initialized
 	//       so other devices can reserve predefined interrupts
 	PCI::PCIManager::get().initialize_devices(cmdline.disable_usb);
-	dprintln("PCI devices initialized");
 
-	VirtualFileSystem::initialize(cmdline.root);
+	// root filesystem can only be on a storage or USB device, the rest
+	// of the drivers keep probing while it is mounted
+	PCI::PCIManager::get().wait_for_storage_devices();
+	dprintln("PCI storage devices initialized");
+
+	{
+		BootTimeline::Scope _("vfs"_sv);
+		VirtualFileSystem::initialize(cmdline.root);
+	}
 	dprintln("VFS initialized");
 
 	// NOTE: All modules should be loaded
@@ -266,6 +287,9 @@ static void init2(void*)
 
 	Banos::initialize_initial_drivers();
 
+	PCI::PCIManager::get().wait_for_all_devices();
+	dprintln("PCI devices initialized");
+
 	auto console_path = MUST(BAN::String::formatted("/dev/{}", cmdline.console));
 	auto console_path_sv = console_path.sv();
 	MUST(Process::create_userspace({ 0, 0, 0, 0 }, "/usr/bin/init"_sv, BAN::Span<BAN::StringView>(&console_path_sv, 1)));
@@ -63,3 +63,17 @@ int posix_fallocate(int fd, off_t offset, off_t size)
 	fprintf(stddbg, "TODO: posix_fallocate\n");
 	return 0;
 }
+
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t len, unsigned flags)
+{
+	pthread_testcancel();
+	const sys_splice_t arguments {
+		.fd_in = fd_in,
+		.off_in = off_in,
+		.fd_out = fd_out,
+		.off_out = off_out,
+		.len = len,
+		.flags = flags,
+	};
+	return syscall(SYS_SPLICE, &arguments);
+}
@@ -26,7 +26,6 @@ typedef struct
 {
 	pthread_mutexattr_t attr;
 	uint32_t futex;
-	uint32_t waiters;
 	unsigned lock_depth;
 } pthread_mutex_t;
 
@@ -35,16 +34,12 @@ typedef struct
 	int clock;
 	int shared;
 } pthread_condattr_t;
-struct _pthread_cond_block
-{
-	struct _pthread_cond_block* next;
-	uint32_t futex;
-};
 typedef struct
 {
 	pthread_condattr_t attr;
-	pthread_spinlock_t lock;
-	struct _pthread_cond_block* block_list;
+	uint32_t futex;
+	uint32_t waiters;
+	pthread_mutex_t* mutex;
 } pthread_cond_t;
 
 typedef struct
@@ -53,11 +48,10 @@ typedef struct
 } pthread_barrierattr_t;
 typedef struct
 {
-	pthread_mutex_t lock;
-	pthread_cond_t cond;
+	int shared;
 	unsigned target;
-	unsigned waiting;
-	unsigned generation;
+	uint32_t waiting;
+	uint32_t generation;
 } pthread_barrier_t;
 
 typedef struct
@@ -66,11 +60,12 @@ typedef struct
 } pthread_rwlockattr_t;
 typedef struct
 {
-	pthread_mutex_t lock;
-	pthread_cond_t cond;
-	unsigned writers_waiting;
-	unsigned writer_active;
-	unsigned readers_active;
+	int shared;
+	uint32_t state;
+	uint32_t readers_waiting;
+	uint32_t writers_waiting;
+	uint32_t reader_futex;
+	uint32_t writer_futex;
 } pthread_rwlock_t;
 
 __END_DECLS
@@ -35,6 +35,16 @@ typedef struct _dynamic_tls_t
 	_dynamic_tls_entry_t* entries;
 } _dynamic_tls_t;
 
+// per thread generator of getrandom, keyed from the kernel
+typedef struct _getrandom_state_t
+{
+	uint32_t key[8];
+	uint64_t generation;	// shared page random generation the key was taken at, 0 if unseeded
+	uint8_t batch[32];
+	uint8_t batch_left;
+	volatile int in_use;	// set while generating, a signal handler must not reuse the state
+} _getrandom_state_t;
+
 struct uthread
 {
 	struct uthread* self;
@@ -58,6 +68,8 @@ struct uthread
 	pthread_key_t specific_keys[PTHREAD_KEYS_MAX];
 	void* specific_vals[PTHREAD_KEYS_MAX];
 
+	_getrandom_state_t getrandom_state;
+
 	// FIXME: make this dynamic
 	uintptr_t dtv[1 + 256];
 };
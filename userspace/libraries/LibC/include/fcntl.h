@@ -26,6 +26,8 @@ __BEGIN_DECLS
 #define F_SETLKW		9
 #define F_GETOWN		10
 #define F_SETOWN		11
+#define F_GETPIPE_SZ	12
+#define F_SETPIPE_SZ	13
 
 #define F_RDLCK 1
 #define F_UNLCK 2
@@ -101,6 +103,24 @@ int openat(int fd, const char* path, int oflag, ...);
 int posix_fadvise(int fd, off_t offset, off_t len, int advice);
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+#define SPLICE_F_MOVE		0x1
+#define SPLICE_F_NONBLOCK	0x2
+#define SPLICE_F_MORE		0x4
+#define SPLICE_F_GIFT		0x8
+
+struct sys_splice_t
+{
+	int fd_in;
+	off_t* off_in;
+	int fd_out;
+	off_t* off_out;
+	size_t len;
+	unsigned flags;
+};
+
+/* NOTE: unlike on linux, neither of the file descriptors has to be a pipe */
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t len, unsigned flags);
+
 __END_DECLS
 
 #endif
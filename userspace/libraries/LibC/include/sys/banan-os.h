@@ -8,6 +8,9 @@ __BEGIN_DECLS
 #define __need_size_t
 #include <stddef.h>
 
+#include <stdint.h>
+#include <sys/types.h>
+
 #define TTY_CMD_SET		0x01
 #define TTY_CMD_UNSET	0x02
 
@@ -31,6 +34,54 @@ struct full_meminfo_t
 	size_t used_pages;
 };
 
+#define PROC_STATE_RUNNING	'R'
+#define PROC_STATE_SLEEPING	'S'
+#define PROC_STATE_STOPPED	'T'
+#define PROC_STATE_ZOMBIE	'Z'
+
+// all processes as an array of proc_stat_t, read with a single read
+#define PROC_PROCESSES_PATH "/proc/processes"
+
+struct proc_counters_t
+{
+	uint64_t user_ns;
+	uint64_t system_ns;
+	uint64_t voluntary_switches;	// thread blocked
+	uint64_t involuntary_switches;	// thread was preempted or yielded
+	uint64_t minor_faults;
+	uint64_t major_faults;			// page had to be read from a file
+	uint64_t read_bytes;
+	uint64_t write_bytes;
+	uint64_t read_syscalls;
+	uint64_t write_syscalls;
+};
+
+// contents of /proc/<pid>/task/<tid>/stat
+struct proc_thread_stat_t
+{
+	pid_t tid;
+	char state;			// one of PROC_STATE_* definitions
+	unsigned last_cpu;
+	struct proc_counters_t counters;
+};
+
+// contents of /proc/<pid>/stat, counters include threads that have exited
+struct proc_stat_t
+{
+	pid_t pid;
+	pid_t ppid;
+	pid_t pgrp;
+	pid_t sid;
+	uid_t uid;
+	gid_t gid;
+	char state;			// one of PROC_STATE_* definitions
+	unsigned last_cpu;	// of the main thread
+	size_t thread_count;
+	struct proc_meminfo_t meminfo;
+	struct proc_counters_t counters;
+	char command[64];	// argv[0], possibly truncated
+};
+
 /*
 fildes:		refers to valid tty device
 command:	one of TTY_CMD_* definitions
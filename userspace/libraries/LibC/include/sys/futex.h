@@ -8,15 +8,53 @@ __BEGIN_DECLS
 #include <stdint.h>
 #include <time.h>
 
-#define FUTEX_WAIT     0
-#define FUTEX_WAKE     1
-#define FUTEX_PRIVATE  0x10
-#define FUTEX_REALTIME 0x20
+#define FUTEX_WAIT        0
+#define FUTEX_WAKE        1
+#define FUTEX_REQUEUE     3
+#define FUTEX_CMP_REQUEUE 4
+#define FUTEX_WAKE_OP     5
+#define FUTEX_WAIT_BITSET 9
+#define FUTEX_WAKE_BITSET 10
+#define FUTEX_PRIVATE     0x10
+#define FUTEX_REALTIME    0x20
 
-#define FUTEX_WAIT_PRIVATE (FUTEX_WAIT | FUTEX_PRIVATE)
-#define FUTEX_WAKE_PRIVATE (FUTEX_WAKE | FUTEX_PRIVATE)
+#define FUTEX_WAIT_PRIVATE        (FUTEX_WAIT        | FUTEX_PRIVATE)
+#define FUTEX_WAKE_PRIVATE        (FUTEX_WAKE        | FUTEX_PRIVATE)
+#define FUTEX_REQUEUE_PRIVATE     (FUTEX_REQUEUE     | FUTEX_PRIVATE)
+#define FUTEX_CMP_REQUEUE_PRIVATE (FUTEX_CMP_REQUEUE | FUTEX_PRIVATE)
+#define FUTEX_WAKE_OP_PRIVATE     (FUTEX_WAKE_OP     | FUTEX_PRIVATE)
+#define FUTEX_WAIT_BITSET_PRIVATE (FUTEX_WAIT_BITSET | FUTEX_PRIVATE)
+#define FUTEX_WAKE_BITSET_PRIVATE (FUTEX_WAKE_BITSET | FUTEX_PRIVATE)
 
-// op is one of FUTEX_WAIT or FUTEX_WAKE optionally or'ed with FUTEX_PRIVATE and/or FUTEX_REALTIME
+#define FUTEX_BITSET_MATCH_ANY 0xFFFFFFFF
+
+#define FUTEX_OP_SET        0
+#define FUTEX_OP_ADD        1
+#define FUTEX_OP_OR         2
+#define FUTEX_OP_ANDN       3
+#define FUTEX_OP_XOR        4
+#define FUTEX_OP_OPARG_SHIFT 8
+
+#define FUTEX_OP_CMP_EQ 0
+#define FUTEX_OP_CMP_NE 1
+#define FUTEX_OP_CMP_LT 2
+#define FUTEX_OP_CMP_LE 3
+#define FUTEX_OP_CMP_GT 4
+#define FUTEX_OP_CMP_GE 5
+
+// op and cmp are one of FUTEX_OP_* and FUTEX_OP_CMP_*, oparg and cmparg are 12 bit signed values
+#define FUTEX_OP(op, oparg, cmp, cmparg) \
+	((((op) & 0xF) << 28) | (((cmp) & 0xF) << 24) | (((oparg) & 0xFFF) << 12) | ((cmparg) & 0xFFF))
+
+// extra arguments for FUTEX_REQUEUE, FUTEX_CMP_REQUEUE, FUTEX_WAKE_OP and the bitset operations
+struct futex_args
+{
+	uint32_t* addr2;
+	uint32_t value2;
+	uint32_t value3;
+};
+
+// op is one of the FUTEX_* operations optionally or'ed with FUTEX_PRIVATE and/or FUTEX_REALTIME
 //
 // FUTEX_WAIT
 //   put current thread to sleep until *addr != value or until timeout occurs
@@ -25,6 +63,22 @@ __BEGIN_DECLS
 // FUTEX_WAKE
 //   signals waiting futexes to recheck *addr. at most value threads are woken up
 //
+// FUTEX_REQUEUE
+//   wake at most value threads waiting on addr and move at most args->value2
+//   of the remaining waiters to wait on args->addr2
+//
+// FUTEX_CMP_REQUEUE
+//   same as FUTEX_REQUEUE but fails with EAGAIN if *addr != args->value3
+//
+// FUTEX_WAKE_OP
+//   atomically apply operation args->value3 (see FUTEX_OP) to *args->addr2, wake at most
+//   value threads waiting on addr and, if the comparison of the old value of *args->addr2
+//   holds, at most args->value2 threads waiting on args->addr2
+//
+// FUTEX_WAIT_BITSET, FUTEX_WAKE_BITSET
+//   same as FUTEX_WAIT and FUTEX_WAKE but a waiter is only woken up if its
+//   bitset shares a bit with the waker's bitset. bitset is given in args->value3
+//
 // FUTEX_PRIVATE
 //   limit futex wait/wake events to the current process
 //
@@ -33,12 +87,13 @@ __BEGIN_DECLS
 //
 // ERRORS
 //   ETIMEDOUT timeout occured
-//   EINVAL    addr is not aligned on 4 byte boundary
+//   EINVAL    addr is not aligned on 4 byte boundary, args is invalid or missing
 //   ENOSYS    op contains unrecognized value
 //   EINTR     function was interrupted
-//   ENOMEM    not enough memory to allocate futex object
-//   EAGAIN    *addr != value before thread was put to sleep
+//   EAGAIN    *addr != value before thread was put to sleep or
+//             *addr != args->value3 in FUTEX_CMP_REQUEUE
 int futex(int op, const uint32_t* addr, uint32_t value, const struct timespec* abstime);
+int futex_ext(int op, const uint32_t* addr, uint32_t value, const struct timespec* abstime, const struct futex_args* args);
 
 __END_DECLS
 
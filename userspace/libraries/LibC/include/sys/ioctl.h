@@ -84,6 +84,9 @@ struct fb_msync_region
 };
 #define FB_MSYNC_RECTANGLE 90 /* msync a rectangular area in mmap'd framebuffer device */
 
+#define PROFILE_START 100 /* start sampling with struct profile_config from <sys/profile.h> */
+#define PROFILE_STOP  101 /* stop sampling */
+
 int ioctl(int, unsigned long, ...);
 
 __END_DECLS
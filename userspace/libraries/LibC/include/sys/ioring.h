@@ -0,0 +1,109 @@
+#ifndef _SYS_IORING_H
+#define _SYS_IORING_H 1
+
+// banan-os specific asynchronous submission/completion ring
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#define IORING_OP_NOP     0
+#define IORING_OP_READ    1
+#define IORING_OP_WRITE   2
+#define IORING_OP_RECVMSG 3
+#define IORING_OP_SENDMSG 4
+#define IORING_OP_ACCEPT  5
+#define IORING_OP_FSYNC   6
+#define IORING_OP_TIMEOUT 7
+#define IORING_OP_POLL    8
+
+#define IORING_CLOEXEC 0x1
+
+#define IORING_MAX_ENTRIES 4096
+
+// offset value for IORING_OP_READ and IORING_OP_WRITE to use the file offset
+#define IORING_OFFSET_CURRENT ((uint64_t)-1)
+
+struct ioring_sqe
+{
+	uint8_t  opcode;
+	uint8_t  __reserved[3];
+	int32_t  fd;
+	uint64_t off;       // file offset, IORING_OP_ACCEPT: socklen_t*
+	uint64_t addr;      // buffer, msghdr*, sockaddr* or timespec*
+	uint32_t len;       // buffer length
+	uint32_t op_flags;  // msg flags, accept flags or poll events
+	uint64_t user_data;
+};
+
+struct ioring_cqe
+{
+	uint64_t user_data;
+	int32_t  res;       // result or negative errno
+	uint32_t flags;
+};
+
+// Header of the memory shared between the kernel and userspace. It is
+// followed by sq_entries submission and cq_entries completion entries.
+// Kernel only writes sq_head, cq_tail and cq_overflow.
+struct ioring_shared
+{
+	uint32_t sq_head;
+	uint32_t sq_tail;
+	uint32_t cq_head;
+	uint32_t cq_tail;
+	uint32_t sq_entries;
+	uint32_t cq_entries;
+	uint32_t cq_overflow;
+	uint32_t __reserved;
+};
+
+#define IORING_SHARED_SIZE(sq_entries) \
+	(sizeof(struct ioring_shared) + \
+	(sq_entries) * sizeof(struct ioring_sqe) + \
+	(sq_entries) * 2 * sizeof(struct ioring_cqe))
+
+struct ioring
+{
+	int fd;
+	struct ioring_shared* shared;
+	struct ioring_sqe* sqes;
+	struct ioring_cqe* cqes;
+	uint32_t sq_entries;
+	uint32_t cq_entries;
+	uint32_t sq_local_tail;
+	uint32_t sq_submitted;
+};
+
+// raw interface, entries must be a power of two and shared must point to
+// IORING_SHARED_SIZE(entries) bytes of writable memory
+int ioring_setup(unsigned entries, struct ioring_shared* shared, int flags);
+int ioring_enter(int fd, unsigned to_submit, unsigned min_complete, const struct timespec* timeout);
+
+int ioring_queue_init(unsigned entries, struct ioring* ring, int flags);
+void ioring_queue_exit(struct ioring* ring);
+
+struct ioring_sqe* ioring_get_sqe(struct ioring* ring);
+int ioring_submit(struct ioring* ring);
+int ioring_submit_and_wait(struct ioring* ring, unsigned wait_nr);
+int ioring_peek_cqe(struct ioring* ring, struct ioring_cqe** cqe);
+int ioring_wait_cqe(struct ioring* ring, struct ioring_cqe** cqe);
+void ioring_cqe_seen(struct ioring* ring, struct ioring_cqe* cqe);
+
+void ioring_prep_nop(struct ioring_sqe* sqe);
+void ioring_prep_read(struct ioring_sqe* sqe, int fd, void* buffer, unsigned nbytes, uint64_t offset);
+void ioring_prep_write(struct ioring_sqe* sqe, int fd, const void* buffer, unsigned nbytes, uint64_t offset);
+void ioring_prep_recvmsg(struct ioring_sqe* sqe, int fd, struct msghdr* message, unsigned flags);
+void ioring_prep_sendmsg(struct ioring_sqe* sqe, int fd, const struct msghdr* message, unsigned flags);
+void ioring_prep_accept(struct ioring_sqe* sqe, int fd, struct sockaddr* address, socklen_t* address_len, int flags);
+void ioring_prep_fsync(struct ioring_sqe* sqe, int fd);
+void ioring_prep_timeout(struct ioring_sqe* sqe, const struct timespec* timeout);
+void ioring_prep_poll(struct ioring_sqe* sqe, int fd, unsigned poll_mask);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef _SYS_LOCKSTAT_H
+#define _SYS_LOCKSTAT_H 1
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define LOCKSTAT_DISABLE 0
+#define LOCKSTAT_ENABLE  1
+#define LOCKSTAT_RESET   2
+
+// one line per lock class
+//   "name acquisitions contended wait_cycles hold_cycles max_hold_cycles"
+// times are TSC cycles, hold times of read locks are not measured
+#define LOCKSTAT_PROC_PATH "/proc/lockstat"
+
+// one line per tracepoint "name count"
+#define LOCKSTAT_TRACEPOINTS_PROC_PATH "/proc/tracepoints"
+
+// recent tracepoint events of every processor, one per line
+//   "timestamp_ns cpu tid name arg0 arg1 arg2"
+#define LOCKSTAT_TRACE_PROC_PATH "/proc/trace"
+
+// command is one of LOCKSTAT_DISABLE, LOCKSTAT_ENABLE or LOCKSTAT_RESET
+//
+// LOCKSTAT_ENABLE, LOCKSTAT_DISABLE
+//   start or stop collecting lock statistics and tracepoint events
+//
+// LOCKSTAT_RESET
+//   zero all lock statistics and tracepoint counts and forget recorded events
+//
+// ERRORS
+//   EINVAL command is invalid
+//   EPERM  caller is not superuser
+int lockstat(int command);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _SYS_PROFILE_H
+#define _SYS_PROFILE_H 1
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define PROFILE_DEVICE "/dev/profile"
+
+#define PROFILE_MAX_DEPTH 16
+#define PROFILE_MAX_PATH  192
+
+#define PROFILE_RECORD_SAMPLE  0 /* timer sample of the interrupted thread */
+#define PROFILE_RECORD_MMAP    1 /* executable file mapping created by a profiled process */
+#define PROFILE_RECORD_DROPPED 2 /* dropped.count records were lost on cpu */
+
+#define PROFILE_SAMPLE_IDLE 0x1 /* processor was idle */
+
+// argument of PROFILE_START ioctl
+struct profile_config
+{
+	pid_t pid;				// process to sample, 0 samples every process
+	uint32_t frequency_hz;	// samples per second per processor
+};
+
+// fixed size record read from PROFILE_DEVICE
+struct profile_record
+{
+	uint32_t type;
+	uint32_t cpu;
+	pid_t pid;		// 0 for kernel threads
+	pid_t tid;
+	uint64_t timestamp_ns;
+	union
+	{
+		struct
+		{
+			uint32_t flags;
+			uint32_t kernel_depth;
+			uint32_t user_depth;
+			uintptr_t kernel_stack[PROFILE_MAX_DEPTH];	// innermost frame first
+			uintptr_t user_stack[PROFILE_MAX_DEPTH];
+		} sample;
+		struct
+		{
+			uintptr_t address;
+			size_t size;
+			off_t offset;
+			char path[PROFILE_MAX_PATH];
+		} map;
+		struct
+		{
+			uint64_t count;
+		} dropped;
+	};
+};
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef _SYS_RANDOM_H
+#define _SYS_RANDOM_H 1
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#define __need_size_t
+#define __need_ssize_t
+#include <sys/types.h>
+
+// accepted for compatibility, the kernel generator is seeded before
+// userspace starts so getrandom never blocks and has a single pool
+#define GRND_NONBLOCK	0x01
+#define GRND_RANDOM		0x02
+#define GRND_INSECURE	0x04
+
+// fills buffer with length cryptographically secure random bytes
+//
+// ERRORS
+//   EINVAL flags contains unknown bits
+ssize_t getrandom(void* buffer, size_t length, unsigned flags);
+
+__END_DECLS
+
+#endif
@@ -15,6 +15,7 @@ __BEGIN_DECLS
 #include <sys/types.h>
 
 #include <sys/uio.h>
+#include <time.h>
 
 #include <bits/types/sa_family_t.h>
 #include <bits/types/socklen_t.h>
@@ -48,6 +49,12 @@ struct msghdr
 	int				msg_flags;		/* Flags on received message. */
 };
 
+struct mmsghdr
+{
+	struct msghdr	msg_hdr;	/* Message header. */
+	unsigned int	msg_len;	/* Number of bytes transferred. */
+};
+
 struct cmsghdr
 {
 	socklen_t	cmsg_len;	/* Data byte count, including the cmsghdr. */
@@ -120,6 +127,7 @@ struct linger
 #define SO_SNDLOWAT		13
 #define SO_SNDTIMEO		14
 #define SO_TYPE			15
+#define SO_REUSEPORT	16
 
 #define SOMAXCONN 4096
 
@@ -132,6 +140,7 @@ struct linger
 #define MSG_TRUNC		0x040
 #define MSG_WAITALL		0x080
 #define MSG_DONTWAIT    0x100
+#define MSG_WAITFORONE	0x200
 
 #define AF_UNSPEC	0
 #define AF_INET		1
@@ -180,8 +189,10 @@ int		listen(int socket, int backlog);
 ssize_t	recv(int socket, void* buffer, size_t length, int flags);
 ssize_t	recvfrom(int socket, void* __restrict buffer, size_t length, int flags, struct sockaddr* __restrict address, socklen_t* __restrict address_len);
 ssize_t	recvmsg(int socket, struct msghdr* message, int flags);
+int		recvmmsg(int socket, struct mmsghdr* messages, unsigned int vlen, int flags, struct timespec* timeout);
 ssize_t	send(int socket, const void* buffer, size_t length, int flags);
 ssize_t	sendmsg(int socket, const struct msghdr* message, int flags);
+int		sendmmsg(int socket, struct mmsghdr* messages, unsigned int vlen, int flags);
 ssize_t	sendto(int socket, const void* message, size_t length, int flags, const struct sockaddr* dest_addr, socklen_t dest_len);
 int		setsockopt(int socket, int level, int option_name, const void* option_value, socklen_t option_len);
 int		shutdown(int socket, int how);
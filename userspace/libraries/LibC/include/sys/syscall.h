@@ -118,6 +118,22 @@ __BEGIN_DECLS
 	O(SYS_CHROOT,			chroot)			\
 	O(SYS_EVENTFD,			eventfd)		\
     O(SYS_BANOS_INSTALL,    banos_install)  \
+	O(SYS_SENDFILE,			sendfile)		\
+	O(SYS_SPLICE,			splice)			\
+	O(SYS_COPY_FILE_RANGE,	copy_file_range)	\
+	O(SYS_READV,			readv)			\
+	O(SYS_WRITEV,			writev)			\
+	O(SYS_PREADV,			preadv)			\
+	O(SYS_PWRITEV,			pwritev)		\
+	O(SYS_IORING_SETUP,		ioring_setup)	\
+	O(SYS_IORING_ENTER,		ioring_enter)	\
+	O(SYS_GETRLIMIT,		getrlimit)		\
+	O(SYS_SETRLIMIT,		setrlimit)		\
+	O(SYS_RECVMMSG,			recvmmsg)		\
+	O(SYS_SENDMMSG,			sendmmsg)		\
+	O(SYS_SYSCALL_TRACE,	syscall_trace)	\
+	O(SYS_LOCKSTAT,			lockstat)		\
+	O(SYS_GETRANDOM,		getrandom)		\
 
 enum Syscall
 {
@@ -0,0 +1,49 @@
+#ifndef _SYS_SYSCALL_TRACE_H
+#define _SYS_SYSCALL_TRACE_H 1
+
+#include <sys/cdefs.h>
+
+__BEGIN_DECLS
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#define SYSCALL_TRACE_PROCESS 0
+#define SYSCALL_TRACE_THREAD  1
+
+// event syscall number of a record that reports args[0] events lost on cpu
+#define SYSCALL_TRACE_DROPPED -1
+
+#define SYSCALL_TRACE_DEVICE "/dev/systrace"
+
+// one record per completed syscall, read from SYSCALL_TRACE_DEVICE
+struct syscall_trace_event
+{
+	pid_t pid;
+	pid_t tid;
+	int syscall;
+	unsigned cpu;
+	long args[5];
+	long ret;			// return value, or negated errno
+	uint64_t entry_ns;	// CLOCK_MONOTONIC time of syscall entry and exit
+	uint64_t exit_ns;
+};
+
+// target is one of SYSCALL_TRACE_PROCESS or SYSCALL_TRACE_THREAD
+//
+// SYSCALL_TRACE_PROCESS
+//   enable or disable tracing of all threads of process id. children forked
+//   by a traced process are traced too
+//
+// SYSCALL_TRACE_THREAD
+//   enable or disable tracing of thread id of the calling process
+//
+// ERRORS
+//   EINVAL target is invalid
+//   ESRCH  no process or thread was found with id
+//   EPERM  caller is not allowed to trace process id
+int syscall_trace(int target, pid_t id, int enable);
+
+__END_DECLS
+
+#endif
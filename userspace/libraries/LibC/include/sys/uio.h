@@ -7,6 +7,7 @@
 
 __BEGIN_DECLS
 
+#define __need_off_t
 #define __need_size_t
 #define __need_ssize_t
 #include <sys/types.h>
@@ -20,6 +21,9 @@ struct iovec
 ssize_t readv(int fildes, const struct iovec* iov, int iovcnt);
 ssize_t writev(int fildes, const struct iovec* iov, int iovcnt);
 
+ssize_t preadv(int fildes, const struct iovec* iov, int iovcnt, off_t offset);
+ssize_t pwritev(int fildes, const struct iovec* iov, int iovcnt, off_t offset);
+
 __END_DECLS
 
 #endif
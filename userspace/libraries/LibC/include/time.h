@@ -55,6 +55,8 @@ struct itimerspec
 #define CLOCK_PROCESS_CPUTIME_ID	1
 #define CLOCK_REALTIME				2
 #define CLOCK_THREAD_CPUTIME_ID		3
+#define CLOCK_MONOTONIC_COARSE		4
+#define CLOCK_REALTIME_COARSE		5
 
 #define TIMER_ABSTIME 1
 
@@ -603,6 +603,7 @@ int					usleep(useconds_t usec);
 ssize_t				write(int fildes, const void* buf, size_t nbyte);
 
 int					chroot(const char* path);
+ssize_t				copy_file_range(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t len, unsigned flags);
 int					getpagesize(void);
 char*				getpass(const char* prompt);
 
@@ -4,6 +4,7 @@
 #include <BAN/PlacementNew.h>
 
 #include <errno.h>
+#include <limits.h>
 #include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
@@ -453,6 +454,7 @@ int pthread_create(pthread_t* __restrict thread, const pthread_attr_t* __restric
 			.cleanup_funcs = nullptr,
 			.specific_keys = {},
 			.specific_vals = {},
+			.getrandom_state = {},
 			.dtv = { self->dtv[0] }
 		};
 		strcpy(uthread->name, self->name);
@@ -876,12 +878,63 @@ int pthread_mutex_init(pthread_mutex_t* __restrict mutex, const pthread_mutexatt
 	*mutex = {
 		.attr = *attr,
 		.futex = 0,
-		.waiters = 0,
 		.lock_depth = 0,
 	};
 	return 0;
 }
 
+// mutex->futex holds the owner's tid, with this bit set when other threads may be sleeping on it
+static constexpr uint32_t s_mutex_waiters_bit = 0x80000000;
+static constexpr size_t s_mutex_spin_count = 100;
+
+static bool _pthread_mutex_try_acquire(pthread_mutex_t* mutex, uint32_t value)
+{
+	uint32_t expected = 0;
+	return BAN::atomic_compare_exchange(mutex->futex, expected, value, BAN::MemoryOrder::memory_order_acquire);
+}
+
+// if contended is set, the caller may have been requeued to the mutex by pthread_cond_broadcast
+// and the lock is marked as having waiters so the next unlock wakes up the others
+static int _pthread_mutex_lock_slow(pthread_mutex_t* mutex, const struct timespec* abstime, bool contended)
+{
+	const uint32_t tid = pthread_self()->id;
+
+	if (!contended)
+	{
+		// owner is likely to release the lock soon, spin for a while before going to sleep
+		for (size_t i = 0; i < s_mutex_spin_count; i++)
+		{
+			const uint32_t value = BAN::atomic_load(mutex->futex, BAN::MemoryOrder::memory_order_relaxed);
+			if (value == 0 && _pthread_mutex_try_acquire(mutex, tid))
+			{
+				mutex->lock_depth = 1;
+				return 0;
+			}
+			if (value & s_mutex_waiters_bit)
+				break;
+			__builtin_ia32_pause();
+		}
+	}
+
+	const int op = FUTEX_WAIT | (mutex->attr.shared ? 0 : FUTEX_PRIVATE) | FUTEX_REALTIME;
+
+	// after sleeping we can't know whether others are still waiting, so acquire the lock as contended
+	while (!_pthread_mutex_try_acquire(mutex, tid | s_mutex_waiters_bit))
+	{
+		uint32_t value = BAN::atomic_load(mutex->futex, BAN::MemoryOrder::memory_order_relaxed);
+		if (value == 0)
+			continue;
+		if (!(value & s_mutex_waiters_bit) && !BAN::atomic_compare_exchange(mutex->futex, value, value | s_mutex_waiters_bit))
+			continue;
+
+		if (const int err = futex(op, &mutex->futex, value | s_mutex_waiters_bit, abstime); err && err != EAGAIN)
+			return err;
+	}
+
+	mutex->lock_depth = 1;
+	return 0;
+}
+
 int pthread_mutex_lock(pthread_mutex_t* mutex)
 {
 	return pthread_mutex_timedlock(mutex, nullptr);
@@ -894,18 +947,17 @@ int pthread_mutex_trylock(pthread_mutex_t* mutex)
 	switch (mutex->attr.type)
 	{
 		case PTHREAD_MUTEX_RECURSIVE:
-			if (mutex->futex != tid)
+			if ((mutex->futex & ~s_mutex_waiters_bit) != tid)
 				break;
 			mutex->lock_depth++;
 			return 0;
 		case PTHREAD_MUTEX_ERRORCHECK:
-			if (mutex->futex != tid)
+			if ((mutex->futex & ~s_mutex_waiters_bit) != tid)
 				break;
 			return EDEADLK;
 	}
 
-	uint32_t expected = 0;
-	if (!BAN::atomic_compare_exchange(mutex->futex, expected, tid, BAN::MemoryOrder::memory_order_acquire))
+	if (!_pthread_mutex_try_acquire(mutex, tid))
 		return EBUSY;
 
 	mutex->lock_depth = 1;
@@ -917,39 +969,18 @@ int pthread_mutex_timedlock(pthread_mutex_t* __restrict mutex, const struct time
 	// recursive/errorcheck handled in trylock to remove code duplication
 	if (const int ret = pthread_mutex_trylock(mutex); ret != EBUSY)
 		return ret;
-
-	const uint32_t tid = pthread_self()->id;
-
-	uint32_t expected = 0;
-	while (!BAN::atomic_compare_exchange(mutex->futex, expected, tid, BAN::memory_order_acquire))
-	{
-		const int op = FUTEX_WAIT | (mutex->attr.shared ? 0 : FUTEX_PRIVATE) | FUTEX_REALTIME;
-
-		BAN::atomic_add_fetch(mutex->waiters, 1);
-		const auto err = futex(op, &mutex->futex, expected, abstime);
-		BAN::atomic_sub_fetch(mutex->waiters, 1);
-
-		if (err && err != EAGAIN)
-			return err;
-
-		expected = 0;
-	}
-
-	mutex->lock_depth = 1;
-	return 0;
+	return _pthread_mutex_lock_slow(mutex, abstime, false);
 }
 
 int pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
-	ASSERT(mutex->futex == static_cast<uint32_t>(pthread_self()->id));
+	ASSERT((mutex->futex & ~s_mutex_waiters_bit) == static_cast<uint32_t>(pthread_self()->id));
 
 	mutex->lock_depth--;
 	if (mutex->lock_depth == 0)
 	{
 		const int op = FUTEX_WAKE | (mutex->attr.shared ? 0 : FUTEX_PRIVATE);
-
-		BAN::atomic_store(mutex->futex, 0, BAN::memory_order_release);
-		if (BAN::atomic_load(mutex->waiters))
+		if (BAN::atomic_exchange(mutex->futex, 0, BAN::memory_order_release) & s_mutex_waiters_bit)
 			futex(op, &mutex->futex, 1, nullptr);
 	}
 
@@ -1004,25 +1035,34 @@ int pthread_rwlock_init(pthread_rwlock_t* __restrict rwlock, const pthread_rwloc
 	if (attr == nullptr)
 		attr = &default_attr;
 	*rwlock = {
-		.lock = PTHREAD_MUTEX_INITIALIZER,
-		.cond = PTHREAD_COND_INITIALIZER,
-		.writers_waiting = 0,
-		.writer_active = 0,
-		.readers_active = 0,
-	};
-	const pthread_mutexattr_t mattr {
-		.type = PTHREAD_MUTEX_DEFAULT,
-		.shared = attr->shared,
-	};
-	pthread_mutex_init(&rwlock->lock, &mattr);
-	const pthread_condattr_t cattr {
-		.clock = CLOCK_REALTIME,
 		.shared = attr->shared,
+		.state = 0,
+		.readers_waiting = 0,
+		.writers_waiting = 0,
+		.reader_futex = 0,
+		.writer_futex = 0,
 	};
-	pthread_cond_init(&rwlock->cond, &cattr);
 	return 0;
 }
 
+// rwlock->state holds the number of active readers, or this bit if a writer holds the lock.
+// Writers are preferred: new readers block while any writer is waiting.
+static constexpr uint32_t s_rwlock_writer_bit = 0x80000000;
+
+static void _pthread_rwlock_wake_readers(pthread_rwlock_t* rwlock)
+{
+	if (BAN::atomic_load(rwlock->readers_waiting) == 0)
+		return;
+	BAN::atomic_add_fetch(rwlock->reader_futex, 1);
+	futex(FUTEX_WAKE | (rwlock->shared ? 0 : FUTEX_PRIVATE), &rwlock->reader_futex, INT_MAX, nullptr);
+}
+
+static void _pthread_rwlock_wake_writer(pthread_rwlock_t* rwlock)
+{
+	BAN::atomic_add_fetch(rwlock->writer_futex, 1);
+	futex(FUTEX_WAKE | (rwlock->shared ? 0 : FUTEX_PRIVATE), &rwlock->writer_futex, 1, nullptr);
+}
+
 int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock)
 {
 	return pthread_rwlock_timedrdlock(rwlock, nullptr);
@@ -1030,26 +1070,42 @@ int pthread_rwlock_rdlock(pthread_rwlock_t* rwlock)
 
 int pthread_rwlock_tryrdlock(pthread_rwlock_t* rwlock)
 {
-	int ret = 0;
-	pthread_mutex_lock(&rwlock->lock);
-	if (!rwlock->writers_waiting && !rwlock->writer_active)
-		rwlock->readers_active++;
-	else
-		ret = EBUSY;
-	pthread_mutex_unlock(&rwlock->lock);
-	return ret;
+	uint32_t state = BAN::atomic_load(rwlock->state, BAN::MemoryOrder::memory_order_relaxed);
+	for (;;)
+	{
+		if ((state & s_rwlock_writer_bit) || BAN::atomic_load(rwlock->writers_waiting))
+			return EBUSY;
+		if (state + 1 == s_rwlock_writer_bit)
+			return EAGAIN;
+		if (BAN::atomic_compare_exchange(rwlock->state, state, state + 1, BAN::MemoryOrder::memory_order_acquire))
+			return 0;
+	}
 }
 
 int pthread_rwlock_timedrdlock(pthread_rwlock_t* __restrict rwlock, const struct timespec* __restrict abstime)
 {
-	int ret = 0;
-	pthread_mutex_lock(&rwlock->lock);
-	while (ret == 0 && (rwlock->writers_waiting || rwlock->writer_active))
-		ret = pthread_cond_timedwait(&rwlock->cond, &rwlock->lock, abstime);
-	if (ret == 0)
-		rwlock->readers_active++;
-	pthread_mutex_unlock(&rwlock->lock);
-	return ret;
+	const int op = FUTEX_WAIT | (rwlock->shared ? 0 : FUTEX_PRIVATE) | FUTEX_REALTIME;
+
+	for (;;)
+	{
+		if (const int ret = pthread_rwlock_tryrdlock(rwlock); ret != EBUSY)
+			return ret;
+
+		BAN::atomic_add_fetch(rwlock->readers_waiting, 1);
+
+		// recheck after announcing ourselves so an unlock can't be missed
+		const uint32_t seq = BAN::atomic_load(rwlock->reader_futex);
+		const bool blocked = (BAN::atomic_load(rwlock->state) & s_rwlock_writer_bit) || BAN::atomic_load(rwlock->writers_waiting);
+
+		int err = 0;
+		if (blocked)
+			err = futex(op, &rwlock->reader_futex, seq, abstime);
+
+		BAN::atomic_sub_fetch(rwlock->readers_waiting, 1);
+
+		if (err && err != EAGAIN)
+			return err;
+	}
 }
 
 int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock)
@@ -1059,45 +1115,55 @@ int pthread_rwlock_wrlock(pthread_rwlock_t* rwlock)
 
 int pthread_rwlock_trywrlock(pthread_rwlock_t* rwlock)
 {
-	int ret = 0;
-	pthread_mutex_lock(&rwlock->lock);
-	if (!rwlock->readers_active && !rwlock->writer_active)
-		rwlock->writer_active = 1;
-	else
-		ret = EBUSY;
-	pthread_mutex_unlock(&rwlock->lock);
-	return ret;
+	uint32_t expected = 0;
+	if (!BAN::atomic_compare_exchange(rwlock->state, expected, s_rwlock_writer_bit, BAN::MemoryOrder::memory_order_acquire))
+		return EBUSY;
+	return 0;
 }
 
 int pthread_rwlock_timedwrlock(pthread_rwlock_t* __restrict rwlock, const struct timespec* __restrict abstime)
 {
-	int ret = 0;
-	pthread_mutex_lock(&rwlock->lock);
-	rwlock->writers_waiting++;
-	while (ret == 0 && (rwlock->readers_active || rwlock->writer_active))
-		ret = pthread_cond_timedwait(&rwlock->cond, &rwlock->lock, abstime);
-	rwlock->writers_waiting--;
-	if (ret == 0)
-		rwlock->writer_active = 1;
-	pthread_mutex_unlock(&rwlock->lock);
-	return ret;
+	if (pthread_rwlock_trywrlock(rwlock) == 0)
+		return 0;
+
+	const int op = FUTEX_WAIT | (rwlock->shared ? 0 : FUTEX_PRIVATE) | FUTEX_REALTIME;
+
+	BAN::atomic_add_fetch(rwlock->writers_waiting, 1);
+
+	for (;;)
+	{
+		const uint32_t seq = BAN::atomic_load(rwlock->writer_futex);
+		if (pthread_rwlock_trywrlock(rwlock) == 0)
+			break;
+
+		if (const int err = futex(op, &rwlock->writer_futex, seq, abstime); err && err != EAGAIN)
+		{
+			// readers may be blocked only because of us
+			if (BAN::atomic_sub_fetch(rwlock->writers_waiting, 1) == 0 && !(BAN::atomic_load(rwlock->state) & s_rwlock_writer_bit))
+				_pthread_rwlock_wake_readers(rwlock);
+			return err;
+		}
+	}
+
+	BAN::atomic_sub_fetch(rwlock->writers_waiting, 1);
+	return 0;
 }
 
 int pthread_rwlock_unlock(pthread_rwlock_t* rwlock)
 {
-	pthread_mutex_lock(&rwlock->lock);
-	if (rwlock->writer_active)
+	if (BAN::atomic_load(rwlock->state, BAN::MemoryOrder::memory_order_relaxed) & s_rwlock_writer_bit)
 	{
-		rwlock->writer_active = 0;
-		pthread_cond_broadcast(&rwlock->cond);
+		BAN::atomic_store(rwlock->state, 0);
+		if (BAN::atomic_load(rwlock->writers_waiting))
+			_pthread_rwlock_wake_writer(rwlock);
+		else
+			_pthread_rwlock_wake_readers(rwlock);
 	}
 	else
 	{
-		rwlock->readers_active--;
-		if (rwlock->readers_active == 0)
-			pthread_cond_broadcast(&rwlock->cond);
+		if (BAN::atomic_sub_fetch(rwlock->state, 1) == 0 && BAN::atomic_load(rwlock->writers_waiting))
+			_pthread_rwlock_wake_writer(rwlock);
 	}
-	pthread_mutex_unlock(&rwlock->lock);
 	return 0;
 }
 
@@ -1172,37 +1238,50 @@ int pthread_cond_init(pthread_cond_t* __restrict cond, const pthread_condattr_t*
 		attr = &default_attr;
 	*cond = {
 		.attr = *attr,
-		.lock = PTHREAD_SPIN_INITIALIZER,
-		.block_list = nullptr,
+		.futex = 0,
+		.waiters = 0,
+		.mutex = nullptr,
 	};
 	return 0;
 }
 
 int pthread_cond_broadcast(pthread_cond_t* cond)
 {
-	pthread_spin_lock(&cond->lock);
-	for (auto* block = cond->block_list; block; block = block->next)
-	{
-		BAN::atomic_store(block->futex, 1);
+	if (BAN::atomic_load(cond->waiters) == 0)
+		return 0;
 
-		const int op = FUTEX_WAKE | (cond->attr.shared ? 0 : FUTEX_PRIVATE);
-		futex(op, &block->futex, 1, nullptr);
+	const uint32_t seq = BAN::atomic_add_fetch(cond->futex, 1);
+	const int private_flag = cond->attr.shared ? 0 : FUTEX_PRIVATE;
+
+	// wake up one waiter and move the rest to the mutex, they would only contend on it anyway.
+	// mutex's futex key must match so requeue is only possible if neither is process shared.
+	// cond->mutex of a process shared condition variable may point into another address space
+	auto* mutex = cond->attr.shared ? nullptr : BAN::atomic_load(cond->mutex);
+	if (mutex != nullptr && !mutex->attr.shared)
+	{
+		const futex_args args {
+			.addr2 = &mutex->futex,
+			.value2 = INT_MAX,
+			.value3 = seq,
+		};
+		// on any failure fall back to waking up everyone, a waiter must never be left sleeping
+		if (futex_ext(FUTEX_CMP_REQUEUE | private_flag, &cond->futex, 1, nullptr, &args) == 0)
+			return 0;
 	}
-	pthread_spin_unlock(&cond->lock);
+
+	futex(FUTEX_WAKE | private_flag, &cond->futex, INT_MAX, nullptr);
 	return 0;
 }
 
 int pthread_cond_signal(pthread_cond_t* cond)
 {
-	pthread_spin_lock(&cond->lock);
-	if (auto* block = cond->block_list)
-	{
-		BAN::atomic_store(block->futex, 1);
+	if (BAN::atomic_load(cond->waiters) == 0)
+		return 0;
 
-		const int op = FUTEX_WAKE | (cond->attr.shared ? 0 : FUTEX_PRIVATE);
-		futex(op, &block->futex, 1, nullptr);
-	}
-	pthread_spin_unlock(&cond->lock);
+	BAN::atomic_add_fetch(cond->futex, 1);
+
+	const int op = FUTEX_WAKE | (cond->attr.shared ? 0 : FUTEX_PRIVATE);
+	futex(op, &cond->futex, 1, nullptr);
 	return 0;
 }
 
@@ -1216,39 +1295,24 @@ int pthread_cond_timedwait(pthread_cond_t* __restrict cond, pthread_mutex_t* __r
 {
 	pthread_testcancel();
 
-	pthread_spin_lock(&cond->lock);
-	_pthread_cond_block block = {
-		.next = cond->block_list,
-		.futex = 0,
-	};
-	cond->block_list = &block;
-	pthread_spin_unlock(&cond->lock);
+	BAN::atomic_add_fetch(cond->waiters, 1);
+	BAN::atomic_store(cond->mutex, mutex);
+	const uint32_t seq = BAN::atomic_load(cond->futex);
 
 	pthread_mutex_unlock(mutex);
 
-	int ret = 0;
-	while (ret == 0 && BAN::atomic_load(block.futex) == 0)
-	{
-		const int op = FUTEX_WAIT
-			| (cond->attr.shared ? 0 : FUTEX_PRIVATE)
-			| (cond->attr.clock == CLOCK_REALTIME ? FUTEX_REALTIME : 0);
-		if (const int err = futex(op, &block.futex, 0, abstime); err != EAGAIN)
-			ret = err;
-	}
+	const int op = FUTEX_WAIT
+		| (cond->attr.shared ? 0 : FUTEX_PRIVATE)
+		| (cond->attr.clock == CLOCK_REALTIME ? FUTEX_REALTIME : 0);
+	int ret = futex(op, &cond->futex, seq, abstime);
+	if (ret == EAGAIN)
+		ret = 0;
 
-	pthread_spin_lock(&cond->lock);
-	if (&block == cond->block_list)
-		cond->block_list = block.next;
-	else
-	{
-		_pthread_cond_block* prev = cond->block_list;
-		while (prev->next != &block)
-			prev = prev->next;
-		prev->next = block.next;
-	}
-	pthread_spin_unlock(&cond->lock);
+	BAN::atomic_sub_fetch(cond->waiters, 1);
 
-	pthread_mutex_lock(mutex);
+	// we may have been requeued to the mutex, in which case the other requeued waiters
+	// are only woken up if we mark the mutex as contended
+	_pthread_mutex_lock_slow(mutex, nullptr, true);
 
 	return ret;
 }
@@ -1303,44 +1367,32 @@ int pthread_barrier_init(pthread_barrier_t* __restrict barrier, const pthread_ba
 	if (attr == nullptr)
 		attr = &default_attr;
 	*barrier = {
-		.lock = PTHREAD_MUTEX_INITIALIZER,
-		.cond = PTHREAD_COND_INITIALIZER,
+		.shared = attr->shared,
 		.target = count,
 		.waiting = 0,
 		.generation = 0,
 	};
-	const pthread_mutexattr_t mattr {
-		.type = PTHREAD_MUTEX_DEFAULT,
-		.shared = attr->shared,
-	};
-	pthread_mutex_init(&barrier->lock, &mattr);
-	const pthread_condattr_t cattr {
-		.clock = CLOCK_REALTIME,
-		.shared = attr->shared,
-	};
-	pthread_cond_init(&barrier->cond, &cattr);
 	return 0;
 }
 
 int pthread_barrier_wait(pthread_barrier_t* barrier)
 {
-	pthread_mutex_lock(&barrier->lock);
-
-	const auto gen = barrier->generation;
-	barrier->waiting++;
+	const uint32_t gen = BAN::atomic_load(barrier->generation);
 
-	if (barrier->waiting == barrier->target)
+	if (BAN::atomic_add_fetch(barrier->waiting, 1) == barrier->target)
 	{
-		barrier->waiting = 0;
-		barrier->generation++;
-		pthread_cond_broadcast(&barrier->cond);
-		pthread_mutex_unlock(&barrier->lock);
+		// nobody can arrive at the next generation before we release this one
+		BAN::atomic_store(barrier->waiting, 0);
+		BAN::atomic_add_fetch(barrier->generation, 1);
+
+		const int op = FUTEX_WAKE | (barrier->shared ? 0 : FUTEX_PRIVATE);
+		futex(op, &barrier->generation, INT_MAX, nullptr);
 		return PTHREAD_BARRIER_SERIAL_THREAD;
 	}
 
-	while (barrier->generation == gen)
-		pthread_cond_wait(&barrier->cond, &barrier->lock);
-	pthread_mutex_unlock(&barrier->lock);
+	const int op = FUTEX_WAIT | (barrier->shared ? 0 : FUTEX_PRIVATE);
+	while (BAN::atomic_load(barrier->generation) == gen)
+		futex(op, &barrier->generation, gen, nullptr);
 	return 0;
 }
 
@@ -149,7 +149,7 @@ static int add_file_action(posix_spawn_file_actions_t* file_actions, _posix_spaw
 
 int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* file_actions, int fildes)
 {
-	if (fildes < 0 || fildes >= OPEN_MAX)
+	if (fildes < 0 || fildes >= sysconf(_SC_OPEN_MAX))
 		return EBADF;
 
 	return add_file_action(file_actions, {
@@ -162,7 +162,7 @@ int posix_spawn_file_actions_addclose(posix_spawn_file_actions_t* file_actions,
 
 int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* file_actions, int fildes, int newfildes)
 {
-	if (fildes < 0 || fildes >= OPEN_MAX || newfildes < 0 || newfildes >= OPEN_MAX)
+	if (fildes < 0 || fildes >= sysconf(_SC_OPEN_MAX) || newfildes < 0 || newfildes >= sysconf(_SC_OPEN_MAX))
 		return EBADF;
 
 	return add_file_action(file_actions, {
@@ -176,7 +176,7 @@ int posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t* file_actions, i
 
 int posix_spawn_file_actions_addopen(posix_spawn_file_actions_t* __restrict file_actions, int fildes, const char* __restrict path, int oflag, mode_t mode)
 {
-	if (fildes < 0 || fildes >= OPEN_MAX)
+	if (fildes < 0 || fildes >= sysconf(_SC_OPEN_MAX))
 		return EBADF;
 
 	char* path_copy = strdup(path);
@@ -4,9 +4,14 @@
 #include <unistd.h>
 
 int futex(int op, const uint32_t* addr, uint32_t value, const struct timespec* abstime)
+{
+	return futex_ext(op, addr, value, abstime, nullptr);
+}
+
+int futex_ext(int op, const uint32_t* addr, uint32_t value, const struct timespec* abstime, const struct futex_args* args)
 {
 	errno = 0;
-	while (syscall(SYS_FUTEX, op, addr, value, abstime) == -1 && errno == EINTR)
+	while (syscall(SYS_FUTEX, op, addr, value, abstime, args) == -1 && errno == EINTR)
 		errno = 0;
 	return errno;
 }
@@ -0,0 +1,191 @@
+#include <BAN/Atomic.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/ioring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int ioring_setup(unsigned entries, struct ioring_shared* shared, int flags)
+{
+	return syscall(SYS_IORING_SETUP, entries, shared, flags);
+}
+
+int ioring_enter(int fd, unsigned to_submit, unsigned min_complete, const struct timespec* timeout)
+{
+	return syscall(SYS_IORING_ENTER, fd, to_submit, min_complete, timeout);
+}
+
+int ioring_queue_init(unsigned entries, struct ioring* ring, int flags)
+{
+	if (entries == 0 || entries > IORING_MAX_ENTRIES)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	unsigned rounded = 1;
+	while (rounded < entries)
+		rounded <<= 1;
+
+	const size_t size = IORING_SHARED_SIZE(rounded);
+
+	void* shared = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED)
+		return -1;
+
+	const int fd = ioring_setup(rounded, static_cast<ioring_shared*>(shared), flags);
+	if (fd == -1)
+	{
+		munmap(shared, size);
+		return -1;
+	}
+
+	ring->fd = fd;
+	ring->shared = static_cast<ioring_shared*>(shared);
+	ring->sqes = reinterpret_cast<ioring_sqe*>(ring->shared + 1);
+	ring->cqes = reinterpret_cast<ioring_cqe*>(ring->sqes + rounded);
+	ring->sq_entries = ring->shared->sq_entries;
+	ring->cq_entries = ring->shared->cq_entries;
+	ring->sq_local_tail = 0;
+	ring->sq_submitted = 0;
+
+	return 0;
+}
+
+void ioring_queue_exit(struct ioring* ring)
+{
+	close(ring->fd);
+	munmap(ring->shared, IORING_SHARED_SIZE(ring->sq_entries));
+}
+
+struct ioring_sqe* ioring_get_sqe(struct ioring* ring)
+{
+	const uint32_t head = BAN::atomic_load(ring->shared->sq_head, BAN::MemoryOrder::memory_order_acquire);
+	if (ring->sq_local_tail - head >= ring->sq_entries)
+		return nullptr;
+
+	auto* sqe = &ring->sqes[ring->sq_local_tail++ & (ring->sq_entries - 1)];
+	memset(sqe, 0, sizeof(ioring_sqe));
+	return sqe;
+}
+
+static unsigned ioring_flush_sq(struct ioring* ring)
+{
+	BAN::atomic_store(ring->shared->sq_tail, ring->sq_local_tail, BAN::MemoryOrder::memory_order_release);
+	const unsigned to_submit = ring->sq_local_tail - ring->sq_submitted;
+	ring->sq_submitted = ring->sq_local_tail;
+	return to_submit;
+}
+
+int ioring_submit(struct ioring* ring)
+{
+	const unsigned to_submit = ioring_flush_sq(ring);
+	if (to_submit == 0)
+		return 0;
+	return ioring_enter(ring->fd, to_submit, 0, nullptr);
+}
+
+int ioring_submit_and_wait(struct ioring* ring, unsigned wait_nr)
+{
+	return ioring_enter(ring->fd, ioring_flush_sq(ring), wait_nr, nullptr);
+}
+
+int ioring_peek_cqe(struct ioring* ring, struct ioring_cqe** cqe)
+{
+	const uint32_t head = ring->shared->cq_head;
+	const uint32_t tail = BAN::atomic_load(ring->shared->cq_tail, BAN::MemoryOrder::memory_order_acquire);
+	if (head == tail)
+	{
+		errno = EAGAIN;
+		return -1;
+	}
+
+	*cqe = &ring->cqes[head & (ring->cq_entries - 1)];
+	return 0;
+}
+
+int ioring_wait_cqe(struct ioring* ring, struct ioring_cqe** cqe)
+{
+	for (;;)
+	{
+		if (ioring_peek_cqe(ring, cqe) == 0)
+			return 0;
+		if (ioring_enter(ring->fd, ioring_flush_sq(ring), 1, nullptr) == -1)
+			return -1;
+	}
+}
+
+void ioring_cqe_seen(struct ioring* ring, struct ioring_cqe*)
+{
+	BAN::atomic_add_fetch(ring->shared->cq_head, 1, BAN::MemoryOrder::memory_order_release);
+}
+
+void ioring_prep_nop(struct ioring_sqe* sqe)
+{
+	sqe->opcode = IORING_OP_NOP;
+}
+
+void ioring_prep_read(struct ioring_sqe* sqe, int fd, void* buffer, unsigned nbytes, uint64_t offset)
+{
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(buffer);
+	sqe->len = nbytes;
+	sqe->off = offset;
+}
+
+void ioring_prep_write(struct ioring_sqe* sqe, int fd, const void* buffer, unsigned nbytes, uint64_t offset)
+{
+	sqe->opcode = IORING_OP_WRITE;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(buffer);
+	sqe->len = nbytes;
+	sqe->off = offset;
+}
+
+void ioring_prep_recvmsg(struct ioring_sqe* sqe, int fd, struct msghdr* message, unsigned flags)
+{
+	sqe->opcode = IORING_OP_RECVMSG;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(message);
+	sqe->op_flags = flags;
+}
+
+void ioring_prep_sendmsg(struct ioring_sqe* sqe, int fd, const struct msghdr* message, unsigned flags)
+{
+	sqe->opcode = IORING_OP_SENDMSG;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(message);
+	sqe->op_flags = flags;
+}
+
+void ioring_prep_accept(struct ioring_sqe* sqe, int fd, struct sockaddr* address, socklen_t* address_len, int flags)
+{
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = fd;
+	sqe->addr = reinterpret_cast<uintptr_t>(address);
+	sqe->off = reinterpret_cast<uintptr_t>(address_len);
+	sqe->op_flags = flags;
+}
+
+void ioring_prep_fsync(struct ioring_sqe* sqe, int fd)
+{
+	sqe->opcode = IORING_OP_FSYNC;
+	sqe->fd = fd;
+}
+
+void ioring_prep_timeout(struct ioring_sqe* sqe, const struct timespec* timeout)
+{
+	sqe->opcode = IORING_OP_TIMEOUT;
+	sqe->fd = -1;
+	sqe->addr = reinterpret_cast<uintptr_t>(timeout);
+}
+
+void ioring_prep_poll(struct ioring_sqe* sqe, int fd, unsigned poll_mask)
+{
+	sqe->opcode = IORING_OP_POLL;
+	sqe->fd = fd;
+	sqe->op_flags = poll_mask;
+}
@@ -0,0 +1,8 @@
+#include <sys/lockstat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int lockstat(int command)
+{
+	return syscall(SYS_LOCKSTAT, command);
+}
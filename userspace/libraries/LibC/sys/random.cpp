@@ -0,0 +1,118 @@
+#include <BAN/Atomic.h>
+#include <BAN/ChaCha20.h>
+#include <BAN/Math.h>
+
+#include <kernel/API/SharedPage.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/random.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using BAN::ChaCha20;
+
+extern volatile Kernel::API::SharedPage* g_shared_page;
+
+template<typename T>
+static void secure_zero(T& object)
+{
+	memset(&object, 0, sizeof(T));
+	asm volatile("" :: "r"(&object) : "memory");
+}
+
+// Replaces the key with the first half of a block and returns the second half,
+// so output that was already handed out cannot be reconstructed from the state
+static void advance_state(_getrandom_state_t& state, uint32_t (&out)[ChaCha20::key_words])
+{
+	uint32_t block[ChaCha20::block_words];
+	ChaCha20::block(state.key, 0, 0, block);
+	memcpy(state.key, block, sizeof(state.key));
+	memcpy(out, block + ChaCha20::key_words, sizeof(out));
+	secure_zero(block);
+}
+
+// Takes a new key from the kernel if it has reseeded since the last one
+static bool reseed_if_needed(_getrandom_state_t& state)
+{
+	const uint64_t generation = BAN::atomic_load(g_shared_page->random_generation, BAN::memory_order_acquire);
+	if (state.generation == generation)
+		return true;
+
+	if (syscall(SYS_GETRANDOM, state.key, sizeof(state.key), 0) != sizeof(state.key))
+		return false;
+
+	state.generation = generation;
+	state.batch_left = 0;
+	return true;
+}
+
+static void generate(_getrandom_state_t& state, uint8_t* buffer, size_t length)
+{
+	// small requests are served from a batch to amortize the block function
+	if (length <= sizeof(state.batch))
+	{
+		if (state.batch_left < length)
+		{
+			uint32_t batch[ChaCha20::key_words];
+			advance_state(state, batch);
+			memcpy(state.batch, batch, sizeof(state.batch));
+			secure_zero(batch);
+			state.batch_left = sizeof(state.batch);
+		}
+
+		state.batch_left -= length;
+		memcpy(buffer, state.batch + state.batch_left, length);
+		memset(state.batch + state.batch_left, 0, length);
+		return;
+	}
+
+	uint32_t key[ChaCha20::key_words];
+	advance_state(state, key);
+
+	uint32_t block[ChaCha20::block_words];
+	for (uint64_t counter = 0; length > 0; counter++)
+	{
+		ChaCha20::block(key, counter, 0, block);
+		const size_t to_copy = BAN::Math::min(length, ChaCha20::block_size);
+		memcpy(buffer, block, to_copy);
+		buffer += to_copy;
+		length -= to_copy;
+	}
+
+	secure_zero(key);
+	secure_zero(block);
+}
+
+ssize_t getrandom(void* buffer, size_t length, unsigned flags)
+{
+	if (flags & ~(GRND_NONBLOCK | GRND_RANDOM | GRND_INSECURE))
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (g_shared_page == nullptr || !(g_shared_page->features & Kernel::API::SPF_GETRANDOM))
+		return syscall(SYS_GETRANDOM, buffer, length, flags);
+
+	// a signal handler interrupted getrandom on this thread
+	auto& state = _get_uthread()->getrandom_state;
+	if (state.in_use)
+		return syscall(SYS_GETRANDOM, buffer, length, flags);
+
+	state.in_use = 1;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+
+	ssize_t result = -1;
+	if (reseed_if_needed(state))
+	{
+		generate(state, static_cast<uint8_t*>(buffer), length);
+		result = length;
+	}
+
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	state.in_use = 0;
+
+	return result;
+}
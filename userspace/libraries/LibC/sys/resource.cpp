@@ -4,8 +4,9 @@
 #include <kernel/Thread.h>
 
 #include <errno.h>
-#include <limits.h>
 #include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 int getrlimit(int resource, struct rlimit* rlp)
 {
@@ -28,9 +29,7 @@ int getrlimit(int resource, struct rlimit* rlp)
 			rlp->rlim_max = BAN::numeric_limits<rlim_t>::max();
 			return 0;
 		case RLIMIT_NOFILE:
-			rlp->rlim_cur = OPEN_MAX;
-			rlp->rlim_max = OPEN_MAX;
-			return 0;
+			return syscall(SYS_GETRLIMIT, resource, rlp);
 		case RLIMIT_STACK:
 			rlp->rlim_cur = Kernel::Thread::userspace_stack_size;
 			rlp->rlim_max = Kernel::Thread::userspace_stack_size;
@@ -64,6 +63,9 @@ int getrusage(int who, struct rusage* r_usage)
 
 int setrlimit(int resource, const struct rlimit* rlp)
 {
+	if (resource == RLIMIT_NOFILE)
+		return syscall(SYS_SETRLIMIT, resource, rlp);
+
 	dwarnln("TODO: setrlimit({}, {})", resource, rlp);
 	errno = ENOTSUP;
 	return -1;
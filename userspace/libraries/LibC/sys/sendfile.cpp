@@ -0,0 +1,10 @@
+#include <pthread.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+ssize_t sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+	pthread_testcancel();
+	return syscall(SYS_SENDFILE, out_fd, in_fd, offset, count);
+}
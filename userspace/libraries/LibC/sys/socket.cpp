@@ -73,6 +73,12 @@ ssize_t recvmsg(int socket, struct msghdr* message, int flags)
 	return syscall(SYS_RECVMSG, socket, message, flags);
 }
 
+int recvmmsg(int socket, struct mmsghdr* messages, unsigned int vlen, int flags, struct timespec* timeout)
+{
+	pthread_testcancel();
+	return syscall(SYS_RECVMMSG, socket, messages, vlen, flags, timeout);
+}
+
 ssize_t send(int socket, const void* buffer, size_t length, int flags)
 {
 	// cancellation point in sendto
@@ -107,6 +113,12 @@ ssize_t sendmsg(int socket, const struct msghdr* message, int flags)
 	return syscall(SYS_SENDMSG, socket, message, flags);
 }
 
+int sendmmsg(int socket, struct mmsghdr* messages, unsigned int vlen, int flags)
+{
+	pthread_testcancel();
+	return syscall(SYS_SENDMMSG, socket, messages, vlen, flags);
+}
+
 int socket(int domain, int type, int protocol)
 {
 	return syscall(SYS_SOCKET, domain, type, protocol);
@@ -0,0 +1,8 @@
+#include <sys/syscall.h>
+#include <sys/syscall_trace.h>
+#include <unistd.h>
+
+int syscall_trace(int target, pid_t id, int enable)
+{
+	return syscall(SYS_SYSCALL_TRACE, target, id, enable);
+}
@@ -21,14 +21,9 @@ char* tzname[2];
 
 extern volatile Kernel::API::SharedPage* g_shared_page;
 
-int clock_gettime(clockid_t clock_id, struct timespec* tp)
+// returns nanoseconds since boot and the index of the processor it was read on
+static uint64_t shared_page_ns_since_boot(uint32_t& cpu)
 {
-	if (clock_id != CLOCK_MONOTONIC && clock_id != CLOCK_REALTIME)
-		return syscall(SYS_CLOCK_GETTIME, clock_id, tp);
-
-	if (g_shared_page == nullptr || !(g_shared_page->features & Kernel::API::SPF_GETTIME))
-		return syscall(SYS_CLOCK_GETTIME, clock_id, tp);
-
 	uint32_t mult;
 	int8_t   shift;
 	uint64_t last_ns;
@@ -50,7 +45,6 @@ int clock_gettime(clockid_t clock_id, struct timespec* tp)
 read_tsc_info:
 	if (g_shared_page->features & Kernel::API::SPF_RDTSCP)
 	{
-		uint32_t cpu;
 		curr_tsc = __builtin_ia32_rdtscp(&cpu);
 		read_tsc_info(g_shared_page->cpus[cpu].gettime_local);
 	}
@@ -62,7 +56,8 @@ read_tsc_info:
 		asm volatile("lsl %1, %0" : "=r"(cpu2) : "r"(g_shared_page->gdt_cpu_offset));
 		if (cpu1 != cpu2)
 			continue;
-		read_tsc_info(g_shared_page->cpus[cpu1].gettime_local);
+		cpu = cpu1;
+		read_tsc_info(g_shared_page->cpus[cpu].gettime_local);
 		break;
 	}
 
@@ -79,7 +74,87 @@ read_tsc_info:
 	clock_ns = (clock_ns * mult) >> 32;
 	clock_ns += last_ns;
 
-	if (clock_id == CLOCK_REALTIME)
+	return clock_ns;
+}
+
+static uint64_t shared_page_coarse_ns_since_boot()
+{
+	const auto& sgettime = g_shared_page->gettime_shared;
+
+	uint32_t seq1, seq2;
+	uint64_t coarse_ns;
+	do {
+		seq1      = BAN::atomic_load(sgettime.coarse_seq, BAN::memory_order_acquire);
+		coarse_ns = sgettime.coarse_ns;
+		seq2      = BAN::atomic_load(sgettime.coarse_seq, BAN::memory_order_acquire);
+	} while (seq1 != seq2 || (seq1 & 1));
+
+	return coarse_ns;
+}
+
+// returns false if cpu time cannot be determined without a syscall
+static bool shared_page_cpu_time_ns(clockid_t clock_id, uint64_t& cpu_time_ns)
+{
+	uint32_t cpu;
+	const uint64_t current_ns = shared_page_ns_since_boot(cpu);
+
+	const auto& cputime = g_shared_page->cpus[cpu].cputime;
+
+	uint32_t seq1, seq2;
+	uint32_t tid;
+	uint32_t flags;
+	uint64_t total_ns;
+	uint64_t start_ns;
+	do {
+		seq1     = BAN::atomic_load(cputime.seq, BAN::memory_order_acquire);
+		tid      = cputime.tid;
+		flags    = cputime.flags;
+		total_ns = cputime.total_ns;
+		start_ns = cputime.start_ns;
+		seq2     = BAN::atomic_load(cputime.seq, BAN::memory_order_acquire);
+	} while (seq1 != seq2 || (seq1 & 1));
+
+	// we got migrated after reading the time
+	if (tid != static_cast<uint32_t>(pthread_self()->id))
+		return false;
+	if (clock_id == CLOCK_PROCESS_CPUTIME_ID && !(flags & Kernel::API::SPC_SINGLE_THREADED))
+		return false;
+
+	cpu_time_ns = total_ns;
+	if (current_ns > start_ns)
+		cpu_time_ns += current_ns - start_ns;
+	return true;
+}
+
+int clock_gettime(clockid_t clock_id, struct timespec* tp)
+{
+	if (g_shared_page == nullptr || !(g_shared_page->features & Kernel::API::SPF_GETTIME))
+		return syscall(SYS_CLOCK_GETTIME, clock_id, tp);
+
+	uint64_t clock_ns;
+	switch (clock_id)
+	{
+		case CLOCK_MONOTONIC:
+		case CLOCK_REALTIME:
+		{
+			uint32_t cpu;
+			clock_ns = shared_page_ns_since_boot(cpu);
+			break;
+		}
+		case CLOCK_MONOTONIC_COARSE:
+		case CLOCK_REALTIME_COARSE:
+			clock_ns = shared_page_coarse_ns_since_boot();
+			break;
+		case CLOCK_PROCESS_CPUTIME_ID:
+		case CLOCK_THREAD_CPUTIME_ID:
+			if (!shared_page_cpu_time_ns(clock_id, clock_ns))
+				return syscall(SYS_CLOCK_GETTIME, clock_id, tp);
+			break;
+		default:
+			return syscall(SYS_CLOCK_GETTIME, clock_id, tp);
+	}
+
+	if (clock_id == CLOCK_REALTIME || clock_id == CLOCK_REALTIME_COARSE)
 	{
 		const auto& sgettime = g_shared_page->gettime_shared;
 		clock_ns += sgettime.realtime_s * 1'000'000'000 + sgettime.realtime_ns;
@@ -95,10 +170,30 @@ read_tsc_info:
 
 int clock_getres(clockid_t clock_id, struct timespec* res)
 {
-	(void)clock_id;
-	res->tv_sec = 0;
-	res->tv_nsec = 10;
-	dprintln("TODO: clock_getres");
+	long resolution_ns;
+	switch (clock_id)
+	{
+		case CLOCK_MONOTONIC:
+		case CLOCK_REALTIME:
+		case CLOCK_PROCESS_CPUTIME_ID:
+		case CLOCK_THREAD_CPUTIME_ID:
+			resolution_ns = 1;
+			break;
+		case CLOCK_MONOTONIC_COARSE:
+		case CLOCK_REALTIME_COARSE:
+			resolution_ns = g_shared_page ? g_shared_page->gettime_shared.coarse_resolution_ns : 1'000'000;
+			break;
+		default:
+			errno = EINVAL;
+			return -1;
+	}
+
+	if (res != nullptr)
+	{
+		res->tv_sec = 0;
+		res->tv_nsec = resolution_ns;
+	}
+
 	return 0;
 }
 
@@ -120,7 +215,7 @@ clock_t clock(void)
 time_t time(time_t* tloc)
 {
 	timespec tp;
-	if (clock_gettime(CLOCK_REALTIME, &tp) == -1)
+	if (clock_gettime(CLOCK_REALTIME_COARSE, &tp) == -1)
 		return -1;
 	if (tloc)
 		*tloc = tp.tv_sec;
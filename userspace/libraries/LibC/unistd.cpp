@@ -16,6 +16,7 @@
 #include <sys/auxv.h>
 #include <sys/banan-os.h>
 #include <sys/ioctl.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
@@ -559,6 +560,9 @@ pid_t fork(void)
 	const pid_t pid = syscall(SYS_FORK);
 	if (pid == -1)
 		return -1;
+	// child must not continue the random stream of its parent
+	if (pid == 0)
+		memset(&_get_uthread()->getrandom_state, 0, sizeof(_getrandom_state_t));
 	_pthread_call_atfork(pid ? _PTHREAD_ATFORK_PARENT : _PTHREAD_ATFORK_CHILD);
 	return pid;
 }
@@ -674,6 +678,16 @@ int chroot(const char* path)
 	return syscall(SYS_CHROOT, path);
 }
 
+ssize_t copy_file_range(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t len, unsigned flags)
+{
+	if (flags != 0)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+	return syscall(SYS_COPY_FILE_RANGE, fd_in, off_in, fd_out, off_out, len);
+}
+
 int getpagesize(void)
 {
 	static int auxv_page_size = -1;
@@ -1139,7 +1153,13 @@ long sysconf(int name)
 		XOPEN_CASE(VERSION)
 #undef XOPEN_CASE
 
-		case _SC_OPEN_MAX:         return OPEN_MAX;
+		case _SC_OPEN_MAX:
+		{
+			rlimit limit;
+			if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+				return -1;
+			return limit.rlim_cur;
+		}
 
 		case _SC_PAGE_SIZE:
 		case _SC_PAGESIZE:         return getpagesize();
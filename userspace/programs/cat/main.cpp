@@ -1,8 +1,37 @@
 #include <fcntl.h>
 #include <stdio.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+
+bool cat_regular_file(int fd)
+{
+	off_t offset = 0;
+	while (ssize_t n_sent = sendfile(STDOUT_FILENO, fd, &offset, 1 << 30))
+	{
+		if (n_sent == -1)
+		{
+			perror("sendfile");
+			return false;
+		}
+	}
+
+	char last = '\0';
+	if (offset > 0 && pread(fd, &last, 1, offset - 1) != 1)
+	{
+		perror("pread");
+		return false;
+	}
+	if (last != '\n')
+		write(STDOUT_FILENO, "\n", 1);
+	return true;
+}
 
 bool cat_file(int fd)
 {
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+		return cat_regular_file(fd);
+
 	char last = '\0';
 	char buffer[1024];
 	while (ssize_t n_read = read(fd, buffer, sizeof(buffer)))
@@ -39,28 +39,15 @@ static int copy_file(const char* src, const char* dst)
 
 		int result = 0;
 
-		char buffer[512];
 		for (;;)
 		{
-			const ssize_t nread = read(src_fd, buffer, 512);
-			if (nread <= 0)
+			const ssize_t ncopied = copy_file_range(src_fd, nullptr, dst_fd, nullptr, 1 << 30, 0);
+			if (ncopied <= 0)
 			{
-				if (nread == -1)
+				if (ncopied == -1)
 					result = errno;
 				break;
 			}
-
-			ssize_t total_written = 0;
-			while (total_written < nread)
-			{
-				const ssize_t nwrite = write(dst_fd, buffer + total_written, nread - total_written);
-				if (nwrite < 0)
-				{
-					result = errno;
-					break;
-				}
-				total_written += nwrite;
-			}
 		}
 
 		close(src_fd);
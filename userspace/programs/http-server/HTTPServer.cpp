@@ -7,7 +7,8 @@
 #include <ctype.h>
 #include <fcntl.h>
 #include <netinet/in.h>
-#include <sys/select.h>
+#include <sys/ioring.h>
+#include <sys/sendfile.h>
 #include <sys/socket.h>
 
 static BAN::StringView status_to_brief(unsigned);
@@ -58,73 +59,99 @@ BAN::ErrorOr<void> HTTPServer::initialize(BAN::StringView root, BAN::IPv4Address
 	return {};
 }
 
+bool HTTPServer::queue_accept(ioring& ring)
+{
+	auto* sqe = ioring_get_sqe(&ring);
+	if (sqe == nullptr)
+		return false;
+	ioring_prep_accept(sqe, m_listen_socket, nullptr, nullptr, 0);
+	sqe->user_data = m_listen_socket;
+	return true;
+}
+
+bool HTTPServer::queue_receive(ioring& ring, int fd, BAN::Vector<uint8_t>& data)
+{
+	// data is received directly to the end of client's buffer
+	const size_t old_size = data.size();
+	if (data.resize(old_size + receive_size).is_error())
+		return false;
+
+	auto* sqe = ioring_get_sqe(&ring);
+	if (sqe == nullptr)
+	{
+		MUST(data.resize(old_size));
+		return false;
+	}
+	ioring_prep_read(sqe, fd, data.data() + old_size, receive_size, IORING_OFFSET_CURRENT);
+	sqe->user_data = fd;
+	return true;
+}
+
 void HTTPServer::start()
 {
 	ASSERT(m_listen_socket != -1);
 
-	while (true)
+	ioring ring;
+	if (ioring_queue_init(256, &ring, IORING_CLOEXEC) == -1)
 	{
-		fd_set fds;
-		FD_ZERO(&fds);
+		perror("ioring_queue_init");
+		return;
+	}
+	BAN::ScopeGuard _([&ring] { ioring_queue_exit(&ring); });
 
-		FD_SET(m_listen_socket, &fds);
-		int max_fd = m_listen_socket;
+	if (!queue_accept(ring))
+		return;
 
-		for (const auto& [fd, _] : m_client_data)
-		{
-			FD_SET(fd, &fds);
-			max_fd = BAN::Math::max(max_fd, fd);
-		}
-
-		if (select(max_fd + 1, &fds, nullptr, nullptr, nullptr) == -1)
+	while (true)
+	{
+		ioring_cqe* cqe;
+		if (ioring_wait_cqe(&ring, &cqe) == -1)
 		{
-			perror("select");
+			perror("ioring_wait_cqe");
 			break;
 		}
 
-		if (FD_ISSET(m_listen_socket, &fds))
-		{
-			int new_fd = accept(m_listen_socket, nullptr, nullptr);
-			if (new_fd == -1)
-			{
-				perror("accept");
-				continue;
-			}
-			MUST(m_client_data.emplace(new_fd));
-		}
+		const int fd = cqe->user_data;
+		const int result = cqe->res;
+		ioring_cqe_seen(&ring, cqe);
 
-		for (auto& [fd, data] : m_client_data)
+		if (fd == m_listen_socket)
 		{
-			if (!FD_ISSET(fd, &fds))
-				continue;
-
-			char buffer[1024];
-			int nrecv = recv(fd, buffer, sizeof(buffer), 0);
-			if (nrecv < 0)
-				perror("recv");
-			if (nrecv <= 0)
+			if (result < 0)
+				fprintf(stderr, "accept: %s\n", strerror(-result));
+			else
 			{
-				close(fd);
-				m_client_data.remove(fd);
-				break;
+				auto it_or_error = m_client_data.emplace(result);
+				if (it_or_error.is_error() || !queue_receive(ring, result, it_or_error.value()->value))
+				{
+					close(result);
+					m_client_data.remove(result);
+				}
 			}
 
-			size_t old_size = data.size();
-			if (data.resize(old_size + nrecv).is_error())
-			{
-				close(fd);
-				m_client_data.remove(fd);
+			if (!queue_accept(ring))
 				break;
-			}
+			continue;
+		}
 
-			memcpy(data.data() + old_size, buffer, nrecv);
+		auto it = m_client_data.find(fd);
+		ASSERT(it != m_client_data.end());
+		auto& data = it->value;
 
-			if (!handle_all_requests(fd, data))
-			{
-				close(fd);
-				m_client_data.remove(fd);
-				break;
-			}
+		if (result < 0)
+			fprintf(stderr, "recv: %s\n", strerror(-result));
+
+		bool keep_open = (result > 0);
+		if (keep_open)
+		{
+			MUST(data.resize(data.size() - receive_size + result));
+			keep_open = handle_all_requests(fd, data) && queue_receive(ring, fd, data);
+		}
+
+		if (!keep_open)
+		{
+			close(fd);
+			m_client_data.remove(it);
 		}
 	}
 }
@@ -219,7 +246,7 @@ BAN::ErrorOr<HTTPRequest> HTTPServer::get_http_request(BAN::Vector<uint8_t>& dat
 	return request;
 }
 
-BAN::ErrorOr<void> HTTPServer::send_http_response(int fd, unsigned status, BAN::ConstByteSpan data, BAN::StringView mime)
+BAN::ErrorOr<void> HTTPServer::send_http_header(int fd, unsigned status, size_t content_length, BAN::StringView mime)
 {
 	dprintln("HTTP/1.1 {} {}", status, status_to_brief(status));
 
@@ -227,7 +254,7 @@ BAN::ErrorOr<void> HTTPServer::send_http_response(int fd, unsigned status, BAN::
 	TRY(output.append(MUST(BAN::String::formatted("HTTP/1.1 {} {}\r\n", status, status_to_brief(status)))));
 	if (!mime.empty())
 		TRY(output.append(MUST(BAN::String::formatted("Content-Type: {}\r\n", mime))));
-	TRY(output.append(MUST(BAN::String::formatted("Content-Length: {}\r\n", data.size()))));
+	TRY(output.append(MUST(BAN::String::formatted("Content-Length: {}\r\n", content_length))));
 	TRY(output.append("\r\n"));
 
 	size_t total_sent = 0;
@@ -241,7 +268,14 @@ BAN::ErrorOr<void> HTTPServer::send_http_response(int fd, unsigned status, BAN::
 		total_sent += nsend;
 	}
 
-	total_sent = 0;
+	return {};
+}
+
+BAN::ErrorOr<void> HTTPServer::send_http_response(int fd, unsigned status, BAN::ConstByteSpan data, BAN::StringView mime)
+{
+	TRY(send_http_header(fd, status, data.size(), mime));
+
+	size_t total_sent = 0;
 	while (total_sent < data.size())
 	{
 		ssize_t nsend = send(fd, data.data() + total_sent, data.size() - total_sent, 0);
@@ -255,6 +289,23 @@ BAN::ErrorOr<void> HTTPServer::send_http_response(int fd, unsigned status, BAN::
 	return {};
 }
 
+BAN::ErrorOr<void> HTTPServer::send_http_file_response(int fd, unsigned status, int file_fd, size_t file_size, BAN::StringView mime)
+{
+	TRY(send_http_header(fd, status, file_size, mime));
+
+	off_t offset = 0;
+	while (static_cast<size_t>(offset) < file_size)
+	{
+		ssize_t nsend = sendfile(fd, file_fd, &offset, file_size - offset);
+		if (nsend == -1)
+			return BAN::Error::from_errno(errno);
+		if (nsend == 0)
+			return BAN::Error::from_errno(ECONNRESET);
+	}
+
+	return {};
+}
+
 BAN::ErrorOr<unsigned> HTTPServer::handle_request(int fd, BAN::Vector<uint8_t>& data)
 {
 	auto request_or_error = get_http_request(data);
@@ -317,14 +368,7 @@ BAN::ErrorOr<unsigned> HTTPServer::handle_request(int fd, BAN::Vector<uint8_t>&
 	if (fstat(file_fd, &file_st) == -1)
 		return 500;
 
-	BAN::Vector<uint8_t> file_data;
-	if (file_data.resize(file_st.st_size).is_error())
-		return 500;
-
-	if (read(file_fd, file_data.data(), file_data.size()) == -1)
-		return 500;
-
-	TRY(send_http_response(fd, 200, BAN::ConstByteSpan(file_data.span()), extension_to_mime(extension)));
+	TRY(send_http_file_response(fd, 200, file_fd, file_st.st_size, extension_to_mime(extension)));
 
 	return 200;
 }
@@ -7,6 +7,8 @@
 #include <BAN/StringView.h>
 #include <BAN/Vector.h>
 
+#include <sys/ioring.h>
+
 struct HTTPHeader
 {
 	BAN::StringView name;
@@ -35,13 +37,20 @@ public:
 	BAN::StringView web_root() const { return m_web_root.sv(); }
 
 private:
+	bool queue_accept(ioring&);
+	bool queue_receive(ioring&, int fd, BAN::Vector<uint8_t>& data);
+
 	BAN::ErrorOr<HTTPRequest> get_http_request(BAN::Vector<uint8_t>& data);
+	BAN::ErrorOr<void> send_http_header(int fd, unsigned status, size_t content_length, BAN::StringView mime);
 	BAN::ErrorOr<void> send_http_response(int fd, unsigned status, BAN::ConstByteSpan, BAN::StringView mime);
+	BAN::ErrorOr<void> send_http_file_response(int fd, unsigned status, int file_fd, size_t file_size, BAN::StringView mime);
 	BAN::ErrorOr<unsigned> handle_request(int fd, BAN::Vector<uint8_t>& data);
 	// Returns false if the connection should be closed
 	bool handle_all_requests(int fd, BAN::Vector<uint8_t>& data);
 
 private:
+	static constexpr size_t receive_size = 1024;
+
 	BAN::String m_web_root;
 
 	int m_listen_socket { -1 };
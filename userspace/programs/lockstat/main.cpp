@@ -0,0 +1,226 @@
+#include <BAN/Sort.h>
+#include <BAN/Vector.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/lockstat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct LockClassStats
+{
+	char name[64];
+	unsigned long long acquisitions;
+	unsigned long long contended;
+	unsigned long long wait_cycles;
+	unsigned long long hold_cycles;
+	unsigned long long max_hold_cycles;
+};
+
+struct TraceEvent
+{
+	unsigned long long timestamp_ns;
+	unsigned cpu;
+	int tid;
+	char name[32];
+	unsigned long long args[3];
+};
+
+static bool print_lock_stats()
+{
+	FILE* fp = fopen(LOCKSTAT_PROC_PATH, "r");
+	if (fp == nullptr)
+	{
+		perror(LOCKSTAT_PROC_PATH);
+		return false;
+	}
+
+	BAN::Vector<LockClassStats> classes;
+	LockClassStats stats;
+	while (fscanf(fp, "%63s %llu %llu %llu %llu %llu", stats.name, &stats.acquisitions, &stats.contended, &stats.wait_cycles, &stats.hold_cycles, &stats.max_hold_cycles) == 6)
+		MUST(classes.push_back(stats));
+	fclose(fp);
+
+	BAN::sort::sort(classes.begin(), classes.end(),
+		[](const LockClassStats& a, const LockClassStats& b) { return a.wait_cycles > b.wait_cycles; }
+	);
+
+	printf("%-24s %12s %12s %7s %14s %10s %14s %10s %12s\n",
+		"class", "acquired", "contended", "cont%", "wait cycles", "avg wait", "hold cycles", "avg hold", "max hold"
+	);
+	for (const auto& lock_class : classes)
+	{
+		printf("%-24s %12llu %12llu %6.2f%% %14llu %10llu %14llu %10llu %12llu\n",
+			lock_class.name,
+			lock_class.acquisitions,
+			lock_class.contended,
+			lock_class.acquisitions ? 100.0 * lock_class.contended / lock_class.acquisitions : 0.0,
+			lock_class.wait_cycles,
+			lock_class.contended ? lock_class.wait_cycles / lock_class.contended : 0,
+			lock_class.hold_cycles,
+			lock_class.acquisitions ? lock_class.hold_cycles / lock_class.acquisitions : 0,
+			lock_class.max_hold_cycles
+		);
+	}
+
+	return true;
+}
+
+static bool print_tracepoint_counts()
+{
+	FILE* fp = fopen(LOCKSTAT_TRACEPOINTS_PROC_PATH, "r");
+	if (fp == nullptr)
+	{
+		perror(LOCKSTAT_TRACEPOINTS_PROC_PATH);
+		return false;
+	}
+
+	printf("\n%-24s %12s\n", "tracepoint", "hits");
+
+	char name[32];
+	unsigned long long count;
+	while (fscanf(fp, "%31s %llu", name, &count) == 2)
+		printf("%-24s %12llu\n", name, count);
+	fclose(fp);
+
+	return true;
+}
+
+static bool print_trace_events()
+{
+	FILE* fp = fopen(LOCKSTAT_TRACE_PROC_PATH, "r");
+	if (fp == nullptr)
+	{
+		perror(LOCKSTAT_TRACE_PROC_PATH);
+		return false;
+	}
+
+	BAN::Vector<TraceEvent> events;
+	TraceEvent event;
+	while (fscanf(fp, "%llu %u %d %31s %llu %llu %llu", &event.timestamp_ns, &event.cpu, &event.tid, event.name, &event.args[0], &event.args[1], &event.args[2]) == 7)
+		MUST(events.push_back(event));
+	fclose(fp);
+
+	// every processor records to its own ring, merge them to one timeline
+	BAN::sort::sort(events.begin(), events.end(),
+		[](const TraceEvent& a, const TraceEvent& b) { return a.timestamp_ns < b.timestamp_ns; }
+	);
+
+	printf("\n%16s %4s %6s %-16s %s\n", "time", "cpu", "tid", "tracepoint", "arguments");
+	for (const auto& event : events)
+	{
+		printf("%6llu.%09llu %4u %6d %-16s 0x%llx 0x%llx 0x%llx\n",
+			event.timestamp_ns / 1'000'000'000,
+			event.timestamp_ns % 1'000'000'000,
+			event.cpu, event.tid, event.name,
+			event.args[0], event.args[1], event.args[2]
+		);
+	}
+
+	return true;
+}
+
+static int run_program(char** argv)
+{
+	if (lockstat(LOCKSTAT_RESET) == -1 || lockstat(LOCKSTAT_ENABLE) == -1)
+	{
+		perror("lockstat");
+		return -1;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return -1;
+	}
+	if (pid == 0)
+	{
+		execvp(argv[0], argv);
+		perror(argv[0]);
+		exit(127);
+	}
+
+	int status;
+	while (waitpid(pid, &status, 0) == -1)
+		continue;
+
+	lockstat(LOCKSTAT_DISABLE);
+
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	if (WIFSIGNALED(status))
+		return 128 + WTERMSIG(status);
+	return 0;
+}
+
+static void usage(const char* argv0, int ret)
+{
+	FILE* fout = ret ? stderr : stdout;
+	fprintf(fout, "usage: %s [OPTION]... [PROGRAM [ARGS]...]\n", argv0);
+	fprintf(fout, "  show kernel lock contention statistics and tracepoint hits. if PROGRAM is\n");
+	fprintf(fout, "  given, statistics are reset and collected only while it runs\n");
+	fprintf(fout, "OPTIONS:\n");
+	fprintf(fout, "  -e, --enable   start collecting statistics\n");
+	fprintf(fout, "  -d, --disable  stop collecting statistics\n");
+	fprintf(fout, "  -r, --reset    zero all statistics\n");
+	fprintf(fout, "  -t, --trace    also print the recent tracepoint events\n");
+	fprintf(fout, "  -h, --help     show this message and exit\n");
+	exit(ret);
+}
+
+int main(int argc, char** argv)
+{
+	int command = -1;
+	bool show_trace = false;
+
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--enable") == 0)
+			command = LOCKSTAT_ENABLE;
+		else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--disable") == 0)
+			command = LOCKSTAT_DISABLE;
+		else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--reset") == 0)
+			command = LOCKSTAT_RESET;
+		else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--trace") == 0)
+			show_trace = true;
+		else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+			usage(argv[0], 0);
+		else
+		{
+			fprintf(stderr, "unrecognized option '%s'\n", argv[i]);
+			usage(argv[0], 1);
+		}
+	}
+
+	if (command != -1)
+	{
+		if (i < argc)
+			usage(argv[0], 1);
+		if (lockstat(command) == -1)
+		{
+			perror("lockstat");
+			return 1;
+		}
+		return 0;
+	}
+
+	int ret = 0;
+	if (i < argc)
+	{
+		ret = run_program(argv + i);
+		if (ret == -1)
+			return 1;
+	}
+
+	if (!print_lock_stats())
+		return 1;
+	if (!print_tracepoint_counts())
+		return 1;
+	if (show_trace && !print_trace_events())
+		return 1;
+
+	return ret;
+}
@@ -0,0 +1,714 @@
+#include <BAN/HashMap.h>
+#include <BAN/Sort.h>
+#include <BAN/String.h>
+#include <BAN/Vector.h>
+
+#include <LibELF/Types.h>
+#include <LibELF/Values.h>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/profile.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace LibELF;
+
+static constexpr char s_file_magic[8] { 'B', 'A', 'N', 'P', 'E', 'R', 'F', '\0' };
+static constexpr uint32_t s_file_version = 1;
+
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t frequency_hz;
+	uint32_t reserved;
+};
+
+static volatile sig_atomic_t s_interrupted = 0;
+
+static void record_usage(const char* argv0, int ret)
+{
+	FILE* fout = ret ? stderr : stdout;
+	fprintf(fout, "usage: %s record [OPTION]... PROGRAM [ARGS]...\n", argv0);
+	fprintf(fout, "       %s record [OPTION]... -p PID\n", argv0);
+	fprintf(fout, "       %s record [OPTION]... -a\n", argv0);
+	fprintf(fout, "  sample call chains of PROGRAM, a running process or the whole system\n");
+	fprintf(fout, "OPTIONS:\n");
+	fprintf(fout, "  -F HZ     samples per second per processor, default 1000\n");
+	fprintf(fout, "  -o FILE   write samples to FILE, default perf.data\n");
+	fprintf(fout, "  -p PID    sample an already running process until SIGINT\n");
+	fprintf(fout, "  -a        sample every process, until PROGRAM exits or SIGINT\n");
+	exit(ret);
+}
+
+static void report_usage(const char* argv0, int ret)
+{
+	FILE* fout = ret ? stderr : stdout;
+	fprintf(fout, "usage: %s report [OPTION]...\n", argv0);
+	fprintf(fout, "  show where samples recorded by '%s record' were taken\n", argv0);
+	fprintf(fout, "OPTIONS:\n");
+	fprintf(fout, "  -i FILE   read samples from FILE, default perf.data\n");
+	fprintf(fout, "  -k FILE   kernel image used for kernel symbols, default /boot/banan-os.kernel\n");
+	fprintf(fout, "  -g        also show time spent in callees of each symbol\n");
+	fprintf(fout, "  -n COUNT  show at most COUNT symbols, default 40\n");
+	exit(ret);
+}
+
+static void usage(const char* argv0, int ret)
+{
+	FILE* fout = ret ? stderr : stdout;
+	fprintf(fout, "usage: %s COMMAND [ARGS]...\n", argv0);
+	fprintf(fout, "COMMANDS:\n");
+	fprintf(fout, "  record  sample call chains to a file\n");
+	fprintf(fout, "  report  summarize a recorded file\n");
+	exit(ret);
+}
+
+static bool write_all(int fd, const void* data, size_t size)
+{
+	const auto* bytes = static_cast<const uint8_t*>(data);
+	while (size)
+	{
+		const ssize_t nwrite = write(fd, bytes, size);
+		if (nwrite <= 0)
+			return false;
+		bytes += nwrite;
+		size -= nwrite;
+	}
+	return true;
+}
+
+struct RecordStats
+{
+	size_t samples { 0 };
+	size_t mappings { 0 };
+	size_t lost { 0 };
+};
+
+static bool drain_records(int profile_fd, int output_fd, RecordStats& stats)
+{
+	profile_record records[32];
+	for (;;)
+	{
+		const ssize_t nread = read(profile_fd, records, sizeof(records));
+		if (nread <= 0)
+			return true;
+
+		const size_t count = nread / sizeof(profile_record);
+		for (size_t i = 0; i < count; i++)
+		{
+			switch (records[i].type)
+			{
+				case PROFILE_RECORD_SAMPLE:  stats.samples++; break;
+				case PROFILE_RECORD_MMAP:    stats.mappings++; break;
+				case PROFILE_RECORD_DROPPED: stats.lost += records[i].dropped.count; break;
+			}
+		}
+
+		if (!write_all(output_fd, records, count * sizeof(profile_record)))
+			return false;
+	}
+}
+
+static int perf_record(int argc, char** argv)
+{
+	uint32_t frequency_hz = 1000;
+	const char* output_path = "perf.data";
+	pid_t attach_pid = -1;
+	bool system_wide = false;
+
+	int i = 2;
+	for (; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (strcmp(argv[i], "-F") == 0 && i + 1 < argc)
+			frequency_hz = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			output_path = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+			attach_pid = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-a") == 0)
+			system_wide = true;
+		else if (strcmp(argv[i], "--") == 0)
+		{
+			i++;
+			break;
+		}
+		else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+			record_usage(argv[0], 0);
+		else
+		{
+			fprintf(stderr, "unrecognized option '%s'\n", argv[i]);
+			record_usage(argv[0], 1);
+		}
+	}
+
+	const bool has_program = i < argc;
+	if (frequency_hz == 0 || attach_pid == 0)
+		record_usage(argv[0], 1);
+	if (attach_pid != -1 && (has_program || system_wide))
+		record_usage(argv[0], 1);
+	if (attach_pid == -1 && !has_program && !system_wide)
+		record_usage(argv[0], 1);
+
+	int profile_fd = open(PROFILE_DEVICE, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (profile_fd == -1)
+	{
+		perror(PROFILE_DEVICE);
+		return 1;
+	}
+
+	int output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (output_fd == -1)
+	{
+		perror(output_path);
+		return 1;
+	}
+
+	FileHeader header {};
+	memcpy(header.magic, s_file_magic, sizeof(header.magic));
+	header.version = s_file_version;
+	header.record_size = sizeof(profile_record);
+	header.frequency_hz = frequency_hz;
+	if (!write_all(output_fd, &header, sizeof(header)))
+	{
+		perror(output_path);
+		return 1;
+	}
+
+	// drop records left over from earlier sessions
+	{
+		profile_record dummy[32];
+		while (read(profile_fd, dummy, sizeof(dummy)) > 0)
+			continue;
+	}
+
+	signal(SIGINT, [](int) { s_interrupted = 1; });
+
+	// the child waits for the profiler to be started before exec so its mappings are recorded
+	int start_pipe[2] { -1, -1 };
+	pid_t child_pid = -1;
+	if (has_program)
+	{
+		if (pipe(start_pipe) == -1)
+		{
+			perror("pipe");
+			return 1;
+		}
+
+		child_pid = fork();
+		if (child_pid == -1)
+		{
+			perror("fork");
+			return 1;
+		}
+		if (child_pid == 0)
+		{
+			signal(SIGINT, SIG_DFL);
+			close(start_pipe[1]);
+			char dummy;
+			if (read(start_pipe[0], &dummy, 1) != 1)
+				exit(1);
+			close(start_pipe[0]);
+			execvp(argv[i], argv + i);
+			perror(argv[i]);
+			exit(127);
+		}
+		close(start_pipe[0]);
+	}
+
+	profile_config config {
+		.pid = system_wide ? 0 : (attach_pid != -1 ? attach_pid : child_pid),
+		.frequency_hz = frequency_hz,
+	};
+	if (ioctl(profile_fd, PROFILE_START, &config) == -1)
+	{
+		perror("PROFILE_START");
+		if (child_pid != -1)
+			kill(child_pid, SIGKILL);
+		return 1;
+	}
+
+	if (child_pid != -1)
+	{
+		const char dummy = 0;
+		write(start_pipe[1], &dummy, 1);
+		close(start_pipe[1]);
+	}
+
+	RecordStats stats;
+
+	int exit_status = 0;
+	bool write_failed = false;
+	for (;;)
+	{
+		if (!drain_records(profile_fd, output_fd, stats))
+		{
+			write_failed = true;
+			break;
+		}
+
+		if (child_pid != -1)
+		{
+			int status;
+			if (waitpid(child_pid, &status, WNOHANG) == child_pid)
+			{
+				if (WIFEXITED(status))
+					exit_status = WEXITSTATUS(status);
+				else if (WIFSIGNALED(status))
+					exit_status = 128 + WTERMSIG(status);
+				break;
+			}
+		}
+		else if (attach_pid != -1 && kill(attach_pid, 0) == -1)
+			break;
+
+		if (s_interrupted)
+			break;
+
+		usleep(10'000);
+	}
+
+	ioctl(profile_fd, PROFILE_STOP);
+
+	// samples taken just before stopping may still be in flight on other processors
+	usleep(10'000);
+	if (!write_failed && !drain_records(profile_fd, output_fd, stats))
+		write_failed = true;
+
+	close(output_fd);
+	close(profile_fd);
+
+	if (write_failed)
+	{
+		perror(output_path);
+		return 1;
+	}
+
+	fprintf(stderr, "perf: wrote %zu samples and %zu mappings to %s\n", stats.samples, stats.mappings, output_path);
+	if (stats.lost)
+		fprintf(stderr, "perf: %zu records were lost, try a lower frequency\n", stats.lost);
+
+	return exit_status;
+}
+
+struct Symbol
+{
+	uintptr_t address;
+	size_t size;
+	BAN::String name;
+};
+
+struct ElfImage
+{
+	bool valid { false };
+	BAN::String path;
+	BAN::Vector<ElfNativeProgramHeader> loads;
+	BAN::Vector<Symbol> symbols;
+
+	// converts a file offset to the address used by the symbol table
+	bool file_offset_to_address(uintptr_t offset, uintptr_t& address) const
+	{
+		for (const auto& load : loads)
+		{
+			if (offset < load.p_offset || offset >= load.p_offset + load.p_filesz)
+				continue;
+			address = offset - load.p_offset + load.p_vaddr;
+			return true;
+		}
+		return false;
+	}
+
+	const Symbol* find_symbol(uintptr_t address) const
+	{
+		size_t l = 0, r = symbols.size();
+		while (l < r)
+		{
+			const size_t mid = (l + r) / 2;
+			if (symbols[mid].address <= address)
+				l = mid + 1;
+			else
+				r = mid;
+		}
+		if (l == 0)
+			return nullptr;
+		const auto& symbol = symbols[l - 1];
+		if (address >= symbol.address + BAN::Math::max<size_t>(symbol.size, 1))
+			return nullptr;
+		return &symbol;
+	}
+};
+
+static bool read_file(const char* path, BAN::Vector<uint8_t>& data)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || data.resize(st.st_size).is_error())
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t total = 0;
+	while (total < data.size())
+	{
+		const ssize_t nread = read(fd, data.data() + total, data.size() - total);
+		if (nread <= 0)
+			break;
+		total += nread;
+	}
+
+	close(fd);
+	return total == data.size();
+}
+
+static ElfImage load_elf_image(const char* path)
+{
+	ElfImage image;
+	MUST(image.path.append(path));
+
+	BAN::Vector<uint8_t> data;
+	if (!read_file(path, data) || data.size() < sizeof(ElfNativeFileHeader))
+		return image;
+
+	const auto& file_header = *reinterpret_cast<const ElfNativeFileHeader*>(data.data());
+	if (file_header.e_ident[EI_MAG0] != ELFMAG0 || file_header.e_ident[EI_MAG1] != ELFMAG1 || file_header.e_ident[EI_MAG2] != ELFMAG2 || file_header.e_ident[EI_MAG3] != ELFMAG3)
+		return image;
+#if ARCH(x86_64)
+	if (file_header.e_ident[EI_CLASS] != ELFCLASS64)
+		return image;
+#elif ARCH(i686)
+	if (file_header.e_ident[EI_CLASS] != ELFCLASS32)
+		return image;
+#endif
+
+	const auto in_bounds = [&data](size_t offset, size_t size) {
+		return offset <= data.size() && size <= data.size() - offset;
+	};
+
+	if (!in_bounds(file_header.e_phoff, file_header.e_phnum * sizeof(ElfNativeProgramHeader)))
+		return image;
+	if (!in_bounds(file_header.e_shoff, file_header.e_shnum * sizeof(ElfNativeSectionHeader)))
+		return image;
+
+	for (size_t i = 0; i < file_header.e_phnum; i++)
+	{
+		const auto& program_header = *reinterpret_cast<const ElfNativeProgramHeader*>(data.data() + file_header.e_phoff + i * file_header.e_phentsize);
+		if (program_header.p_type == PT_LOAD)
+			MUST(image.loads.push_back(program_header));
+	}
+
+	const auto* section_headers = reinterpret_cast<const ElfNativeSectionHeader*>(data.data() + file_header.e_shoff);
+
+	// prefer the full symbol table, stripped files only have dynamic symbols
+	const ElfNativeSectionHeader* symtab = nullptr;
+	for (size_t i = 0; i < file_header.e_shnum; i++)
+	{
+		if (section_headers[i].sh_type == SHT_SYMTAB)
+			symtab = &section_headers[i];
+		else if (section_headers[i].sh_type == SHT_DYNSYM && symtab == nullptr)
+			symtab = &section_headers[i];
+	}
+
+	if (symtab != nullptr && symtab->sh_link < file_header.e_shnum)
+	{
+		const auto& strtab = section_headers[symtab->sh_link];
+		if (in_bounds(symtab->sh_offset, symtab->sh_size) && in_bounds(strtab.sh_offset, strtab.sh_size))
+		{
+			const auto* symbols = reinterpret_cast<const ElfNativeSymbol*>(data.data() + symtab->sh_offset);
+			const auto* strings = reinterpret_cast<const char*>(data.data() + strtab.sh_offset);
+			for (size_t i = 0; i < symtab->sh_size / sizeof(ElfNativeSymbol); i++)
+			{
+				const auto& symbol = symbols[i];
+				if (ELF_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_value == 0)
+					continue;
+				if (symbol.st_name >= strtab.sh_size)
+					continue;
+				Symbol entry;
+				entry.address = symbol.st_value;
+				entry.size = symbol.st_size;
+				MUST(entry.name.append(BAN::StringView(strings + symbol.st_name, strnlen(strings + symbol.st_name, strtab.sh_size - symbol.st_name))));
+				MUST(image.symbols.push_back(BAN::move(entry)));
+			}
+		}
+	}
+
+	BAN::sort::sort(image.symbols.begin(), image.symbols.end(),
+		[](const Symbol& a, const Symbol& b) { return a.address < b.address; }
+	);
+
+	image.valid = true;
+	return image;
+}
+
+struct Mapping
+{
+	pid_t pid;
+	uintptr_t address;
+	size_t size;
+	uintptr_t offset;
+	BAN::String path;
+};
+
+class Symbolizer
+{
+public:
+	Symbolizer(const char* kernel_path)
+		: m_kernel_path(kernel_path)
+	{ }
+
+	void add_mapping(const profile_record& record)
+	{
+		Mapping mapping;
+		mapping.pid = record.pid;
+		mapping.address = record.map.address;
+		mapping.size = record.map.size;
+		mapping.offset = record.map.offset;
+		MUST(mapping.path.append(record.map.path));
+		MUST(m_mappings.push_back(BAN::move(mapping)));
+	}
+
+	// Returns "symbol [dso]" for the address or a best effort description if the symbol is unknown
+	BAN::String symbolize(pid_t pid, uintptr_t address, bool is_kernel)
+	{
+		if (is_kernel)
+		{
+			const auto& kernel = image(m_kernel_path);
+			if (const auto* symbol = kernel.find_symbol(address))
+				return MUST(BAN::String::formatted("{} [kernel]", symbol->name));
+			return MUST(BAN::String::formatted("{} [kernel]", reinterpret_cast<void*>(address)));
+		}
+
+		// later mappings replace earlier ones at the same address
+		for (size_t i = m_mappings.size(); i > 0; i--)
+		{
+			const auto& mapping = m_mappings[i - 1];
+			if (mapping.pid != pid || address < mapping.address || address >= mapping.address + mapping.size)
+				continue;
+
+			const auto& elf = image(mapping.path);
+
+			uintptr_t elf_address;
+			if (elf.file_offset_to_address(address - mapping.address + mapping.offset, elf_address))
+				if (const auto* symbol = elf.find_symbol(elf_address))
+					return MUST(BAN::String::formatted("{} [{}]", symbol->name, basename(mapping.path)));
+
+			return MUST(BAN::String::formatted("{} [{}]", reinterpret_cast<void*>(address - mapping.address + mapping.offset), basename(mapping.path)));
+		}
+
+		return MUST(BAN::String::formatted("{} [unknown]", reinterpret_cast<void*>(address)));
+	}
+
+private:
+	static BAN::StringView basename(BAN::StringView path)
+	{
+		for (size_t i = path.size(); i > 0; i--)
+			if (path[i - 1] == '/')
+				return path.substring(i);
+		return path;
+	}
+
+	const ElfImage& image(BAN::StringView path)
+	{
+		for (const auto& image : m_images)
+			if (image.path == path)
+				return image;
+		MUST(m_images.push_back(load_elf_image(BAN::String(path).data())));
+		const auto& image = m_images.back();
+		if (!image.valid)
+			fprintf(stderr, "perf: could not load symbols from %.*s\n", static_cast<int>(path.size()), path.data());
+		return image;
+	}
+
+private:
+	const char* m_kernel_path;
+	BAN::Vector<Mapping> m_mappings;
+	BAN::Vector<ElfImage> m_images;
+};
+
+struct SymbolCount
+{
+	size_t self { 0 };
+	size_t children { 0 };
+};
+
+static int perf_report(int argc, char** argv)
+{
+	const char* input_path = "perf.data";
+	const char* kernel_path = "/boot/banan-os.kernel";
+	bool show_children = false;
+	size_t max_rows = 40;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+			input_path = argv[++i];
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+			kernel_path = argv[++i];
+		else if (strcmp(argv[i], "-g") == 0)
+			show_children = true;
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			max_rows = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+			report_usage(argv[0], 0);
+		else
+		{
+			fprintf(stderr, "unrecognized option '%s'\n", argv[i]);
+			report_usage(argv[0], 1);
+		}
+	}
+
+	BAN::Vector<uint8_t> data;
+	if (!read_file(input_path, data))
+	{
+		perror(input_path);
+		return 1;
+	}
+
+	if (data.size() < sizeof(FileHeader))
+	{
+		fprintf(stderr, "%s: not a perf file\n", input_path);
+		return 1;
+	}
+
+	const auto& header = *reinterpret_cast<const FileHeader*>(data.data());
+	if (memcmp(header.magic, s_file_magic, sizeof(s_file_magic)) != 0 || header.version != s_file_version || header.record_size != sizeof(profile_record))
+	{
+		fprintf(stderr, "%s: not a perf file or recorded with an incompatible version\n", input_path);
+		return 1;
+	}
+
+	const auto* records = reinterpret_cast<const profile_record*>(data.data() + sizeof(FileHeader));
+	const size_t record_count = (data.size() - sizeof(FileHeader)) / sizeof(profile_record);
+
+	// mappings are recorded before the samples that use them, but records from
+	// different processors are not ordered so collect all of them first
+	Symbolizer symbolizer(kernel_path);
+	for (size_t i = 0; i < record_count; i++)
+		if (records[i].type == PROFILE_RECORD_MMAP)
+			symbolizer.add_mapping(records[i]);
+
+	BAN::HashMap<BAN::String, SymbolCount> counts;
+	size_t total_samples = 0;
+	size_t idle_samples = 0;
+	size_t kernel_samples = 0;
+	size_t lost_records = 0;
+
+	BAN::Vector<BAN::String> chain;
+	for (size_t i = 0; i < record_count; i++)
+	{
+		const auto& record = records[i];
+		if (record.type == PROFILE_RECORD_DROPPED)
+			lost_records += record.dropped.count;
+		if (record.type != PROFILE_RECORD_SAMPLE)
+			continue;
+
+		total_samples++;
+		if (record.sample.flags & PROFILE_SAMPLE_IDLE)
+		{
+			idle_samples++;
+			continue;
+		}
+		if (record.sample.kernel_depth)
+			kernel_samples++;
+
+		chain.clear();
+		const uint32_t kernel_depth = BAN::Math::min<uint32_t>(record.sample.kernel_depth, PROFILE_MAX_DEPTH);
+		const uint32_t user_depth = BAN::Math::min<uint32_t>(record.sample.user_depth, PROFILE_MAX_DEPTH);
+		for (uint32_t j = 0; j < kernel_depth; j++)
+			MUST(chain.push_back(symbolizer.symbolize(record.pid, record.sample.kernel_stack[j], true)));
+		for (uint32_t j = 0; j < user_depth; j++)
+			MUST(chain.push_back(symbolizer.symbolize(record.pid, record.sample.user_stack[j], false)));
+		if (chain.empty())
+			continue;
+
+		for (size_t j = 0; j < chain.size(); j++)
+		{
+			// recursive functions are counted once per sample
+			bool seen = false;
+			for (size_t k = 0; k < j && !seen; k++)
+				seen = (chain[k] == chain[j]);
+			if (seen)
+				continue;
+
+			auto it = counts.find(chain[j]);
+			if (it == counts.end())
+				it = MUST(counts.emplace(chain[j]));
+			if (j == 0)
+				it->value.self++;
+			it->value.children++;
+		}
+	}
+
+	if (total_samples == 0)
+	{
+		fprintf(stderr, "%s: no samples\n", input_path);
+		return 1;
+	}
+
+	struct Row
+	{
+		const BAN::String* name;
+		SymbolCount count;
+	};
+	BAN::Vector<Row> rows;
+	for (const auto& [name, count] : counts)
+		MUST(rows.push_back({ &name, count }));
+
+	BAN::sort::sort(rows.begin(), rows.end(),
+		[show_children](const Row& a, const Row& b) {
+			if (show_children && a.count.children != b.count.children)
+				return a.count.children > b.count.children;
+			return a.count.self > b.count.self;
+		}
+	);
+
+	printf("# %zu samples at %u Hz, %zu in kernel, %zu idle", total_samples, header.frequency_hz, kernel_samples, idle_samples);
+	if (lost_records)
+		printf(", %zu records lost", lost_records);
+	printf("\n#\n");
+
+	if (show_children)
+		printf("# children     self  symbol\n");
+	else
+		printf("#     self  samples  symbol\n");
+
+	for (size_t i = 0; i < rows.size() && i < max_rows; i++)
+	{
+		const auto& row = rows[i];
+		if (!show_children && row.count.self == 0)
+			break;
+		const double self = 100.0 * row.count.self / total_samples;
+		if (show_children)
+			printf("  %7.2f%% %7.2f%%  %s\n", 100.0 * row.count.children / total_samples, self, row.name->data());
+		else
+			printf("  %7.2f%% %8zu  %s\n", self, row.count.self, row.name->data());
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+		usage(argv[0], 1);
+
+	if (strcmp(argv[1], "record") == 0)
+		return perf_record(argc, argv);
+	if (strcmp(argv[1], "report") == 0)
+		return perf_report(argc, argv);
+	if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)
+		usage(argv[0], 0);
+
+	fprintf(stderr, "unknown command '%s'\n", argv[1]);
+	usage(argv[0], 1);
+}
@@ -0,0 +1,356 @@
+#include <BAN/Sort.h>
+#include <BAN/Vector.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/syscall_trace.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr const char* s_syscall_names[] {
+#define O(enum, name) #name,
+	__SYSCALL_LIST(O)
+#undef O
+};
+
+// bucket i counts calls that took [2^(i-1), 2^i) microseconds, bucket 0 calls under 1 us
+static constexpr size_t s_histogram_buckets = 24;
+
+struct SyscallStats
+{
+	uint64_t calls;
+	uint64_t errors;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint64_t histogram[s_histogram_buckets];
+};
+static SyscallStats s_stats[__SYSCALL_COUNT];
+
+static BAN::Vector<pid_t> s_traced_pids;
+static uint64_t s_dropped_events = 0;
+static bool s_summary = false;
+static FILE* s_output = stderr;
+
+static volatile sig_atomic_t s_interrupted = 0;
+
+static const char* syscall_name(int syscall)
+{
+	if (syscall < 0 || syscall >= __SYSCALL_COUNT)
+		return "unknown";
+	return s_syscall_names[syscall];
+}
+
+static bool is_traced_pid(pid_t pid)
+{
+	for (pid_t traced : s_traced_pids)
+		if (traced == pid)
+			return true;
+	return false;
+}
+
+static void print_event(const syscall_trace_event& event)
+{
+	fprintf(s_output, "[%d:%d] %s(0x%lx, 0x%lx, 0x%lx, 0x%lx, 0x%lx) = ",
+		event.pid, event.tid, syscall_name(event.syscall),
+		event.args[0], event.args[1], event.args[2], event.args[3], event.args[4]
+	);
+	if (event.ret < 0 && event.ret >= -4095)
+		fprintf(s_output, "-1 %s (%s)", strerrorname_np(-event.ret), strerror(-event.ret));
+	else
+		fprintf(s_output, "%ld", event.ret);
+
+	const uint64_t duration_ns = event.exit_ns - event.entry_ns;
+	fprintf(s_output, " <%llu.%06llu>\n",
+		static_cast<unsigned long long>(duration_ns / 1'000'000'000),
+		static_cast<unsigned long long>(duration_ns / 1'000 % 1'000'000)
+	);
+}
+
+static void account_event(const syscall_trace_event& event)
+{
+	if (event.syscall < 0 || event.syscall >= __SYSCALL_COUNT)
+		return;
+
+	const uint64_t duration_ns = event.exit_ns - event.entry_ns;
+
+	auto& stats = s_stats[event.syscall];
+	stats.calls++;
+	if (event.ret < 0 && event.ret >= -4095)
+		stats.errors++;
+	stats.total_ns += duration_ns;
+	if (duration_ns > stats.max_ns)
+		stats.max_ns = duration_ns;
+
+	size_t bucket = 0;
+	for (uint64_t us = duration_ns / 1000; us && bucket < s_histogram_buckets - 1; us >>= 1)
+		bucket++;
+	stats.histogram[bucket]++;
+}
+
+static void handle_event(const syscall_trace_event& event)
+{
+	if (event.syscall == SYSCALL_TRACE_DROPPED)
+	{
+		s_dropped_events += event.args[0];
+		return;
+	}
+
+	// the device reports every traced process in the system, only
+	// look at the ones we started or attached to and their children
+	if (!is_traced_pid(event.pid))
+		return;
+
+	if (event.syscall == SYS_FORK && event.ret > 0 && !is_traced_pid(event.ret))
+		MUST(s_traced_pids.push_back(event.ret));
+
+	if (s_summary)
+		account_event(event);
+	else
+		print_event(event);
+}
+
+static void drain_events(int fd)
+{
+	syscall_trace_event events[64];
+	for (;;)
+	{
+		const ssize_t nread = read(fd, events, sizeof(events));
+		if (nread <= 0)
+			return;
+		for (size_t i = 0; i < nread / sizeof(syscall_trace_event); i++)
+			handle_event(events[i]);
+	}
+}
+
+static void print_histogram(const SyscallStats& stats)
+{
+	size_t first = 0;
+	while (stats.histogram[first] == 0)
+		first++;
+	size_t last = s_histogram_buckets - 1;
+	while (stats.histogram[last] == 0)
+		last--;
+
+	uint64_t max_count = 0;
+	for (size_t i = first; i <= last; i++)
+		if (stats.histogram[i] > max_count)
+			max_count = stats.histogram[i];
+
+	for (size_t i = first; i <= last; i++)
+	{
+		const unsigned long long low  = i ? 1ull << (i - 1) : 0;
+		const unsigned long long high = 1ull << i;
+
+		char bar[41] {};
+		const size_t bar_len = stats.histogram[i] * 40 / max_count;
+		memset(bar, '#', bar_len);
+
+		if (i == s_histogram_buckets - 1)
+			fprintf(s_output, "    %8llu+         us %10llu |%s\n", low, static_cast<unsigned long long>(stats.histogram[i]), bar);
+		else
+			fprintf(s_output, "    %8llu-%-8llu us %10llu |%s\n", low, high, static_cast<unsigned long long>(stats.histogram[i]), bar);
+	}
+}
+
+static void print_summary()
+{
+	BAN::Vector<int> syscalls;
+	uint64_t total_ns = 0;
+	uint64_t total_calls = 0;
+	uint64_t total_errors = 0;
+	for (int i = 0; i < __SYSCALL_COUNT; i++)
+	{
+		if (s_stats[i].calls == 0)
+			continue;
+		MUST(syscalls.push_back(i));
+		total_ns += s_stats[i].total_ns;
+		total_calls += s_stats[i].calls;
+		total_errors += s_stats[i].errors;
+	}
+
+	BAN::sort::sort(syscalls.begin(), syscalls.end(),
+		[](int a, int b) { return s_stats[a].total_ns > s_stats[b].total_ns; }
+	);
+
+	fprintf(s_output, "%% time     seconds  usecs/call   max usecs      calls     errors syscall\n");
+	fprintf(s_output, "------ ----------- ----------- ----------- ---------- ---------- ----------------\n");
+	for (int syscall : syscalls)
+	{
+		const auto& stats = s_stats[syscall];
+		fprintf(s_output, "%6.2f %11.6f %11llu %11llu %10llu %10llu %s\n",
+			total_ns ? 100.0 * stats.total_ns / total_ns : 0.0,
+			stats.total_ns / 1e9,
+			static_cast<unsigned long long>(stats.total_ns / stats.calls / 1000),
+			static_cast<unsigned long long>(stats.max_ns / 1000),
+			static_cast<unsigned long long>(stats.calls),
+			static_cast<unsigned long long>(stats.errors),
+			syscall_name(syscall)
+		);
+	}
+	fprintf(s_output, "------ ----------- ----------- ----------- ---------- ---------- ----------------\n");
+	fprintf(s_output, "100.00 %11.6f %11llu %11s %10llu %10llu total\n",
+		total_ns / 1e9,
+		static_cast<unsigned long long>(total_calls ? total_ns / total_calls / 1000 : 0),
+		"",
+		static_cast<unsigned long long>(total_calls),
+		static_cast<unsigned long long>(total_errors)
+	);
+
+	fprintf(s_output, "\nlatency histograms\n");
+	for (int syscall : syscalls)
+	{
+		fprintf(s_output, "  %s\n", syscall_name(syscall));
+		print_histogram(s_stats[syscall]);
+	}
+}
+
+static void usage(const char* argv0, int ret)
+{
+	FILE* fout = ret ? stderr : stdout;
+	fprintf(fout, "usage: %s [OPTION]... PROGRAM [ARGS]...\n", argv0);
+	fprintf(fout, "       %s [OPTION]... -p PID\n", argv0);
+	fprintf(fout, "  trace system calls of PROGRAM or an already running process\n");
+	fprintf(fout, "OPTIONS:\n");
+	fprintf(fout, "  -c, --summary  print per syscall counts, times and latency histograms instead of every call\n");
+	fprintf(fout, "  -o FILE        write output to FILE instead of stderr\n");
+	fprintf(fout, "  -p PID         attach to process PID, detach on SIGINT\n");
+	fprintf(fout, "  -h, --help     show this message and exit\n");
+	exit(ret);
+}
+
+int main(int argc, char** argv)
+{
+	pid_t attach_pid = -1;
+	const char* output_path = nullptr;
+
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i++)
+	{
+		if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--summary") == 0)
+			s_summary = true;
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			output_path = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+		{
+			char* endp;
+			attach_pid = strtol(argv[++i], &endp, 10);
+			if (*endp || attach_pid <= 0)
+			{
+				fprintf(stderr, "invalid pid '%s'\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+			usage(argv[0], 0);
+		else
+		{
+			fprintf(stderr, "unrecognized option '%s'\n", argv[i]);
+			usage(argv[0], 1);
+		}
+	}
+
+	if ((attach_pid == -1) == (i >= argc))
+		usage(argv[0], 1);
+
+	if (output_path)
+	{
+		s_output = fopen(output_path, "w");
+		if (s_output == nullptr)
+		{
+			perror(output_path);
+			return 1;
+		}
+	}
+
+	int trace_fd = open(SYSCALL_TRACE_DEVICE, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (trace_fd == -1)
+	{
+		perror(SYSCALL_TRACE_DEVICE);
+		return 1;
+	}
+
+	// drop events left over from earlier sessions
+	drain_events(trace_fd);
+	s_dropped_events = 0;
+
+	pid_t child_pid = -1;
+	if (attach_pid != -1)
+	{
+		if (syscall_trace(SYSCALL_TRACE_PROCESS, attach_pid, 1) == -1)
+		{
+			perror("syscall_trace");
+			return 1;
+		}
+		MUST(s_traced_pids.push_back(attach_pid));
+
+		signal(SIGINT, [](int) { s_interrupted = 1; });
+	}
+	else
+	{
+		child_pid = fork();
+		if (child_pid == -1)
+		{
+			perror("fork");
+			return 1;
+		}
+		if (child_pid == 0)
+		{
+			if (syscall_trace(SYSCALL_TRACE_PROCESS, getpid(), 1) == -1)
+			{
+				perror("syscall_trace");
+				exit(1);
+			}
+			execvp(argv[i], argv + i);
+			perror(argv[i]);
+			exit(127);
+		}
+		MUST(s_traced_pids.push_back(child_pid));
+	}
+
+	int exit_status = 0;
+	for (;;)
+	{
+		drain_events(trace_fd);
+
+		if (child_pid != -1)
+		{
+			int status;
+			if (waitpid(child_pid, &status, WNOHANG) == child_pid)
+			{
+				if (WIFEXITED(status))
+					exit_status = WEXITSTATUS(status);
+				else if (WIFSIGNALED(status))
+					exit_status = 128 + WTERMSIG(status);
+				break;
+			}
+		}
+		else if (s_interrupted || kill(attach_pid, 0) == -1)
+		{
+			syscall_trace(SYSCALL_TRACE_PROCESS, attach_pid, 0);
+			break;
+		}
+
+		usleep(10'000);
+	}
+
+	// events are published when the syscall returns, give the other
+	// processors a moment to finish the ones that were in flight
+	usleep(10'000);
+	drain_events(trace_fd);
+
+	if (s_summary)
+		print_summary();
+	if (s_dropped_events)
+		fprintf(stderr, "strace: %llu events were lost, trace is incomplete\n", static_cast<unsigned long long>(s_dropped_events));
+
+	if (s_output != stderr)
+		fclose(s_output);
+	close(trace_fd);
+
+	return exit_status;
+}
@@ -2,7 +2,6 @@
 #include <BAN/Sort.h>
 #include <BAN/String.h>
 #include <BAN/Vector.h>
-#include <dirent.h>
 #include <fcntl.h>
 #include <signal.h>
 #include <stdio.h>
@@ -16,6 +15,8 @@ winsize g_winsize;
 struct ProcessInfo
 {
 	pid_t pid;
+	char state;
+	size_t thread_count;
 	BAN::String virt;
 	BAN::String phys;
 	uint32_t cpu_load;
@@ -32,88 +33,86 @@ struct MemInfo
 };
 MemInfo g_meminfo;
 
-void update_process_info(uint64_t delta_ms)
+static BAN::String bytes_to_string(size_t size)
 {
-	g_process_infos.clear();
-	const auto prev_us = BAN::move(g_process_prev_us);
+	if (size < 1024)
+		return MUST(BAN::String::formatted("{}", size));
 
-	DIR* dirp = opendir("/proc");
-	if (dirp == nullptr)
-		return;
+	size = size / 1024 * 10;
 
-	const dirent* dent;
-	while ((dent = readdir(dirp)))
-	{
-		char* endp;
-		const pid_t pid = strtol(dent->d_name, &endp, 10);
-		if (*endp)
-			continue;
+	size_t suffix_idx = 0;
+	for (; size >= 10240; size /= 1024)
+		suffix_idx++;
 
-		int pid_fd = openat(dirfd(dirp), dent->d_name, O_RDONLY);
-		if (pid_fd == -1)
-			continue;
+	constexpr char suffix[] { 'K', 'M', 'G', 'T', 'P', 'E', 'Z', 'Y', 'R', 'Q' };
+	if (size >= 100)
+		return MUST(BAN::String::formatted("{}{}", size / 10, suffix[suffix_idx]));
+	return MUST(BAN::String::formatted("{}.{}{}", size / 10, size % 10, suffix[suffix_idx]));
+}
 
-		ProcessInfo info {};
-		info.pid = pid;
+// Reads stats of every process with a single read, the buffer
+// only has to grow when more processes appear than fit in it
+static bool read_process_stats(BAN::Vector<proc_stat_t>& stats)
+{
+	int fd = open(PROC_PROCESSES_PATH, O_RDONLY);
+	if (fd == -1)
+		return false;
 
-		const auto read_from = [pid_fd](const char* file, void* buffer, size_t size) {
-			int fd = openat(pid_fd, file, O_RDONLY);
-			ASSERT(fd >= 0);
-			read(fd, buffer, size);
-			close(fd);
-		};
+	// leave room for processes created since the previous read
+	MUST(stats.resize(BAN::Math::max<size_t>(stats.size() + 16, 64)));
 
+	for (;;)
+	{
+		const size_t buffer_size = stats.size() * sizeof(proc_stat_t);
+		const ssize_t nread = pread(fd, stats.data(), buffer_size, 0);
+		if (nread == -1)
+		{
+			close(fd);
+			return false;
+		}
+		if (static_cast<size_t>(nread) < buffer_size)
 		{
-			const auto bytes_to_string = [](size_t size) -> BAN::String {
-				if (size < 1024)
-					return MUST(BAN::String::formatted("{}", size));
-
-				size = size / 1024 * 10;
-
-				size_t suffix_idx = 0;
-				for (; size >= 10240; size /= 1024)
-					suffix_idx++;
-
-				constexpr char suffix[] { 'K', 'M', 'G', 'T', 'P', 'E', 'Z', 'Y', 'R', 'Q' };
-				if (size >= 100)
-					return MUST(BAN::String::formatted("{}{}", size / 10, suffix[suffix_idx]));
-				return MUST(BAN::String::formatted("{}.{}{}", size / 10, size % 10, suffix[suffix_idx]));
-			};
-
-			proc_meminfo_t meminfo;
-			read_from("meminfo", &meminfo, sizeof(meminfo));
-			info.virt = bytes_to_string(meminfo.virt_pages * meminfo.page_size);
-			info.phys = bytes_to_string(meminfo.phys_pages * meminfo.page_size);
+			MUST(stats.resize(nread / sizeof(proc_stat_t)));
+			break;
 		}
+		MUST(stats.resize(stats.size() * 2));
+	}
 
-		{
-			char buffer[32];
-			read_from("cputime", buffer, sizeof(buffer));
-			buffer[sizeof(buffer) - 1] = '\0';
+	close(fd);
+	return true;
+}
 
-			const auto cpu_us = strtoull(buffer, nullptr, 10) / 1000;
+void update_process_info(uint64_t delta_ms)
+{
+	g_process_infos.clear();
+	const auto prev_us = BAN::move(g_process_prev_us);
 
-			uint64_t cpu_delta_us = cpu_us;
-			if (auto it = prev_us.find(pid); it != prev_us.end())
-				cpu_delta_us -= it->value;
-			info.cpu_load = cpu_delta_us / delta_ms;
+	static BAN::Vector<proc_stat_t> stats;
+	if (!read_process_stats(stats))
+		return;
 
-			MUST(g_process_prev_us.insert(pid, cpu_us));
-		}
+	for (const auto& stat : stats)
+	{
+		ProcessInfo info {};
+		info.pid = stat.pid;
+		info.state = stat.state;
+		info.thread_count = stat.thread_count;
+		info.virt = bytes_to_string(stat.meminfo.virt_pages * stat.meminfo.page_size);
+		info.phys = bytes_to_string(stat.meminfo.phys_pages * stat.meminfo.page_size);
 
-		{
-			char buffer[128];
-			read_from("cmdline", buffer, sizeof(buffer));
-			buffer[sizeof(buffer) - 1] = '\0';
-			info.command = buffer;
-		}
+		const auto cpu_us = (stat.counters.user_ns + stat.counters.system_ns) / 1000;
 
-		MUST(g_process_infos.push_back(BAN::move(info)));
+		uint64_t cpu_delta_us = cpu_us;
+		if (auto it = prev_us.find(stat.pid); it != prev_us.end())
+			cpu_delta_us -= it->value;
+		info.cpu_load = cpu_delta_us / delta_ms;
 
-		close(pid_fd);
-	}
+		MUST(g_process_prev_us.insert(stat.pid, cpu_us));
+
+		info.command = stat.command;
 
-	closedir(dirp);
+		MUST(g_process_infos.push_back(BAN::move(info)));
+	}
 
 	BAN::sort::sort(g_process_infos.begin(), g_process_infos.end(), [](auto& a, auto& b) {
 		return a.cpu_load > b.cpu_load;
@@ -157,7 +156,7 @@ void render_info()
 		++header_rows
 	);
 
-	printf("\e[%zuH\e[7m  PID  VIRT  PHYS  %%CPU COMMAND\e[K\e[27m",
+	printf("\e[%zuH\e[7m  PID S  THR  VIRT  PHYS  %%CPU COMMAND\e[K\e[27m",
 		++header_rows
 	);
 
@@ -166,8 +165,10 @@ void render_info()
 	{
 		const auto& info = g_process_infos[i];
 		printf("\e[%zuH", i + header_rows + 1);
-		printf("%5d %5s %5s %3u.%01u %s",
+		printf("%5d %c %4zu %5s %5s %3u.%01u %s",
 			info.pid,
+			info.state,
+			info.thread_count,
 			info.virt.data(),
 			info.phys.data(),
 			info.cpu_load / 10, info.cpu_load % 10,
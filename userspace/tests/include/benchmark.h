@@ -0,0 +1,68 @@
+#pragma once
+
+// Timing, reporting and threading helpers shared by the tests that benchmark
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCHMARK_MAX_THREADS 8
+
+static inline uint64_t get_ns()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+}
+
+static inline void print_throughput(const char* name, uint64_t bytes, uint64_t elapsed_ns)
+{
+	if (elapsed_ns == 0)
+		elapsed_ns = 1;
+	printf("  %-28s %6llu MB/s\n", name, (unsigned long long)(bytes * 1'000'000'000ull / elapsed_ns / 1'000'000));
+}
+
+// Runs thread_main(context, index) on thread_count threads and waits for all of them.
+// Returns false if a thread could not be started or any thread_main returned false.
+static inline bool run_threads(size_t thread_count, bool (*thread_main)(void* context, size_t index), void* context)
+{
+	struct thread_info_t
+	{
+		bool (*thread_main)(void*, size_t);
+		void* context;
+		size_t index;
+		bool success;
+	};
+
+	if (thread_count > BENCHMARK_MAX_THREADS)
+		return false;
+
+	pthread_t threads[BENCHMARK_MAX_THREADS];
+	thread_info_t infos[BENCHMARK_MAX_THREADS];
+
+	size_t started = 0;
+	for (; started < thread_count; started++)
+	{
+		infos[started] = { thread_main, context, started, false };
+		const auto trampoline = [](void* arg) -> void* {
+			auto& info = *static_cast<thread_info_t*>(arg);
+			info.success = info.thread_main(info.context, info.index);
+			return nullptr;
+		};
+		if (pthread_create(&threads[started], nullptr, trampoline, &infos[started]) != 0)
+		{
+			perror("pthread_create");
+			break;
+		}
+	}
+
+	bool success = (started == thread_count);
+	for (size_t i = 0; i < started; i++)
+	{
+		pthread_join(threads[i], nullptr);
+		if (!infos[i].success)
+			success = false;
+	}
+	return success;
+}
@@ -0,0 +1,93 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ITERATIONS 1000000
+
+template<typename F>
+static void benchmark(const char* name, F func)
+{
+	const uint64_t start_ns = get_ns();
+	for (size_t i = 0; i < ITERATIONS; i++)
+		func();
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	printf("  %-32s %4llu ns/call\n", name, (unsigned long long)(elapsed_ns / ITERATIONS));
+}
+
+static bool check_clock(const char* name, clockid_t clock_id)
+{
+	timespec res;
+	if (clock_getres(clock_id, &res) == -1)
+	{
+		perror("clock_getres");
+		return false;
+	}
+
+	// userspace and syscall results should agree to within a coarse tick
+	timespec user, kernel;
+	clock_gettime(clock_id, &user);
+	syscall(SYS_CLOCK_GETTIME, clock_id, &kernel);
+
+	const int64_t user_ns = user.tv_sec * 1'000'000'000ll + user.tv_nsec;
+	const int64_t kernel_ns = kernel.tv_sec * 1'000'000'000ll + kernel.tv_nsec;
+	const int64_t diff_ns = kernel_ns - user_ns;
+
+	printf("  %-24s resolution %ld ns, syscall differs by %lld ns\n", name, res.tv_nsec, (long long)diff_ns);
+	if (diff_ns >= -2'000'000 && diff_ns <= 10'000'000)
+		return true;
+	fprintf(stderr, "  %s: userspace and syscall disagree\n", name);
+	return false;
+}
+
+static bool check_monotonic(clockid_t clock_id)
+{
+	timespec prev;
+	clock_gettime(clock_id, &prev);
+	for (size_t i = 0; i < ITERATIONS / 10; i++)
+	{
+		timespec curr;
+		clock_gettime(clock_id, &curr);
+		if (curr.tv_sec < prev.tv_sec || (curr.tv_sec == prev.tv_sec && curr.tv_nsec < prev.tv_nsec))
+		{
+			fprintf(stderr, "  clock %d went backwards\n", clock_id);
+			return false;
+		}
+		prev = curr;
+	}
+	return true;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("clocks\n");
+	const struct { const char* name; clockid_t id; } clocks[] {
+		{ "CLOCK_MONOTONIC",          CLOCK_MONOTONIC          },
+		{ "CLOCK_REALTIME",           CLOCK_REALTIME           },
+		{ "CLOCK_MONOTONIC_COARSE",   CLOCK_MONOTONIC_COARSE   },
+		{ "CLOCK_REALTIME_COARSE",    CLOCK_REALTIME_COARSE    },
+		{ "CLOCK_PROCESS_CPUTIME_ID", CLOCK_PROCESS_CPUTIME_ID },
+		{ "CLOCK_THREAD_CPUTIME_ID",  CLOCK_THREAD_CPUTIME_ID  },
+	};
+	for (const auto& clock : clocks)
+		if (!check_clock(clock.name, clock.id) || !check_monotonic(clock.id))
+			ret = 1;
+
+	printf("cost per call\n");
+	timespec ts;
+	timeval tv;
+	benchmark("clock_gettime(MONOTONIC)",        [&] { clock_gettime(CLOCK_MONOTONIC, &ts); });
+	benchmark("clock_gettime(MONOTONIC_COARSE)", [&] { clock_gettime(CLOCK_MONOTONIC_COARSE, &ts); });
+	benchmark("clock_gettime(THREAD_CPUTIME)",   [&] { clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts); });
+	benchmark("clock()",                         [&] { clock(); });
+	benchmark("time()",                          [&] { time(nullptr); });
+	benchmark("gettimeofday()",                  [&] { gettimeofday(&tv, nullptr); });
+	benchmark("syscall(SYS_CLOCK_GETTIME)",      [&] { syscall(SYS_CLOCK_GETTIME, CLOCK_MONOTONIC, &ts); });
+
+	return ret;
+}
@@ -0,0 +1,158 @@
+#include "benchmark.h"
+
+#include <BAN/Atomic.h>
+#include <BAN/Math.h>
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define IDLE_FDS 10000
+#define ROUNDS 10000
+#define EXCLUSIVE_THREADS 4
+
+static int benchmark_idle_fds()
+{
+	int epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd == -1)
+	{
+		perror("epoll_create1");
+		return 1;
+	}
+
+	// every idle pipe takes two fds
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < 2 * IDLE_FDS + 16)
+	{
+		limit.rlim_cur = BAN::Math::min<rlim_t>(2 * IDLE_FDS + 16, limit.rlim_max);
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+
+	// register as many idle pipes as we are allowed to open
+	size_t idle_fds = 0;
+	while (idle_fds < IDLE_FDS)
+	{
+		int fds[2];
+		if (pipe(fds) == -1)
+			break;
+		epoll_event event { .events = EPOLLIN, .data = { .fd = fds[0] } };
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, fds[0], &event) == -1)
+		{
+			perror("epoll_ctl");
+			return 1;
+		}
+		idle_fds++;
+	}
+
+	int active[2];
+	if (idle_fds == 0 || pipe(active) == -1)
+	{
+		perror("pipe");
+		return 1;
+	}
+
+	epoll_event event { .events = EPOLLIN, .data = { .fd = active[0] } };
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, active[0], &event) == -1)
+	{
+		perror("epoll_ctl");
+		return 1;
+	}
+
+	const uint64_t start_ns = get_ns();
+	for (size_t i = 0; i < ROUNDS; i++)
+	{
+		char byte = 'x';
+		if (write(active[1], &byte, 1) != 1)
+		{
+			perror("write");
+			return 1;
+		}
+
+		epoll_event events[16];
+		const int count = epoll_wait(epfd, events, 16, -1);
+		if (count != 1 || events[0].data.fd != active[0])
+		{
+			fprintf(stderr, "unexpected epoll_wait result %d\n", count);
+			return 1;
+		}
+
+		if (read(active[0], &byte, 1) != 1)
+		{
+			perror("read");
+			return 1;
+		}
+	}
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	printf("  %zu idle fds, 1 active: %llu ns/wakeup\n", idle_fds, (unsigned long long)(elapsed_ns / ROUNDS));
+
+	return 0;
+}
+
+static int s_exclusive_fd;
+static BAN::Atomic<uint32_t> s_exclusive_wakeups { 0 };
+
+static void* exclusive_waiter(void*)
+{
+	int epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd == -1)
+		return nullptr;
+
+	epoll_event event { .events = EPOLLIN | EPOLLEXCLUSIVE, .data = { .fd = s_exclusive_fd } };
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, s_exclusive_fd, &event) == -1)
+		return nullptr;
+
+	epoll_event events[1];
+	if (epoll_wait(epfd, events, 1, 500) == 1)
+		s_exclusive_wakeups++;
+
+	close(epfd);
+	return nullptr;
+}
+
+static int test_exclusive_wakeups()
+{
+	int fds[2];
+	if (pipe(fds) == -1)
+	{
+		perror("pipe");
+		return 1;
+	}
+	s_exclusive_fd = fds[0];
+
+	pthread_t threads[EXCLUSIVE_THREADS];
+	for (auto& thread : threads)
+		pthread_create(&thread, nullptr, exclusive_waiter, nullptr);
+
+	// give all threads time to block
+	usleep(100'000);
+
+	char byte = 'x';
+	write(fds[1], &byte, 1);
+
+	for (auto& thread : threads)
+		pthread_join(thread, nullptr);
+
+	printf("  %d exclusive waiters, %u woken up by one write\n", EXCLUSIVE_THREADS, s_exclusive_wakeups.load());
+
+	close(fds[0]);
+	close(fds[1]);
+
+	return s_exclusive_wakeups.load() == 1 ? 0 : 1;
+}
+
+int main()
+{
+	printf("EPOLLEXCLUSIVE\n");
+	if (test_exclusive_wakeups())
+		return 1;
+
+	printf("mostly idle fds\n");
+	if (benchmark_idle_fds())
+		return 1;
+
+	return 0;
+}
@@ -0,0 +1,126 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define SOCKETS 10000
+#define ROUNDS 20000
+
+static int s_sockets[SOCKETS];
+
+static bool raise_fd_limit()
+{
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == -1)
+	{
+		perror("getrlimit");
+		return false;
+	}
+
+	if (limit.rlim_cur >= SOCKETS + 64)
+		return true;
+
+	limit.rlim_cur = SOCKETS + 64;
+	if (limit.rlim_max < limit.rlim_cur)
+	{
+		fprintf(stderr, "hard fd limit %u is too low\n", limit.rlim_max);
+		return false;
+	}
+
+	if (setrlimit(RLIMIT_NOFILE, &limit) == -1)
+	{
+		perror("setrlimit");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_lowest_free_fd()
+{
+	// closing a pair from the middle of the table should make it the lowest free fds
+	const int fd0 = s_sockets[SOCKETS / 2];
+	const int fd1 = s_sockets[SOCKETS / 2 + 1];
+	close(fd0);
+	close(fd1);
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, &s_sockets[SOCKETS / 2]) == -1)
+	{
+		perror("socketpair");
+		return false;
+	}
+
+	if (s_sockets[SOCKETS / 2] != fd0 || s_sockets[SOCKETS / 2 + 1] != fd1)
+	{
+		fprintf(stderr, "expected fds %d and %d, got %d and %d\n", fd0, fd1, s_sockets[SOCKETS / 2], s_sockets[SOCKETS / 2 + 1]);
+		return false;
+	}
+
+	return true;
+}
+
+static bool reader_thread(void*, size_t index)
+{
+	// use a socket pair spread out over the whole table
+	const int fd0 = s_sockets[(index * (SOCKETS / BENCHMARK_MAX_THREADS)) & ~1];
+	const int fd1 = s_sockets[((index * (SOCKETS / BENCHMARK_MAX_THREADS)) & ~1) + 1];
+
+	for (size_t i = 0; i < ROUNDS; i++)
+	{
+		char byte = 'x';
+		if (write(fd0, &byte, 1) != 1 || read(fd1, &byte, 1) != 1)
+		{
+			perror("read/write");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool benchmark_read_throughput(size_t thread_count)
+{
+	const uint64_t start_ns = get_ns();
+	const bool success = run_threads(thread_count, reader_thread, nullptr);
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (!success)
+		return false;
+
+	const uint64_t operations = thread_count * ROUNDS * 2;
+	printf("  %zu threads: %llu ops/s\n", thread_count, (unsigned long long)(operations * 1'000'000'000 / elapsed_ns));
+	return true;
+}
+
+int main()
+{
+	if (!raise_fd_limit())
+		return 1;
+
+	for (size_t i = 0; i < SOCKETS; i += 2)
+	{
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, &s_sockets[i]) == -1)
+		{
+			fprintf(stderr, "socketpair failed after %zu sockets: ", i);
+			perror("");
+			return 1;
+		}
+	}
+	printf("opened %d sockets, highest fd %d\n", SOCKETS, s_sockets[SOCKETS - 1]);
+
+	if (!test_lowest_free_fd())
+		return 1;
+
+	printf("read/write throughput\n");
+	for (size_t thread_count = 1; thread_count <= BENCHMARK_MAX_THREADS; thread_count *= 2)
+		if (!benchmark_read_throughput(thread_count))
+			return 1;
+
+	for (int fd : s_sockets)
+		close(fd);
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include "benchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_SIZE_MIB 1024
+#define SMALL_SIZE_MIB 4
+
+struct zeroed_pages_t
+{
+	unsigned long long pages;
+	unsigned long long capacity;
+	unsigned long long hits;
+	unsigned long long misses;
+};
+
+static bool read_zeroed_pages(zeroed_pages_t& out)
+{
+	int fd = open("/proc/zeroed_pages", O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	char buffer[128];
+	const ssize_t nread = read(fd, buffer, sizeof(buffer) - 1);
+	close(fd);
+	if (nread <= 0)
+		return false;
+	buffer[nread] = '\0';
+
+	return sscanf(buffer, "%llu %llu %llu %llu", &out.pages, &out.capacity, &out.hits, &out.misses) == 4;
+}
+
+static bool benchmark(const char* name, size_t size)
+{
+	zeroed_pages_t before {}, after {};
+	const bool has_stats = read_zeroed_pages(before);
+
+	const uint64_t start_ns = get_ns();
+
+	auto* buffer = static_cast<uint8_t*>(malloc(size));
+	if (buffer == nullptr)
+	{
+		perror("malloc");
+		return false;
+	}
+	memset(buffer, 0xAB, size);
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (has_stats)
+		read_zeroed_pages(after);
+
+	free(buffer);
+
+	char full_name[32];
+	snprintf(full_name, sizeof(full_name), "%s, %zu MiB", name, size / 1024 / 1024);
+	print_throughput(full_name, size, elapsed_ns);
+	if (has_stats)
+		printf("    zeroed page pool hits %llu, misses %llu\n", after.hits - before.hits, after.misses - before.misses);
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	size_t size_mib = DEFAULT_SIZE_MIB;
+	if (argc >= 2)
+		size_mib = strtoul(argv[1], nullptr, 0);
+	if (size_mib == 0)
+	{
+		fprintf(stderr, "usage: %s [SIZE_MIB]\n", argv[0]);
+		return 1;
+	}
+
+	printf("first touch throughput of malloc + memset\n");
+
+	int ret = 0;
+
+	// give idle processors time to fill the zeroed page pool
+	sleep(1);
+	if (!benchmark("small, pool filled", SMALL_SIZE_MIB * 1024 * 1024))
+		ret = 1;
+
+	sleep(1);
+	if (!benchmark("large", size_mib * 1024 * 1024))
+		ret = 1;
+
+	return ret;
+}
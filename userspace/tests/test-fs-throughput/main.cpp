@@ -0,0 +1,165 @@
+#include "benchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TMPFS_FILE_SIZE (4 * 1024 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+#define BYTES_PER_THREAD (64 * 1024 * 1024)
+
+// file on a disk backed filesystem, repeated reads of it are served from the disk cache
+#define DEFAULT_DISK_FILE "/usr/bin/Shell"
+
+struct worker_t
+{
+	const char* path;
+	size_t file_size;
+	bool write;
+};
+
+static bool worker_main(void* context, size_t index)
+{
+	const auto& worker = static_cast<const worker_t*>(context)[index];
+
+	int fd = open(worker.path, worker.write ? O_RDWR : O_RDONLY);
+	if (fd == -1)
+	{
+		perror(worker.path);
+		return false;
+	}
+
+	auto* buffer = static_cast<uint8_t*>(malloc(CHUNK_SIZE));
+	if (buffer == nullptr)
+	{
+		perror("malloc");
+		close(fd);
+		return false;
+	}
+	memset(buffer, 0x5A, CHUNK_SIZE);
+
+	const size_t chunk_size = worker.file_size < CHUNK_SIZE ? worker.file_size : CHUNK_SIZE;
+	off_t offset = 0;
+	for (size_t total = 0; total < BYTES_PER_THREAD; total += chunk_size)
+	{
+		if (offset + chunk_size > worker.file_size)
+			offset = 0;
+		const ssize_t ret = worker.write
+			? pwrite(fd, buffer, chunk_size, offset)
+			: pread(fd, buffer, chunk_size, offset);
+		if (ret != static_cast<ssize_t>(chunk_size))
+		{
+			perror(worker.write ? "pwrite" : "pread");
+			free(buffer);
+			close(fd);
+			return false;
+		}
+		offset += chunk_size;
+	}
+
+	free(buffer);
+	close(fd);
+	return true;
+}
+
+static bool benchmark(const char* name, worker_t (&workers)[BENCHMARK_MAX_THREADS], size_t thread_count)
+{
+	const uint64_t start_ns = get_ns();
+	const bool success = run_threads(thread_count, worker_main, workers);
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (!success)
+		return false;
+
+	char full_name[32];
+	snprintf(full_name, sizeof(full_name), "%s, %zu threads", name, thread_count);
+	print_throughput(full_name, thread_count * BYTES_PER_THREAD, elapsed_ns);
+	return true;
+}
+
+static bool create_tmpfs_file(const char* path)
+{
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1)
+	{
+		perror(path);
+		return false;
+	}
+
+	static uint8_t buffer[CHUNK_SIZE];
+	for (size_t total = 0; total < TMPFS_FILE_SIZE; total += sizeof(buffer))
+	{
+		if (write(fd, buffer, sizeof(buffer)) != sizeof(buffer))
+		{
+			perror("write");
+			close(fd);
+			return false;
+		}
+	}
+
+	close(fd);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	const char* disk_file = (argc >= 2) ? argv[1] : DEFAULT_DISK_FILE;
+
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	if (processors < 1)
+		processors = 1;
+	const size_t max_threads = processors < BENCHMARK_MAX_THREADS ? processors : BENCHMARK_MAX_THREADS;
+
+	static char tmpfs_paths[BENCHMARK_MAX_THREADS][32];
+	worker_t tmpfs_workers[BENCHMARK_MAX_THREADS];
+	for (size_t i = 0; i < max_threads; i++)
+	{
+		snprintf(tmpfs_paths[i], sizeof(tmpfs_paths[i]), "/tmp/fs-throughput-%zu", i);
+		if (!create_tmpfs_file(tmpfs_paths[i]))
+			return 1;
+		tmpfs_workers[i] = { .path = tmpfs_paths[i], .file_size = TMPFS_FILE_SIZE, .write = false };
+	}
+
+	struct stat st;
+	if (stat(disk_file, &st) == -1)
+	{
+		perror(disk_file);
+		return 1;
+	}
+	if (st.st_size == 0)
+	{
+		fprintf(stderr, "%s: file is empty\n", disk_file);
+		return 1;
+	}
+
+	worker_t disk_workers[BENCHMARK_MAX_THREADS];
+	for (size_t i = 0; i < max_threads; i++)
+		disk_workers[i] = { .path = disk_file, .file_size = static_cast<size_t>(st.st_size), .write = false };
+
+	int ret = 0;
+
+	printf("file throughput, %zu threads max\n", max_threads);
+	for (size_t thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+	{
+		if (!benchmark("tmpfs read", tmpfs_workers, thread_count))
+			ret = 1;
+
+		for (size_t i = 0; i < thread_count; i++)
+			tmpfs_workers[i].write = true;
+		if (!benchmark("tmpfs write", tmpfs_workers, thread_count))
+			ret = 1;
+		for (size_t i = 0; i < thread_count; i++)
+			tmpfs_workers[i].write = false;
+
+		if (!benchmark("disk cache read", disk_workers, thread_count))
+			ret = 1;
+	}
+
+	for (size_t i = 0; i < max_threads; i++)
+		unlink(tmpfs_paths[i]);
+
+	return ret;
+}
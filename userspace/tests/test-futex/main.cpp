@@ -0,0 +1,249 @@
+#include "benchmark.h"
+
+#include <BAN/Atomic.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/futex.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define LOCK_THREADS 2
+#define LOCK_ITERATIONS 100000
+#define MAX_PROCESSES 4
+
+// returns the number of woken or requeued threads, unlike futex() which returns an errno
+static long futex_count(int op, uint32_t* addr, uint32_t value, uint32_t* addr2, uint32_t value2, uint32_t value3)
+{
+	futex_args args {
+		.addr2 = addr2,
+		.value2 = value2,
+		.value3 = value3,
+	};
+	return syscall(SYS_FUTEX, op, addr, value, nullptr, &args);
+}
+
+struct waiter_info_t
+{
+	uint32_t* addr;
+	uint32_t value;
+	uint32_t bitset;
+};
+
+static BAN::Atomic<uint32_t> s_woken { 0 };
+
+static void* waiter_thread(void* arg)
+{
+	const auto& info = *static_cast<waiter_info_t*>(arg);
+	futex_args args { .addr2 = nullptr, .value2 = 0, .value3 = info.bitset };
+	if (futex_ext(FUTEX_WAIT_BITSET_PRIVATE, info.addr, info.value, nullptr, &args) == 0)
+		s_woken++;
+	return nullptr;
+}
+
+template<size_t N>
+static void start_waiters(pthread_t (&threads)[N], waiter_info_t (&infos)[N])
+{
+	s_woken = 0;
+	for (size_t i = 0; i < N; i++)
+		pthread_create(&threads[i], nullptr, waiter_thread, &infos[i]);
+	// give all threads time to block
+	usleep(100'000);
+}
+
+template<size_t N>
+static void join_waiters(pthread_t (&threads)[N])
+{
+	for (auto& thread : threads)
+		pthread_join(thread, nullptr);
+}
+
+static bool expect(const char* what, long got, long expected)
+{
+	if (got == expected)
+		return true;
+	fprintf(stderr, "  %s: expected %ld, got %ld\n", what, expected, got);
+	return false;
+}
+
+static bool test_requeue()
+{
+	uint32_t futex1 = 0;
+	uint32_t futex2 = 0;
+
+	pthread_t threads[4];
+	waiter_info_t infos[4];
+	for (auto& info : infos)
+		info = { &futex1, 0, FUTEX_BITSET_MATCH_ANY };
+	start_waiters(threads, infos);
+
+	bool success = true;
+	success &= expect("cmp requeue with wrong value", futex_count(FUTEX_CMP_REQUEUE_PRIVATE, &futex1, 1, &futex2, 10, 1) == -1 ? errno : 0, EAGAIN);
+	success &= expect("cmp requeue", futex_count(FUTEX_CMP_REQUEUE_PRIVATE, &futex1, 1, &futex2, 10, 0), 4);
+	success &= expect("wake old address", futex_count(FUTEX_WAKE_PRIVATE, &futex1, 10, nullptr, 0, 0), 0);
+	success &= expect("wake new address", futex_count(FUTEX_WAKE_PRIVATE, &futex2, 10, nullptr, 0, 0), 3);
+
+	join_waiters(threads);
+	success &= expect("threads woken", s_woken.load(), 4);
+
+	return success;
+}
+
+static bool test_wake_op()
+{
+	uint32_t futex1 = 0;
+	uint32_t futex2 = 0;
+
+	pthread_t threads[4];
+	waiter_info_t infos[4] {
+		{ &futex1, 0, FUTEX_BITSET_MATCH_ANY },
+		{ &futex1, 0, FUTEX_BITSET_MATCH_ANY },
+		{ &futex2, 0, FUTEX_BITSET_MATCH_ANY },
+		{ &futex2, 0, FUTEX_BITSET_MATCH_ANY },
+	};
+	start_waiters(threads, infos);
+
+	bool success = true;
+	success &= expect("wake op", futex_count(FUTEX_WAKE_OP_PRIVATE, &futex1, 1, &futex2, 1, FUTEX_OP(FUTEX_OP_ADD, 5, FUTEX_OP_CMP_EQ, 0)), 2);
+	success &= expect("wake op result", futex2, 5);
+	success &= expect("wake op false comparison", futex_count(FUTEX_WAKE_OP_PRIVATE, &futex1, 1, &futex2, 1, FUTEX_OP(FUTEX_OP_SET, 0, FUTEX_OP_CMP_LT, 5)), 1);
+	success &= expect("wake op set", futex2, 0);
+	success &= expect("wake rest", futex_count(FUTEX_WAKE_PRIVATE, &futex2, 10, nullptr, 0, 0), 1);
+
+	join_waiters(threads);
+	success &= expect("threads woken", s_woken.load(), 4);
+
+	return success;
+}
+
+static bool test_bitset()
+{
+	uint32_t futex = 0;
+
+	pthread_t threads[3];
+	waiter_info_t infos[3] {
+		{ &futex, 0, 0b001 },
+		{ &futex, 0, 0b010 },
+		{ &futex, 0, 0b110 },
+	};
+	start_waiters(threads, infos);
+
+	bool success = true;
+	success &= expect("wake bitset 0b100", futex_count(FUTEX_WAKE_BITSET_PRIVATE, &futex, 10, nullptr, 0, 0b100), 1);
+	success &= expect("wake bitset 0b010", futex_count(FUTEX_WAKE_BITSET_PRIVATE, &futex, 10, nullptr, 0, 0b010), 1);
+	success &= expect("wake bitset 0b001", futex_count(FUTEX_WAKE_BITSET_PRIVATE, &futex, 10, nullptr, 0, 0b001), 1);
+
+	join_waiters(threads);
+	success &= expect("threads woken", s_woken.load(), 3);
+
+	return success;
+}
+
+// 0 unlocked, 1 locked, 2 locked with waiters
+static uint32_t s_lock;
+static uint64_t s_counter;
+
+static void lock()
+{
+	uint32_t state = 0;
+	if (BAN::atomic_compare_exchange(s_lock, state, 1))
+		return;
+	if (state != 2)
+		state = BAN::atomic_exchange(s_lock, 2);
+	while (state != 0)
+	{
+		futex(FUTEX_WAIT_PRIVATE, &s_lock, 2, nullptr);
+		state = BAN::atomic_exchange(s_lock, 2);
+	}
+}
+
+static void unlock()
+{
+	if (BAN::atomic_fetch_sub(s_lock, 1) == 1)
+		return;
+	BAN::atomic_store(s_lock, 0);
+	futex(FUTEX_WAKE_PRIVATE, &s_lock, 1, nullptr);
+}
+
+static void* lock_thread(void*)
+{
+	for (size_t i = 0; i < LOCK_ITERATIONS; i++)
+	{
+		lock();
+		s_counter++;
+		unlock();
+	}
+	return nullptr;
+}
+
+static void contend_lock()
+{
+	pthread_t threads[LOCK_THREADS];
+	for (auto& thread : threads)
+		pthread_create(&thread, nullptr, lock_thread, nullptr);
+	for (auto& thread : threads)
+		pthread_join(thread, nullptr);
+	exit(s_counter == LOCK_THREADS * LOCK_ITERATIONS ? 0 : 1);
+}
+
+static bool benchmark_contention(size_t process_count)
+{
+	pid_t pids[MAX_PROCESSES];
+
+	const uint64_t start_ns = get_ns();
+
+	for (size_t i = 0; i < process_count; i++)
+	{
+		pids[i] = fork();
+		if (pids[i] == -1)
+		{
+			perror("fork");
+			exit(1);
+		}
+		if (pids[i] == 0)
+			contend_lock();
+	}
+
+	bool success = true;
+	for (size_t i = 0; i < process_count; i++)
+	{
+		int status;
+		if (waitpid(pids[i], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			success = false;
+	}
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	const uint64_t operations = process_count * LOCK_THREADS * LOCK_ITERATIONS;
+	printf("  %zu processes: %llu lock/unlock pairs/s\n", process_count, (unsigned long long)(operations * 1'000'000'000 / elapsed_ns));
+
+	if (!success)
+		fprintf(stderr, "  lost updates or a child failed\n");
+	return success;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("FUTEX_CMP_REQUEUE\n");
+	if (!test_requeue())
+		ret = 1;
+
+	printf("FUTEX_WAKE_OP\n");
+	if (!test_wake_op())
+		ret = 1;
+
+	printf("FUTEX_WAKE_BITSET\n");
+	if (!test_bitset())
+		ret = 1;
+
+	printf("lock contention, %d threads per process\n", LOCK_THREADS);
+	for (size_t process_count = 1; process_count <= MAX_PROCESSES; process_count *= 2)
+		if (!benchmark_contention(process_count))
+			ret = 1;
+
+	return ret;
+}
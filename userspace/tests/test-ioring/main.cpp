@@ -0,0 +1,199 @@
+#include "benchmark.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioring.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CONNECTIONS 8
+#define ROUNDS 2000
+#define MESSAGE_SIZE 64
+
+static void print_result(const char* name, uint64_t start_ns, uint64_t end_ns, uint64_t syscalls)
+{
+	const uint64_t requests = (uint64_t)CONNECTIONS * ROUNDS;
+	const uint64_t duration_us = (end_ns - start_ns) / 1000;
+	printf("  %-10s %5llu.%03llu ms, %llu ns/request, %llu.%02llu syscalls/request\n", name,
+		(unsigned long long)(duration_us / 1000),
+		(unsigned long long)(duration_us % 1000),
+		(unsigned long long)((end_ns - start_ns) / requests),
+		(unsigned long long)(syscalls / requests),
+		(unsigned long long)(syscalls * 100 / requests % 100)
+	);
+}
+
+static void echo_server(const int (&fds)[CONNECTIONS])
+{
+	pollfd pfds[CONNECTIONS];
+	for (int i = 0; i < CONNECTIONS; i++)
+		pfds[i] = { .fd = fds[i], .events = POLLIN, .revents = 0 };
+
+	for (;;)
+	{
+		if (poll(pfds, CONNECTIONS, -1) == -1)
+			exit(1);
+
+		for (int i = 0; i < CONNECTIONS; i++)
+		{
+			if (!(pfds[i].revents & (POLLIN | POLLHUP)))
+				continue;
+
+			char buffer[MESSAGE_SIZE];
+			const ssize_t nrecv = recv(fds[i], buffer, sizeof(buffer), 0);
+			if (nrecv <= 0)
+				exit(0);
+			if (send(fds[i], buffer, nrecv, 0) != nrecv)
+				exit(1);
+		}
+	}
+}
+
+static bool ping_pong_syscalls(const int (&fds)[CONNECTIONS])
+{
+	char buffer[MESSAGE_SIZE] {};
+	uint64_t syscalls = 0;
+
+	const uint64_t start_ns = get_ns();
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int i = 0; i < CONNECTIONS; i++, syscalls++)
+		{
+			if (send(fds[i], buffer, sizeof(buffer), 0) != sizeof(buffer))
+			{
+				perror("send");
+				return false;
+			}
+		}
+
+		for (int i = 0; i < CONNECTIONS; i++, syscalls++)
+		{
+			if (recv(fds[i], buffer, sizeof(buffer), MSG_WAITALL) != sizeof(buffer))
+			{
+				perror("recv");
+				return false;
+			}
+		}
+	}
+	print_result("syscalls", start_ns, get_ns(), syscalls);
+
+	return true;
+}
+
+static bool ping_pong_ioring(const int (&fds)[CONNECTIONS])
+{
+	ioring ring;
+	if (ioring_queue_init(2 * CONNECTIONS, &ring, 0) == -1)
+	{
+		perror("ioring_queue_init");
+		return false;
+	}
+
+	char send_buffer[MESSAGE_SIZE] {};
+	char recv_buffers[CONNECTIONS][MESSAGE_SIZE];
+	uint64_t syscalls = 0;
+
+	bool success = true;
+
+	const uint64_t start_ns = get_ns();
+	for (int round = 0; round < ROUNDS && success; round++)
+	{
+		for (int i = 0; i < CONNECTIONS; i++)
+		{
+			ioring_prep_write(ioring_get_sqe(&ring), fds[i], send_buffer, sizeof(send_buffer), IORING_OFFSET_CURRENT);
+			ioring_prep_read(ioring_get_sqe(&ring), fds[i], recv_buffers[i], sizeof(recv_buffers[i]), IORING_OFFSET_CURRENT);
+		}
+
+		// submit the whole round and wait for all of its completions with a single syscall
+		syscalls++;
+		if (ioring_submit_and_wait(&ring, 2 * CONNECTIONS) == -1)
+		{
+			perror("ioring_submit_and_wait");
+			success = false;
+			break;
+		}
+
+		for (int i = 0; i < 2 * CONNECTIONS; i++)
+		{
+			ioring_cqe* cqe;
+			if (ioring_peek_cqe(&ring, &cqe) == -1)
+			{
+				syscalls++;
+				if (ioring_wait_cqe(&ring, &cqe) == -1)
+				{
+					perror("ioring_wait_cqe");
+					success = false;
+					break;
+				}
+			}
+
+			if (cqe->res != MESSAGE_SIZE)
+			{
+				fprintf(stderr, "unexpected result %d\n", cqe->res);
+				success = false;
+			}
+
+			ioring_cqe_seen(&ring, cqe);
+		}
+	}
+
+	if (success)
+		print_result("ioring", start_ns, get_ns(), syscalls);
+
+	ioring_queue_exit(&ring);
+	return success;
+}
+
+int main()
+{
+	int client_fds[CONNECTIONS];
+	int server_fds[CONNECTIONS];
+
+	for (int i = 0; i < CONNECTIONS; i++)
+	{
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+		{
+			perror("socketpair");
+			return 1;
+		}
+		client_fds[i] = fds[0];
+		server_fds[i] = fds[1];
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return 1;
+	}
+
+	if (pid == 0)
+	{
+		for (int i = 0; i < CONNECTIONS; i++)
+			close(client_fds[i]);
+		echo_server(server_fds);
+		exit(0);
+	}
+
+	for (int i = 0; i < CONNECTIONS; i++)
+		close(server_fds[i]);
+
+	printf("ping-pong, %d connections, %d rounds, %d byte messages\n", CONNECTIONS, ROUNDS, MESSAGE_SIZE);
+
+	int ret = 0;
+	if (!ping_pong_syscalls(client_fds))
+		ret = 1;
+	if (!ping_pong_ioring(client_fds))
+		ret = 1;
+
+	for (int i = 0; i < CONNECTIONS; i++)
+		close(client_fds[i]);
+	waitpid(pid, nullptr, 0);
+
+	return ret;
+}
@@ -0,0 +1,220 @@
+#include "benchmark.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TRANSFER_SIZE (256 * 1024 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+
+static void producer(int fd)
+{
+	static uint8_t buffer[CHUNK_SIZE];
+	for (size_t i = 0; i < sizeof(buffer); i++)
+		buffer[i] = i;
+
+	for (size_t total = 0; total < TRANSFER_SIZE;)
+	{
+		const ssize_t nwrite = write(fd, buffer, sizeof(buffer));
+		if (nwrite <= 0)
+			exit(1);
+		total += nwrite;
+	}
+	exit(0);
+}
+
+static void relay_copy(int fd_in, int fd_out)
+{
+	static uint8_t buffer[CHUNK_SIZE];
+	for (;;)
+	{
+		const ssize_t nread = read(fd_in, buffer, sizeof(buffer));
+		if (nread < 0)
+			exit(1);
+		if (nread == 0)
+			exit(0);
+		for (ssize_t nwritten = 0; nwritten < nread;)
+		{
+			const ssize_t ret = write(fd_out, buffer + nwritten, nread - nwritten);
+			if (ret <= 0)
+				exit(1);
+			nwritten += ret;
+		}
+	}
+}
+
+static void relay_splice(int fd_in, int fd_out)
+{
+	for (;;)
+	{
+		const ssize_t ret = splice(fd_in, nullptr, fd_out, nullptr, CHUNK_SIZE, 0);
+		if (ret < 0)
+			exit(1);
+		if (ret == 0)
+			exit(0);
+	}
+}
+
+static void consumer(int fd)
+{
+	static uint8_t buffer[CHUNK_SIZE];
+	size_t total = 0;
+	for (;;)
+	{
+		const ssize_t nread = read(fd, buffer, sizeof(buffer));
+		if (nread < 0)
+			exit(1);
+		if (nread == 0)
+			break;
+		for (ssize_t i = 0; i < nread; i++)
+			if (buffer[i] != static_cast<uint8_t>(total + i))
+				exit(2);
+		total += nread;
+	}
+	exit(total == TRANSFER_SIZE ? 0 : 3);
+}
+
+// producer -> relay -> relay -> consumer
+static bool benchmark_pipeline(const char* name, int pipe_size, bool use_splice)
+{
+	int fds[3][2];
+	for (auto& pipe_fds : fds)
+	{
+		if (pipe(pipe_fds) == -1)
+		{
+			perror("pipe");
+			return false;
+		}
+		if (pipe_size && fcntl(pipe_fds[0], F_SETPIPE_SZ, pipe_size) == -1)
+		{
+			perror("fcntl");
+			return false;
+		}
+	}
+
+	const uint64_t start_ns = get_ns();
+
+	pid_t pids[4];
+	for (size_t stage = 0; stage < 4; stage++)
+	{
+		pids[stage] = fork();
+		if (pids[stage] == -1)
+		{
+			perror("fork");
+			exit(1);
+		}
+		if (pids[stage] != 0)
+			continue;
+
+		const int fd_in  = (stage > 0) ? fds[stage - 1][0] : -1;
+		const int fd_out = (stage < 3) ? fds[stage][1] : -1;
+		for (auto& pipe_fds : fds)
+			for (int fd : pipe_fds)
+				if (fd != fd_in && fd != fd_out)
+					close(fd);
+
+		if (stage == 0)
+			producer(fd_out);
+		else if (stage == 3)
+			consumer(fd_in);
+		else if (use_splice)
+			relay_splice(fd_in, fd_out);
+		else
+			relay_copy(fd_in, fd_out);
+	}
+
+	for (auto& pipe_fds : fds)
+		for (int fd : pipe_fds)
+			close(fd);
+
+	bool success = true;
+	for (pid_t pid : pids)
+	{
+		int status;
+		if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			success = false;
+	}
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	print_throughput(name, TRANSFER_SIZE, elapsed_ns);
+
+	if (!success)
+		fprintf(stderr, "  %s: data was corrupted or a stage failed\n", name);
+	return success;
+}
+
+static bool test_pipe_size()
+{
+	int fds[2];
+	if (pipe(fds) == -1)
+	{
+		perror("pipe");
+		return false;
+	}
+
+	bool success = true;
+
+	if (fcntl(fds[1], F_SETPIPE_SZ, 100'000) != 102400 || fcntl(fds[0], F_GETPIPE_SZ) != 102400)
+	{
+		fprintf(stderr, "  F_SETPIPE_SZ did not round up to page size\n");
+		success = false;
+	}
+
+	// fill the pipe without blocking, it should hold exactly its capacity
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	static uint8_t buffer[4096];
+	size_t total = 0;
+	for (;;)
+	{
+		const ssize_t ret = write(fds[1], buffer, sizeof(buffer));
+		if (ret == -1 && errno == EAGAIN)
+			break;
+		if (ret <= 0)
+		{
+			perror("write");
+			success = false;
+			break;
+		}
+		total += ret;
+	}
+	if (total != 102400)
+	{
+		fprintf(stderr, "  full pipe held %zu bytes\n", total);
+		success = false;
+	}
+
+	if (fcntl(fds[1], F_SETPIPE_SZ, 4096) != -1 || errno != EBUSY)
+	{
+		fprintf(stderr, "  shrinking a full pipe did not fail with EBUSY\n");
+		success = false;
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+	return success;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("F_SETPIPE_SZ\n");
+	if (!test_pipe_size())
+		ret = 1;
+
+	printf("3 stage pipeline, %d MiB\n", TRANSFER_SIZE / 1024 / 1024);
+	if (!benchmark_pipeline("default size, read/write", 0, false))
+		ret = 1;
+	if (!benchmark_pipeline("1 MiB, read/write", 1024 * 1024, false))
+		ret = 1;
+	if (!benchmark_pipeline("default size, splice", 0, true))
+		ret = 1;
+	if (!benchmark_pipeline("1 MiB, splice", 1024 * 1024, true))
+		ret = 1;
+
+	return ret;
+}
@@ -1,8 +1,21 @@
+#include "benchmark.h"
+
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 
+#define QUEUE_SIZE 64
+#define PRODUCERS 2
+#define CONSUMERS 2
+#define ITEMS_PER_PRODUCER 100000
+
+#define RWLOCK_READERS 3
+#define RWLOCK_ITERATIONS 100000
+
+#define BARRIER_THREADS 4
+#define BARRIER_ROUNDS 10000
+
 pthread_spinlock_t spinlock;
 
 void* thread_func(void*)
@@ -30,6 +43,188 @@ void* thread_func(void*)
 	return value;
 }
 
+struct queue_t
+{
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
+	pthread_cond_t not_full = PTHREAD_COND_INITIALIZER;
+	uint64_t items[QUEUE_SIZE];
+	size_t head = 0;
+	size_t count = 0;
+	bool done = false;
+};
+
+static queue_t s_queue;
+
+static void* producer_thread(void*)
+{
+	for (uint64_t i = 1; i <= ITEMS_PER_PRODUCER; i++)
+	{
+		pthread_mutex_lock(&s_queue.mutex);
+		while (s_queue.count == QUEUE_SIZE)
+			pthread_cond_wait(&s_queue.not_full, &s_queue.mutex);
+		s_queue.items[(s_queue.head + s_queue.count) % QUEUE_SIZE] = i;
+		s_queue.count++;
+		pthread_cond_signal(&s_queue.not_empty);
+		pthread_mutex_unlock(&s_queue.mutex);
+	}
+	return nullptr;
+}
+
+static void* consumer_thread(void* arg)
+{
+	auto& sum = *static_cast<uint64_t*>(arg);
+	for (;;)
+	{
+		pthread_mutex_lock(&s_queue.mutex);
+		while (s_queue.count == 0 && !s_queue.done)
+			pthread_cond_wait(&s_queue.not_empty, &s_queue.mutex);
+		if (s_queue.count == 0)
+		{
+			pthread_mutex_unlock(&s_queue.mutex);
+			return nullptr;
+		}
+		sum += s_queue.items[s_queue.head];
+		s_queue.head = (s_queue.head + 1) % QUEUE_SIZE;
+		s_queue.count--;
+		// wakes up every producer to exercise requeueing to the mutex
+		pthread_cond_broadcast(&s_queue.not_full);
+		pthread_mutex_unlock(&s_queue.mutex);
+	}
+}
+
+static bool benchmark_producer_consumer()
+{
+	pthread_t producers[PRODUCERS];
+	pthread_t consumers[CONSUMERS];
+	uint64_t sums[CONSUMERS] {};
+
+	const uint64_t start_ns = get_ns();
+
+	for (auto& producer : producers)
+		pthread_create(&producer, nullptr, producer_thread, nullptr);
+	for (size_t i = 0; i < CONSUMERS; i++)
+		pthread_create(&consumers[i], nullptr, consumer_thread, &sums[i]);
+
+	for (auto& producer : producers)
+		pthread_join(producer, nullptr);
+
+	pthread_mutex_lock(&s_queue.mutex);
+	s_queue.done = true;
+	pthread_cond_broadcast(&s_queue.not_empty);
+	pthread_mutex_unlock(&s_queue.mutex);
+
+	uint64_t total = 0;
+	for (size_t i = 0; i < CONSUMERS; i++)
+	{
+		pthread_join(consumers[i], nullptr);
+		total += sums[i];
+	}
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	const uint64_t items = PRODUCERS * ITEMS_PER_PRODUCER;
+	printf("  %d producers, %d consumers: %llu items/s\n", PRODUCERS, CONSUMERS, (unsigned long long)(items * 1'000'000'000 / elapsed_ns));
+
+	const uint64_t expected = PRODUCERS * (uint64_t)ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2;
+	if (total == expected)
+		return true;
+	fprintf(stderr, "  expected sum %llu, got %llu\n", (unsigned long long)expected, (unsigned long long)total);
+	return false;
+}
+
+static pthread_rwlock_t s_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static uint64_t s_rwlock_values[2];
+static bool s_rwlock_torn = false;
+
+static void* rwlock_reader_thread(void*)
+{
+	for (size_t i = 0; i < RWLOCK_ITERATIONS; i++)
+	{
+		pthread_rwlock_rdlock(&s_rwlock);
+		if (s_rwlock_values[0] != s_rwlock_values[1])
+			s_rwlock_torn = true;
+		pthread_rwlock_unlock(&s_rwlock);
+	}
+	return nullptr;
+}
+
+static void* rwlock_writer_thread(void*)
+{
+	for (size_t i = 0; i < RWLOCK_ITERATIONS / 10; i++)
+	{
+		pthread_rwlock_wrlock(&s_rwlock);
+		s_rwlock_values[0]++;
+		s_rwlock_values[1]++;
+		pthread_rwlock_unlock(&s_rwlock);
+	}
+	return nullptr;
+}
+
+static bool test_rwlock()
+{
+	pthread_t readers[RWLOCK_READERS];
+	pthread_t writer;
+
+	const uint64_t start_ns = get_ns();
+
+	pthread_create(&writer, nullptr, rwlock_writer_thread, nullptr);
+	for (auto& reader : readers)
+		pthread_create(&reader, nullptr, rwlock_reader_thread, nullptr);
+	for (auto& reader : readers)
+		pthread_join(reader, nullptr);
+	pthread_join(writer, nullptr);
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	const uint64_t operations = RWLOCK_READERS * RWLOCK_ITERATIONS + RWLOCK_ITERATIONS / 10;
+	printf("  %d readers, 1 writer: %llu locks/s\n", RWLOCK_READERS, (unsigned long long)(operations * 1'000'000'000 / elapsed_ns));
+
+	if (!s_rwlock_torn && s_rwlock_values[0] == RWLOCK_ITERATIONS / 10)
+		return true;
+	fprintf(stderr, "  readers saw a partial write or writes were lost\n");
+	return false;
+}
+
+static pthread_barrier_t s_barrier;
+static unsigned s_barrier_round;
+static bool s_barrier_failed = false;
+
+static void* barrier_thread(void*)
+{
+	for (unsigned i = 0; i < BARRIER_ROUNDS; i++)
+	{
+		if (pthread_barrier_wait(&s_barrier) == PTHREAD_BARRIER_SERIAL_THREAD)
+			s_barrier_round++;
+		pthread_barrier_wait(&s_barrier);
+		if (s_barrier_round != i + 1)
+			s_barrier_failed = true;
+	}
+	return nullptr;
+}
+
+static bool test_barrier()
+{
+	pthread_barrier_init(&s_barrier, nullptr, BARRIER_THREADS);
+
+	pthread_t threads[BARRIER_THREADS];
+
+	const uint64_t start_ns = get_ns();
+
+	for (auto& thread : threads)
+		pthread_create(&thread, nullptr, barrier_thread, nullptr);
+	for (auto& thread : threads)
+		pthread_join(thread, nullptr);
+
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+	printf("  %d threads: %llu barriers/s\n", BARRIER_THREADS, (unsigned long long)(2ull * BARRIER_ROUNDS * 1'000'000'000 / elapsed_ns));
+
+	pthread_barrier_destroy(&s_barrier);
+
+	if (!s_barrier_failed && s_barrier_round == BARRIER_ROUNDS)
+		return true;
+	fprintf(stderr, "  threads passed a barrier early\n");
+	return false;
+}
+
 int main(int argc, char** argv)
 {
 	pthread_spin_init(&spinlock, 0);
@@ -57,5 +252,19 @@ int main(int argc, char** argv)
 	else
 		printf("[MAIN] thread returned %d\n", *static_cast<int*>(value));
 
-	return 0;
+	int ret = 0;
+
+	printf("producer/consumer\n");
+	if (!benchmark_producer_consumer())
+		ret = 1;
+
+	printf("rwlock\n");
+	if (!test_rwlock())
+		ret = 1;
+
+	printf("barrier\n");
+	if (!test_barrier())
+		ret = 1;
+
+	return ret;
 }
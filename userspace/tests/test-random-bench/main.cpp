@@ -0,0 +1,187 @@
+#include "benchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BULK_SIZE (64 * 1024 * 1024)
+#define CHUNK_SIZE (1024 * 1024)
+#define SMALL_ITERATIONS 1000000
+
+static bool read_dev_random(size_t bytes)
+{
+	int fd = open("/dev/urandom", O_RDONLY);
+	if (fd == -1)
+	{
+		perror("/dev/urandom");
+		return false;
+	}
+
+	static uint8_t buffer[CHUNK_SIZE];
+	for (size_t total = 0; total < bytes; total += sizeof(buffer))
+	{
+		if (read(fd, buffer, sizeof(buffer)) != sizeof(buffer))
+		{
+			perror("read");
+			close(fd);
+			return false;
+		}
+	}
+
+	close(fd);
+	return true;
+}
+
+static bool benchmark_dev_random()
+{
+	const uint64_t start_ns = get_ns();
+	if (!read_dev_random(BULK_SIZE))
+		return false;
+	print_throughput("/dev/urandom read", BULK_SIZE, get_ns() - start_ns);
+	return true;
+}
+
+static bool benchmark_getrandom_bulk(bool use_syscall)
+{
+	static uint8_t buffer[CHUNK_SIZE];
+
+	const uint64_t start_ns = get_ns();
+	for (size_t total = 0; total < BULK_SIZE; total += sizeof(buffer))
+	{
+		const ssize_t ret = use_syscall
+			? syscall(SYS_GETRANDOM, buffer, sizeof(buffer), 0)
+			: getrandom(buffer, sizeof(buffer), 0);
+		if (ret != sizeof(buffer))
+		{
+			perror("getrandom");
+			return false;
+		}
+	}
+	print_throughput(use_syscall ? "getrandom syscall, 1 MiB" : "getrandom, 1 MiB", BULK_SIZE, get_ns() - start_ns);
+	return true;
+}
+
+static bool benchmark_getrandom_small(bool use_syscall)
+{
+	uint64_t value;
+
+	const uint64_t start_ns = get_ns();
+	for (size_t i = 0; i < SMALL_ITERATIONS; i++)
+	{
+		const ssize_t ret = use_syscall
+			? syscall(SYS_GETRANDOM, &value, sizeof(value), 0)
+			: getrandom(&value, sizeof(value), 0);
+		if (ret != sizeof(value))
+		{
+			perror("getrandom");
+			return false;
+		}
+	}
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	printf("  %-28s %6llu ns/call\n", use_syscall ? "getrandom syscall, 8 bytes" : "getrandom, 8 bytes", (unsigned long long)(elapsed_ns / SMALL_ITERATIONS));
+	return true;
+}
+
+static bool benchmark_parallel(size_t thread_count)
+{
+	const uint64_t start_ns = get_ns();
+	const bool success = run_threads(thread_count,
+		[](void*, size_t) { return read_dev_random(BULK_SIZE / 4); },
+		nullptr
+	);
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (!success)
+		return false;
+
+	char name[32];
+	snprintf(name, sizeof(name), "/dev/urandom, %zu threads", thread_count);
+	print_throughput(name, thread_count * (BULK_SIZE / 4), elapsed_ns);
+	return true;
+}
+
+// parent and child must not continue the same random stream after fork
+static bool test_fork_diverges()
+{
+	uint64_t before;
+	if (getrandom(&before, sizeof(before), 0) != sizeof(before))
+		return false;
+
+	int fds[2];
+	if (pipe(fds) == -1)
+	{
+		perror("pipe");
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		uint64_t value;
+		if (getrandom(&value, sizeof(value), 0) != sizeof(value))
+			exit(1);
+		if (write(fds[1], &value, sizeof(value)) != sizeof(value))
+			exit(1);
+		exit(0);
+	}
+
+	uint64_t parent_value, child_value;
+	bool success = getrandom(&parent_value, sizeof(parent_value), 0) == sizeof(parent_value);
+	if (read(fds[0], &child_value, sizeof(child_value)) != sizeof(child_value))
+		success = false;
+
+	int status;
+	waitpid(pid, &status, 0);
+	close(fds[0]);
+	close(fds[1]);
+
+	if (success && parent_value == child_value)
+	{
+		fprintf(stderr, "  parent and child got the same value\n");
+		success = false;
+	}
+
+	return success;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("bulk throughput\n");
+	if (!benchmark_dev_random())
+		ret = 1;
+	if (!benchmark_getrandom_bulk(true))
+		ret = 1;
+	if (!benchmark_getrandom_bulk(false))
+		ret = 1;
+
+	printf("small requests\n");
+	if (!benchmark_getrandom_small(true))
+		ret = 1;
+	if (!benchmark_getrandom_small(false))
+		ret = 1;
+
+	printf("parallel throughput\n");
+	for (size_t thread_count = 1; thread_count <= BENCHMARK_MAX_THREADS; thread_count *= 2)
+		if (!benchmark_parallel(thread_count))
+			ret = 1;
+
+	printf("fork\n");
+	if (!test_fork_diverges())
+		ret = 1;
+
+	return ret;
+}
@@ -0,0 +1,281 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define GROUP_SIZE 4
+#define UDP_CLIENTS 64
+#define TCP_CONNECTIONS 32
+#define UDP_PORT 7100
+#define TCP_PORT 7101
+
+static sockaddr_in loopback_address(uint16_t port)
+{
+	sockaddr_in address {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = inet_addr("127.0.0.1");
+	return address;
+}
+
+static int bound_socket(int type, uint16_t port, bool reuse_port)
+{
+	int socket = ::socket(AF_INET, type, 0);
+	if (socket == -1)
+	{
+		perror("socket");
+		exit(1);
+	}
+
+	const int value = reuse_port;
+	if (setsockopt(socket, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)) == -1)
+	{
+		perror("setsockopt");
+		exit(1);
+	}
+
+	const auto address = loopback_address(port);
+	if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+	{
+		close(socket);
+		return -1;
+	}
+
+	return socket;
+}
+
+static bool test_bind_rules()
+{
+	bool success = true;
+
+	int first = bound_socket(SOCK_DGRAM, UDP_PORT, false);
+	if (bound_socket(SOCK_DGRAM, UDP_PORT, true) != -1 || errno != EADDRINUSE)
+	{
+		fprintf(stderr, "  bound to a port whose owner does not allow sharing\n");
+		success = false;
+	}
+	close(first);
+
+	first = bound_socket(SOCK_DGRAM, UDP_PORT, true);
+	if (bound_socket(SOCK_DGRAM, UDP_PORT, false) != -1 || errno != EADDRINUSE)
+	{
+		fprintf(stderr, "  bound to a shared port without SO_REUSEPORT\n");
+		success = false;
+	}
+	close(first);
+
+	return success;
+}
+
+// Every datagram is received exactly once and the clients are spread to more than one socket
+static bool test_udp_spreading()
+{
+	int servers[GROUP_SIZE];
+	for (auto& server : servers)
+	{
+		server = bound_socket(SOCK_DGRAM, UDP_PORT, true);
+		if (server == -1)
+		{
+			perror("bind");
+			return false;
+		}
+	}
+
+	const auto server_address = loopback_address(UDP_PORT);
+	for (uint8_t i = 0; i < UDP_CLIENTS; i++)
+	{
+		int client = socket(AF_INET, SOCK_DGRAM, 0);
+		if (client == -1 || sendto(client, &i, 1, 0, reinterpret_cast<const sockaddr*>(&server_address), sizeof(server_address)) != 1)
+		{
+			perror("sendto");
+			return false;
+		}
+		close(client);
+	}
+
+	bool received[UDP_CLIENTS] {};
+	size_t per_socket[GROUP_SIZE] {};
+	size_t total = 0;
+
+	pollfd fds[GROUP_SIZE];
+	for (size_t i = 0; i < GROUP_SIZE; i++)
+		fds[i] = { .fd = servers[i], .events = POLLIN, .revents = 0 };
+
+	while (total < UDP_CLIENTS && poll(fds, GROUP_SIZE, 1000) > 0)
+	{
+		for (size_t i = 0; i < GROUP_SIZE; i++)
+		{
+			if (!(fds[i].revents & POLLIN))
+				continue;
+			uint8_t value;
+			if (recv(servers[i], &value, 1, 0) != 1 || value >= UDP_CLIENTS || received[value])
+			{
+				fprintf(stderr, "  invalid or duplicate datagram\n");
+				return false;
+			}
+			received[value] = true;
+			per_socket[i]++;
+			total++;
+		}
+	}
+
+	for (auto server : servers)
+		close(server);
+
+	size_t used_sockets = 0;
+	for (size_t i = 0; i < GROUP_SIZE; i++)
+	{
+		printf("  socket %zu: %zu datagrams\n", i, per_socket[i]);
+		used_sockets += !!per_socket[i];
+	}
+
+	if (total != UDP_CLIENTS)
+	{
+		fprintf(stderr, "  received %zu/%d datagrams\n", total, UDP_CLIENTS);
+		return false;
+	}
+	if (used_sockets < 2)
+	{
+		fprintf(stderr, "  datagrams were not spread across sockets\n");
+		return false;
+	}
+	return true;
+}
+
+[[noreturn]] static void tcp_worker(int listener, uint8_t index)
+{
+	for (;;)
+	{
+		int client = accept(listener, nullptr, nullptr);
+		if (client == -1)
+			exit(1);
+		uint8_t value;
+		if (recv(client, &value, 1, 0) == 1)
+		{
+			const uint8_t reply[2] { value, index };
+			send(client, reply, sizeof(reply), 0);
+		}
+		close(client);
+	}
+}
+
+// Each connection is accepted by exactly one worker, which replies with its index
+static bool test_tcp_listeners()
+{
+	pid_t workers[GROUP_SIZE];
+	int listeners[GROUP_SIZE];
+	for (auto& listener : listeners)
+	{
+		listener = bound_socket(SOCK_STREAM, TCP_PORT, true);
+		if (listener == -1 || listen(listener, TCP_CONNECTIONS) == -1)
+		{
+			perror("listen");
+			return false;
+		}
+	}
+
+	for (uint8_t i = 0; i < GROUP_SIZE; i++)
+	{
+		workers[i] = fork();
+		if (workers[i] == -1)
+		{
+			perror("fork");
+			exit(1);
+		}
+		if (workers[i] == 0)
+		{
+			for (uint8_t j = 0; j < GROUP_SIZE; j++)
+				if (j != i)
+					close(listeners[j]);
+			tcp_worker(listeners[i], i);
+		}
+	}
+
+	for (auto listener : listeners)
+		close(listener);
+
+	bool success = true;
+	size_t per_worker[GROUP_SIZE] {};
+
+	const auto server_address = loopback_address(TCP_PORT);
+	for (uint8_t i = 0; i < TCP_CONNECTIONS && success; i++)
+	{
+		int client = socket(AF_INET, SOCK_STREAM, 0);
+		if (client == -1 || connect(client, reinterpret_cast<const sockaddr*>(&server_address), sizeof(server_address)) == -1)
+		{
+			perror("connect");
+			success = false;
+			break;
+		}
+
+		uint8_t reply[2];
+		size_t nrecv = 0;
+		if (send(client, &i, 1, 0) == 1)
+		{
+			while (nrecv < sizeof(reply))
+			{
+				const ssize_t ret = recv(client, reply + nrecv, sizeof(reply) - nrecv, 0);
+				if (ret <= 0)
+					break;
+				nrecv += ret;
+			}
+		}
+
+		if (nrecv != sizeof(reply) || reply[0] != i || reply[1] >= GROUP_SIZE)
+		{
+			fprintf(stderr, "  invalid reply on connection %u\n", i);
+			success = false;
+		}
+		else
+		{
+			per_worker[reply[1]]++;
+		}
+
+		close(client);
+	}
+
+	for (auto worker : workers)
+	{
+		kill(worker, SIGKILL);
+		waitpid(worker, nullptr, 0);
+	}
+
+	size_t used_workers = 0;
+	for (size_t i = 0; i < GROUP_SIZE; i++)
+	{
+		printf("  worker %zu: %zu connections\n", i, per_worker[i]);
+		used_workers += !!per_worker[i];
+	}
+
+	if (success && used_workers < 2)
+	{
+		fprintf(stderr, "  connections were not spread across listeners\n");
+		success = false;
+	}
+	return success;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("bind rules\n");
+	if (!test_bind_rules())
+		ret = 1;
+
+	printf("UDP, %d sockets\n", GROUP_SIZE);
+	if (!test_udp_spreading())
+		ret = 1;
+
+	printf("TCP, %d listeners\n", GROUP_SIZE);
+	if (!test_tcp_listeners())
+		ret = 1;
+
+	return ret;
+}
@@ -0,0 +1,198 @@
+#include "benchmark.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define SOURCE_FILE "test-sendfile-src"
+#define TARGET_FILE "test-sendfile-dst"
+#define FILE_SIZE (16 * 1024 * 1024)
+
+static int prepare_file()
+{
+	int fd = open(SOURCE_FILE, O_WRONLY | O_TRUNC | O_CREAT, 0666);
+	if (fd == -1)
+	{
+		perror("open");
+		return 1;
+	}
+
+	char buffer[4096];
+	for (size_t i = 0; i < sizeof(buffer); i++)
+		buffer[i] = 'a' + i % 26;
+
+	for (size_t i = 0; i < FILE_SIZE / sizeof(buffer); i++)
+	{
+		if (write(fd, buffer, sizeof(buffer)) != sizeof(buffer))
+		{
+			perror("write");
+			close(fd);
+			return 1;
+		}
+	}
+
+	close(fd);
+	return 0;
+}
+
+static bool copy_with_read_write(int src_fd, int dst_fd, size_t buffer_size)
+{
+	char* buffer = static_cast<char*>(malloc(buffer_size));
+	if (buffer == nullptr)
+		return false;
+
+	bool success = true;
+	for (;;)
+	{
+		const ssize_t nread = read(src_fd, buffer, buffer_size);
+		if (nread <= 0)
+		{
+			success = (nread == 0);
+			break;
+		}
+
+		for (ssize_t total = 0; total < nread;)
+		{
+			const ssize_t nwrite = write(dst_fd, buffer + total, nread - total);
+			if (nwrite <= 0)
+			{
+				success = false;
+				break;
+			}
+			total += nwrite;
+		}
+	}
+
+	free(buffer);
+	return success;
+}
+
+static bool copy_with_copy_file_range(int src_fd, int dst_fd)
+{
+	for (;;)
+	{
+		const ssize_t ncopied = copy_file_range(src_fd, nullptr, dst_fd, nullptr, FILE_SIZE, 0);
+		if (ncopied <= 0)
+			return ncopied == 0;
+	}
+}
+
+static bool send_with_sendfile(int src_fd, int dst_fd)
+{
+	off_t offset = 0;
+	while (offset < FILE_SIZE)
+		if (sendfile(dst_fd, src_fd, &offset, FILE_SIZE - offset) <= 0)
+			return false;
+	return true;
+}
+
+static int benchmark_file_copy(const char* name, bool use_copy_file_range)
+{
+	int src_fd = open(SOURCE_FILE, O_RDONLY);
+	int dst_fd = open(TARGET_FILE, O_WRONLY | O_TRUNC | O_CREAT, 0666);
+	if (src_fd == -1 || dst_fd == -1)
+	{
+		perror("open");
+		return 1;
+	}
+
+	const uint64_t start_ns = get_ns();
+	const bool success = use_copy_file_range
+		? copy_with_copy_file_range(src_fd, dst_fd)
+		: copy_with_read_write(src_fd, dst_fd, 512);
+	const uint64_t end_ns = get_ns();
+
+	close(src_fd);
+	close(dst_fd);
+
+	if (!success)
+	{
+		perror(name);
+		return 1;
+	}
+
+	print_throughput(name, FILE_SIZE, end_ns - start_ns);
+	return 0;
+}
+
+static int benchmark_socket_send(const char* name, bool use_sendfile)
+{
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == -1)
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return 1;
+	}
+
+	if (pid == 0)
+	{
+		close(sockets[0]);
+		char buffer[4096];
+		while (read(sockets[1], buffer, sizeof(buffer)) > 0)
+			continue;
+		exit(0);
+	}
+
+	close(sockets[1]);
+
+	int src_fd = open(SOURCE_FILE, O_RDONLY);
+	if (src_fd == -1)
+	{
+		perror("open");
+		return 1;
+	}
+
+	const uint64_t start_ns = get_ns();
+	const bool success = use_sendfile
+		? send_with_sendfile(src_fd, sockets[0])
+		: copy_with_read_write(src_fd, sockets[0], 64 * 1024);
+	const uint64_t end_ns = get_ns();
+
+	close(src_fd);
+	close(sockets[0]);
+	waitpid(pid, nullptr, 0);
+
+	if (!success)
+	{
+		perror(name);
+		return 1;
+	}
+
+	print_throughput(name, FILE_SIZE, end_ns - start_ns);
+	return 0;
+}
+
+int main()
+{
+	if (prepare_file())
+		return 1;
+
+	printf("file to file, %d MiB\n", FILE_SIZE / 1024 / 1024);
+	if (benchmark_file_copy("read/write", false))
+		return 1;
+	if (benchmark_file_copy("copy_file_range", true))
+		return 1;
+
+	printf("file to socket, %d MiB\n", FILE_SIZE / 1024 / 1024);
+	if (benchmark_socket_send("read/write", false))
+		return 1;
+	if (benchmark_socket_send("sendfile", true))
+		return 1;
+
+	unlink(SOURCE_FILE);
+	unlink(TARGET_FILE);
+
+	return 0;
+}
@@ -1,19 +1,257 @@
+#include "benchmark.h"
+
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#define BENCHMARK_PACKETS 100000
+#define BENCHMARK_BATCH 16
+#define BENCHMARK_PACKET_SIZE 64
+#define BENCHMARK_ROUND_TRIPS 20000
+
 int usage(const char* argv0)
 {
-	fprintf(stderr, "usage: %s [-s|-c] [-a addr] [-p port]\n", argv0);
+	fprintf(stderr, "usage: %s [-s|-c|-b] [-a addr] [-p port]\n", argv0);
 	return 1;
 }
 
+// The sender sends a window of BENCHMARK_BATCH packets and waits for an acknowledgement
+// before sending the next one, so no packets get dropped when the receive queue fills up
+static void benchmark_sender(const sockaddr_in& server_addr, bool batched)
+{
+	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket == -1 || connect(socket, (const sockaddr*)&server_addr, sizeof(server_addr)) == -1)
+		exit(1);
+
+	static char buffers[BENCHMARK_BATCH][BENCHMARK_PACKET_SIZE];
+	iovec iovs[BENCHMARK_BATCH];
+	mmsghdr messages[BENCHMARK_BATCH] {};
+	for (size_t i = 0; i < BENCHMARK_BATCH; i++)
+	{
+		iovs[i] = { .iov_base = buffers[i], .iov_len = BENCHMARK_PACKET_SIZE };
+		messages[i].msg_hdr.msg_iov = &iovs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	for (size_t sent = 0; sent < BENCHMARK_PACKETS; sent += BENCHMARK_BATCH)
+	{
+		if (batched)
+		{
+			for (size_t i = 0; i < BENCHMARK_BATCH;)
+			{
+				const int ret = sendmmsg(socket, messages + i, BENCHMARK_BATCH - i, 0);
+				if (ret <= 0)
+					exit(1);
+				i += ret;
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < BENCHMARK_BATCH; i++)
+				if (send(socket, buffers[i], BENCHMARK_PACKET_SIZE, 0) != BENCHMARK_PACKET_SIZE)
+					exit(1);
+		}
+
+		char ack;
+		if (recv(socket, &ack, 1, 0) != 1)
+			exit(1);
+	}
+
+	exit(0);
+}
+
+static bool benchmark_latency(uint16_t port)
+{
+	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket == -1)
+	{
+		perror("socket");
+		return false;
+	}
+
+	sockaddr_in bind_addr;
+	bind_addr.sin_family = AF_INET;
+	bind_addr.sin_port = htons(port);
+	bind_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+	if (bind(socket, (sockaddr*)&bind_addr, sizeof(bind_addr)) == -1)
+	{
+		perror("bind");
+		close(socket);
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		close(socket);
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		char buffer[BENCHMARK_PACKET_SIZE];
+		for (size_t i = 0; i < BENCHMARK_ROUND_TRIPS; i++)
+		{
+			sockaddr_in sender;
+			socklen_t sender_len = sizeof(sender);
+			const ssize_t nrecv = recvfrom(socket, buffer, sizeof(buffer), 0, (sockaddr*)&sender, &sender_len);
+			if (nrecv <= 0 || sendto(socket, buffer, nrecv, 0, (sockaddr*)&sender, sender_len) != nrecv)
+				exit(1);
+		}
+		exit(0);
+	}
+
+	close(socket);
+
+	socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket == -1 || connect(socket, (sockaddr*)&bind_addr, sizeof(bind_addr)) == -1)
+	{
+		perror("socket");
+		kill(pid, SIGKILL);
+		waitpid(pid, nullptr, 0);
+		return false;
+	}
+
+	bool success = true;
+
+	char buffer[BENCHMARK_PACKET_SIZE] {};
+	const uint64_t start_ns = get_ns();
+	for (size_t i = 0; i < BENCHMARK_ROUND_TRIPS && success; i++)
+		if (send(socket, buffer, sizeof(buffer), 0) != sizeof(buffer) || recv(socket, buffer, sizeof(buffer), 0) != sizeof(buffer))
+			success = false;
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (!success)
+		kill(pid, SIGKILL);
+
+	int status;
+	if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		success = false;
+
+	close(socket);
+
+	if (!success)
+	{
+		fprintf(stderr, "  round trip benchmark failed\n");
+		return false;
+	}
+
+	printf("  %llu ns round trip\n", (unsigned long long)(elapsed_ns / BENCHMARK_ROUND_TRIPS));
+	return true;
+}
+
+static bool benchmark(uint16_t port, bool batched)
+{
+	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+	if (socket == -1)
+	{
+		perror("socket");
+		return false;
+	}
+
+	sockaddr_in bind_addr;
+	bind_addr.sin_family = AF_INET;
+	bind_addr.sin_port = htons(port);
+	bind_addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+	if (bind(socket, (sockaddr*)&bind_addr, sizeof(bind_addr)) == -1)
+	{
+		perror("bind");
+		close(socket);
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		close(socket);
+		return false;
+	}
+	if (pid == 0)
+		benchmark_sender(bind_addr, batched);
+
+	static char buffers[BENCHMARK_BATCH][BENCHMARK_PACKET_SIZE];
+	iovec iovs[BENCHMARK_BATCH];
+	mmsghdr messages[BENCHMARK_BATCH] {};
+	for (size_t i = 0; i < BENCHMARK_BATCH; i++)
+	{
+		iovs[i] = { .iov_base = buffers[i], .iov_len = BENCHMARK_PACKET_SIZE };
+		messages[i].msg_hdr.msg_iov = &iovs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	sockaddr_in sender;
+	socklen_t sender_len = sizeof(sender);
+
+	bool success = true;
+
+	const uint64_t start_ns = get_ns();
+	for (size_t received = 0; received < BENCHMARK_PACKETS && success;)
+	{
+		for (size_t i = 0; i < BENCHMARK_BATCH && success;)
+		{
+			if (batched)
+			{
+				messages[i].msg_hdr.msg_name = &sender;
+				messages[i].msg_hdr.msg_namelen = sizeof(sender);
+				const int ret = recvmmsg(socket, messages + i, BENCHMARK_BATCH - i, MSG_WAITFORONE, nullptr);
+				if (ret <= 0)
+					success = false;
+				else
+					i += ret;
+			}
+			else
+			{
+				sender_len = sizeof(sender);
+				if (recvfrom(socket, buffers[i], BENCHMARK_PACKET_SIZE, 0, (sockaddr*)&sender, &sender_len) != BENCHMARK_PACKET_SIZE)
+					success = false;
+				else
+					i++;
+			}
+		}
+		received += BENCHMARK_BATCH;
+
+		const char ack = 0;
+		if (success && sendto(socket, &ack, 1, 0, (sockaddr*)&sender, sizeof(sender)) != 1)
+			success = false;
+	}
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	if (!success)
+		kill(pid, SIGKILL);
+
+	int status;
+	if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		success = false;
+
+	close(socket);
+
+	if (!success)
+	{
+		fprintf(stderr, "  %s: benchmark failed\n", batched ? "recvmmsg/sendmmsg" : "recvfrom/send");
+		return false;
+	}
+
+	printf("  %s: %llu packets/s\n",
+		batched ? "recvmmsg/sendmmsg" : "recvfrom/send",
+		(unsigned long long)(BENCHMARK_PACKETS * 1'000'000'000ull / elapsed_ns)
+	);
+	return true;
+}
+
 int main(int argc, char** argv)
 {
 	bool server = false;
+	bool run_benchmark = false;
 	uint32_t addr = 0;
 	uint16_t port = 0;
 
@@ -23,6 +261,8 @@ int main(int argc, char** argv)
 			server = true;
 		else if (strcmp(argv[i], "-c") == 0)
 			server = false;
+		else if (strcmp(argv[i], "-b") == 0)
+			run_benchmark = true;
 		else if (strcmp(argv[i], "-a") == 0)
 			addr = inet_addr(argv[++i]);
 		else if (strcmp(argv[i], "-p") == 0)
@@ -31,6 +271,19 @@ int main(int argc, char** argv)
 			return usage(argv[0]);
 	}
 
+	if (run_benchmark)
+	{
+		if (port == 0)
+			port = 5555;
+		bool success = true;
+		printf("loopback latency, %d byte packets\n", BENCHMARK_PACKET_SIZE);
+		success &= benchmark_latency(port);
+		printf("loopback packets per second, %d byte packets in windows of %d\n", BENCHMARK_PACKET_SIZE, BENCHMARK_BATCH);
+		success &= benchmark(port, false);
+		success &= benchmark(port, true);
+		return success ? 0 : 1;
+	}
+
 	int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
 	if (socket == -1)
 	{
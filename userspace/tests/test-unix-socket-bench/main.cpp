@@ -0,0 +1,260 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PING_PONG_ITERATIONS 100000
+#define TRANSFER_SIZE (256 * 1024 * 1024)
+#define CHUNK_SIZE (64 * 1024)
+
+static bool read_exact(int fd, void* buffer, size_t size)
+{
+	for (size_t nread = 0; nread < size;)
+	{
+		const ssize_t ret = read(fd, static_cast<uint8_t*>(buffer) + nread, size - nread);
+		if (ret <= 0)
+			return false;
+		nread += ret;
+	}
+	return true;
+}
+
+static bool write_exact(int fd, const void* buffer, size_t size)
+{
+	for (size_t nwritten = 0; nwritten < size;)
+	{
+		const ssize_t ret = write(fd, static_cast<const uint8_t*>(buffer) + nwritten, size - nwritten);
+		if (ret <= 0)
+			return false;
+		nwritten += ret;
+	}
+	return true;
+}
+
+static bool wait_child(pid_t pid)
+{
+	int status;
+	return waitpid(pid, &status, 0) != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool benchmark_ping_pong(int type, const char* name)
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, type, 0, fds) == -1)
+	{
+		perror("socketpair");
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		close(fds[0]);
+		char byte;
+		for (size_t i = 0; i < PING_PONG_ITERATIONS; i++)
+			if (!read_exact(fds[1], &byte, 1) || !write_exact(fds[1], &byte, 1))
+				exit(1);
+		exit(0);
+	}
+
+	close(fds[1]);
+
+	bool success = true;
+
+	const uint64_t start_ns = get_ns();
+	for (size_t i = 0; i < PING_PONG_ITERATIONS && success; i++)
+	{
+		char byte = i;
+		char reply;
+		if (!write_exact(fds[0], &byte, 1) || !read_exact(fds[0], &reply, 1) || reply != byte)
+			success = false;
+	}
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	close(fds[0]);
+	if (!wait_child(pid))
+		success = false;
+
+	if (success)
+		printf("  %s: %llu ns round trip\n", name, (unsigned long long)(elapsed_ns / PING_PONG_ITERATIONS));
+	else
+		fprintf(stderr, "  %s: ping-pong failed\n", name);
+	return success;
+}
+
+static bool benchmark_throughput()
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+	{
+		perror("socketpair");
+		return false;
+	}
+
+	const pid_t pid = fork();
+	if (pid == -1)
+	{
+		perror("fork");
+		return false;
+	}
+
+	if (pid == 0)
+	{
+		close(fds[0]);
+		static uint8_t buffer[CHUNK_SIZE];
+		for (size_t total = 0; total < TRANSFER_SIZE; total += sizeof(buffer))
+		{
+			for (size_t i = 0; i < sizeof(buffer); i++)
+				buffer[i] = total + i;
+			if (!write_exact(fds[1], buffer, sizeof(buffer)))
+				exit(1);
+		}
+		exit(0);
+	}
+
+	close(fds[1]);
+
+	static uint8_t buffer[CHUNK_SIZE];
+
+	bool success = true;
+	size_t total = 0;
+
+	const uint64_t start_ns = get_ns();
+	for (;;)
+	{
+		const ssize_t nread = read(fds[0], buffer, sizeof(buffer));
+		if (nread <= 0)
+		{
+			success = (nread == 0);
+			break;
+		}
+		for (ssize_t i = 0; i < nread && success; i++)
+			if (buffer[i] != static_cast<uint8_t>(total + i))
+				success = false;
+		total += nread;
+	}
+	const uint64_t elapsed_ns = get_ns() - start_ns;
+
+	close(fds[0]);
+	if (!wait_child(pid))
+		success = false;
+	if (total != TRANSFER_SIZE)
+		success = false;
+
+	if (success)
+		print_throughput("SOCK_STREAM", TRANSFER_SIZE, elapsed_ns);
+	else
+		fprintf(stderr, "  SOCK_STREAM: data corrupted or lost, got %zu bytes\n", total);
+	return success;
+}
+
+// ancillary data must not be merged with data sent before or after it
+static bool test_ancillary_barrier()
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1)
+	{
+		perror("socketpair");
+		return false;
+	}
+
+	bool success = true;
+
+	if (!write_exact(fds[0], "abc", 3))
+		success = false;
+
+	{
+		char data[] = "def";
+		iovec iov { .iov_base = data, .iov_len = 3 };
+
+		char control[CMSG_SPACE(sizeof(int))] {};
+		msghdr message {};
+		message.msg_iov = &iov;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		auto* cheader = CMSG_FIRSTHDR(&message);
+		cheader->cmsg_level = SOL_SOCKET;
+		cheader->cmsg_type = SCM_RIGHTS;
+		cheader->cmsg_len = CMSG_LEN(sizeof(int));
+		*reinterpret_cast<int*>(CMSG_DATA(cheader)) = STDOUT_FILENO;
+
+		if (sendmsg(fds[0], &message, 0) != 3)
+			success = false;
+	}
+
+	if (!write_exact(fds[0], "ghi", 3))
+		success = false;
+
+	const auto receive =
+		[&](const char* expected, bool expect_fd) -> bool
+		{
+			char data[16] {};
+			iovec iov { .iov_base = data, .iov_len = sizeof(data) };
+
+			char control[CMSG_SPACE(sizeof(int))] {};
+			msghdr message {};
+			message.msg_iov = &iov;
+			message.msg_iovlen = 1;
+			message.msg_control = control;
+			message.msg_controllen = sizeof(control);
+
+			const ssize_t nrecv = recvmsg(fds[1], &message, 0);
+			if (nrecv != static_cast<ssize_t>(strlen(expected)) || memcmp(data, expected, nrecv) != 0)
+			{
+				fprintf(stderr, "  expected '%s', got '%.*s'\n", expected, (int)nrecv, data);
+				return false;
+			}
+
+			auto* cheader = CMSG_FIRSTHDR(&message);
+			if ((cheader != nullptr) != expect_fd)
+			{
+				fprintf(stderr, "  ancillary data %s with '%s'\n", expect_fd ? "missing" : "unexpected", expected);
+				return false;
+			}
+			if (cheader != nullptr)
+				close(*reinterpret_cast<int*>(CMSG_DATA(cheader)));
+			return true;
+		};
+
+	// the descriptor is only received with the data it was sent with
+	success &= receive("abc", false);
+	success &= receive("def", true);
+	success &= receive("ghi", false);
+
+	close(fds[0]);
+	close(fds[1]);
+	return success;
+}
+
+int main()
+{
+	int ret = 0;
+
+	printf("ping-pong latency\n");
+	if (!benchmark_ping_pong(SOCK_STREAM, "SOCK_STREAM"))
+		ret = 1;
+	if (!benchmark_ping_pong(SOCK_SEQPACKET, "SOCK_SEQPACKET"))
+		ret = 1;
+
+	printf("throughput\n");
+	if (!benchmark_throughput())
+		ret = 1;
+
+	printf("ancillary data barrier\n");
+	if (!test_ancillary_barrier())
+		ret = 1;
+
+	return ret;
+}
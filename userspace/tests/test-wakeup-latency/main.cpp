@@ -0,0 +1,133 @@
+#include "benchmark.h"
+
+#include <BAN/Atomic.h>
+#include <BAN/Sort.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/futex.h>
+#include <unistd.h>
+
+#define ITERATIONS 10000
+#define IDLE_ITERATIONS 1000
+#define IDLE_SLEEP_US 1000
+
+struct ping_pong_t
+{
+	BAN::Atomic<uint32_t> turn { 0 };
+	BAN::Atomic<uint64_t> wake_ns { 0 };
+	BAN::Atomic<int> last_cpu { -1 };
+	size_t iterations;
+	useconds_t sleep_us;
+
+	// measured by the side that gets woken
+	uint64_t latencies_ns[2][ITERATIONS];
+	size_t cross_cpu_wakeups;
+};
+
+static void pass_turn(ping_pong_t& ping_pong, uint32_t next)
+{
+	ping_pong.wake_ns.store(get_ns());
+	ping_pong.turn.store(next);
+	futex(FUTEX_WAKE_PRIVATE, reinterpret_cast<uint32_t*>(&ping_pong.turn), 1, nullptr);
+}
+
+static void wait_turn(ping_pong_t& ping_pong, uint32_t self)
+{
+	for (;;)
+	{
+		const uint32_t turn = ping_pong.turn.load();
+		if (turn == self)
+			return;
+		futex(FUTEX_WAIT_PRIVATE, reinterpret_cast<uint32_t*>(&ping_pong.turn), turn, nullptr);
+	}
+}
+
+static void run_side(ping_pong_t& ping_pong, uint32_t self)
+{
+	for (size_t i = 0; i < ping_pong.iterations; i++)
+	{
+		wait_turn(ping_pong, self);
+		ping_pong.latencies_ns[self][i] = get_ns() - ping_pong.wake_ns.load();
+
+		const int cpu = sched_getcpu();
+		if (const int last_cpu = ping_pong.last_cpu.exchange(cpu); last_cpu != -1 && last_cpu != cpu)
+			ping_pong.cross_cpu_wakeups++;
+
+		// let the other side's processor go idle before waking it
+		if (ping_pong.sleep_us)
+			usleep(ping_pong.sleep_us);
+
+		pass_turn(ping_pong, !self);
+	}
+}
+
+static void print_latencies(const char* name, ping_pong_t& ping_pong)
+{
+	static uint64_t latencies[2 * ITERATIONS];
+
+	// the first wakeup of thread 0 is the start of the test, it is not measured
+	size_t total = 0;
+	for (size_t i = 1; i < ping_pong.iterations; i++)
+		latencies[total++] = ping_pong.latencies_ns[0][i];
+	for (size_t i = 0; i < ping_pong.iterations; i++)
+		latencies[total++] = ping_pong.latencies_ns[1][i];
+
+	BAN::sort::sort(latencies, latencies + total);
+
+	uint64_t sum = 0;
+	for (size_t i = 0; i < total; i++)
+		sum += latencies[i];
+
+	printf("  %-24s min %6llu ns, median %6llu ns, avg %6llu ns, p99 %7llu ns, max %8llu ns, %zu/%zu cross cpu\n",
+		name,
+		(unsigned long long)latencies[0],
+		(unsigned long long)latencies[total / 2],
+		(unsigned long long)(sum / total),
+		(unsigned long long)latencies[total * 99 / 100],
+		(unsigned long long)latencies[total - 1],
+		ping_pong.cross_cpu_wakeups, total
+	);
+}
+
+static bool benchmark(const char* name, size_t iterations, useconds_t sleep_us)
+{
+	auto* ping_pong = new ping_pong_t;
+	ping_pong->iterations = iterations;
+	ping_pong->sleep_us = sleep_us;
+	ping_pong->cross_cpu_wakeups = 0;
+
+	pthread_t thread;
+	const auto thread_main = [](void* arg) -> void* {
+		run_side(*static_cast<ping_pong_t*>(arg), 1);
+		return nullptr;
+	};
+	if (pthread_create(&thread, nullptr, thread_main, ping_pong) != 0)
+	{
+		perror("pthread_create");
+		delete ping_pong;
+		return false;
+	}
+
+	run_side(*ping_pong, 0);
+	pthread_join(thread, nullptr);
+
+	print_latencies(name, *ping_pong);
+
+	delete ping_pong;
+	return true;
+}
+
+int main()
+{
+	printf("futex ping-pong wakeup latency (%ld processors)\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+	int ret = 0;
+	if (!benchmark("back to back", ITERATIONS, 0))
+		ret = 1;
+	if (!benchmark("after 1 ms idle", IDLE_ITERATIONS, IDLE_SLEEP_US))
+		ret = 1;
+	return ret;
+}